@@ -0,0 +1,425 @@
+// --- xRcon\BanList.cpp ---
+// Implementation of the central ban list and its server-side IP filter sync.
+// Rules are matched through a radix trie (addresses) and hashes (names, GUIDs); the ini format mirrors servers.ini.
+
+#include "BanList.h"
+#include "PlayerIndex.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+static char lowerAscii(char c) {
+    return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+static uint32_t prefixMask(uint32_t length) {
+    return length == 0 ? 0 : ~0u << (32 - length);
+}
+
+// Leading bits a and b share, at most limit.
+static uint32_t commonLength(uint32_t a, uint32_t b, uint32_t limit) {
+    uint32_t length = 0;
+    for (uint32_t diff = a ^ b; length < limit && !(diff & 0x80000000u); diff <<= 1) ++length;
+    return length;
+}
+
+bool BanList::parseAddress(std::string_view text, uint32_t& ip, uint32_t& bits) {
+    uint32_t mask = 0;
+    if (!PlayerIndex::parseCidr(text, ip, mask)) return false;
+    bits = 0;
+    while (bits < 32 && (mask & (0x80000000u >> bits))) ++bits;
+    return true;
+}
+
+bool BanList::wildcardMatch(std::string_view pattern, std::string_view text) {
+    // Greedy with backtracking to the last star: linear for patterns with one star, which is the usual case
+    size_t p = 0, t = 0, star = std::string_view::npos, resume = 0;
+    while (t < text.size()) {
+        if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == text[t])) {
+            ++p;
+            ++t;
+        }
+        else if (p < pattern.size() && pattern[p] == '*') {
+            star = p++;
+            resume = t;
+        }
+        else if (star != std::string_view::npos) {
+            p = star + 1;
+            t = ++resume;
+        }
+        else {
+            return false;
+        }
+    }
+    while (p < pattern.size() && pattern[p] == '*') ++p;
+    return p == pattern.size();
+}
+
+// Kind and canonical pattern; no two rules share one.
+static std::string patternTag(const BanRule& rule) {
+    return static_cast<char>('0' + static_cast<int>(rule.kind)) + rule.pattern;
+}
+
+bool BanList::canonicalize(BanRule& rule) const {
+    if (rule.kind == BanKind::Address) {
+        if (!parseAddress(rule.pattern, rule.ip, rule.bits) || rule.bits == 0) return false; // Not everyone
+        char text[24];
+        snprintf(text, sizeof(text), "%u.%u.%u.%u", rule.ip >> 24, (rule.ip >> 16) & 255, (rule.ip >> 8) & 255, rule.ip & 255);
+        rule.pattern = text;
+        if (rule.bits < 32) rule.pattern += "/" + std::to_string(rule.bits);
+        rule.key.clear();
+    }
+    else if (rule.kind == BanKind::Name) {
+        rule.key = PlayerIndex::normalize(rule.pattern);
+        if (rule.key.empty() || rule.key.find_first_not_of('*') == std::string::npos) return false;
+    }
+    else {
+        rule.key = rule.pattern;
+        for (char& c : rule.key) c = lowerAscii(c);
+        rule.pattern = rule.key;
+        if (rule.key.empty()) return false;
+    }
+    return patterns.count(patternTag(rule)) == 0;
+}
+
+void BanList::trieInsert(uint32_t prefix, uint32_t length, int32_t rule) {
+    if (trie.empty()) trie.push_back(TrieNode{ 0, 0, { -1, -1 }, -1 });
+    prefix &= prefixMask(length);
+    uint32_t at = 0;
+    for (;;) {
+        // trie[at] is a prefix of (prefix, length)
+        if (trie[at].length == length) {
+            trie[at].rule = rule;
+            return;
+        }
+        uint32_t bit = (prefix >> (31 - trie[at].length)) & 1;
+        int32_t next = trie[at].child[bit];
+        if (next < 0) {
+            trie.push_back(TrieNode{ prefix, length, { -1, -1 }, rule });
+            trie[at].child[bit] = static_cast<int32_t>(trie.size() - 1);
+            return;
+        }
+        TrieNode child = trie[next];
+        uint32_t common = commonLength(child.prefix, prefix, std::min(child.length, length));
+        if (common == child.length) {
+            at = static_cast<uint32_t>(next);
+            continue;
+        }
+        // The paths part below the edge: split it with a node for the shared bits
+        TrieNode split{ prefix & prefixMask(common), common, { -1, -1 }, -1 };
+        split.child[(child.prefix >> (31 - common)) & 1] = next;
+        if (common == length) {
+            split.rule = rule;
+        }
+        else {
+            trie.push_back(TrieNode{ prefix, length, { -1, -1 }, rule });
+            split.child[(prefix >> (31 - common)) & 1] = static_cast<int32_t>(trie.size() - 1);
+        }
+        trie.push_back(split);
+        trie[at].child[bit] = static_cast<int32_t>(trie.size() - 1);
+        return;
+    }
+}
+
+void BanList::index(uint32_t position) {
+    const BanRule& rule = list[position];
+    patterns.insert(patternTag(rule));
+    if (rule.kind == BanKind::Address) {
+        trieInsert(rule.ip, rule.bits, static_cast<int32_t>(position));
+    }
+    else if (rule.kind == BanKind::Guid) {
+        guids[rule.key] = position;
+    }
+    else if (rule.key.find_first_of("*?") == std::string::npos) {
+        exactNames[rule.key] = position;
+    }
+    else {
+        NamePattern pattern{ std::string(), position };
+        for (size_t start = 0; start < rule.key.size();) {
+            size_t end = std::min(rule.key.find_first_of("*?", start), rule.key.size());
+            if (end - start > pattern.literal.size()) pattern.literal = rule.key.substr(start, end - start);
+            start = end + 1;
+        }
+        namePatterns.push_back(std::move(pattern));
+    }
+}
+
+void BanList::rebuild() {
+    trie.clear();
+    exactNames.clear();
+    namePatterns.clear();
+    guids.clear();
+    patterns.clear();
+    for (uint32_t i = 0; i < list.size(); ++i) index(i);
+}
+
+bool BanList::add(BanRule rule) {
+    if (!canonicalize(rule)) {
+        return false;
+    }
+    rule.id = nextId++;
+    list.push_back(std::move(rule));
+    index(static_cast<uint32_t>(list.size() - 1));
+    ++changes;
+    return true;
+}
+
+bool BanList::remove(uint32_t id) {
+    auto it = std::find_if(list.begin(), list.end(), [id](const BanRule& rule) { return rule.id == id; });
+    if (it == list.end()) {
+        return false;
+    }
+    list.erase(it);
+    rebuild(); // Indexes into list moved; removals are rare
+    ++changes;
+    return true;
+}
+
+void BanList::clear() {
+    list.clear();
+    rebuild();
+    ++changes;
+}
+
+const BanRule* BanList::match(std::string_view key, uint32_t ip, std::string_view guid, uint64_t nowUnixMs) const {
+    if (ip && !trie.empty()) {
+        // Longest active prefix on the path; a lapsed /32 does not hide an active /16 above it
+        const BanRule* found = nullptr;
+        int32_t at = 0;
+        while (at >= 0) {
+            const TrieNode& node = trie[at];
+            if ((ip & prefixMask(node.length)) != node.prefix) break;
+            if (node.rule >= 0 && list[node.rule].active(nowUnixMs)) found = &list[node.rule];
+            if (node.length == 32) break;
+            at = node.child[(ip >> (31 - node.length)) & 1];
+        }
+        if (found) return found;
+    }
+    if (!guid.empty()) {
+        auto it = guids.find(std::string(guid));
+        if (it != guids.end() && list[it->second].active(nowUnixMs)) return &list[it->second];
+    }
+    if (!key.empty()) {
+        auto it = exactNames.find(std::string(key));
+        if (it != exactNames.end() && list[it->second].active(nowUnixMs)) return &list[it->second];
+        for (const NamePattern& pattern : namePatterns) {
+            if (key.find(pattern.literal) == std::string_view::npos) continue;
+            const BanRule& rule = list[pattern.rule];
+            if (rule.active(nowUnixMs) && wildcardMatch(rule.key, key)) return &rule;
+        }
+    }
+    return nullptr;
+}
+
+void BanList::ipFilters(uint64_t nowUnixMs, std::vector<std::string>& out, size_t limit) const {
+    out.clear();
+    // bits << 32 | ip, so the widest ranges sort first; only the ones kept are formatted
+    std::vector<uint64_t> ranges;
+    for (const BanRule& rule : list) {
+        if (rule.kind != BanKind::Address || rule.bits % 8 != 0 || !rule.active(nowUnixMs)) continue;
+        ranges.push_back(static_cast<uint64_t>(rule.bits) << 32 | rule.ip);
+    }
+    if (ranges.size() > limit) {
+        std::nth_element(ranges.begin(), ranges.begin() + limit, ranges.end());
+        ranges.resize(limit);
+    }
+    for (uint64_t range : ranges) {
+        uint32_t bits = static_cast<uint32_t>(range >> 32), ip = static_cast<uint32_t>(range);
+        std::string filter;
+        for (uint32_t octet = 0; octet < bits / 8; ++octet) {
+            if (octet) filter += '.';
+            filter += std::to_string((ip >> (24 - 8 * octet)) & 255);
+        }
+        out.push_back(std::move(filter));
+    }
+    std::sort(out.begin(), out.end());
+    out.erase(std::unique(out.begin(), out.end()), out.end());
+}
+
+static const char* kindName(BanKind kind) {
+    return kind == BanKind::Address ? "address" : kind == BanKind::Name ? "name" : "guid";
+}
+
+// One [ban] section per rule with type, pattern, reason, added and expires keys (times in Unix ms).
+size_t BanList::load(const std::string& path) {
+    list.clear();
+    rebuild();
+    ++changes;
+    std::ifstream file(path);
+    stamp(path);
+    if (!file.is_open()) {
+        return 0;
+    }
+    size_t skipped = 0;
+    BanRule rule;
+    bool inRule = false;
+    std::string typeName;
+    auto finish = [&]() {
+        if (!inRule) return;
+        bool known = true;
+        if (typeName == "address") rule.kind = BanKind::Address;
+        else if (typeName == "name") rule.kind = BanKind::Name;
+        else if (typeName == "guid") rule.kind = BanKind::Guid;
+        else known = false;
+        if (!known || !add(rule)) ++skipped;
+        rule = BanRule();
+        typeName.clear();
+        inRule = false;
+    };
+    std::string line;
+    while (std::getline(file, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty() || line[0] == ';') continue;
+        if (line[0] == '[') {
+            finish();
+            inRule = line == "[ban]";
+            continue;
+        }
+        size_t equals = line.find('=');
+        if (!inRule || equals == std::string::npos) continue;
+        std::string key = line.substr(0, equals);
+        std::string value = line.substr(equals + 1);
+        if (key == "type") typeName = value;
+        else if (key == "pattern") rule.pattern = value;
+        else if (key == "reason") rule.reason = value;
+        else if (key == "added") rule.addedUnixMs = std::strtoull(value.c_str(), nullptr, 10);
+        else if (key == "expires") rule.expiresUnixMs = std::strtoull(value.c_str(), nullptr, 10);
+    }
+    finish();
+    return skipped;
+}
+
+bool BanList::save(const std::string& path) {
+    std::string temporary = path + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::trunc);
+        if (!file.is_open()) {
+            return false;
+        }
+        file << "; xRcon ban list. One [ban] section per rule: type is address (a.b.c.d or a.b.c.d/bits), name\n"
+                "; (* and ? wildcards, colors and case ignored) or guid. Times are Unix milliseconds; expires=0 is permanent.\n";
+        for (const BanRule& rule : list) {
+            file << "\n[ban]\ntype=" << kindName(rule.kind) << "\npattern=" << rule.pattern << "\nreason=" << rule.reason
+                 << "\nadded=" << rule.addedUnixMs << "\nexpires=" << rule.expiresUnixMs << "\n";
+        }
+        if (!file.good()) {
+            return false;
+        }
+    }
+    std::error_code error;
+    std::filesystem::rename(temporary, path, error);
+    if (error) {
+        std::filesystem::remove(temporary, error);
+        return false;
+    }
+    stamp(path);
+    return true;
+}
+
+void BanList::stamp(const std::string& path) {
+    namespace fs = std::filesystem;
+    std::error_code error;
+    bool exists = fs::is_regular_file(path, error);
+    fileSize = exists ? fs::file_size(path, error) : 0;
+    writeTime = exists ? static_cast<int64_t>(fs::last_write_time(path, error).time_since_epoch().count()) : 0;
+}
+
+bool BanList::changedOnDisk(const std::string& path) const {
+    namespace fs = std::filesystem;
+    std::error_code error;
+    bool exists = fs::is_regular_file(path, error);
+    uintmax_t size = exists ? fs::file_size(path, error) : 0;
+    int64_t time = exists ? static_cast<int64_t>(fs::last_write_time(path, error).time_since_epoch().count()) : 0;
+    return size != fileSize || time != writeTime;
+}
+
+void IpFilterSync::diff(const std::string& server, const std::vector<std::string>& desired,
+    std::vector<std::string>& add, std::vector<std::string>& remove) const {
+    add.clear();
+    remove.clear();
+    static const std::vector<std::string> none;
+    auto it = servers.find(server);
+    const std::vector<std::string>& held = it == servers.end() ? none : it->second;
+    std::set_difference(desired.begin(), desired.end(), held.begin(), held.end(), std::back_inserter(add));
+    std::set_difference(held.begin(), held.end(), desired.begin(), desired.end(), std::back_inserter(remove));
+}
+
+void IpFilterSync::applied(const std::string& server, const std::string& filter, bool present) {
+    std::vector<std::string>& held = servers[server];
+    auto at = std::lower_bound(held.begin(), held.end(), filter);
+    bool has = at != held.end() && *at == filter;
+    if (present && !has) held.insert(at, filter);
+    else if (!present && has) held.erase(at);
+}
+
+void IpFilterSync::retain(const std::vector<std::string>& names) {
+    for (auto it = servers.begin(); it != servers.end();) {
+        if (std::find(names.begin(), names.end(), it->first) != names.end()) ++it;
+        else it = servers.erase(it);
+    }
+}
+
+const std::vector<std::string>* IpFilterSync::pushed(const std::string& server) const {
+    auto it = servers.find(server);
+    return it == servers.end() ? nullptr : &it->second;
+}
+
+// "[server name]" sections with a comma-separated filters= line.
+bool IpFilterSync::load(const std::string& path) {
+    servers.clear();
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        return false;
+    }
+    std::string line;
+    std::string server;
+    while (std::getline(file, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.size() >= 2 && line.front() == '[' && line.back() == ']') {
+            server = line.substr(1, line.size() - 2);
+            continue;
+        }
+        if (server.empty() || line.compare(0, 8, "filters=") != 0) continue;
+        std::vector<std::string>& held = servers[server];
+        std::string_view rest(line);
+        rest.remove_prefix(8);
+        while (!rest.empty()) {
+            size_t comma = rest.find(',');
+            std::string_view filter = rest.substr(0, comma);
+            if (!filter.empty()) held.emplace_back(filter);
+            rest = comma == std::string_view::npos ? std::string_view() : rest.substr(comma + 1);
+        }
+        std::sort(held.begin(), held.end());
+        held.erase(std::unique(held.begin(), held.end()), held.end());
+    }
+    return true;
+}
+
+bool IpFilterSync::save(const std::string& path) const {
+    std::string temporary = path + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::trunc);
+        if (!file.is_open()) {
+            return false;
+        }
+        for (const auto& entry : servers) {
+            if (entry.second.empty()) continue;
+            file << "[" << entry.first << "]\nfilters=";
+            for (size_t i = 0; i < entry.second.size(); ++i) file << (i ? "," : "") << entry.second[i];
+            file << "\n";
+        }
+        if (!file.good()) {
+            return false;
+        }
+    }
+    std::error_code error;
+    std::filesystem::rename(temporary, path, error);
+    if (error) {
+        std::filesystem::remove(temporary, error);
+        return false;
+    }
+    return true;
+}
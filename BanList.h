@@ -0,0 +1,112 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+enum class BanKind : uint8_t { Address, Name, Guid };
+
+struct BanRule {
+    uint32_t id = 0;              // Assigned by BanList::add; not stored
+    BanKind kind = BanKind::Address;
+    std::string pattern;          // "a.b.c.d" or "a.b.c.d/bits"; a name with * and ? wildcards; a GUID
+    std::string reason;
+    uint64_t addedUnixMs = 0;
+    uint64_t expiresUnixMs = 0;   // 0 = never
+
+    // Set by add from pattern
+    uint32_t ip = 0;
+    uint32_t bits = 0;
+    std::string key;              // Name: color-stripped and lowercased; GUID: lowercased
+
+    bool active(uint64_t nowUnixMs) const { return expiresUnixMs == 0 || nowUnixMs < expiresUnixMs; }
+};
+
+// The central ban list, kept in an ini file the admin may also edit by hand. Addresses and ranges are
+// matched through a path-compressed binary radix trie (one walk of at most 32 bits finds the longest
+// active prefix), names through a hash of exact names plus the wildcard patterns, GUIDs through a hash.
+class BanList {
+public:
+    // Canonicalizes and adds rule. Returns false (adding nothing) if its pattern is invalid or a rule of
+    // the same kind and pattern exists.
+    bool add(BanRule rule);
+    bool remove(uint32_t id);
+    void clear();
+    const std::vector<BanRule>& rules() const { return list; }
+    uint64_t version() const { return changes; } // Bumped by every change
+
+    // The rule a player falls under, or null. key is the color-stripped lowercased name
+    // (PlayerIndex::normalize), guid lowercased. Expired rules never match.
+    const BanRule* match(std::string_view key, uint32_t ip, std::string_view guid, uint64_t nowUnixMs) const;
+
+    static const size_t kMaxIpFilters = 1024;    // Quake 3 servers hold no more
+
+    // Server-side IP filters for the active address rules on octet boundaries, in Quake 3 addip form
+    // ("a.b.c" for a /24), sorted. Past limit the widest ranges are kept; the rest, like other ranges,
+    // can only be enforced by kicks.
+    void ipFilters(uint64_t nowUnixMs, std::vector<std::string>& out, size_t limit = kMaxIpFilters) const;
+
+    // Replaces the list with path's rules. Returns how many rules were skipped as invalid.
+    size_t load(const std::string& path);
+    bool save(const std::string& path);
+    // True if path was written since the last load or save through this list.
+    bool changedOnDisk(const std::string& path) const;
+
+    static bool parseAddress(std::string_view text, uint32_t& ip, uint32_t& bits);
+    // Glob match; * matches any run of characters, ? any one.
+    static bool wildcardMatch(std::string_view pattern, std::string_view text);
+
+private:
+    // Node 0 is the root (empty prefix). child is -1 where there is none; rule is an index into list or -1.
+    struct TrieNode {
+        uint32_t prefix;
+        uint32_t length;
+        int32_t child[2];
+        int32_t rule;
+    };
+    // A wildcard name rule and its longest literal run, which a name must contain before it is globbed.
+    struct NamePattern {
+        std::string literal;
+        uint32_t rule;
+    };
+
+    bool canonicalize(BanRule& rule) const;
+    void index(uint32_t position);
+    void rebuild();
+    void trieInsert(uint32_t prefix, uint32_t length, int32_t rule);
+    void stamp(const std::string& path);
+
+    std::vector<BanRule> list;
+    std::vector<TrieNode> trie;
+    std::unordered_map<std::string, uint32_t> exactNames;    // Key -> index into list
+    std::vector<NamePattern> namePatterns;
+    std::unordered_map<std::string, uint32_t> guids;
+    std::unordered_set<std::string> patterns;                // Kind and pattern of every rule
+    uint32_t nextId = 1;
+    uint64_t changes = 0;
+    uintmax_t fileSize = 0;
+    int64_t writeTime = 0;
+};
+
+// Which IP filters each server was last sent, so changes to the ban list go out as addip/removeip
+// diffs instead of full rewrites. Kept in its own file next to the ban list.
+class IpFilterSync {
+public:
+    // Filters to add to and remove from server to make it hold desired (sorted).
+    void diff(const std::string& server, const std::vector<std::string>& desired,
+        std::vector<std::string>& add, std::vector<std::string>& remove) const;
+    // Records a filter the server acknowledged adding (present) or removing.
+    void applied(const std::string& server, const std::string& filter, bool present);
+    // Drops servers that are no longer in the list.
+    void retain(const std::vector<std::string>& servers);
+    const std::vector<std::string>* pushed(const std::string& server) const;
+
+    bool load(const std::string& path);
+    bool save(const std::string& path) const;
+
+private:
+    std::unordered_map<std::string, std::vector<std::string>> servers; // Sorted filters per server
+};
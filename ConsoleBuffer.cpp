@@ -0,0 +1,234 @@
+// --- xRcon\ConsoleBuffer.cpp ---
+// Implementation of the fixed-memory console scrollback.
+// Line text is kept contiguous in the ring and separated by '\n', so search scans raw bytes and maps hits back to lines.
+
+#include "ConsoleBuffer.h"
+#include <algorithm>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CONSOLEBUFFER_SSE2 1
+#include <emmintrin.h>
+#endif
+
+// Smallest rings worth having; keeps the arithmetic below free of zero capacities.
+static const size_t kMinimumLines = 16;
+static const size_t kMinimumText = 256;
+
+ConsoleBuffer::ConsoleBuffer(size_t maxLines, size_t maxTextBytes)
+    : maxLines(std::max(maxLines, kMinimumLines)),
+      textCapacityBytes(std::max(maxTextBytes, kMinimumText)),
+      records(new Record[this->maxLines]),
+      text(new char[textCapacityBytes]) {
+    tags.emplace_back();
+}
+
+// Sequences keep counting so a view never mistakes new lines for ones it already shows.
+void ConsoleBuffer::clear() {
+    first = next;
+}
+
+uint64_t ConsoleBuffer::oldestOffset() const {
+    return first < next ? record(first).offset : writeOffset;
+}
+
+void ConsoleBuffer::evictOldest() {
+    if (first < next) ++first;
+}
+
+void ConsoleBuffer::appendLine(std::string_view line, uint16_t tag, ConsoleKind kind, int64_t timeMs) {
+    size_t length = std::min(line.size(), textCapacityBytes - 1); // Room for the separator
+    size_t needed = length + 1;
+    size_t position = static_cast<size_t>(writeOffset % textCapacityBytes);
+    size_t padding = position + needed > textCapacityBytes ? textCapacityBytes - position : 0;
+    uint64_t start = writeOffset + padding;
+    uint64_t end = start + needed;
+    while (first < next && (end - record(first).offset > textCapacityBytes || next - first >= maxLines)) evictOldest();
+
+    // A line never straddles the end of the ring; the skipped tail reads as empty separators
+    if (padding) std::memset(text.get() + position, '\n', padding);
+    char* out = text.get() + static_cast<size_t>(start % textCapacityBytes);
+    std::memcpy(out, line.data(), length);
+    out[length] = '\n';
+    writeOffset = end;
+
+    Record& slot = records[static_cast<size_t>(next % maxLines)];
+    slot.offset = start;
+    slot.timeMs = timeMs;
+    slot.length = static_cast<uint32_t>(length);
+    slot.tag = tag;
+    slot.kind = kind;
+    ++next;
+}
+
+uint64_t ConsoleBuffer::append(std::string_view chunk, uint16_t tag, ConsoleKind kind, int64_t timeMs) {
+    uint64_t added = next;
+    size_t start = 0;
+    while (true) {
+        size_t newline = chunk.find('\n', start);
+        std::string_view piece = chunk.substr(start, newline == std::string_view::npos ? std::string_view::npos : newline - start);
+        if (!piece.empty() && piece.back() == '\r') piece.remove_suffix(1);
+        // A trailing newline ends the last line rather than starting an empty one
+        if (newline == std::string_view::npos) {
+            if (!piece.empty() || start == 0) appendLine(piece, tag, kind, timeMs);
+            break;
+        }
+        appendLine(piece, tag, kind, timeMs);
+        start = newline + 1;
+    }
+    return added;
+}
+
+uint16_t ConsoleBuffer::tagFor(std::string_view name) {
+    if (name.empty()) return 0;
+    for (size_t i = 1; i < tags.size(); ++i) {
+        if (tags[i] == name) return static_cast<uint16_t>(i);
+    }
+    if (tags.size() > 0xFFFF) return 0;
+    tags.emplace_back(name);
+    return static_cast<uint16_t>(tags.size() - 1);
+}
+
+std::string_view ConsoleBuffer::tagName(uint16_t tag) const {
+    return tag < tags.size() ? std::string_view(tags[tag]) : std::string_view();
+}
+
+bool ConsoleBuffer::line(uint64_t sequence, ConsoleLine& out) const {
+    if (sequence < first || sequence >= next) return false;
+    const Record& r = record(sequence);
+    out.sequence = sequence;
+    out.timeMs = r.timeMs;
+    out.tag = r.tag;
+    out.kind = r.kind;
+    out.text = std::string_view(text.get() + static_cast<size_t>(r.offset % textCapacityBytes), r.length);
+    return true;
+}
+
+// Last held line starting at or before offset. Offsets grow with the sequence, so this is a binary search.
+uint64_t ConsoleBuffer::lineAt(uint64_t offset) const {
+    uint64_t low = first, high = next;
+    while (high - low > 1) {
+        uint64_t middle = low + (high - low) / 2;
+        if (record(middle).offset <= offset) low = middle;
+        else high = middle;
+    }
+    return low;
+}
+
+static unsigned char foldAscii(unsigned char c) {
+    return c >= 'A' && c <= 'Z' ? static_cast<unsigned char>(c + 32) : c;
+}
+
+// Boyer-Moore-Horspool over one contiguous span. Returns the match index or npos.
+template <bool Fold>
+static size_t horspool(const unsigned char* hay, size_t hayLength, const unsigned char* needle, size_t needleLength, const size_t* skip) {
+    if (hayLength < needleLength) return std::string_view::npos;
+    size_t last = needleLength - 1;
+    size_t at = 0;
+    while (at + last < hayLength) {
+        size_t i = last;
+        while (true) {
+            unsigned char c = hay[at + i];
+            if ((Fold ? foldAscii(c) : c) != needle[i]) break;
+            if (i == 0) return at;
+            --i;
+        }
+        unsigned char tail = hay[at + last];
+        at += skip[Fold ? foldAscii(tail) : tail];
+    }
+    return std::string_view::npos;
+}
+
+template <bool Fold>
+static bool matchesAt(const unsigned char* hay, const unsigned char* needle, size_t length) {
+    for (size_t i = 0; i < length; ++i) {
+        if ((Fold ? foldAscii(hay[i]) : hay[i]) != needle[i]) return false;
+    }
+    return true;
+}
+
+#ifdef CONSOLEBUFFER_SSE2
+
+// Bytes equal to c, or to its upper case too when folding.
+template <bool Fold>
+static __m128i equalsFolded(__m128i block, unsigned char c) {
+    __m128i equal = _mm_cmpeq_epi8(block, _mm_set1_epi8(static_cast<char>(c)));
+    if (Fold && c >= 'a' && c <= 'z') equal = _mm_or_si128(equal, _mm_cmpeq_epi8(block, _mm_set1_epi8(static_cast<char>(c - 32))));
+    return equal;
+}
+
+// Checks 16 starting positions at once: only where both the first and the last needle byte line up
+// is the middle compared. Skip tables cannot jump far on console text that shares letters with the
+// needle, while this costs the same per block whatever the text.
+template <bool Fold>
+static size_t search(const unsigned char* hay, size_t hayLength, const unsigned char* needle, size_t needleLength, const size_t* skip) {
+    size_t last = needleLength - 1;
+    size_t at = 0;
+    if (needleLength > 1) {
+        for (; at + last + 16 <= hayLength; at += 16) {
+            __m128i head = equalsFolded<Fold>(_mm_loadu_si128(reinterpret_cast<const __m128i*>(hay + at)), needle[0]);
+            __m128i tail = equalsFolded<Fold>(_mm_loadu_si128(reinterpret_cast<const __m128i*>(hay + at + last)), needle[last]);
+            unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_and_si128(head, tail)));
+            while (mask) {
+                size_t bit = 0;
+                while (!(mask & (1u << bit))) ++bit;
+                if (matchesAt<Fold>(hay + at + bit + 1, needle + 1, needleLength - 2)) return at + bit;
+                mask &= mask - 1;
+            }
+        }
+    }
+    size_t rest = horspool<Fold>(hay + at, hayLength - at, needle, needleLength, skip);
+    return rest == std::string_view::npos ? rest : at + rest;
+}
+
+#else
+
+template <bool Fold>
+static size_t search(const unsigned char* hay, size_t hayLength, const unsigned char* needle, size_t needleLength, const size_t* skip) {
+    return horspool<Fold>(hay, hayLength, needle, needleLength, skip);
+}
+
+#endif
+
+uint64_t ConsoleBuffer::find(std::string_view needle, uint64_t fromSequence, bool ignoreCase, uint16_t tag) const {
+    if (fromSequence < first) fromSequence = first;
+    if (fromSequence >= next || needle.find('\n') != std::string_view::npos) return npos;
+    if (needle.empty()) {
+        for (uint64_t s = fromSequence; s < next; ++s) {
+            if (tag == 0 || record(s).tag == tag) return s;
+        }
+        return npos;
+    }
+
+    std::string pattern(needle);
+    if (ignoreCase) {
+        for (char& c : pattern) c = static_cast<char>(foldAscii(static_cast<unsigned char>(c)));
+    }
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(pattern.data());
+    size_t skip[256];
+    std::fill(skip, skip + 256, pattern.size());
+    for (size_t i = 0; i + 1 < pattern.size(); ++i) {
+        skip[p[i]] = pattern.size() - 1 - i;
+        if (ignoreCase && p[i] >= 'a' && p[i] <= 'z') skip[p[i] - 32] = pattern.size() - 1 - i;
+    }
+
+    const unsigned char* ring = reinterpret_cast<const unsigned char*>(text.get());
+    uint64_t at = record(fromSequence).offset;
+    while (at < writeOffset) {
+        // Search up to the end of the ring or the newest byte, whichever is first
+        size_t position = static_cast<size_t>(at % textCapacityBytes);
+        size_t span = static_cast<size_t>(std::min<uint64_t>(writeOffset - at, textCapacityBytes - position));
+        size_t hit = ignoreCase
+            ? search<true>(ring + position, span, p, pattern.size(), skip)
+            : search<false>(ring + position, span, p, pattern.size(), skip);
+        if (hit == std::string_view::npos) {
+            at += span;
+            continue;
+        }
+        uint64_t sequence = lineAt(at + hit);
+        const Record& r = record(sequence);
+        if (tag == 0 || r.tag == tag) return sequence;
+        at = r.offset + r.length + 1;
+    }
+    return npos;
+}
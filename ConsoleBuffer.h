@@ -0,0 +1,81 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+enum class ConsoleKind : uint8_t {
+    Info,
+    Command,                      // Something the user sent
+    Reply,                        // Server output
+    Error
+};
+
+// One scrollback line. text stays valid until the line is evicted.
+struct ConsoleLine {
+    uint64_t sequence = 0;        // Ever-increasing line number, never reused
+    int64_t timeMs = 0;           // Wall-clock milliseconds since the Unix epoch
+    uint16_t tag = 0;             // Server tag from ConsoleBuffer::tagFor, 0 = none
+    ConsoleKind kind = ConsoleKind::Info;
+    std::string_view text;
+};
+
+// Scrollback for the output console in fixed memory: a byte ring holding line text and a ring of
+// line records. Appending evicts the oldest lines once either ring is full, so capacity is set once
+// and never grows. Lines are addressed by sequence number, which lets a view append only what is new.
+class ConsoleBuffer {
+public:
+    static const uint64_t npos = ~0ull;
+
+    ConsoleBuffer(size_t maxLines, size_t maxTextBytes);
+    ConsoleBuffer(const ConsoleBuffer&) = delete;
+    ConsoleBuffer& operator=(const ConsoleBuffer&) = delete;
+
+    // Splits text at '\n' (dropping a '\r' before it) and appends one line per piece, all with the
+    // same time, tag and kind. Lines longer than the text ring are cut. Returns the first new sequence.
+    uint64_t append(std::string_view text, uint16_t tag, ConsoleKind kind, int64_t timeMs);
+    void clear();
+
+    // Small interned id for a server name, shared by all its lines. 0 is the empty name.
+    uint16_t tagFor(std::string_view name);
+    std::string_view tagName(uint16_t tag) const;
+
+    uint64_t firstSequence() const { return first; }  // Oldest line still held
+    uint64_t endSequence() const { return next; }     // One past the newest line
+    size_t size() const { return static_cast<size_t>(next - first); }
+    bool line(uint64_t sequence, ConsoleLine& out) const;
+
+    // First line at or after fromSequence containing needle, optionally only lines with tag
+    // (0 = any). ASCII case folding when ignoreCase. Returns npos if there is none.
+    uint64_t find(std::string_view needle, uint64_t fromSequence, bool ignoreCase = false, uint16_t tag = 0) const;
+
+    size_t textBytesUsed() const { return static_cast<size_t>(writeOffset - oldestOffset()); }
+    size_t lineCapacity() const { return maxLines; }
+    size_t textCapacity() const { return textCapacityBytes; }
+
+private:
+    struct Record {
+        uint64_t offset;          // Absolute stream offset of the text; ring position is offset % capacity
+        int64_t timeMs;
+        uint32_t length;
+        uint16_t tag;
+        ConsoleKind kind;
+    };
+
+    void appendLine(std::string_view text, uint16_t tag, ConsoleKind kind, int64_t timeMs);
+    void evictOldest();
+    uint64_t oldestOffset() const;
+    const Record& record(uint64_t sequence) const { return records[static_cast<size_t>(sequence % maxLines)]; }
+    uint64_t lineAt(uint64_t offset) const;
+
+    size_t maxLines;
+    size_t textCapacityBytes;
+    std::unique_ptr<Record[]> records;
+    std::unique_ptr<char[]> text;
+    uint64_t first = 0;
+    uint64_t next = 0;
+    uint64_t writeOffset = 0;     // Absolute offset the next line is written at
+    std::vector<std::string> tags;
+};
@@ -0,0 +1,374 @@
+// --- xRcon\CvarStore.cpp ---
+// Implementation of the fleet cvar store: content hashing, baseline profiles and the drift check that
+// only walks a server's cvars when its hashes say something differs.
+
+#include "CvarStore.h"
+#include "BanList.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+
+const char* const CvarStore::kVolatile =
+    "sv_hostname,mapname,g_gametype,g_gametypestring,gamestartup,sv_keywords,sv_maprotationcurrent";
+
+static char lower(char c) {
+    return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+static std::string lowercase(std::string_view text) {
+    std::string result(text);
+    for (char& c : result) c = lower(c);
+    return result;
+}
+
+static std::string trim(std::string_view text) {
+    size_t begin = text.find_first_not_of(" \t");
+    if (begin == std::string_view::npos) return std::string();
+    size_t end = text.find_last_not_of(" \t");
+    return std::string(text.substr(begin, end - begin + 1));
+}
+
+static bool hasWildcard(std::string_view text) {
+    return text.find_first_of("*?") != std::string_view::npos;
+}
+
+// FNV-1a of the lowercased name and the value, finished with a 64-bit mix so that summing pair hashes
+// (which makes the content hash independent of reply order) does not cancel out.
+uint64_t CvarStore::hashPair(std::string_view key, std::string_view value) {
+    uint64_t hash = 14695981039346656037ull;
+    for (char c : key) hash = (hash ^ static_cast<unsigned char>(lower(c))) * 1099511628211ull;
+    hash = (hash ^ 0xFF) * 1099511628211ull;
+    for (char c : value) hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+    hash ^= hash >> 33;
+    hash *= 0xFF51AFD7ED558CCDull;
+    hash ^= hash >> 33;
+    hash *= 0xC4CEB9FE1A85EC53ull;
+    return hash ^ (hash >> 33);
+}
+
+// What a baseline key the server does not report hashes as; no value hashes to it.
+static uint64_t hashMissing(std::string_view key) {
+    return ~CvarStore::hashPair(key, std::string_view());
+}
+
+static bool keyLess(const std::pair<std::string, std::string>& a, const std::pair<std::string, std::string>& b) {
+    return a.first < b.first;
+}
+
+// Sorts by name and keeps the first of any repeated name.
+static void normalize(CvarList& cvars) {
+    std::stable_sort(cvars.begin(), cvars.end(), keyLess);
+    cvars.erase(std::unique(cvars.begin(), cvars.end(), [](const auto& a, const auto& b) { return a.first == b.first; }),
+        cvars.end());
+}
+
+static uint64_t hashList(const CvarList& cvars) {
+    uint64_t hash = 0;
+    for (const auto& cvar : cvars) hash += CvarStore::hashPair(cvar.first, cvar.second);
+    return hash;
+}
+
+bool CvarStore::addProfile(CvarProfile profile, std::string& error) {
+    if (profile.name.empty()) {
+        error = "Profile without a game name";
+        return false;
+    }
+    for (const CvarProfile& other : list) {
+        if (lowercase(other.name) == lowercase(profile.name)) {
+            error = "Profile " + profile.name + ": defined twice";
+            return false;
+        }
+    }
+    if (profile.cvars.empty() && profile.reference.empty()) {
+        error = "Profile " + profile.name + ": no cvars and no reference server";
+        return false;
+    }
+    for (auto& cvar : profile.cvars) cvar.first = lowercase(cvar.first);
+    normalize(profile.cvars);
+    for (std::string& pattern : profile.ignore) pattern = lowercase(pattern);
+    Baseline base;
+    base.cvars = profile.cvars;
+    base.hash = hashList(base.cvars);
+    base.generation = ++generation;
+    list.push_back(std::move(profile));
+    baselines.push_back(std::move(base));
+    profileByGame.clear();
+    return true;
+}
+
+void CvarStore::clearProfiles() {
+    list.clear();
+    baselines.clear();
+    profileByGame.clear();
+    ++generation;
+}
+
+size_t CvarStore::loadProfiles(const std::string& path, std::vector<std::string>& errors) {
+    clearProfiles();
+    std::ifstream file(path);
+    stamp(path, fileSize, writeTime);
+    if (!file.is_open()) {
+        return 0;
+    }
+    CvarProfile profile;
+    bool inProfile = false;
+    bool ignoreSet = false;
+    auto finish = [&]() {
+        if (!inProfile) return;
+        if (!profile.reference.empty() && !ignoreSet) {
+            std::string_view rest = kVolatile;
+            while (!rest.empty()) {
+                size_t comma = rest.find(',');
+                profile.ignore.emplace_back(rest.substr(0, comma));
+                rest = comma == std::string_view::npos ? std::string_view() : rest.substr(comma + 1);
+            }
+        }
+        std::string error;
+        if (!addProfile(std::move(profile), error)) errors.push_back(error);
+        profile = CvarProfile();
+        inProfile = false;
+        ignoreSet = false;
+    };
+    std::string line;
+    while (std::getline(file, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty() || line[0] == ';') continue;
+        if (line[0] == '[') {
+            finish();
+            size_t close = line.find(']');
+            profile.name = trim(line.substr(1, close == std::string::npos ? std::string::npos : close - 1));
+            inProfile = true;
+            continue;
+        }
+        size_t equals = line.find('=');
+        if (!inProfile || equals == std::string::npos) continue;
+        std::string key = trim(line.substr(0, equals));
+        std::string value = line.substr(equals + 1);
+        if (key == "reference") profile.reference = trim(value);
+        else if (key == "ignore") {
+            ignoreSet = true;
+            std::string_view rest = value;
+            while (!rest.empty()) {
+                size_t comma = rest.find(',');
+                std::string pattern = trim(rest.substr(0, comma));
+                if (!pattern.empty()) profile.ignore.push_back(std::move(pattern));
+                rest = comma == std::string_view::npos ? std::string_view() : rest.substr(comma + 1);
+            }
+        }
+        else if (!key.empty()) profile.cvars.emplace_back(key, value);
+    }
+    finish();
+    return list.size();
+}
+
+void CvarStore::stamp(const std::string& path, uintmax_t& size, int64_t& time) {
+    namespace fs = std::filesystem;
+    std::error_code error;
+    bool exists = fs::is_regular_file(path, error);
+    size = exists ? fs::file_size(path, error) : 0;
+    time = exists ? static_cast<int64_t>(fs::last_write_time(path, error).time_since_epoch().count()) : 0;
+}
+
+bool CvarStore::changedOnDisk(const std::string& path) const {
+    uintmax_t size = 0;
+    int64_t time = 0;
+    stamp(path, size, time);
+    return size != fileSize || time != writeTime;
+}
+
+int CvarStore::profileFor(const std::string& game) {
+    auto cached = profileByGame.find(game);
+    if (cached != profileByGame.end()) {
+        return cached->second;
+    }
+    std::string key = lowercase(game);
+    int found = -1;
+    for (size_t i = 0; i < list.size() && found < 0; ++i) {
+        if (!hasWildcard(list[i].name) && lowercase(list[i].name) == key) found = static_cast<int>(i);
+    }
+    for (size_t i = 0; i < list.size() && found < 0; ++i) {
+        if (hasWildcard(list[i].name) && BanList::wildcardMatch(lowercase(list[i].name), key)) found = static_cast<int>(i);
+    }
+    profileByGame.emplace(game, found);
+    return found;
+}
+
+// The profile's baseline, rebuilt when its reference server reports something new. Servers are only
+// checked again when the rebuilt baseline differs.
+const CvarStore::Baseline& CvarStore::baseline(int profile) {
+    const CvarProfile& source = list[profile];
+    Baseline& base = baselines[profile];
+    if (source.reference.empty()) {
+        return base;
+    }
+    auto reference = servers.find(source.reference);
+    uint64_t referenceHash = reference == servers.end() ? 0 : reference->second.hash;
+    if (referenceHash == base.referenceHash) {
+        return base;
+    }
+    base.referenceHash = referenceHash;
+    CvarList cvars = source.cvars;
+    if (reference != servers.end()) {
+        for (const auto& cvar : reference->second.cvars) {
+            bool ignored = std::binary_search(source.cvars.begin(), source.cvars.end(), cvar, keyLess);
+            for (size_t i = 0; i < source.ignore.size() && !ignored; ++i) {
+                ignored = BanList::wildcardMatch(source.ignore[i], cvar.first);
+            }
+            if (!ignored) cvars.push_back(cvar);
+        }
+        std::sort(cvars.begin(), cvars.end(), keyLess);
+    }
+    uint64_t hash = hashList(cvars);
+    if (hash != base.hash || cvars.size() != base.cvars.size()) {
+        base.cvars = std::move(cvars);
+        base.hash = hash;
+        base.generation = ++generation;
+    }
+    return base;
+}
+
+// Brings entry's drift up to date. Nothing is looked at unless its content or its baseline changed;
+// then the values for the baseline keys are hashed, and walked for the diff only if that hash differs.
+bool CvarStore::check(Entry& entry) {
+    int profile = profileFor(entry.game);
+    if (profile < 0) {
+        bool had = !entry.drift.empty();
+        entry.profile = -1;
+        entry.drift.clear();
+        return had;
+    }
+    const Baseline& base = baseline(profile);
+    if (entry.profile == profile && entry.checkedHash == entry.hash && entry.checkedGeneration == base.generation) {
+        return false;
+    }
+    entry.profile = profile;
+    entry.checkedHash = entry.hash;
+    entry.checkedGeneration = base.generation;
+
+    uint64_t projected = 0;
+    auto at = entry.cvars.begin();
+    for (const auto& cvar : base.cvars) {
+        at = std::lower_bound(at, entry.cvars.end(), cvar, keyLess);
+        projected += at != entry.cvars.end() && at->first == cvar.first ? hashPair(cvar.first, at->second) : hashMissing(cvar.first);
+    }
+    std::vector<CvarDiff> diffs;
+    if (projected != base.hash) {
+        at = entry.cvars.begin();
+        for (const auto& cvar : base.cvars) {
+            at = std::lower_bound(at, entry.cvars.end(), cvar, keyLess);
+            bool present = at != entry.cvars.end() && at->first == cvar.first;
+            if (present && at->second == cvar.second) continue;
+            CvarDiff diff;
+            diff.key = cvar.first;
+            diff.expected = cvar.second;
+            diff.missing = !present;
+            if (present) diff.actual = at->second;
+            diffs.push_back(std::move(diff));
+        }
+    }
+    if (diffs == entry.drift) {
+        return false;
+    }
+    entry.drift = std::move(diffs);
+    return true;
+}
+
+bool CvarStore::update(const std::string& server, const std::string& game, const StatusView& status, uint64_t nowMs) {
+    Entry& entry = servers[server];
+    entry.fetchedMs = nowMs;
+    uint64_t hash = 0;
+    for (size_t i = 0; i < status.cvarCount; ++i) {
+        hash += hashPair(status.cvars[i].key, status.cvars[i].value);
+    }
+    if (hash != entry.hash || entry.cvars.size() != status.cvarCount || entry.game != game) {
+        entry.game = game;
+        entry.cvars.clear();
+        entry.cvars.reserve(status.cvarCount);
+        for (size_t i = 0; i < status.cvarCount; ++i) {
+            entry.cvars.emplace_back(lowercase(status.cvars[i].key), std::string(status.cvars[i].value));
+        }
+        normalize(entry.cvars);
+        entry.hash = hashList(entry.cvars);
+    }
+    return check(entry);
+}
+
+void CvarStore::retain(const std::vector<std::string>& names) {
+    for (auto it = servers.begin(); it != servers.end();) {
+        if (std::find(names.begin(), names.end(), it->first) != names.end()) ++it;
+        else it = servers.erase(it);
+    }
+}
+
+const std::vector<CvarDiff>* CvarStore::drift(const std::string& server) {
+    auto it = servers.find(server);
+    if (it == servers.end()) {
+        return nullptr;
+    }
+    check(it->second);
+    return it->second.profile < 0 ? nullptr : &it->second.drift;
+}
+
+size_t CvarStore::fleetDrift(std::vector<std::pair<std::string, const std::vector<CvarDiff>*>>& out) {
+    out.clear();
+    size_t checked = 0;
+    for (auto& server : servers) {
+        check(server.second);
+        if (server.second.profile < 0) continue;
+        ++checked;
+        if (!server.second.drift.empty()) out.emplace_back(server.first, &server.second.drift);
+    }
+    std::sort(out.begin(), out.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+    return checked;
+}
+
+bool CvarStore::compare(const std::string& a, const std::string& b, std::vector<CvarDiff>& out) const {
+    out.clear();
+    auto first = servers.find(a);
+    auto second = servers.find(b);
+    if (first == servers.end() || second == servers.end()) {
+        return false;
+    }
+    if (first->second.hash == second->second.hash && first->second.cvars.size() == second->second.cvars.size()) {
+        return true;
+    }
+    const CvarList& left = first->second.cvars;
+    const CvarList& right = second->second.cvars;
+    size_t i = 0;
+    size_t j = 0;
+    while (i < left.size() || j < right.size()) {
+        CvarDiff diff;
+        if (j == right.size() || (i < left.size() && left[i].first < right[j].first)) {
+            diff.key = left[i].first;
+            diff.expected = left[i++].second;
+            diff.missing = true;
+        }
+        else if (i == left.size() || right[j].first < left[i].first) {
+            diff.key = right[j].first;
+            diff.actual = right[j++].second;
+            diff.extra = true;
+        }
+        else {
+            if (left[i].second == right[j].second) {
+                ++i;
+                ++j;
+                continue;
+            }
+            diff.key = left[i].first;
+            diff.expected = left[i++].second;
+            diff.actual = right[j++].second;
+        }
+        out.push_back(std::move(diff));
+    }
+    return true;
+}
+
+const CvarList* CvarStore::cvars(const std::string& server) const {
+    auto it = servers.find(server);
+    return it == servers.end() ? nullptr : &it->second.cvars;
+}
+
+uint64_t CvarStore::hash(const std::string& server) const {
+    auto it = servers.find(server);
+    return it == servers.end() ? 0 : it->second.hash;
+}
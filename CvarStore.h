@@ -0,0 +1,105 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "StatusParser.h"
+
+// Cvar lists are sorted by lowercased name; values are the raw getstatus text.
+using CvarList = std::vector<std::pair<std::string, std::string>>;
+
+// One cvar that differs from the baseline.
+struct CvarDiff {
+    std::string key;
+    std::string expected;         // Baseline value; empty with extra
+    std::string actual;           // Server value; empty with missing
+    bool missing = false;         // The server does not report key
+    bool extra = false;           // Only the server has key (server to server comparisons)
+
+    bool operator==(const CvarDiff& other) const {
+        return key == other.key && expected == other.expected && actual == other.actual &&
+            missing == other.missing && extra == other.extra;
+    }
+};
+
+// What servers of one game, or of a whole family, are expected to run. name is a servers.ini game name
+// or a glob on them ("Call of Duty*"); an exact name wins over globs, and globs go in file order.
+// The baseline is the listed cvars plus, with a reference server, every other cvar that server reports
+// apart from the ignored ones.
+struct CvarProfile {
+    std::string name;
+    CvarList cvars;
+    std::string reference;
+    std::vector<std::string> ignore; // Lowercased name globs, for reference cvars only
+};
+
+// Every server's full serverinfo as last polled, with an order-independent content hash, checked
+// against its game's baseline. A poll whose hash matches the last one costs a hash and nothing else;
+// a changed server hashes its values for the baseline keys and only walks them for the diff when that
+// hash differs from the baseline's. Used from the UI thread only.
+class CvarStore {
+public:
+    // Default ignore list of a profile with a reference server: cvars that differ between identical setups.
+    static const char* const kVolatile;
+
+    // Replaces the profiles with path's. Sections that cannot be used are skipped and described in errors.
+    size_t loadProfiles(const std::string& path, std::vector<std::string>& errors);
+    // True if path was written since the last load.
+    bool changedOnDisk(const std::string& path) const;
+    bool addProfile(CvarProfile profile, std::string& error);
+    void clearProfiles();
+    const std::vector<CvarProfile>& profiles() const { return list; }
+
+    // Records server's cvars. Returns true if its drift changed: new, different or gone.
+    bool update(const std::string& server, const std::string& game, const StatusView& status, uint64_t nowMs);
+    // Drops servers that are no longer in the list.
+    void retain(const std::vector<std::string>& servers);
+
+    // Server's differences from its baseline; null when it has not been polled or has no profile.
+    const std::vector<CvarDiff>* drift(const std::string& server);
+    // Every server that differs from its baseline, by name. Returns how many servers have a baseline.
+    size_t fleetDrift(std::vector<std::pair<std::string, const std::vector<CvarDiff>*>>& out);
+    // Differences of b from a over both full lists; false if either has not been polled.
+    bool compare(const std::string& a, const std::string& b, std::vector<CvarDiff>& out) const;
+
+    const CvarList* cvars(const std::string& server) const;
+    uint64_t hash(const std::string& server) const; // 0 when not polled
+    size_t size() const { return servers.size(); }
+
+    static uint64_t hashPair(std::string_view key, std::string_view value);
+
+private:
+    struct Baseline {
+        CvarList cvars;
+        uint64_t hash = 0;        // Sum of hashPair over cvars
+        uint64_t referenceHash = 0; // Reference server content it was built from
+        uint64_t generation = 0;
+    };
+    struct Entry {
+        std::string game;         // servers.ini game name
+        CvarList cvars;
+        uint64_t hash = 0;        // Sum of hashPair over cvars
+        uint64_t fetchedMs = 0;
+        int profile = -1;         // Checked against, -1 for none
+        uint64_t checkedHash = 0; // hash and baseline generation drift was worked out for
+        uint64_t checkedGeneration = 0;
+        std::vector<CvarDiff> drift;
+    };
+
+    static void stamp(const std::string& path, uintmax_t& size, int64_t& time);
+
+    int profileFor(const std::string& game);
+    const Baseline& baseline(int profile);
+    bool check(Entry& entry);
+
+    std::vector<CvarProfile> list;
+    std::vector<Baseline> baselines; // Parallel to list
+    uint64_t generation = 1;      // Bumped by every baseline change
+    std::unordered_map<std::string, int> profileByGame; // Game name as in servers.ini -> profile, -1 for none
+    std::unordered_map<std::string, Entry> servers;
+    uintmax_t fileSize = 0;
+    int64_t writeTime = 0;
+};
@@ -0,0 +1,75 @@
+// --- xRcon\DefaultsCatalog.cpp ---
+// Implementation of the cached default map and gametype lists.
+// Reads each defaults file once and hands out views until the file changes on disk.
+
+#include "DefaultsCatalog.h"
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+std::string_view DefaultsSnapshot::find(std::string_view game) const {
+    auto found = lists.find(game);
+    return found == lists.end() ? std::string_view() : found->second;
+}
+
+DefaultsCatalog::DefaultsCatalog(std::string path, std::string key)
+    : path(std::move(path)), prefix(std::move(key) + "=") {
+}
+
+DefaultsCatalog& DefaultsCatalog::maps() {
+    static DefaultsCatalog catalog("default_maps.ini", "maps");
+    return catalog;
+}
+
+DefaultsCatalog& DefaultsCatalog::gametypes() {
+    static DefaultsCatalog catalog("default_gametypes.ini", "gametypes");
+    return catalog;
+}
+
+// One stat per call; the file is only read again when it was replaced, edited, created or removed.
+std::shared_ptr<const DefaultsSnapshot> DefaultsCatalog::current() {
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    bool exists = fs::is_regular_file(path, ec);
+    uintmax_t size = exists ? fs::file_size(path, ec) : 0;
+    int64_t time = exists ? static_cast<int64_t>(fs::last_write_time(path, ec).time_since_epoch().count()) : 0;
+
+    std::lock_guard<std::mutex> guard(lock);
+    if (!loaded || exists != existed || size != fileSize || time != writeTime) {
+        snapshot = load();
+        loaded = true;
+        existed = exists;
+        fileSize = size;
+        writeTime = time;
+    }
+    return snapshot;
+}
+
+// Same rules as the line scan it replaces: "[Game]" starts a section and the first key= line
+// of a section wins. CRLF line ends are accepted, as the text-mode stream on Windows did.
+std::shared_ptr<const DefaultsSnapshot> DefaultsCatalog::load() const {
+    std::shared_ptr<DefaultsSnapshot> parsed = std::make_shared<DefaultsSnapshot>();
+    std::ifstream file(path, std::ios::binary);
+    if (file.is_open()) {
+        parsed->text.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    std::string_view rest = parsed->text;
+    std::string_view section;
+    while (!rest.empty()) {
+        size_t newline = rest.find('\n');
+        std::string_view line = rest.substr(0, newline);
+        rest = newline == std::string_view::npos ? std::string_view() : rest.substr(newline + 1);
+        if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+        if (line.empty()) continue;
+        if (line.front() == '[' && line.back() == ']') {
+            section = line.substr(1, line.size() - 2);
+            continue;
+        }
+        if (line.compare(0, prefix.size(), prefix) == 0 &&
+            parsed->lists.emplace(section, line.substr(prefix.size())).second) {
+            parsed->games.push_back(section);
+        }
+    }
+    return parsed;
+}
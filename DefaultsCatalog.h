@@ -0,0 +1,44 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// One parse of a defaults file. The game names and lists are views into text, so a holder of the
+// shared_ptr can keep using them after the file has been reloaded.
+struct DefaultsSnapshot {
+    std::string text;
+    std::vector<std::string_view> games;                              // Games with a list, in file order
+    std::unordered_map<std::string_view, std::string_view> lists;     // Game name -> list text
+
+    // The game's list, or an empty view if the file has none for it.
+    std::string_view find(std::string_view game) const;
+};
+
+// default_maps.ini / default_gametypes.ini parsed once into a hash by game name.
+// current() re-reads the file only when its size or modification time has changed.
+class DefaultsCatalog {
+public:
+    // key is the line prefix holding the list, e.g. "maps" for "maps=...".
+    DefaultsCatalog(std::string path, std::string key);
+
+    std::shared_ptr<const DefaultsSnapshot> current();
+
+    static DefaultsCatalog& maps();       // default_maps.ini
+    static DefaultsCatalog& gametypes();  // default_gametypes.ini
+
+private:
+    std::shared_ptr<const DefaultsSnapshot> load() const;
+
+    std::string path;
+    std::string prefix;                   // key + "="
+    std::mutex lock;
+    std::shared_ptr<const DefaultsSnapshot> snapshot;
+    bool loaded = false;
+    bool existed = false;
+    uintmax_t fileSize = 0;
+    int64_t writeTime = 0;
+};
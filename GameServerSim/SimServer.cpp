@@ -0,0 +1,469 @@
+// --- GameServerSim\SimServer.cpp ---
+// Implementation of the simulated game servers.
+// Answers getstatus, getinfo and rcon requests like a MOHAA (protocol 1) or CoD (protocol 2) server would.
+
+#include "SimServer.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+static const char* const kMohMaps[] = { "dm/mohdm1", "dm/mohdm2", "dm/mohdm3", "dm/mohdm4", "dm/mohdm6", "obj/obj_team1", "obj/obj_team2" };
+static const char* const kCodMaps[] = { "mp_carentan", "mp_brecourt", "mp_dawnville", "mp_harbor", "mp_pavlov", "mp_railyard", "mp_toujane" };
+static const char* const kNameParts[] = { "Sniper", "Medic", "Ghost", "Rifle", "Tank", "Eagle", "Wolf", "Shadow", "Flak", "Viper", "Bravo", "Nomad" };
+
+// Returns monotonic milliseconds for scheduling simulated delays.
+uint64_t simNowMs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+SimRandom::SimRandom(uint64_t seed) : state(seed ? seed : 0x9E3779B97F4A7C15ull) {
+}
+
+// Returns the next 64-bit value.
+uint64_t SimRandom::next() {
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    return state * 0x2545F4914F6CDD1Dull;
+}
+
+// Returns a value in [0, bound).
+uint32_t SimRandom::below(uint32_t bound) {
+    return bound ? static_cast<uint32_t>((next() >> 32) % bound) : 0;
+}
+
+// Returns true with the given probability.
+bool SimRandom::chance(double probability) {
+    if (probability <= 0.0) return false;
+    return static_cast<double>(next() >> 11) * (1.0 / 9007199254740992.0) < probability;
+}
+
+// Creates a server with cvars and a player population drawn from seed.
+SimServer::SimServer(const SimConfig& cfg, uint64_t seed, uint16_t listenPort)
+    : config(cfg), random(seed), port(listenPort), rconTokens(static_cast<double>(cfg.rconBurst)) {
+    bool moh = config.protocolId == 1;
+    if (config.game.empty()) {
+        config.game = moh ? "Medal of Honor: Allied Assault" : "Call of Duty 2";
+    }
+    if (moh) {
+        mapRotation.assign(std::begin(kMohMaps), std::end(kMohMaps));
+    }
+    else {
+        mapRotation.assign(std::begin(kCodMaps), std::end(kCodMaps));
+    }
+    rotationIndex = random.below(static_cast<uint32_t>(mapRotation.size()));
+
+    char hostname[64];
+    std::snprintf(hostname, sizeof(hostname), "^1Sim^7 Server %u", static_cast<unsigned>(port));
+    setCvar("sv_hostname", hostname);
+    setCvar("mapname", mapRotation[rotationIndex]);
+    setCvar("sv_maxclients", std::to_string(config.maxClients));
+    if (moh) {
+        setCvar("g_gametype", "1");
+        setCvar("g_gametypestring", "Free-For-All");
+        setCvar("protocol", "8");
+        setCvar("version", "Medal of Honor Allied Assault 1.11 win-x86 Mar  5 2002");
+    }
+    else {
+        setCvar("g_gametype", "tdm");
+        setCvar("protocol", "118");
+        setCvar("shortversion", "1.3");
+        setCvar("gamename", "Call of Duty 2");
+    }
+    setCvar("sv_floodProtect", "1");
+    setCvar("sv_pure", "1");
+    setCvar("fs_game", "");
+
+    int span = std::max(0, config.maxPlayers - config.minPlayers);
+    int population = config.minPlayers + static_cast<int>(random.below(static_cast<uint32_t>(span + 1)));
+    population = std::min(population, config.maxClients);
+    for (int i = 0; i < population; ++i) {
+        addPlayer();
+    }
+}
+
+// Returns a cvar value, or an empty string if unset.
+std::string SimServer::getCvar(const std::string& name) const {
+    for (const auto& cvar : cvars) {
+        if (cvar.first == name) return cvar.second;
+    }
+    return std::string();
+}
+
+// Sets a cvar, appending it if new.
+void SimServer::setCvar(const std::string& name, const std::string& value) {
+    for (auto& cvar : cvars) {
+        if (cvar.first == name) {
+            cvar.second = value;
+            return;
+        }
+    }
+    cvars.emplace_back(name, value);
+}
+
+// Adds a player in the lowest free slot.
+void SimServer::addPlayer() {
+    if (static_cast<int>(players.size()) >= config.maxClients) return;
+    int slot = 0;
+    for (const auto& p : players) {
+        if (p.slot == slot) ++slot;
+        else break;
+    }
+    SimPlayer player;
+    player.slot = slot;
+    char name[48];
+    std::snprintf(name, sizeof(name), "^%u%s^7%u", static_cast<unsigned>(random.below(8)),
+        kNameParts[random.below(static_cast<uint32_t>(sizeof(kNameParts) / sizeof(kNameParts[0])))],
+        static_cast<unsigned>(random.below(1000)));
+    player.name = name;
+    char guid[33];
+    for (int i = 0; i < 32; ++i) guid[i] = "0123456789abcdef"[random.below(16)];
+    guid[32] = '\0';
+    player.guid = guid;
+    player.address = 0x0A000000u | random.below(0x00FFFFFFu);
+    player.port = static_cast<uint16_t>(20000 + random.below(40000));
+    player.score = static_cast<int>(random.below(40));
+    player.ping = 20 + static_cast<int>(random.below(180));
+    player.qport = static_cast<int>(random.below(65535));
+    auto pos = std::lower_bound(players.begin(), players.end(), player,
+        [](const SimPlayer& a, const SimPlayer& b) { return a.slot < b.slot; });
+    players.insert(pos, player);
+}
+
+// Removes the player at index.
+void SimServer::removePlayer(size_t index) {
+    if (index < players.size()) {
+        players.erase(players.begin() + static_cast<std::ptrdiff_t>(index));
+    }
+}
+
+// Applies population churn and ping/score drift between status queries.
+void SimServer::churnPlayers() {
+    if (random.chance(config.churn) && !players.empty()) {
+        removePlayer(random.below(static_cast<uint32_t>(players.size())));
+    }
+    if (random.chance(config.churn) && static_cast<int>(players.size()) < config.maxPlayers) {
+        addPlayer();
+    }
+    for (auto& p : players) {
+        p.ping = std::max(5, p.ping + static_cast<int>(random.below(11)) - 5);
+        if (random.chance(0.2)) ++p.score;
+    }
+}
+
+// Writes the OOB header, including the MOHAA direction byte.
+void SimServer::beginReply(std::string& reply, const char* kind) const {
+    reply.assign("\xff\xff\xff\xff", 4);
+    if (config.protocolId == 1) reply.push_back('\x01');
+    reply.append(kind);
+    reply.push_back('\n');
+}
+
+// Builds a statusResponse: serverinfo cvars then one line per player.
+void SimServer::buildStatus(std::string& reply) {
+    churnPlayers();
+    beginReply(reply, "statusResponse");
+    for (const auto& cvar : cvars) {
+        reply.push_back('\\');
+        reply.append(cvar.first);
+        reply.push_back('\\');
+        reply.append(cvar.second);
+    }
+    reply.push_back('\n');
+    char line[128];
+    for (const auto& p : players) {
+        std::snprintf(line, sizeof(line), "%d %d \"%s\"\n", p.score, p.ping, p.name.c_str());
+        reply.append(line);
+    }
+}
+
+// Builds an infoResponse with the short serverinfo used by master-list browsers.
+void SimServer::buildInfo(std::string& reply, const std::string& challenge) {
+    beginReply(reply, "infoResponse");
+    reply.append("\\challenge\\").append(challenge);
+    reply.append("\\protocol\\").append(getCvar("protocol"));
+    reply.append("\\hostname\\").append(getCvar("sv_hostname"));
+    reply.append("\\mapname\\").append(getCvar("mapname"));
+    reply.append("\\clients\\").append(std::to_string(players.size()));
+    reply.append("\\sv_maxclients\\").append(getCvar("sv_maxclients"));
+    reply.append("\\gametype\\").append(getCvar(config.protocolId == 1 ? "g_gametypestring" : "g_gametype"));
+    reply.append("\\pure\\1");
+}
+
+// Prints the rcon status table in the game's column layout.
+void SimServer::printStatusTable(std::string& out) const {
+    bool moh = config.protocolId == 1;
+    out.append("map: ").append(getCvar("mapname")).append("\n");
+    if (moh) {
+        out.append("num score ping name            lastmsg address               qport rate\n");
+        out.append("--- ----- ---- --------------- ------- --------------------- ----- -----\n");
+    }
+    else {
+        out.append("num score ping guid                             name            lastmsg address               qport rate\n");
+        out.append("--- ----- ---- -------------------------------- --------------- ------- --------------------- ----- -----\n");
+    }
+    char line[256];
+    for (const auto& p : players) {
+        char address[32];
+        std::snprintf(address, sizeof(address), "%u.%u.%u.%u:%u", (p.address >> 24) & 255, (p.address >> 16) & 255,
+            (p.address >> 8) & 255, p.address & 255, static_cast<unsigned>(p.port));
+        if (moh) {
+            std::snprintf(line, sizeof(line), "%3d %5d %4d %-15s %7d %-21s %5d %5d\n",
+                p.slot, p.score, p.ping, p.name.c_str(), 0, address, p.qport, 25000);
+        }
+        else {
+            std::snprintf(line, sizeof(line), "%3d %5d %4d %s %-15s %7d %-21s %5d %5d\n",
+                p.slot, p.score, p.ping, p.guid.c_str(), p.name.c_str(), 0, address, p.qport, 25000);
+        }
+        out.append(line);
+    }
+}
+
+// Consumes one RCON token, refilling the bucket by elapsed time.
+bool SimServer::takeRconToken(uint64_t nowMs) {
+    if (config.rconPerSecond <= 0.0) return true;
+    if (rconRefillMs != 0 && nowMs > rconRefillMs) {
+        rconTokens = std::min(static_cast<double>(config.rconBurst),
+            rconTokens + (nowMs - rconRefillMs) * config.rconPerSecond / 1000.0);
+    }
+    rconRefillMs = nowMs;
+    if (rconTokens < 1.0) return false;
+    rconTokens -= 1.0;
+    return true;
+}
+
+// Executes "rcon <password> <command>" and builds the print reply.
+void SimServer::handleRcon(const std::string& line, std::string& reply) {
+    size_t passwordEnd = line.find(' ');
+    std::string password = line.substr(0, passwordEnd);
+    std::string command = passwordEnd == std::string::npos ? std::string() : line.substr(passwordEnd + 1);
+    beginReply(reply, "print");
+
+    if (password != config.rconPassword) {
+        ++stats.badPassword;
+        reply.append("Bad rconpassword.\n");
+        return;
+    }
+
+    size_t argStart = command.find(' ');
+    std::string verb = command.substr(0, argStart);
+    std::string arg = argStart == std::string::npos ? std::string() : command.substr(argStart + 1);
+    if (arg.size() >= 2 && arg.front() == '"' && arg.back() == '"') {
+        arg = arg.substr(1, arg.size() - 2);
+    }
+
+    if (verb == "status") {
+        churnPlayers();
+        printStatusTable(reply);
+    }
+    else if (verb == "clientkick" || verb == "banclient" || verb == "kick") {
+        for (size_t i = 0; i < players.size(); ++i) {
+            if (std::to_string(players[i].slot) == arg || (verb == "kick" && players[i].name == arg)) {
+                reply.append(players[i].name).append(verb == "banclient" ? " was banned\n" : " was kicked\n");
+                removePlayer(i);
+                return;
+            }
+        }
+        reply.append("Bad client slot: ").append(arg).append("\n");
+    }
+    else if (verb == "map") {
+        if (arg.empty()) {
+            reply.append("usage: map <mapname>\n");
+            return;
+        }
+        setCvar("mapname", arg);
+        for (auto& p : players) p.score = 0;
+    }
+    else if (verb == "map_rotate") {
+        rotationIndex = (rotationIndex + 1) % mapRotation.size();
+        setCvar("mapname", mapRotation[rotationIndex]);
+    }
+    else if (verb == "map_restart" || verb == "fast_restart" || verb == "restart") {
+        for (auto& p : players) p.score = 0;
+    }
+    else if (verb == "set" || verb == "seta") {
+        size_t split = arg.find(' ');
+        setCvar(arg.substr(0, split), split == std::string::npos ? std::string() : arg.substr(split + 1));
+    }
+    else if (verb == "say") {
+        // Broadcast only; nothing is printed back
+    }
+    else {
+        bool known = false;
+        for (const auto& cvar : cvars) {
+            if (cvar.first == verb) {
+                known = true;
+                break;
+            }
+        }
+        if (!known) {
+            reply.append("Unknown command \"").append(verb).append("\"\n");
+        }
+        else if (arg.empty()) {
+            reply.append("\"").append(verb).append("\" is:\"").append(getCvar(verb)).append("^7\"\n");
+        }
+        else {
+            setCvar(verb, arg);
+        }
+    }
+}
+
+// Parses one request datagram and builds its reply.
+bool SimServer::handle(const char* data, size_t length, uint64_t nowMs, std::string& reply) {
+    ++stats.requests;
+    if (length < 5 || std::memcmp(data, "\xff\xff\xff\xff", 4) != 0) {
+        ++stats.malformed;
+        return false;
+    }
+    size_t pos = 4;
+    if (static_cast<unsigned char>(data[pos]) == 0x02) ++pos; // MOHAA client direction byte
+    std::string line(data + pos, length - pos);
+    line.erase(std::find(line.begin(), line.end(), '\0'), line.end());
+    while (!line.empty() && (line.back() == '\n' || line.back() == '\r' || line.back() == ' ')) line.pop_back();
+
+    if (line.compare(0, 9, "getstatus") == 0) {
+        buildStatus(reply);
+    }
+    else if (line.compare(0, 7, "getinfo") == 0) {
+        buildInfo(reply, line.size() > 8 ? line.substr(8) : std::string());
+    }
+    else if (line.compare(0, 5, "rcon ") == 0) {
+        if (!takeRconToken(nowMs)) {
+            ++stats.throttled;
+            return false; // Flood protection drops the request silently
+        }
+        handleRcon(line.substr(5), reply);
+    }
+    else {
+        ++stats.malformed;
+        return false;
+    }
+    return true;
+}
+
+// Opens one socket per server and seeds every server and network path from seed.
+bool SimNetwork::start(const SimConfig& config, size_t count, uint16_t basePort, uint64_t seed, bool mixProtocols) {
+    stop();
+    SimRandom seeds(seed);
+    servers.reserve(count);
+    sockets.reserve(count);
+    networkRandom.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        SimConfig serverConfig = config;
+        if (mixProtocols) {
+            serverConfig.protocolId = (i % 2 == 0) ? 1 : 2;
+            serverConfig.game.clear();
+        }
+        uint16_t port = static_cast<uint16_t>(basePort + i);
+        UdpSocket socket;
+        if (!socket.open(port)) {
+            std::fprintf(stderr, "Failed to bind 127.0.0.1:%u\n", static_cast<unsigned>(port));
+            stop();
+            return false;
+        }
+        servers.emplace_back(serverConfig, seeds.next(), port);
+        networkRandom.emplace_back(seeds.next());
+        poller.add(socket);
+        sockets.push_back(std::move(socket));
+    }
+    return true;
+}
+
+// Closes every socket and drops pending replies.
+void SimNetwork::stop() {
+    poller.clear();
+    sockets.clear();
+    servers.clear();
+    networkRandom.clear();
+    pending = decltype(pending)();
+}
+
+// Sends every held reply whose delay has elapsed.
+void SimNetwork::flushDue(uint64_t nowMs) {
+    while (!pending.empty() && pending.top().dueMs <= nowMs) {
+        const Pending& p = pending.top();
+        sockets[p.server].sendTo(p.to, p.data.data(), p.data.size());
+        ++servers[p.server].getStats().replies;
+        pending.pop();
+    }
+}
+
+// Runs one poll iteration.
+void SimNetwork::pump(int timeoutMs) {
+    uint64_t now = simNowMs();
+    if (!pending.empty()) {
+        uint64_t due = pending.top().dueMs;
+        timeoutMs = due <= now ? 0 : static_cast<int>(std::min<uint64_t>(due - now, static_cast<uint64_t>(timeoutMs)));
+    }
+    poller.wait(timeoutMs, ready);
+    now = simNowMs();
+
+    char buffer[2048];
+    for (size_t index : ready) {
+        UdpEndpoint from;
+        int received;
+        while ((received = sockets[index].receiveFrom(buffer, sizeof(buffer), from)) > 0) {
+            SimServer& server = servers[index];
+            if (!server.handle(buffer, static_cast<size_t>(received), now, reply)) continue;
+
+            const SimConfig& cfg = server.getConfig();
+            SimRandom& net = networkRandom[index];
+            if (net.chance(cfg.loss)) {
+                ++server.getStats().dropped;
+                continue;
+            }
+            uint64_t delay = cfg.latencyMs + (cfg.jitterMs ? net.below(cfg.jitterMs + 1) : 0);
+            if (net.chance(cfg.reorder)) {
+                delay += cfg.latencyMs + cfg.jitterMs + 50; // Held back so a later reply overtakes it
+                ++server.getStats().reordered;
+            }
+            if (delay == 0) {
+                sockets[index].sendTo(from, reply.data(), reply.size());
+                ++server.getStats().replies;
+            }
+            else {
+                pending.push(Pending{ now + delay, sequence++, index, from, reply });
+            }
+        }
+    }
+    flushDue(simNowMs());
+}
+
+// Sums counters across all servers.
+SimStats SimNetwork::totals() const {
+    SimStats total;
+    for (const auto& server : servers) {
+        const SimStats& s = server.getStats();
+        total.requests += s.requests;
+        total.replies += s.replies;
+        total.dropped += s.dropped;
+        total.reordered += s.reordered;
+        total.throttled += s.throttled;
+        total.badPassword += s.badPassword;
+        total.malformed += s.malformed;
+    }
+    return total;
+}
+
+// Writes a servers.ini that points xRcon at the simulated fleet.
+bool SimNetwork::writeServersIni(const std::string& path) const {
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        return false;
+    }
+    for (const auto& server : servers) {
+        const SimConfig& cfg = server.getConfig();
+        file << "[Sim " << server.getPort() << "]\n";
+        file << "ip=127.0.0.1\n";
+        file << "port=" << server.getPort() << "\n";
+        file << "game=" << cfg.game << "\n";
+        file << "protocol=" << cfg.protocolId << "\n";
+        file << "rconPassword=" << cfg.rconPassword << "\n";
+        file << "gametypes=\n";
+        file << "maps=\n\n";
+    }
+    return true;
+}
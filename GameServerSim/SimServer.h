@@ -0,0 +1,139 @@
+#pragma once
+#include "UdpSocket.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <functional>
+#include <queue>
+#include <utility>
+
+// Deterministic xorshift64* generator so simulator runs are reproducible from a seed.
+class SimRandom {
+public:
+    explicit SimRandom(uint64_t seed = 1);
+    uint64_t next();
+    uint32_t below(uint32_t bound);
+    bool chance(double probability);
+
+private:
+    uint64_t state;
+};
+
+struct SimPlayer {
+    int slot = 0;
+    std::string name;
+    std::string guid;
+    uint32_t address = 0;
+    uint16_t port = 0;
+    int score = 0;
+    int ping = 0;
+    int qport = 0;
+};
+
+// Behaviour of one simulated server and of the network path in front of it.
+struct SimConfig {
+    int protocolId = 2;          // 1 = Medal of Honor, 2 = Call of Duty
+    std::string game;            // Empty picks a default for the protocol
+    std::string rconPassword = "secret";
+    int maxClients = 32;
+    int minPlayers = 0;
+    int maxPlayers = 24;
+    double churn = 0.0;          // Chance per status query that one player joins and one leaves
+    uint32_t latencyMs = 0;      // Base one-way reply delay
+    uint32_t jitterMs = 0;       // Extra random delay, uniform in [0, jitterMs]
+    double loss = 0.0;           // Chance a reply is dropped
+    double reorder = 0.0;        // Chance a reply is held back behind later ones
+    double rconPerSecond = 0.0;  // RCON token refill rate, 0 = unthrottled
+    uint32_t rconBurst = 3;      // RCON token bucket size
+};
+
+struct SimStats {
+    uint64_t requests = 0;
+    uint64_t replies = 0;
+    uint64_t dropped = 0;
+    uint64_t reordered = 0;
+    uint64_t throttled = 0;
+    uint64_t badPassword = 0;
+    uint64_t malformed = 0;
+};
+
+// One fake game server: holds cvars and players and answers out-of-band queries
+// (getstatus, getinfo and rcon) in the Quake 3 wire format used by MOHAA and CoD.
+class SimServer {
+public:
+    SimServer(const SimConfig& config, uint64_t seed, uint16_t port);
+
+    // Builds the reply for one request datagram. Returns false if the request gets no answer.
+    bool handle(const char* data, size_t length, uint64_t nowMs, std::string& reply);
+
+    const SimConfig& getConfig() const { return config; }
+    const std::vector<SimPlayer>& getPlayers() const { return players; }
+    const SimStats& getStats() const { return stats; }
+    SimStats& getStats() { return stats; }
+    uint16_t getPort() const { return port; }
+    std::string getCvar(const std::string& name) const;
+    void setCvar(const std::string& name, const std::string& value);
+
+private:
+    void beginReply(std::string& reply, const char* kind) const;
+    void buildStatus(std::string& reply);
+    void buildInfo(std::string& reply, const std::string& challenge);
+    void handleRcon(const std::string& line, std::string& reply);
+    void printStatusTable(std::string& out) const;
+    void addPlayer();
+    void removePlayer(size_t index);
+    void churnPlayers();
+    bool takeRconToken(uint64_t nowMs);
+
+    SimConfig config;
+    SimRandom random;
+    uint16_t port;
+    std::vector<std::pair<std::string, std::string>> cvars; // In serverinfo order
+    std::vector<SimPlayer> players;
+    std::vector<std::string> mapRotation;
+    size_t rotationIndex = 0;
+    double rconTokens;
+    uint64_t rconRefillMs = 0;
+    SimStats stats;
+};
+
+// Runs many SimServers on consecutive localhost ports and applies latency, loss and reordering to their replies.
+class SimNetwork {
+public:
+    // Creates count servers on basePort.. with protocols from config, or alternating MOHAA/CoD when mixProtocols is set.
+    bool start(const SimConfig& config, size_t count, uint16_t basePort, uint64_t seed, bool mixProtocols);
+    void stop();
+    // Waits up to timeoutMs for requests, answers them and flushes replies that are due.
+    void pump(int timeoutMs);
+
+    size_t size() const { return servers.size(); }
+    SimServer& server(size_t index) { return servers[index]; }
+    SimStats totals() const;
+    // Writes servers.ini sections pointing xRcon at every simulated server.
+    bool writeServersIni(const std::string& path) const;
+
+private:
+    struct Pending {
+        uint64_t dueMs;
+        uint64_t sequence;
+        size_t server;
+        UdpEndpoint to;
+        std::string data;
+        bool operator>(const Pending& other) const {
+            return dueMs != other.dueMs ? dueMs > other.dueMs : sequence > other.sequence;
+        }
+    };
+
+    void flushDue(uint64_t nowMs);
+
+    std::vector<SimServer> servers;
+    std::vector<UdpSocket> sockets;
+    std::vector<SimRandom> networkRandom;
+    UdpPoller poller;
+    std::priority_queue<Pending, std::vector<Pending>, std::greater<Pending>> pending;
+    std::vector<size_t> ready;
+    std::string reply;
+    uint64_t sequence = 0;
+};
+
+uint64_t simNowMs();
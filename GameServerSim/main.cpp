@@ -0,0 +1,132 @@
+// --- GameServerSim\main.cpp ---
+// Entry point for the game server simulator.
+// Runs a fleet of fake MOHAA/CoD servers on localhost for load and regression testing of xRcon.
+
+#include "SimServer.h"
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+static volatile std::sig_atomic_t stopRequested = 0;
+
+// Stops the main loop on Ctrl+C.
+static void onSignal(int) {
+    stopRequested = 1;
+}
+
+// Prints command-line usage.
+static void printUsage() {
+    std::printf(
+        "Usage: GameServerSim [options]\n"
+        "  --servers N         Number of servers (default 100)\n"
+        "  --base-port P       First UDP port (default 40000)\n"
+        "  --protocol 1|2|mix  1 = MOHAA, 2 = CoD, mix = alternate (default mix)\n"
+        "  --players MIN-MAX   Player population per server (default 0-24)\n"
+        "  --max-clients N     sv_maxclients (default 32)\n"
+        "  --churn P           Join/leave chance per status query, 0-1 (default 0)\n"
+        "  --latency MS        Base reply delay (default 0)\n"
+        "  --jitter MS         Extra random delay (default 0)\n"
+        "  --loss P            Reply loss chance, 0-1 (default 0)\n"
+        "  --reorder P         Reply reorder chance, 0-1 (default 0)\n"
+        "  --rcon-rate R       RCON commands per second per server, 0 = unlimited (default 0)\n"
+        "  --rcon-burst N      RCON burst size (default 3)\n"
+        "  --password PW       RCON password (default secret)\n"
+        "  --seed S            RNG seed (default 1)\n"
+        "  --duration SEC      Exit after SEC seconds (default: run until Ctrl+C)\n"
+        "  --write-ini PATH    Write a servers.ini for the simulated fleet and continue\n");
+}
+
+int main(int argc, char** argv) {
+    SimConfig config;
+    size_t count = 100;
+    unsigned long basePort = 40000;
+    bool mix = true;
+    unsigned long long seed = 1;
+    double duration = 0.0;
+    std::string iniPath;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (arg == "--help" || arg == "-h") {
+            printUsage();
+            return 0;
+        }
+        if (!value) {
+            std::fprintf(stderr, "Missing value for %s\n", arg.c_str());
+            return 1;
+        }
+        ++i;
+        if (arg == "--servers") count = std::strtoul(value, nullptr, 10);
+        else if (arg == "--base-port") basePort = std::strtoul(value, nullptr, 10);
+        else if (arg == "--protocol") {
+            mix = std::strcmp(value, "mix") == 0;
+            if (!mix) config.protocolId = std::atoi(value) == 1 ? 1 : 2;
+        }
+        else if (arg == "--players") {
+            if (std::sscanf(value, "%d-%d", &config.minPlayers, &config.maxPlayers) == 1) {
+                config.maxPlayers = config.minPlayers;
+            }
+        }
+        else if (arg == "--max-clients") config.maxClients = std::atoi(value);
+        else if (arg == "--churn") config.churn = std::atof(value);
+        else if (arg == "--latency") config.latencyMs = static_cast<uint32_t>(std::strtoul(value, nullptr, 10));
+        else if (arg == "--jitter") config.jitterMs = static_cast<uint32_t>(std::strtoul(value, nullptr, 10));
+        else if (arg == "--loss") config.loss = std::atof(value);
+        else if (arg == "--reorder") config.reorder = std::atof(value);
+        else if (arg == "--rcon-rate") config.rconPerSecond = std::atof(value);
+        else if (arg == "--rcon-burst") config.rconBurst = static_cast<uint32_t>(std::strtoul(value, nullptr, 10));
+        else if (arg == "--password") config.rconPassword = value;
+        else if (arg == "--seed") seed = std::strtoull(value, nullptr, 10);
+        else if (arg == "--duration") duration = std::atof(value);
+        else if (arg == "--write-ini") iniPath = value;
+        else {
+            std::fprintf(stderr, "Unknown option %s\n", arg.c_str());
+            printUsage();
+            return 1;
+        }
+    }
+    if (count == 0 || basePort == 0 || basePort + count - 1 > 65535) {
+        std::fprintf(stderr, "Invalid server count or port range\n");
+        return 1;
+    }
+
+    if (!UdpSocket::startup()) {
+        std::fprintf(stderr, "Failed to initialize sockets\n");
+        return 1;
+    }
+
+    SimNetwork network;
+    if (!network.start(config, count, static_cast<uint16_t>(basePort), seed, mix)) {
+        UdpSocket::cleanup();
+        return 1;
+    }
+    if (!iniPath.empty() && !network.writeServersIni(iniPath)) {
+        std::fprintf(stderr, "Failed to write %s\n", iniPath.c_str());
+    }
+    std::printf("Simulating %zu servers on 127.0.0.1:%lu-%lu (seed %llu)\n",
+        count, basePort, basePort + count - 1, seed);
+    std::fflush(stdout);
+
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+    uint64_t start = simNowMs();
+    while (!stopRequested) {
+        network.pump(50);
+        if (duration > 0.0 && simNowMs() - start >= static_cast<uint64_t>(duration * 1000.0)) {
+            break;
+        }
+    }
+
+    SimStats total = network.totals();
+    std::printf("requests=%llu replies=%llu dropped=%llu reordered=%llu throttled=%llu badPassword=%llu malformed=%llu\n",
+        static_cast<unsigned long long>(total.requests), static_cast<unsigned long long>(total.replies),
+        static_cast<unsigned long long>(total.dropped), static_cast<unsigned long long>(total.reordered),
+        static_cast<unsigned long long>(total.throttled), static_cast<unsigned long long>(total.badPassword),
+        static_cast<unsigned long long>(total.malformed));
+    network.stop();
+    UdpSocket::cleanup();
+    return 0;
+}
@@ -0,0 +1,20 @@
+// --- xRcon\GameTraits.cpp ---
+// Implementation of game name resolution against the compile-time traits table.
+
+#include "GameTraits.h"
+
+GameId GameTraits::resolve(std::string_view name) {
+    for (const GameTraits& traits : kGameTraits) {
+        if (traits.name && name == traits.name) return traits.id;
+    }
+    if (name.find("Call of Duty") != std::string_view::npos) return GameId::CodOther;
+    return GameId::Unknown;
+}
+
+std::vector<std::pair<std::string, int>> GameTraits::gameOptions() {
+    std::vector<std::pair<std::string, int>> options;
+    for (const GameTraits& traits : kGameTraits) {
+        if (traits.name) options.emplace_back(traits.name, traits.protocolId);
+    }
+    return options;
+}
@@ -0,0 +1,99 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Games xRcon knows, resolved once from the servers.ini game name. The values index kGameTraits.
+enum class GameId : uint8_t {
+    Unknown,
+    MohAlliedAssault,
+    MohSpearhead,
+    MohBreakthrough,
+    CallOfDuty,
+    CodUnitedOffensive,
+    CallOfDuty2,
+    CallOfDuty4,
+    CodWorldAtWar,
+    CodOther,                     // Any other name containing "Call of Duty"
+    Count
+};
+
+// One per-player action column: header, width and the rcon command that takes the slot number as its argument.
+struct PlayerActionColumn {
+    const wchar_t* title;
+    int width;
+    const char* command;
+};
+
+// What the RCON page offers for a game. Adding a game is one kGameTraits entry plus its GameId.
+struct GameTraits {
+    GameId id;
+    const char* name;             // Name shown in the game selector and stored in servers.ini; nullptr for fallbacks
+    int protocolId;               // GameServerQuery protocol: 1 = Medal of Honor, 2 = Call of Duty
+    PlayerActionColumn actions[3];
+    int actionCount;
+    bool restartButton;
+    const char* restartCommand;
+    bool fastRestartButton;
+    bool mapRotateButton;
+    const char* gametypeCvar;     // Cvar the live gametype is read from
+    bool gametypeIsString;        // gametypeCvar reports the display name, not the id
+    bool mapAfterGametype;        // Load the selected map after g_gametype instead of map_restart
+    const char* ipBanCommand;     // Server-side IP filter commands the ban list is synced through; nullptr
+    const char* ipUnbanCommand;   // where the game has none and bans are only enforced by kicks
+
+    static const GameTraits& get(GameId id);
+    // Exact name match, then any "Call of Duty" name, else Unknown.
+    static GameId resolve(std::string_view name);
+    // Selectable games in selector order with their protocol ids.
+    static std::vector<std::pair<std::string, int>> gameOptions();
+};
+
+constexpr PlayerActionColumn kRenameColumn = { L"Rename", 60, "set namechange" };
+constexpr PlayerActionColumn kUnbindColumn = { L"Unbind", 60, "set unbindplayer" };
+constexpr PlayerActionColumn kMohKickColumn = { L"Kick", 60, "clientkick" };
+constexpr PlayerActionColumn kKickColumn = { L"Kick", 80, "clientkick" };
+constexpr PlayerActionColumn kBanColumn = { L"Ban", 80, "banclient" };
+
+// Indexed by GameId. Spearhead shares the Allied Assault player actions (the server-side rename and
+// unbind scripts), but like Breakthrough reports g_gametype and restarts with map_restart. The Medal of
+// Honor family keeps the Quake 3 addip/removeip filter list; Call of Duty bans by GUID only.
+constexpr GameTraits kGameTraits[] = {
+    { GameId::Unknown, nullptr, 0, {}, 0,
+      false, "map_restart", false, false, "g_gametype", false, false, nullptr, nullptr },
+    { GameId::MohAlliedAssault, "Medal of Honor: Allied Assault", 1, { kRenameColumn, kUnbindColumn, kMohKickColumn }, 3,
+      true, "restart", false, false, "g_gametypestring", true, true, "addip", "removeip" },
+    { GameId::MohSpearhead, "Medal of Honor: AA Spearhead", 1, { kRenameColumn, kUnbindColumn, kMohKickColumn }, 3,
+      true, "map_restart", false, false, "g_gametype", false, false, "addip", "removeip" },
+    { GameId::MohBreakthrough, "Medal of Honor: AA Breakthrough", 1, { kKickColumn }, 1,
+      true, "map_restart", false, false, "g_gametype", false, false, "addip", "removeip" },
+    { GameId::CallOfDuty, "Call of Duty", 2, { kKickColumn, kBanColumn }, 2,
+      true, "map_restart", false, true, "g_gametype", false, false, nullptr, nullptr },
+    { GameId::CodUnitedOffensive, "Call of Duty: United Offensive", 2, { kKickColumn, kBanColumn }, 2,
+      true, "map_restart", false, true, "g_gametype", false, false, nullptr, nullptr },
+    { GameId::CallOfDuty2, "Call of Duty 2", 2, { kKickColumn, kBanColumn }, 2,
+      true, "map_restart", true, true, "g_gametype", false, false, nullptr, nullptr },
+    { GameId::CallOfDuty4, "Call of Duty 4: Modern Warfare", 2, { kKickColumn, kBanColumn }, 2,
+      true, "map_restart", true, true, "g_gametype", false, false, nullptr, nullptr },
+    { GameId::CodWorldAtWar, "Call of Duty: World at War", 2, { kKickColumn, kBanColumn }, 2,
+      true, "map_restart", true, true, "g_gametype", false, false, nullptr, nullptr },
+    { GameId::CodOther, nullptr, 2, { kKickColumn, kBanColumn }, 2,
+      true, "map_restart", false, true, "g_gametype", false, false, nullptr, nullptr },
+};
+
+static_assert(sizeof(kGameTraits) / sizeof(kGameTraits[0]) == static_cast<size_t>(GameId::Count),
+    "kGameTraits needs one entry per GameId");
+
+constexpr bool gameTraitsIndexed(size_t i = 0) {
+    return i == static_cast<size_t>(GameId::Count) ||
+        (kGameTraits[i].id == static_cast<GameId>(i) && gameTraitsIndexed(i + 1));
+}
+static_assert(gameTraitsIndexed(), "kGameTraits entries must be in GameId order");
+
+inline const GameTraits& GameTraits::get(GameId id) {
+    return static_cast<size_t>(id) < static_cast<size_t>(GameId::Count)
+        ? kGameTraits[static_cast<size_t>(id)] : kGameTraits[0];
+}
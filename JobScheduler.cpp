@@ -0,0 +1,344 @@
+// --- xRcon\JobScheduler.cpp ---
+// Implementation of cron schedules, the job heap and the job run log.
+// The ini format mirrors rules.ini: one [job] section per job.
+
+#include "JobScheduler.h"
+#include "BanList.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+
+static std::string lowercase(std::string_view text) {
+    std::string result(text);
+    for (char& c : result) c = c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+    return result;
+}
+
+static std::string_view trim(std::string_view text) {
+    while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) text.remove_prefix(1);
+    while (!text.empty() && (text.back() == ' ' || text.back() == '\t')) text.remove_suffix(1);
+    return text;
+}
+
+static bool toLocal(time_t seconds, tm& local) {
+#ifdef _WIN32
+    return localtime_s(&local, &seconds) == 0;
+#else
+    return localtime_r(&seconds, &local) != nullptr;
+#endif
+}
+
+// One value: a number or, where names is given, a three-letter name whose index is its value.
+static bool parseValue(std::string_view text, const char* const* names, int& value) {
+    if (text.empty()) return false;
+    if (text[0] >= '0' && text[0] <= '9') {
+        value = 0;
+        for (char c : text) {
+            if (c < '0' || c > '9' || value > 1000) return false;
+            value = value * 10 + (c - '0');
+        }
+        return true;
+    }
+    std::string name = lowercase(text);
+    for (int i = 0; names && names[i]; ++i) {
+        if (name == names[i]) {
+            value = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Sets a bit in bits for every value the field allows. names[0] stands for the value low.
+static bool parseField(std::string_view text, int low, int high, const char* const* names, uint64_t& bits, std::string& error) {
+    bits = 0;
+    while (!text.empty()) {
+        size_t comma = text.find(',');
+        std::string_view part = text.substr(0, comma);
+        text = comma == std::string_view::npos ? std::string_view() : text.substr(comma + 1);
+
+        int step = 1;
+        size_t slash = part.find('/');
+        if (slash != std::string_view::npos) {
+            if (!parseValue(part.substr(slash + 1), nullptr, step) || step == 0) {
+                error = "bad step in '" + std::string(part) + "'";
+                return false;
+            }
+            part = part.substr(0, slash);
+        }
+        int first = low, last = high;
+        if (part != "*") {
+            size_t dash = part.find('-');
+            int offset = names ? low : 0;
+            if (!parseValue(part.substr(0, dash), names, first)) {
+                error = "bad value '" + std::string(part) + "'";
+                return false;
+            }
+            if (names && !(part[0] >= '0' && part[0] <= '9')) first += offset;
+            last = slash == std::string_view::npos ? first : high;
+            if (dash != std::string_view::npos) {
+                std::string_view end = part.substr(dash + 1);
+                if (!parseValue(end, names, last)) {
+                    error = "bad range '" + std::string(part) + "'";
+                    return false;
+                }
+                if (names && !(end[0] >= '0' && end[0] <= '9')) last += offset;
+                if (high == 7 && last == 0 && first > 0) last = 7; // "fri-sun"
+            }
+        }
+        if (first < low || last > high || first > last) {
+            error = "'" + std::string(part) + "' is outside " + std::to_string(low) + "-" + std::to_string(high);
+            return false;
+        }
+        for (int value = first; value <= last; value += step) bits |= 1ull << value;
+    }
+    if (bits == 0) {
+        error = "empty field";
+        return false;
+    }
+    return true;
+}
+
+bool CronSchedule::parse(std::string_view text, std::string& error) {
+    static const char* const monthNames[] = { "jan", "feb", "mar", "apr", "may", "jun", "jul", "aug", "sep", "oct", "nov", "dec", nullptr };
+    static const char* const dayNames[] = { "sun", "mon", "tue", "wed", "thu", "fri", "sat", nullptr };
+    static const std::pair<const char*, const char*> macros[] = { { "@hourly", "0 * * * *" }, { "@daily", "0 0 * * *" },
+        { "@midnight", "0 0 * * *" }, { "@weekly", "0 0 * * 0" }, { "@monthly", "0 0 1 * *" }, { "@yearly", "0 0 1 1 *" },
+        { "@annually", "0 0 1 1 *" } };
+    text = trim(text);
+    std::string lower = lowercase(text);
+    for (const auto& macro : macros) {
+        if (lower == macro.first) text = macro.second;
+    }
+    std::vector<std::string_view> fields;
+    while (!(text = trim(text)).empty()) {
+        size_t end = text.find_first_of(" \t");
+        fields.push_back(text.substr(0, end));
+        text = end == std::string_view::npos ? std::string_view() : text.substr(end);
+    }
+    if (fields.size() != 5) {
+        error = "expected 5 fields (minute hour day month weekday), got " + std::to_string(fields.size());
+        return false;
+    }
+    uint64_t bits[5];
+    static const int lows[] = { 0, 0, 1, 1, 0 };
+    static const int highs[] = { 59, 23, 31, 12, 7 };
+    const char* const* names[] = { nullptr, nullptr, nullptr, monthNames, dayNames };
+    static const char* const labels[] = { "minute", "hour", "day", "month", "weekday" };
+    for (int i = 0; i < 5; ++i) {
+        std::string fieldError;
+        if (!parseField(fields[i], lows[i], highs[i], names[i], bits[i], fieldError)) {
+            error = std::string(labels[i]) + ": " + fieldError;
+            return false;
+        }
+    }
+    minutes = bits[0];
+    hours = static_cast<uint32_t>(bits[1]);
+    days = static_cast<uint32_t>(bits[2]);
+    months = static_cast<uint32_t>(bits[3]);
+    weekdays = static_cast<uint32_t>((bits[4] | bits[4] >> 7) & 0x7F); // 7 is Sunday too
+    anyDay = fields[2] == "*";
+    anyWeekday = fields[4] == "*";
+    return true;
+}
+
+// Lowest set bit of bits from from to last, or -1.
+static int nextBit(uint64_t bits, int from, int last) {
+    for (int value = from; value <= last; ++value) {
+        if (bits >> value & 1) return value;
+    }
+    return -1;
+}
+
+uint64_t CronSchedule::next(uint64_t afterUnixMs) const {
+    time_t seconds = static_cast<time_t>(afterUnixMs / 1000);
+    seconds = seconds - seconds % 60 + 60;
+    tm local = {};
+    if (!toLocal(seconds, local)) return 0;
+    int lastYear = local.tm_year + 5;
+    // Each step moves the first field that does not match to its next value and clears the ones below
+    // it; mktime carries overflows and settles daylight saving gaps.
+    while (local.tm_year <= lastYear) {
+        bool day = (days >> local.tm_mday & 1) != 0;
+        bool weekday = (weekdays >> local.tm_wday & 1) != 0;
+        bool dayMatches = anyDay && anyWeekday ? true : anyDay ? weekday : anyWeekday ? day : day || weekday;
+        if (!(months >> (local.tm_mon + 1) & 1)) {
+            ++local.tm_mon;
+            local.tm_mday = 1;
+            local.tm_hour = local.tm_min = 0;
+        }
+        else if (!dayMatches) {
+            ++local.tm_mday;
+            local.tm_hour = local.tm_min = 0;
+        }
+        else if (!(hours >> local.tm_hour & 1)) {
+            int hour = nextBit(hours, local.tm_hour, 23);
+            local.tm_hour = hour < 0 ? 24 : hour;
+            local.tm_min = 0;
+        }
+        else if (!(minutes >> local.tm_min & 1)) {
+            int minute = nextBit(minutes, local.tm_min, 59);
+            local.tm_min = minute < 0 ? 60 : minute;
+        }
+        else {
+            return static_cast<uint64_t>(seconds) * 1000;
+        }
+        local.tm_sec = 0;
+        local.tm_isdst = -1;
+        seconds = mktime(&local);
+        if (seconds == static_cast<time_t>(-1)) return 0;
+    }
+    return 0;
+}
+
+bool JobScheduler::targets(const Job& job, std::string_view server) {
+    std::string name = lowercase(server);
+    std::string_view patterns = job.servers;
+    while (!patterns.empty()) {
+        size_t comma = patterns.find(',');
+        std::string_view pattern = trim(patterns.substr(0, comma));
+        patterns = comma == std::string_view::npos ? std::string_view() : patterns.substr(comma + 1);
+        if (!pattern.empty() && BanList::wildcardMatch(pattern, name)) return true;
+    }
+    return false;
+}
+
+// Stable jitter, so a restart does not move a run that was already announced.
+static uint64_t jitterMs(const Job& job, uint64_t scheduledUnixMs) {
+    if (job.jitterSeconds == 0) return 0;
+    uint64_t hash = 14695981039346656037ull;
+    for (char c : job.name) hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+    hash = (hash ^ scheduledUnixMs) * 1099511628211ull;
+    hash ^= hash >> 29;
+    return hash % (static_cast<uint64_t>(job.jitterSeconds) * 1000 + 1);
+}
+
+void JobScheduler::schedule(uint32_t job, uint64_t afterUnixMs) {
+    uint64_t next = list[job].cron.next(afterUnixMs);
+    if (next == 0) return; // Never again
+    heap.push_back({ next + jitterMs(list[job], next), next, job });
+    std::push_heap(heap.begin(), heap.end(), std::greater<Entry>());
+}
+
+void JobScheduler::due(uint64_t nowUnixMs, std::vector<JobDue>& out) {
+    while (!heap.empty() && heap.front().dueUnixMs <= nowUnixMs) {
+        std::pop_heap(heap.begin(), heap.end(), std::greater<Entry>());
+        Entry entry = heap.back();
+        heap.pop_back();
+        out.push_back({ entry.job, entry.scheduledUnixMs, nowUnixMs - entry.dueUnixMs > kLateLimitMs });
+        // After now as well, so a long sleep yields one missed run rather than a backlog
+        schedule(entry.job, std::max(entry.scheduledUnixMs, nowUnixMs));
+    }
+}
+
+bool JobScheduler::add(Job job, uint64_t nowUnixMs, std::string& error) {
+    std::string label = "Job '" + job.name + "': ";
+    if (!job.cron.parse(job.schedule, error)) {
+        error = label + error;
+        return false;
+    }
+    if (job.commands.empty()) {
+        error = label + "no do= command";
+        return false;
+    }
+    job.servers = lowercase(job.servers.empty() ? "*" : job.servers);
+    list.push_back(std::move(job));
+    schedule(static_cast<uint32_t>(list.size() - 1), nowUnixMs);
+    return true;
+}
+
+void JobScheduler::clear() {
+    list.clear();
+    heap.clear();
+}
+
+// One [job] section per job with name, servers, schedule, do (repeatable) and jitter (seconds) keys.
+size_t JobScheduler::load(const std::string& path, uint64_t nowUnixMs, std::vector<std::string>& errors) {
+    clear();
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    bool exists = fs::is_regular_file(path, ec);
+    fileSize = exists ? fs::file_size(path, ec) : 0;
+    writeTime = exists ? static_cast<int64_t>(fs::last_write_time(path, ec).time_since_epoch().count()) : 0;
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        return 0;
+    }
+    Job job;
+    bool inJob = false;
+    auto finish = [&]() {
+        if (!inJob) return;
+        std::string error;
+        if (!add(std::move(job), nowUnixMs, error)) errors.push_back(error);
+        job = Job();
+        inJob = false;
+    };
+    std::string line;
+    while (std::getline(file, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty() || line[0] == ';') continue;
+        if (line[0] == '[') {
+            finish();
+            inJob = line == "[job]";
+            continue;
+        }
+        size_t equals = line.find('=');
+        if (!inJob || equals == std::string::npos) continue;
+        std::string key = line.substr(0, equals);
+        std::string value = line.substr(equals + 1);
+        if (key == "name") job.name = value;
+        else if (key == "servers") job.servers = value;
+        else if (key == "schedule") job.schedule = value;
+        else if (key == "do") job.commands.push_back(value);
+        else if (key == "jitter") job.jitterSeconds = static_cast<uint32_t>(std::strtoul(value.c_str(), nullptr, 10));
+    }
+    finish();
+    return list.size();
+}
+
+bool JobScheduler::changedOnDisk(const std::string& path) const {
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    bool exists = fs::is_regular_file(path, ec);
+    uintmax_t size = exists ? fs::file_size(path, ec) : 0;
+    int64_t time = exists ? static_cast<int64_t>(fs::last_write_time(path, ec).time_since_epoch().count()) : 0;
+    return size != fileSize || time != writeTime;
+}
+
+// Line per run: scheduled and sent times (Unix ms), job, server, ok or failed, command, result. Tabs
+// and line breaks in the text fields are replaced by spaces.
+bool JobHistory::append(const std::string& path, const std::vector<JobRun>& runs) {
+    for (const JobRun& run : runs) {
+        latest.push_back(run);
+        if (latest.size() > kRecent) latest.pop_front();
+    }
+    FILE* file = nullptr;
+#ifdef _WIN32
+    if (fopen_s(&file, path.c_str(), "ab") != 0) file = nullptr;
+#else
+    file = fopen(path.c_str(), "ab");
+#endif
+    if (!file) {
+        return false;
+    }
+    auto field = [file](const std::string& text) {
+        fputc('\t', file);
+        for (char c : text) fputc(c == '\t' || c == '\n' || c == '\r' ? ' ' : c, file);
+    };
+    for (const JobRun& run : runs) {
+        fprintf(file, "%llu\t%llu", (unsigned long long)run.scheduledUnixMs, (unsigned long long)run.sentUnixMs);
+        field(run.job);
+        field(run.server);
+        field(run.ok ? "ok" : "failed");
+        field(run.command);
+        field(run.result);
+        fputc('\n', file);
+    }
+    bool ok = fflush(file) == 0;
+    fclose(file);
+    return ok;
+}
@@ -0,0 +1,104 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// A five-field cron schedule (minute hour day-of-month month day-of-week) in local time. Fields take
+// *, lists, ranges and steps ("*/15", "1-5", "mon,wed"), month and weekday names, and @hourly, @daily,
+// @weekly, @monthly and @yearly. Day of month and day of week both restricted means either may match.
+class CronSchedule {
+public:
+    bool parse(std::string_view text, std::string& error);
+    // First matching minute after afterUnixMs, or 0 if there is none within five years.
+    uint64_t next(uint64_t afterUnixMs) const;
+
+private:
+    uint64_t minutes = 0;         // Bit per allowed value
+    uint32_t hours = 0;
+    uint32_t days = 0;            // Bits 1-31
+    uint32_t months = 0;          // Bits 1-12
+    uint32_t weekdays = 0;        // Bits 0-6, Sunday first
+    bool anyDay = true;           // Day of month was *
+    bool anyWeekday = true;
+};
+
+// A command list sent to every server whose name matches one of servers on schedule.
+struct Job {
+    std::string name;
+    std::string servers = "*";    // Comma-separated name globs, case-insensitive
+    std::string schedule;
+    std::vector<std::string> commands;
+    uint32_t jitterSeconds = 0;   // Each run is put off by a stable pseudo-random 0..jitter seconds
+    CronSchedule cron;            // Parsed by JobScheduler::add
+};
+
+// A job run that came due.
+struct JobDue {
+    uint32_t job = 0;             // Index into JobScheduler::jobs()
+    uint64_t scheduledUnixMs = 0; // The cron time, before jitter
+    bool missed = false;          // Came due too long ago (the machine slept or the program was closed) and is skipped
+};
+
+// Jobs from an ini file, kept in a min-heap by next run time, so the clock tick only looks at the top
+// of the heap and thousands of idle jobs cost nothing until one is due. Used from the UI thread only.
+class JobScheduler {
+public:
+    static const uint64_t kLateLimitMs = 5 * 60 * 1000; // Runs older than this are reported as missed
+
+    // Replaces the jobs with path's and schedules each after nowUnixMs. Jobs that do not parse are
+    // skipped and described in errors.
+    size_t load(const std::string& path, uint64_t nowUnixMs, std::vector<std::string>& errors);
+    // True if path was written since the last load.
+    bool changedOnDisk(const std::string& path) const;
+    bool add(Job job, uint64_t nowUnixMs, std::string& error);
+    void clear();
+    const std::vector<Job>& jobs() const { return list; }
+
+    // Time of the earliest pending run, or UINT64_MAX.
+    uint64_t nextDueUnixMs() const { return heap.empty() ? UINT64_MAX : heap.front().dueUnixMs; }
+    // Moves the runs due at nowUnixMs to out and schedules each job's next run after them.
+    void due(uint64_t nowUnixMs, std::vector<JobDue>& out);
+
+    static bool targets(const Job& job, std::string_view server);
+
+private:
+    struct Entry {
+        uint64_t dueUnixMs;       // With jitter
+        uint64_t scheduledUnixMs;
+        uint32_t job;
+        bool operator>(const Entry& other) const { return dueUnixMs > other.dueUnixMs; }
+    };
+
+    void schedule(uint32_t job, uint64_t afterUnixMs);
+
+    std::vector<Job> list;
+    std::vector<Entry> heap;      // std::push_heap order with std::greater: earliest first
+    uintmax_t fileSize = 0;
+    int64_t writeTime = 0;
+};
+
+// One command of a job run and how the server took it.
+struct JobRun {
+    std::string job;
+    std::string server;
+    std::string command;
+    uint64_t scheduledUnixMs = 0;
+    uint64_t sentUnixMs = 0;
+    bool ok = false;
+    std::string result;           // Reply text, or why there is none
+};
+
+// Every job run, appended to a tab-separated log file, and the latest ones in memory.
+class JobHistory {
+public:
+    static const size_t kRecent = 200;
+
+    bool append(const std::string& path, const std::vector<JobRun>& runs);
+    const std::deque<JobRun>& recent() const { return latest; }
+
+private:
+    std::deque<JobRun> latest;
+};
@@ -0,0 +1,58 @@
+// --- xRcon\ListCatalog.cpp ---
+// Implementation of the interned map/gametype catalogs.
+// Parses a list once and answers index, id and name lookups without walking it again.
+
+#include "ListCatalog.h"
+#include <memory>
+#include <mutex>
+
+const ListCatalog& ListCatalog::get(const std::string& list) {
+    static std::mutex lock;
+    static std::unordered_map<std::string, std::unique_ptr<ListCatalog>> interned;
+    std::lock_guard<std::mutex> guard(lock);
+    std::unique_ptr<ListCatalog>& slot = interned[list];
+    if (!slot) {
+        slot.reset(new ListCatalog(list));
+    }
+    return *slot;
+}
+
+// Same acceptance as ServerManager::parseList: pairs need a non-empty id and name.
+// A repeated id keeps its first position and takes the last name, as the std::map did.
+ListCatalog::ListCatalog(std::string_view list) : text(list) {
+    std::string_view rest = text;
+    while (!rest.empty()) {
+        size_t comma = rest.find(',');
+        std::string_view pair = rest.substr(0, comma);
+        rest = comma == std::string_view::npos ? std::string_view() : rest.substr(comma + 1);
+        size_t colon = pair.find(':');
+        if (colon == std::string_view::npos || colon == 0 || colon == pair.size() - 1) continue;
+        CatalogEntry entry = { pair.substr(0, colon), pair.substr(colon + 1) };
+        auto found = byId.find(entry.id);
+        if (found != byId.end()) {
+            items[found->second].name = entry.name;
+            continue;
+        }
+        byId.emplace(entry.id, static_cast<int>(items.size()));
+        items.push_back(entry);
+    }
+    // Names are indexed after duplicates are resolved; the first entry wins a shared name
+    for (size_t i = 0; i < items.size(); ++i) {
+        byName.emplace(items[i].name, static_cast<int>(i));
+    }
+}
+
+const CatalogEntry* ListCatalog::at(int index) const {
+    if (index < 0 || static_cast<size_t>(index) >= items.size()) return nullptr;
+    return &items[index];
+}
+
+int ListCatalog::indexOfId(std::string_view id) const {
+    auto found = byId.find(id);
+    return found == byId.end() ? -1 : found->second;
+}
+
+int ListCatalog::indexOfName(std::string_view name) const {
+    auto found = byName.find(name);
+    return found == byName.end() ? -1 : found->second;
+}
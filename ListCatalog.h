@@ -0,0 +1,41 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// One id:name pair of a maps or gametypes list. Both views point into the owning catalog.
+struct CatalogEntry {
+    std::string_view id;          // Value sent to the server, e.g. "dm/mohdm6" or "tdm"
+    std::string_view name;        // Human-readable name shown in the selectors
+};
+
+// Parsed maps or gametypes list in config order with O(1) lookups by position, id and name.
+// Catalogs are interned by list text and never freed, so references from get() stay valid
+// and servers with the same list share one catalog.
+class ListCatalog {
+public:
+    // Returns the shared catalog for a "id:name,id2:name2" list, building it on first use.
+    static const ListCatalog& get(const std::string& list);
+
+    explicit ListCatalog(std::string_view list);
+    ListCatalog(const ListCatalog&) = delete;
+    ListCatalog& operator=(const ListCatalog&) = delete;
+
+    size_t size() const { return items.size(); }
+    bool empty() const { return items.empty(); }
+    const std::vector<CatalogEntry>& entries() const { return items; }
+
+    // Entry at a selector position, or nullptr if index is out of range.
+    const CatalogEntry* at(int index) const;
+    // Position of the entry with this id or name, or -1. Used to match live mapname/g_gametype.
+    int indexOfId(std::string_view id) const;
+    int indexOfName(std::string_view name) const;
+
+private:
+    std::string text;             // Owns the characters every entry points into
+    std::vector<CatalogEntry> items;
+    std::unordered_map<std::string_view, int> byId;
+    std::unordered_map<std::string_view, int> byName;
+};
@@ -0,0 +1,349 @@
+// --- xRcon\LogTailer.cpp ---
+// Implementation of the game log pipeline: the in-place line splitter, the per-game line parsers and
+// the tailer that follows a log through truncation and rotation.
+
+#include "LogTailer.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+char* LineSplitter::reserve(size_t n) {
+    if (buffer.size() - end < n && begin > 0) {
+        std::memmove(buffer.data(), buffer.data() + begin, end - begin);
+        end -= begin;
+        begin = 0;
+    }
+    if (buffer.size() - end < n) {
+        buffer.resize(end + n);
+    }
+    return buffer.data() + end;
+}
+
+void LineSplitter::split(std::vector<std::string_view>& out) {
+    const char* data = buffer.data();
+    size_t pos = begin;
+    while (pos < end) {
+        const void* found = std::memchr(data + pos, '\n', end - pos);
+        if (!found) break;
+        size_t stop = static_cast<size_t>(static_cast<const char*>(found) - data);
+        size_t length = stop - pos;
+        if (length > 0 && data[stop - 1] == '\r') --length;
+        out.emplace_back(data + pos, length);
+        pos = stop + 1;
+    }
+    const size_t longest = kMaxLine;
+    while (end - pos >= longest) {
+        out.emplace_back(data + pos, longest);
+        pos += longest;
+    }
+    begin = pos;
+    if (begin == end) begin = end = 0;
+}
+
+static bool startsWith(std::string_view text, std::string_view prefix) {
+    return text.size() >= prefix.size() && text.compare(0, prefix.size(), prefix) == 0;
+}
+
+static std::string_view trimLeft(std::string_view text) {
+    size_t i = 0;
+    while (i < text.size() && text[i] == ' ') ++i;
+    return text.substr(i);
+}
+
+// Takes "mmm:ss " off the front of line.
+static bool parseClock(std::string_view& line, uint32_t& seconds) {
+    size_t i = 0;
+    while (i < line.size() && line[i] == ' ') ++i;
+    uint32_t minutes = 0;
+    size_t start = i;
+    while (i < line.size() && line[i] >= '0' && line[i] <= '9' && i - start < 7) minutes = minutes * 10 + (line[i++] - '0');
+    if (i == start || i + 3 > line.size() || line[i] != ':') return false;
+    char tens = line[i + 1];
+    char ones = line[i + 2];
+    if (tens < '0' || tens > '5' || ones < '0' || ones > '9') return false;
+    seconds = minutes * 60 + (tens - '0') * 10 + (ones - '0');
+    line = trimLeft(line.substr(i + 3));
+    return true;
+}
+
+// Takes the next ';' field off rest; false if rest has no more fields.
+static bool nextField(std::string_view& rest, std::string_view& field, bool last = false) {
+    if (rest.data() == nullptr) return false;
+    size_t semicolon = last ? std::string_view::npos : rest.find(';');
+    field = rest.substr(0, semicolon);
+    rest = semicolon == std::string_view::npos ? std::string_view() : rest.substr(semicolon + 1);
+    return true;
+}
+
+bool LogParser::parseCod(std::string_view line, LogEvent& event) {
+    event = LogEvent();
+    if (!parseClock(line, event.timeSeconds)) return false;
+    if (startsWith(line, "InitGame:")) {
+        event.kind = LogEventKind::MapStart;
+        event.text = trimLeft(line.substr(9));
+        return true;
+    }
+    if (startsWith(line, "ExitLevel:") || startsWith(line, "ShutdownGame:")) {
+        event.kind = LogEventKind::MapEnd;
+        return true;
+    }
+    size_t semicolon = line.find(';');
+    if (semicolon == std::string_view::npos) return false;
+    std::string_view type = line.substr(0, semicolon);
+    std::string_view rest = line.substr(semicolon + 1);
+    std::string_view team;
+    if (type == "J" || type == "Q") {
+        event.kind = type == "J" ? LogEventKind::Join : LogEventKind::Quit;
+        return nextField(rest, event.guid) && nextField(rest, event.slot) && nextField(rest, event.name);
+    }
+    if (type == "K" || type == "D") {
+        event.kind = type == "K" ? LogEventKind::Kill : LogEventKind::Damage;
+        bool ok = nextField(rest, event.victimGuid) && nextField(rest, event.victimSlot) && nextField(rest, team) &&
+            nextField(rest, event.victimName) && nextField(rest, event.guid) && nextField(rest, event.slot) &&
+            nextField(rest, team) && nextField(rest, event.name) && nextField(rest, event.weapon);
+        if (ok && event.slot == "-1") event.slot = event.name = event.guid = std::string_view(); // The world
+        return ok;
+    }
+    if (type == "say" || type == "sayteam") {
+        event.kind = type == "say" ? LogEventKind::Say : LogEventKind::SayTeam;
+        if (!nextField(rest, event.guid) || !nextField(rest, event.slot) || !nextField(rest, event.name) ||
+            !nextField(rest, event.text, true)) {
+            return false;
+        }
+        if (!event.text.empty() && event.text[0] == '\x15') event.text.remove_prefix(1); // Chat color marker
+        return true;
+    }
+    return false;
+}
+
+bool LogParser::parseQuake(std::string_view line, LogEvent& event) {
+    event = LogEvent();
+    if (!parseClock(line, event.timeSeconds)) return false;
+    if (startsWith(line, "InitGame:")) {
+        event.kind = LogEventKind::MapStart;
+        event.text = trimLeft(line.substr(9));
+        return true;
+    }
+    if (startsWith(line, "Exit:") || startsWith(line, "ShutdownGame:")) {
+        event.kind = LogEventKind::MapEnd;
+        return true;
+    }
+    if (startsWith(line, "ClientConnect:") || startsWith(line, "ClientDisconnect:")) {
+        event.kind = line[6] == 'C' ? LogEventKind::Join : LogEventKind::Quit;
+        event.slot = trimLeft(line.substr(line.find(':') + 1));
+        return !event.slot.empty();
+    }
+    if (startsWith(line, "Kill:")) {
+        // Kill: attacker victim means: Attacker killed Victim by MOD_NAME
+        std::string_view numbers = trimLeft(line.substr(5));
+        size_t colon = numbers.find(':');
+        size_t space = numbers.find(' ');
+        if (colon == std::string_view::npos || space == std::string_view::npos || space > colon) return false;
+        event.kind = LogEventKind::Kill;
+        event.slot = numbers.substr(0, space);
+        std::string_view victim = trimLeft(numbers.substr(space + 1));
+        event.victimSlot = victim.substr(0, victim.find(' '));
+        std::string_view text = trimLeft(numbers.substr(colon + 1));
+        size_t killed = text.find(" killed ");
+        size_t by = text.rfind(" by ");
+        if (killed == std::string_view::npos || by == std::string_view::npos || by < killed) return false;
+        event.name = text.substr(0, killed);
+        event.victimName = text.substr(killed + 8, by - killed - 8);
+        event.weapon = text.substr(by + 4);
+        if (event.slot == "1022") event.slot = event.name = std::string_view(); // <world>
+        return true;
+    }
+    if (startsWith(line, "say:") || startsWith(line, "sayteam:")) {
+        event.kind = line[3] == ':' ? LogEventKind::Say : LogEventKind::SayTeam;
+        std::string_view rest = trimLeft(line.substr(line.find(':') + 1));
+        size_t colon = rest.find(": ");
+        if (colon == std::string_view::npos) return false;
+        event.name = rest.substr(0, colon);
+        event.text = rest.substr(colon + 2);
+        return true;
+    }
+    return false;
+}
+
+bool LogParser::parse(int protocolId, std::string_view line, LogEvent& event) {
+    return protocolId == 2 ? parseCod(line, event) : parseQuake(line, event);
+}
+
+static FILE* openFile(const std::string& path, const char* mode) {
+    FILE* file = nullptr;
+#ifdef _WIN32
+    if (fopen_s(&file, path.c_str(), mode) != 0) file = nullptr;
+#else
+    file = fopen(path.c_str(), mode);
+#endif
+    return file;
+}
+
+static bool seekTo(FILE* file, uint64_t position) {
+#ifdef _WIN32
+    return _fseeki64(file, static_cast<__int64>(position), SEEK_SET) == 0;
+#else
+    return fseeko(file, static_cast<off_t>(position), SEEK_SET) == 0;
+#endif
+}
+
+static bool fileLength(FILE* file, uint64_t& length) {
+#ifdef _WIN32
+    if (_fseeki64(file, 0, SEEK_END) != 0) return false;
+    __int64 end = _ftelli64(file);
+#else
+    if (fseeko(file, 0, SEEK_END) != 0) return false;
+    off_t end = ftello(file);
+#endif
+    if (end < 0) return false;
+    length = static_cast<uint64_t>(end);
+    return true;
+}
+
+static uint64_t fnv1a(const char* data, size_t length) {
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < length; ++i) hash = (hash ^ static_cast<unsigned char>(data[i])) * 1099511628211ull;
+    return hash;
+}
+
+void LogTailer::open(const std::string& path, bool readFromStart) {
+    file = path;
+    started = false;
+    fromStart = readFromStart;
+    offset = 0;
+    fingerprint = 0;
+    fingerprintLength = 0;
+    splitter.reset();
+}
+
+size_t LogTailer::poll(std::vector<std::string_view>& out, size_t maxBytes) {
+    out.clear();
+    FILE* handle = openFile(file, "rb");
+    if (!handle) {
+        started = true; // Not there yet, or being replaced; read whatever appears from its start
+        return 0;
+    }
+    uint64_t length = 0;
+    char head[kFingerprintBytes];
+    size_t headLength = 0;
+    if (!fileLength(handle, length) || !seekTo(handle, 0)) {
+        fclose(handle);
+        return 0;
+    }
+    headLength = fread(head, 1, static_cast<size_t>(length < kFingerprintBytes ? length : kFingerprintBytes), handle);
+    if (!started) {
+        started = true;
+        offset = fromStart ? 0 : length;
+    }
+    else if (length < offset) {
+        ++truncated;
+        offset = 0;
+        fingerprintLength = 0;
+        splitter.reset();
+    }
+    else if (fingerprintLength > 0 && (headLength < fingerprintLength || fnv1a(head, fingerprintLength) != fingerprint)) {
+        ++rotated;
+        offset = 0;
+        fingerprintLength = 0;
+        splitter.reset();
+    }
+    if (headLength > fingerprintLength) {
+        fingerprint = fnv1a(head, headLength);
+        fingerprintLength = headLength;
+    }
+
+    size_t wanted = static_cast<size_t>(std::min<uint64_t>(length - offset, maxBytes));
+    size_t read = 0;
+    if (wanted > 0 && seekTo(handle, offset)) {
+        read = fread(splitter.reserve(wanted), 1, wanted, handle);
+        splitter.commit(read);
+        offset += read;
+    }
+    fclose(handle);
+    splitter.split(out);
+    return read;
+}
+
+size_t GameLogs::load(const std::string& path, const std::vector<std::pair<std::string, int>>& servers,
+    std::vector<std::string>& errors) {
+    std::vector<Source> previous = std::move(list);
+    list.clear();
+    std::ifstream file(path);
+    stamp(path, fileSize, writeTime);
+    if (!file.is_open()) {
+        return 0;
+    }
+    Source source;
+    std::string logPath;
+    bool inLog = false;
+    auto finish = [&]() {
+        if (!inLog) return;
+        inLog = false;
+        auto server = std::find_if(servers.begin(), servers.end(), [&](const auto& known) { return known.first == source.server; });
+        if (source.server.empty() || logPath.empty()) {
+            errors.push_back("Log without a server or path");
+        }
+        else if (server == servers.end()) {
+            errors.push_back("Log " + logPath + ": no server named " + source.server);
+        }
+        else {
+            // A log that was already followed keeps its place
+            auto kept = std::find_if(previous.begin(), previous.end(), [&](const Source& old) { return old.tailer.path() == logPath; });
+            if (kept != previous.end()) source.tailer = std::move(kept->tailer);
+            else source.tailer.open(logPath);
+            source.protocolId = server->second;
+            list.push_back(std::move(source));
+        }
+        source = Source();
+        logPath.clear();
+    };
+    std::string line;
+    while (std::getline(file, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty() || line[0] == ';') continue;
+        if (line[0] == '[') {
+            finish();
+            inLog = line == "[log]";
+            continue;
+        }
+        size_t equals = line.find('=');
+        if (!inLog || equals == std::string::npos) continue;
+        std::string key = line.substr(0, equals);
+        std::string value = line.substr(equals + 1);
+        if (key == "server") source.server = value;
+        else if (key == "path") logPath = value;
+    }
+    finish();
+    return list.size();
+}
+
+void GameLogs::stamp(const std::string& path, uintmax_t& size, int64_t& time) {
+    namespace fs = std::filesystem;
+    std::error_code error;
+    bool exists = fs::is_regular_file(path, error);
+    size = exists ? fs::file_size(path, error) : 0;
+    time = exists ? static_cast<int64_t>(fs::last_write_time(path, error).time_since_epoch().count()) : 0;
+}
+
+bool GameLogs::changedOnDisk(const std::string& path) const {
+    uintmax_t size = 0;
+    int64_t time = 0;
+    stamp(path, size, time);
+    return size != fileSize || time != writeTime;
+}
+
+size_t GameLogs::poll(std::vector<Event>& out, size_t maxBytes) {
+    out.clear();
+    size_t count = 0;
+    for (size_t i = 0; i < list.size(); ++i) {
+        list[i].tailer.poll(lines, maxBytes);
+        count += lines.size();
+        LogEvent event;
+        for (std::string_view line : lines) {
+            if (LogParser::parse(list[i].protocolId, line, event)) out.push_back({ i, event });
+        }
+    }
+    return count;
+}
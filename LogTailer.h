@@ -0,0 +1,135 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Splits a byte stream into lines without copying them. Text is read straight into the buffer behind
+// what is left of the previous read, so every complete line is a view into one contiguous block and
+// only the unfinished last line is ever moved.
+class LineSplitter {
+public:
+    static const size_t kMaxLine = 64 * 1024; // Longer lines are cut into pieces of this size
+
+    // Room for n more bytes; write them there, then commit how many were written.
+    char* reserve(size_t n);
+    void commit(size_t n) { end += n; }
+    // Adds every complete line to out, without its '\n' or a '\r' before it. Views stay valid until the
+    // next reserve.
+    void split(std::vector<std::string_view>& out);
+    void reset() { begin = end = 0; }
+    size_t pending() const { return end - begin; } // Bytes of the unfinished line
+
+private:
+    std::vector<char> buffer;
+    size_t begin = 0;             // Unfinished line starts here
+    size_t end = 0;               // Committed bytes end here
+};
+
+enum class LogEventKind : uint8_t {
+    Join,
+    Quit,
+    Kill,
+    Damage,
+    Say,
+    SayTeam,
+    MapStart,
+    MapEnd
+};
+
+// One game log event. Views point into the line it was parsed from.
+struct LogEvent {
+    LogEventKind kind = LogEventKind::Join;
+    uint32_t timeSeconds = 0;     // Log clock: seconds since the server process started
+    std::string_view slot;        // The player joining, quitting, speaking or attacking; empty for the world
+    std::string_view name;
+    std::string_view guid;
+    std::string_view victimSlot;  // Kill and Damage
+    std::string_view victimName;
+    std::string_view victimGuid;
+    std::string_view weapon;
+    std::string_view text;        // Say and SayTeam: the message; MapStart: the serverinfo string
+};
+
+// Per-game log line parsers. Lines start with the "mmm:ss" log clock, which may be padded with spaces.
+class LogParser {
+public:
+    // Call of Duty games_mp.log: J;guid;slot;name, Q;..., K;victim guid;slot;team;name;attacker guid;
+    // slot;team;name;weapon;damage;means;hit location (D; for damage), say;guid;slot;name;text, sayteam;...,
+    // InitGame: and ExitLevel: / ShutdownGame:.
+    static bool parseCod(std::string_view line, LogEvent& event);
+    // Quake 3 style logs as Medal of Honor servers write them: ClientConnect: slot, ClientDisconnect: slot,
+    // Kill: a v m: A killed V by MOD, say: name: text, sayteam: ..., InitGame:, Exit: and ShutdownGame:.
+    static bool parseQuake(std::string_view line, LogEvent& event);
+    // By GameServerQuery protocol: 2 = Call of Duty, anything else Quake 3 style.
+    static bool parse(int protocolId, std::string_view line, LogEvent& event);
+};
+
+// Follows a log file as the server appends to it. The file is opened for each poll and closed again,
+// so the server can rotate it at any time. A file that got shorter was truncated and one whose first
+// bytes changed was replaced; both are read again from the start. Starts at the end of the file, so
+// only what is written after open is reported.
+class LogTailer {
+public:
+    static const size_t kFingerprintBytes = 256;
+
+    void open(const std::string& path, bool fromStart = false);
+    // Reads at most maxBytes of new text and adds the complete lines to out (cleared first). The views
+    // stay valid until the next poll. Returns the bytes read; 0 also while the file is missing.
+    size_t poll(std::vector<std::string_view>& out, size_t maxBytes);
+
+    const std::string& path() const { return file; }
+    uint64_t position() const { return offset; }
+    uint64_t truncations() const { return truncated; }
+    uint64_t rotations() const { return rotated; }
+
+private:
+    std::string file;
+    bool started = false;         // Initial position taken
+    bool fromStart = false;
+    uint64_t offset = 0;          // Next byte to read
+    uint64_t fingerprint = 0;     // Hash of the first fingerprintLength bytes
+    size_t fingerprintLength = 0;
+    uint64_t truncated = 0;
+    uint64_t rotated = 0;
+    LineSplitter splitter;
+};
+
+// Local log files of self-hosted servers, from an ini file of [log] sections with server= (the name in
+// servers.ini) and path=. Used from the UI thread only.
+class GameLogs {
+public:
+    struct Source {
+        std::string server;
+        int protocolId = 0;       // Picks the parser
+        LogTailer tailer;
+    };
+    // A parsed event and the index of its source.
+    struct Event {
+        size_t source;
+        LogEvent event;
+    };
+
+    // Replaces the logs with path's; servers maps each server name to its protocol. Logs of unknown
+    // servers are skipped and described in errors.
+    size_t load(const std::string& path, const std::vector<std::pair<std::string, int>>& servers,
+        std::vector<std::string>& errors);
+    // True if path was written since the last load.
+    bool changedOnDisk(const std::string& path) const;
+    void clear() { list.clear(); }
+    const std::vector<Source>& sources() const { return list; }
+
+    // Reads what every log gained, at most maxBytes each, and adds the events to out (cleared first).
+    // Views stay valid until the next poll. Returns the lines read.
+    size_t poll(std::vector<Event>& out, size_t maxBytes);
+
+private:
+    static void stamp(const std::string& path, uintmax_t& size, int64_t& time);
+
+    std::vector<Source> list;
+    std::vector<std::string_view> lines; // Scratch
+    uintmax_t fileSize = 0;
+    int64_t writeTime = 0;
+};
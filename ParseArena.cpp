@@ -0,0 +1,86 @@
+// --- xRcon\ParseArena.cpp ---
+// Implementation of the per-reply parse arena.
+// Hands out memory from large blocks and releases it all at once when the next snapshot replaces it.
+
+#include "ParseArena.h"
+#include "TextCodec.h"
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+ParseArena::ParseArena(size_t initialBytes) {
+    addBlock(initialBytes);
+}
+
+ParseArena::~ParseArena() {
+    freeBlocks();
+}
+
+// Bumps the cursor, chaining a larger block when the current one is full.
+void* ParseArena::allocate(size_t bytes, size_t alignment) {
+    uintptr_t at = (reinterpret_cast<uintptr_t>(cursor) + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1);
+    if (!cursor || at + bytes > reinterpret_cast<uintptr_t>(limit)) {
+        addBlock(bytes + alignment);
+        at = (reinterpret_cast<uintptr_t>(cursor) + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1);
+    }
+    char* result = reinterpret_cast<char*>(at);
+    used += static_cast<size_t>(result + bytes - cursor);
+    cursor = result + bytes;
+    return result;
+}
+
+std::string_view ParseArena::copy(std::string_view text) {
+    char* out = static_cast<char*>(allocate(text.size() + 1, 1));
+    if (!text.empty()) std::memcpy(out, text.data(), text.size());
+    out[text.size()] = '\0';
+    return std::string_view(out, text.size());
+}
+
+const wchar_t* ParseArena::widen(std::string_view text, ColorCodes colors) {
+    // Never more code units than input bytes, plus the terminator
+    wchar_t* out = allocateArray<wchar_t>(text.size() + 1);
+    TextCodec::toWide(text, out, colors);
+    return out;
+}
+
+// Keeps a single block as large as everything handed out since the last reset.
+void ParseArena::reset() {
+    ++resetCount;
+    if (head && head->next) {
+        size_t combined = total;
+        freeBlocks();
+        addBlock(combined);
+    }
+    else if (head) {
+        cursor = reinterpret_cast<char*>(head + 1);
+    }
+    used = 0;
+}
+
+void ParseArena::addBlock(size_t minimumBytes) {
+    size_t size = head ? head->size * 2 : 0;
+    if (size < minimumBytes) size = minimumBytes;
+    if (size < 1024) size = 1024;
+    Block* block = static_cast<Block*>(std::malloc(sizeof(Block) + size));
+    if (!block) {
+        throw std::bad_alloc();
+    }
+    block->next = head;
+    block->size = size;
+    head = block;
+    cursor = reinterpret_cast<char*>(block + 1);
+    limit = cursor + size;
+    total += size;
+    ++blockAllocations;
+}
+
+void ParseArena::freeBlocks() {
+    while (head) {
+        Block* next = head->next;
+        std::free(head);
+        head = next;
+    }
+    cursor = nullptr;
+    limit = nullptr;
+    total = 0;
+}
@@ -0,0 +1,78 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+#include "TextCodec.h"
+
+// Monotonic allocator for everything parsed out of one server reply (reply text, cvar and
+// player views, converted UI text). Nothing is freed individually; reset() releases it all
+// at once and keeps the memory, so a warmed-up arena makes no heap allocations per refresh.
+class ParseArena {
+public:
+    explicit ParseArena(size_t initialBytes = 16 * 1024);
+    ~ParseArena();
+    ParseArena(const ParseArena&) = delete;
+    ParseArena& operator=(const ParseArena&) = delete;
+
+    void* allocate(size_t bytes, size_t alignment = alignof(std::max_align_t));
+
+    // Uninitialized storage for count objects. Only trivially destructible types, since nothing is destroyed.
+    template <typename T>
+    T* allocateArray(size_t count) {
+        static_assert(std::is_trivially_destructible<T>::value, "ParseArena never runs destructors");
+        return static_cast<T*>(allocate(sizeof(T) * (count ? count : 1), alignof(T)));
+    }
+
+    // Copies text into the arena with a terminating null.
+    std::string_view copy(std::string_view text);
+    // Converts server text to a null-terminated wide string (UTF-16 on Windows) with TextCodec:
+    // UTF-8 where valid, Windows-1252 otherwise, optionally without ^N color codes.
+    const wchar_t* widen(std::string_view text, ColorCodes colors = ColorCodes::Keep);
+
+    // Releases every allocation. Blocks are merged into one of the combined size so the next cycle fits.
+    void reset();
+
+    size_t bytesUsed() const { return used; }
+    size_t capacity() const { return total; }
+    uint64_t heapAllocations() const { return blockAllocations; } // Lifetime count of block allocations
+    uint64_t resets() const { return resetCount; }
+
+private:
+    struct Block {
+        Block* next;
+        size_t size;
+    };
+
+    void addBlock(size_t minimumBytes);
+    void freeBlocks();
+
+    Block* head = nullptr;
+    char* cursor = nullptr;
+    char* limit = nullptr;
+    size_t used = 0;
+    size_t total = 0;
+    uint64_t blockAllocations = 0;
+    uint64_t resetCount = 0;
+};
+
+// Current and next snapshot arenas. A refresh parses into next(); publish() makes it current and
+// releases the snapshot it replaces in one reset.
+class ArenaPair {
+public:
+    // Returns the spare arena, emptied (a refresh that failed half way leaves nothing behind).
+    ParseArena& next() {
+        ParseArena& spare = arenas[active ^ 1];
+        spare.reset();
+        return spare;
+    }
+    ParseArena& current() { return arenas[active]; }
+    void publish() {
+        active ^= 1;
+        arenas[active ^ 1].reset();
+    }
+
+private:
+    ParseArena arenas[2];
+    int active = 0;
+};
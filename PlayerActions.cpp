@@ -0,0 +1,136 @@
+// --- xRcon\PlayerActions.cpp ---
+// Implementation of the optimistic player action tracker.
+// Pending actions are few and short-lived, so they are kept in one vector and scanned.
+
+#include "PlayerActions.h"
+#include <algorithm>
+
+ActionEffect PlayerActions::effectOf(std::string_view command) {
+    auto word = [&command]() {
+        size_t start = command.find_first_not_of(' ');
+        if (start == std::string_view::npos) return std::string_view();
+        size_t end = command.find(' ', start);
+        std::string_view result = command.substr(start, end == std::string_view::npos ? std::string_view::npos : end - start);
+        command.remove_prefix(end == std::string_view::npos ? command.size() : end);
+        return result;
+    };
+    std::string_view verb = word();
+    if (verb == "set") verb = word(); // MOHAA actions are cvars watched by a server-side script
+    if (verb == "clientkick" || verb == "kick" || verb == "banclient" || verb == "tempbanclient" ||
+        verb == "banuser" || verb == "tempbanuser") {
+        return ActionEffect::Removes;
+    }
+    if (verb == "namechange") return ActionEffect::Renames;
+    return ActionEffect::None;
+}
+
+void PlayerActions::applied(const std::string& server, std::string_view slot, std::string_view name,
+    std::string_view command, uint64_t clickMs, uint64_t sentMs) {
+    PlayerAction action;
+    action.server = server;
+    action.slot.assign(slot.data(), slot.size());
+    action.name.assign(name.data(), name.size());
+    action.command.assign(command.data(), command.size());
+    action.effect = effectOf(command);
+    action.clickMs = clickMs;
+    action.sentMs = sentMs;
+
+    ++counters.issued;
+    uint64_t commandMs = sentMs > clickMs ? sentMs - clickMs : 0;
+    counters.commandMsTotal += commandMs;
+    counters.commandMsMax = std::max(counters.commandMsMax, commandMs);
+    if (action.effect == ActionEffect::None) {
+        settle(action, ActionState::Confirmed, sentMs);
+        return;
+    }
+    // A second click on the same row replaces the first
+    for (PlayerAction& existing : pending) {
+        if (existing.server == action.server && existing.slot == action.slot) {
+            existing = std::move(action);
+            return;
+        }
+    }
+    pending.push_back(std::move(action));
+}
+
+const PlayerAction* PlayerActions::pendingFor(const std::string& server, const PlayerView& player) const {
+    for (const PlayerAction& action : pending) {
+        if (action.slot == player.slot && action.name == player.name && action.server == server) return &action;
+    }
+    return nullptr;
+}
+
+bool PlayerActions::hasPending(const std::string& server) const {
+    for (const PlayerAction& action : pending) {
+        if (action.server == server) return true;
+    }
+    return false;
+}
+
+bool PlayerActions::needsVerify(const std::string& server, uint64_t nowMs) const {
+    for (const PlayerAction& action : pending) {
+        if (action.server == server && nowMs >= action.sentMs + kSettleMs) return true;
+    }
+    return false;
+}
+
+void PlayerActions::settle(PlayerAction& action, ActionState state, uint64_t nowMs) {
+    action.state = state;
+    action.settledMs = nowMs;
+    if (state == ActionState::Confirmed) {
+        ++counters.confirmed;
+        uint64_t settleMs = nowMs > action.sentMs ? nowMs - action.sentMs : 0;
+        counters.settleMsTotal += settleMs;
+        counters.settleMsMax = std::max(counters.settleMsMax, settleMs);
+    }
+    else if (state == ActionState::RolledBack) {
+        ++counters.rolledBack;
+    }
+    else if (state == ActionState::Expired) {
+        ++counters.expired;
+    }
+}
+
+void PlayerActions::reconcile(const std::string& server, const PlayersView& players, uint64_t queriedMs, uint64_t nowMs,
+    std::vector<PlayerAction>& settled) {
+    for (size_t i = 0; i < pending.size();) {
+        PlayerAction& action = pending[i];
+        if (action.server != server || queriedMs < action.sentMs) {
+            ++i; // Another server, or a list queried before the command took effect
+            continue;
+        }
+        const PlayerView* row = nullptr;
+        for (size_t r = 0; r < players.count; ++r) {
+            if (players.rows[r].slot == action.slot) {
+                row = &players.rows[r];
+                break;
+            }
+        }
+        // Gone or renamed settles either effect; a player who left during a rename has nothing left to undo
+        bool unchanged = row && row->name == action.name;
+        if (!unchanged) {
+            settle(action, ActionState::Confirmed, nowMs);
+        }
+        else if (queriedMs >= action.sentMs + kSettleMs) {
+            settle(action, ActionState::RolledBack, nowMs);
+        }
+        else {
+            ++i;
+            continue;
+        }
+        settled.push_back(std::move(action));
+        pending.erase(pending.begin() + i);
+    }
+}
+
+void PlayerActions::expire(uint64_t nowMs, std::vector<PlayerAction>& settled) {
+    for (size_t i = 0; i < pending.size();) {
+        if (nowMs - pending[i].sentMs < kExpireMs) {
+            ++i;
+            continue;
+        }
+        settle(pending[i], ActionState::Expired, nowMs);
+        settled.push_back(std::move(pending[i]));
+        pending.erase(pending.begin() + i);
+    }
+}
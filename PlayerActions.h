@@ -0,0 +1,86 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "StatusParser.h"
+
+// What a player action is expected to do to the player list.
+enum class ActionEffect : uint8_t {
+    None,      // Nothing visible (unbind), settled as soon as the command succeeds
+    Removes,   // The player leaves the slot (kick, ban)
+    Renames,   // The player keeps the slot under another name (the server-side rename script)
+};
+
+enum class ActionState : uint8_t {
+    Pending,
+    Confirmed,  // A later player list shows the effect
+    RolledBack, // A player list taken after the grace period still shows the player unchanged
+    Expired,    // No player list arrived before the timeout; the row is shown again
+};
+
+// One player action applied optimistically to the displayed player list.
+struct PlayerAction {
+    std::string server;
+    std::string slot;
+    std::string name;            // Name in the slot when the action was sent
+    std::string command;         // For reporting
+    ActionEffect effect = ActionEffect::None;
+    ActionState state = ActionState::Pending;
+    uint64_t clickMs = 0;        // Confirmed by the admin
+    uint64_t sentMs = 0;         // Rcon reply received; later player lists can show the effect
+    uint64_t settledMs = 0;
+};
+
+// End-to-end cost of moderating: how long the admin waits for each action, and how long the
+// server takes to show it in a player list.
+struct ActionStats {
+    uint64_t issued = 0;
+    uint64_t confirmed = 0;
+    uint64_t rolledBack = 0;
+    uint64_t expired = 0;
+    uint64_t verifyQueries = 0;  // Refreshes requested only to check pending actions
+    uint64_t commandMsTotal = 0; // Click to rcon reply, which is when the table updates
+    uint64_t commandMsMax = 0;
+    uint64_t settleMsTotal = 0;  // Rcon reply to confirmation, over confirmed actions
+    uint64_t settleMsMax = 0;
+};
+
+// Tracks kick/ban/rename actions between the rcon reply and the player list that confirms them, so
+// the player table can show the expected result at once instead of waiting for a full re-query.
+// Used from the UI thread only.
+class PlayerActions {
+public:
+    static const uint32_t kSettleMs = 2000;  // A player list older than sentMs + kSettleMs may not show the effect yet
+    static const uint32_t kExpireMs = 15000; // Pending actions older than this are given up
+
+    static ActionEffect effectOf(std::string_view command);
+
+    // Records an action whose rcon command succeeded. Actions with no visible effect settle at once.
+    void applied(const std::string& server, std::string_view slot, std::string_view name,
+        std::string_view command, uint64_t clickMs, uint64_t sentMs);
+
+    // The pending action on a displayed row, or nullptr.
+    const PlayerAction* pendingFor(const std::string& server, const PlayerView& player) const;
+    bool hasPending(const std::string& server) const;
+    // True when a pending action on server is past its grace period, so the next player list settles it.
+    bool needsVerify(const std::string& server, uint64_t nowMs) const;
+    void verifying() { ++counters.verifyQueries; }
+
+    // Settles pending actions on server against a player list whose query started at queriedMs and
+    // arrived at nowMs. Settled actions are moved to settled.
+    void reconcile(const std::string& server, const PlayersView& players, uint64_t queriedMs, uint64_t nowMs,
+        std::vector<PlayerAction>& settled);
+    // Moves actions pending for longer than kExpireMs to settled.
+    void expire(uint64_t nowMs, std::vector<PlayerAction>& settled);
+
+    size_t pendingCount() const { return pending.size(); }
+    const ActionStats& stats() const { return counters; }
+
+private:
+    void settle(PlayerAction& action, ActionState state, uint64_t nowMs);
+
+    std::vector<PlayerAction> pending;
+    ActionStats counters;
+};
@@ -0,0 +1,359 @@
+// --- xRcon\PlayerIndex.cpp ---
+// Implementation of the fleet-wide player index.
+// Names are found through a sorted key list (prefixes) and a trigram index (substrings, fuzzy); addresses through a sorted IPv4 list.
+
+#include "PlayerIndex.h"
+#include "TextCodec.h"
+#include <algorithm>
+
+static char lowerAscii(char c) {
+    return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+// Distinct trigrams of text, sorted. padded adds a space on each side so short names and their ends count.
+static void trigramsOf(std::string_view text, bool padded, std::vector<uint32_t>& out) {
+    out.clear();
+    std::string buffer;
+    if (padded) {
+        buffer.reserve(text.size() + 2);
+        buffer.push_back(' ');
+        buffer.append(text.data(), text.size());
+        buffer.push_back(' ');
+        text = buffer;
+    }
+    for (size_t i = 0; i + 3 <= text.size(); ++i) {
+        out.push_back(static_cast<uint32_t>(static_cast<unsigned char>(text[i])) << 16 |
+            static_cast<uint32_t>(static_cast<unsigned char>(text[i + 1])) << 8 |
+            static_cast<unsigned char>(text[i + 2]));
+    }
+    std::sort(out.begin(), out.end());
+    out.erase(std::unique(out.begin(), out.end()), out.end());
+}
+
+// IPv4 from "a.b.c.d" or "a.b.c.d:port"; 0 for anything else (bots, loopback, IPv6).
+static uint32_t parseIpv4(std::string_view text, size_t& consumed) {
+    uint32_t ip = 0;
+    size_t pos = 0;
+    for (int part = 0; part < 4; ++part) {
+        if (part > 0) {
+            if (pos >= text.size() || text[pos] != '.') return 0;
+            ++pos;
+        }
+        size_t start = pos;
+        uint32_t value = 0;
+        while (pos < text.size() && text[pos] >= '0' && text[pos] <= '9' && pos - start < 3) {
+            value = value * 10 + static_cast<uint32_t>(text[pos++] - '0');
+        }
+        if (pos == start || value > 255) return 0;
+        ip = ip << 8 | value;
+    }
+    consumed = pos;
+    return ip;
+}
+
+std::string PlayerIndex::normalize(std::string_view name) {
+    std::string key(3 * name.size() + 1, '\0');
+    key.resize(TextCodec::toUtf8(name, &key[0], ColorCodes::Strip));
+    for (char& c : key) c = lowerAscii(c);
+    return key;
+}
+
+bool PlayerIndex::parseCidr(std::string_view text, uint32_t& base, uint32_t& mask) {
+    size_t consumed = 0;
+    uint32_t ip = parseIpv4(text, consumed);
+    if (consumed == 0) return false;
+    uint32_t bits = 32;
+    if (consumed < text.size()) {
+        if (text[consumed] == ':') {
+            // An address copied from the player table, port included
+        }
+        else if (text[consumed] == '/' && consumed + 1 < text.size() && text.size() - consumed <= 3) {
+            bits = 0;
+            for (size_t i = consumed + 1; i < text.size(); ++i) {
+                if (text[i] < '0' || text[i] > '9') return false;
+                bits = bits * 10 + static_cast<uint32_t>(text[i] - '0');
+            }
+            if (bits > 32) return false;
+        }
+        else {
+            return false;
+        }
+    }
+    mask = bits == 0 ? 0 : ~0u << (32 - bits);
+    base = ip & mask;
+    return true;
+}
+
+bool PlayerIndex::keyLess(uint32_t a, uint32_t b) const {
+    int order = players[a].key.compare(players[b].key);
+    return order != 0 ? order < 0 : a < b;
+}
+
+uint32_t PlayerIndex::add(const std::string& server, const PlayerView& row, uint64_t nowMs) {
+    uint32_t id;
+    if (!freeIds.empty()) {
+        id = freeIds.back();
+        freeIds.pop_back();
+    }
+    else {
+        id = static_cast<uint32_t>(players.size());
+        players.emplace_back();
+    }
+    IndexedPlayer& player = players[id];
+    player.server = server;
+    player.slot.assign(row.slot.data(), row.slot.size());
+    player.name.assign(row.name.data(), row.name.size());
+    player.key = normalize(row.name);
+    player.address.assign(row.address.data(), row.address.size());
+    player.guid.assign(row.guid.data(), row.guid.size());
+    for (char& c : player.guid) c = lowerAscii(c);
+    size_t consumed = 0;
+    player.ip = parseIpv4(row.address, consumed);
+    player.live = true;
+    player.joinedMs = nowMs;
+    ++liveCount;
+
+    byKey.insert(std::lower_bound(byKey.begin(), byKey.end(), id,
+        [this](uint32_t a, uint32_t b) { return keyLess(a, b); }), id);
+    if (player.ip) {
+        uint64_t entry = static_cast<uint64_t>(player.ip) << 32 | id;
+        byAddress.insert(std::lower_bound(byAddress.begin(), byAddress.end(), entry), entry);
+    }
+    std::vector<uint32_t> keyGrams;
+    trigramsOf(player.key, true, keyGrams);
+    player.grams = static_cast<uint16_t>(std::min<size_t>(keyGrams.size(), 0xFFFF));
+    for (uint32_t gram : keyGrams) grams[gram].push_back(id);
+    if (!player.guid.empty()) byGuid[player.guid].push_back(id);
+    return id;
+}
+
+// Removes id from an unordered posting list, dropping the list when it empties.
+template <typename Map, typename Key>
+static void unpost(Map& map, const Key& key, uint32_t id) {
+    auto it = map.find(key);
+    if (it == map.end()) return;
+    std::vector<uint32_t>& ids = it->second;
+    auto found = std::find(ids.begin(), ids.end(), id);
+    if (found != ids.end()) {
+        *found = ids.back();
+        ids.pop_back();
+    }
+    if (ids.empty()) map.erase(it);
+}
+
+void PlayerIndex::remove(uint32_t id, std::vector<IndexedPlayer>* left) {
+    IndexedPlayer& player = players[id];
+    if (left) left->push_back(player);
+    auto keyAt = std::lower_bound(byKey.begin(), byKey.end(), id,
+        [this](uint32_t a, uint32_t b) { return keyLess(a, b); });
+    if (keyAt != byKey.end() && *keyAt == id) byKey.erase(keyAt);
+    if (player.ip) {
+        uint64_t entry = static_cast<uint64_t>(player.ip) << 32 | id;
+        auto addressAt = std::lower_bound(byAddress.begin(), byAddress.end(), entry);
+        if (addressAt != byAddress.end() && *addressAt == entry) byAddress.erase(addressAt);
+    }
+    std::vector<uint32_t> keyGrams;
+    trigramsOf(player.key, true, keyGrams);
+    for (uint32_t gram : keyGrams) unpost(grams, gram, id);
+    if (!player.guid.empty()) unpost(byGuid, player.guid, id);
+
+    player.live = false;
+    player.server.clear();
+    player.name.clear();
+    player.key.clear();
+    freeIds.push_back(id);
+    --liveCount;
+}
+
+size_t PlayerIndex::update(const std::string& server, const PlayersView& rows, uint64_t nowMs,
+    std::vector<IndexedPlayer>* left, std::vector<uint32_t>* joined) {
+    auto it = byServer.find(server);
+    if (it == byServer.end()) {
+        if (rows.count == 0) return 0;
+        it = byServer.emplace(server, std::vector<uint32_t>()).first;
+    }
+    std::vector<uint32_t>& ids = it->second;
+
+    // Match rows to held entries by slot and name; a server holds a few dozen players at most
+    std::vector<char> kept(ids.size(), 0);
+    std::vector<uint32_t> next;
+    std::vector<size_t> added;
+    next.reserve(rows.count);
+    for (size_t r = 0; r < rows.count; ++r) {
+        const PlayerView& row = rows.rows[r];
+        size_t match = ids.size();
+        for (size_t i = 0; i < ids.size(); ++i) {
+            if (!kept[i] && players[ids[i]].slot == row.slot && players[ids[i]].name == row.name) {
+                match = i;
+                break;
+            }
+        }
+        if (match == ids.size()) {
+            added.push_back(r);
+            continue;
+        }
+        kept[match] = 1;
+        next.push_back(ids[match]);
+    }
+
+    size_t changes = 0;
+    for (size_t i = 0; i < ids.size(); ++i) {
+        if (kept[i]) continue;
+        remove(ids[i], left); // Left, or replaced in the slot
+        ++changes;
+    }
+    for (size_t r : added) {
+        next.push_back(add(server, rows.rows[r], nowMs));
+        if (joined) joined->push_back(next.back());
+        ++changes;
+    }
+    if (next.empty()) {
+        byServer.erase(it);
+    }
+    else {
+        ids.swap(next);
+    }
+    return changes;
+}
+
+void PlayerIndex::removeServer(const std::string& server, std::vector<IndexedPlayer>* left) {
+    auto it = byServer.find(server);
+    if (it == byServer.end()) return;
+    for (uint32_t id : it->second) remove(id, left);
+    byServer.erase(it);
+}
+
+void PlayerIndex::retain(const std::vector<std::string>& servers, std::vector<IndexedPlayer>* left) {
+    std::vector<std::string> gone;
+    for (const auto& entry : byServer) {
+        if (std::find(servers.begin(), servers.end(), entry.first) == servers.end()) gone.push_back(entry.first);
+    }
+    for (const std::string& server : gone) removeServer(server, left);
+}
+
+void PlayerIndex::clear(std::vector<IndexedPlayer>* left) {
+    if (left) {
+        for (const IndexedPlayer& player : players) {
+            if (player.live) left->push_back(player);
+        }
+    }
+    players.clear();
+    freeIds.clear();
+    liveCount = 0;
+    byServer.clear();
+    byKey.clear();
+    byAddress.clear();
+    grams.clear();
+    byGuid.clear();
+}
+
+void PlayerIndex::findPrefix(std::string_view text, size_t limit, std::vector<uint32_t>& out) const {
+    out.clear();
+    std::string prefix = normalize(text);
+    auto it = std::lower_bound(byKey.begin(), byKey.end(), prefix,
+        [this](uint32_t id, const std::string& value) { return players[id].key < value; });
+    for (; it != byKey.end() && out.size() < limit; ++it) {
+        if (players[*it].key.compare(0, prefix.size(), prefix) != 0) break;
+        out.push_back(*it);
+    }
+}
+
+void PlayerIndex::findSubstring(std::string_view text, size_t limit, std::vector<uint32_t>& out) const {
+    out.clear();
+    std::string needle = normalize(text);
+    if (needle.empty()) return;
+    if (needle.size() < 3) {
+        // Too short for a trigram; a scan over the keys is still well under a millisecond
+        for (uint32_t id : byKey) {
+            if (out.size() >= limit) break;
+            if (players[id].key.find(needle) != std::string::npos) out.push_back(id);
+        }
+        return;
+    }
+
+    // Candidates from the needle's rarest trigram, confirmed against the key
+    std::vector<uint32_t> needleGrams;
+    trigramsOf(needle, false, needleGrams);
+    const std::vector<uint32_t>* rarest = nullptr;
+    for (uint32_t gram : needleGrams) {
+        auto it = grams.find(gram);
+        if (it == grams.end()) return; // No name has it
+        if (!rarest || it->second.size() < rarest->size()) rarest = &it->second;
+    }
+    for (uint32_t id : *rarest) {
+        if (out.size() >= limit) break;
+        if (players[id].key.find(needle) != std::string::npos) out.push_back(id);
+    }
+}
+
+void PlayerIndex::findFuzzy(std::string_view text, size_t limit, std::vector<uint32_t>& out, double minScore) const {
+    out.clear();
+    std::vector<uint32_t> queryGrams;
+    trigramsOf(normalize(text), true, queryGrams);
+    if (queryGrams.empty()) return;
+    if (shared.size() < players.size()) shared.resize(players.size(), 0);
+
+    touched.clear();
+    for (uint32_t gram : queryGrams) {
+        auto it = grams.find(gram);
+        if (it == grams.end()) continue;
+        for (uint32_t id : it->second) {
+            if (shared[id]++ == 0) touched.push_back(id);
+        }
+    }
+    std::vector<std::pair<double, uint32_t>> scored;
+    for (uint32_t id : touched) {
+        double common = shared[id];
+        double score = common / (queryGrams.size() + players[id].grams - common);
+        shared[id] = 0;
+        if (score >= minScore) scored.emplace_back(score, id);
+    }
+    size_t top = std::min(limit, scored.size());
+    std::partial_sort(scored.begin(), scored.begin() + top, scored.end(),
+        [](const std::pair<double, uint32_t>& a, const std::pair<double, uint32_t>& b) {
+            return a.first != b.first ? a.first > b.first : a.second < b.second;
+        });
+    for (size_t i = 0; i < top; ++i) out.push_back(scored[i].second);
+}
+
+bool PlayerIndex::findAddress(std::string_view text, size_t limit, std::vector<uint32_t>& out) const {
+    out.clear();
+    uint32_t base = 0, mask = 0;
+    if (!parseCidr(text, base, mask)) return false;
+    uint64_t last = static_cast<uint64_t>(base | ~mask) << 32 | 0xFFFFFFFFull;
+    for (auto it = std::lower_bound(byAddress.begin(), byAddress.end(), static_cast<uint64_t>(base) << 32);
+        it != byAddress.end() && *it <= last && out.size() < limit; ++it) {
+        out.push_back(static_cast<uint32_t>(*it));
+    }
+    return true;
+}
+
+void PlayerIndex::findGuid(std::string_view guid, size_t limit, std::vector<uint32_t>& out) const {
+    out.clear();
+    std::string key(guid.data(), guid.size());
+    for (char& c : key) c = lowerAscii(c);
+    auto it = byGuid.find(key);
+    if (it == byGuid.end()) return;
+    for (uint32_t id : it->second) {
+        if (out.size() >= limit) break;
+        out.push_back(id);
+    }
+}
+
+void PlayerIndex::search(std::string_view query, size_t limit, std::vector<uint32_t>& out) const {
+    while (!query.empty() && query.front() == ' ') query.remove_prefix(1);
+    while (!query.empty() && query.back() == ' ') query.remove_suffix(1);
+    out.clear();
+    if (query.empty() || findAddress(query, limit, out)) return;
+    findGuid(query, limit, out);
+    if (!out.empty()) return;
+
+    findSubstring(query, limit, out);
+    if (out.size() >= limit) return;
+    std::vector<uint32_t> fuzzy;
+    findFuzzy(query, limit, fuzzy);
+    for (uint32_t id : fuzzy) {
+        if (out.size() >= limit) break;
+        if (std::find(out.begin(), out.end(), id) == out.end()) out.push_back(id);
+    }
+}
@@ -0,0 +1,73 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "StatusParser.h"
+
+// One online player as last polled.
+struct IndexedPlayer {
+    std::string server;
+    std::string slot;
+    std::string name;             // As reported, with color codes
+    std::string key;              // Color-stripped and lowercased; what name searches match
+    std::string address;
+    std::string guid;             // Lowercased, empty when the server does not report one
+    uint32_t ip = 0;              // IPv4 in host order, 0 when the address has none
+    uint16_t grams = 0;           // Distinct trigrams of the padded key
+    bool live = false;            // False while the id is on the free list
+    uint64_t joinedMs = 0;        // First poll that showed the player
+};
+
+// Who is online on every server, searchable by name, address and GUID. Fed with each server's player
+// list as polls arrive; only joins and leaves touch the lookup structures, so keeping it current
+// costs next to nothing between polls. Used from the UI thread only.
+class PlayerIndex {
+public:
+    // Brings server's players in line with players. A row whose slot and name are unchanged keeps its
+    // entry. Returns how many players joined or left; the ones that left are added to left and the ids
+    // of the ones that joined to joined, if given.
+    size_t update(const std::string& server, const PlayersView& players, uint64_t nowMs,
+        std::vector<IndexedPlayer>* left = nullptr, std::vector<uint32_t>* joined = nullptr);
+    void removeServer(const std::string& server, std::vector<IndexedPlayer>* left = nullptr);
+    // Drops servers that are no longer in the list.
+    void retain(const std::vector<std::string>& servers, std::vector<IndexedPlayer>* left = nullptr);
+    void clear(std::vector<IndexedPlayer>* left = nullptr);
+
+    // Each search replaces out with at most limit ids for player().
+    void findPrefix(std::string_view text, size_t limit, std::vector<uint32_t>& out) const;
+    void findSubstring(std::string_view text, size_t limit, std::vector<uint32_t>& out) const;
+    // Names sharing the most trigrams with text, best first, down to a Jaccard similarity of minScore.
+    void findFuzzy(std::string_view text, size_t limit, std::vector<uint32_t>& out, double minScore = 0.2) const;
+    // "a.b.c.d" or "a.b.c.d/bits". Returns false if text is neither.
+    bool findAddress(std::string_view text, size_t limit, std::vector<uint32_t>& out) const;
+    void findGuid(std::string_view guid, size_t limit, std::vector<uint32_t>& out) const;
+    // What the search box does: an address or CIDR range, else a GUID, else substring matches on the
+    // name topped up with fuzzy ones.
+    void search(std::string_view query, size_t limit, std::vector<uint32_t>& out) const;
+
+    const IndexedPlayer& player(uint32_t id) const { return players[id]; }
+    size_t size() const { return liveCount; }
+    uint32_t idLimit() const { return static_cast<uint32_t>(players.size()); } // Ids below it may be live
+
+    static std::string normalize(std::string_view name);
+    static bool parseCidr(std::string_view text, uint32_t& base, uint32_t& mask);
+
+private:
+    uint32_t add(const std::string& server, const PlayerView& row, uint64_t nowMs);
+    void remove(uint32_t id, std::vector<IndexedPlayer>* left);
+    bool keyLess(uint32_t a, uint32_t b) const;
+
+    std::vector<IndexedPlayer> players;                         // By id
+    std::vector<uint32_t> freeIds;
+    size_t liveCount = 0;
+    std::unordered_map<std::string, std::vector<uint32_t>> byServer;
+    std::vector<uint32_t> byKey;                                // Ids sorted by key, for prefixes
+    std::vector<uint64_t> byAddress;                            // ip << 32 | id, sorted
+    std::unordered_map<uint32_t, std::vector<uint32_t>> grams;  // Trigram -> ids
+    std::unordered_map<std::string, std::vector<uint32_t>> byGuid;
+    mutable std::vector<uint16_t> shared;                       // Fuzzy search scratch, by id
+    mutable std::vector<uint32_t> touched;
+};
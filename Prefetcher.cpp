@@ -0,0 +1,91 @@
+// --- xRcon\Prefetcher.cpp ---
+// Implementation of the prefetch planner.
+// Candidates are ranked by kind, deduplicated with per-index epoch marks, and cut off when the token bucket runs dry.
+
+#include "Prefetcher.h"
+#include <algorithm>
+
+Prefetcher::Prefetcher() {
+    available = budget.burst;
+}
+
+void Prefetcher::setBudget(const Budget& value) {
+    budget = value;
+    available = std::min(available, static_cast<double>(budget.burst));
+}
+
+void Prefetcher::resize(size_t serverCount) {
+    openCount.resize(serverCount, 0);
+    marks.resize(serverCount, 0);
+    recentList.erase(std::remove_if(recentList.begin(), recentList.end(),
+        [serverCount](uint32_t index) { return index >= serverCount; }), recentList.end());
+}
+
+void Prefetcher::opened(uint32_t index) {
+    if (index >= openCount.size()) return;
+    ++openCount[index];
+    auto it = std::find(recentList.begin(), recentList.end(), index);
+    if (it != recentList.end()) recentList.erase(it);
+    recentList.insert(recentList.begin(), index);
+    if (recentList.size() > kRecentCapacity) recentList.pop_back();
+}
+
+void Prefetcher::refill(uint64_t nowMs) {
+    if (!started) {
+        started = true;
+        lastRefillMs = nowMs;
+        return;
+    }
+    if (nowMs <= lastRefillMs) return;
+    available += static_cast<double>(nowMs - lastRefillMs) * budget.queriesPerMinute / 60000.0;
+    available = std::min(available, static_cast<double>(budget.burst));
+    lastRefillMs = nowMs;
+}
+
+// Adds index unless it is the selection, already planned, warm, or unaffordable. Returns false once the budget is spent.
+bool Prefetcher::consider(uint32_t index, uint32_t current, const std::function<bool(uint32_t)>& isWarm, std::vector<uint32_t>& out) {
+    if (available < kQueriesPerServer) return false;
+    if (index >= marks.size() || index == current || marks[index] == planEpoch) return true;
+    marks[index] = planEpoch;
+    if (isWarm && isWarm(index)) return true;
+    available -= kQueriesPerServer;
+    out.push_back(index);
+    return true;
+}
+
+size_t Prefetcher::plan(uint32_t current, uint64_t nowMs, const std::function<bool(uint32_t)>& isWarm, std::vector<uint32_t>& out) {
+    refill(nowMs);
+    size_t before = out.size();
+    size_t count = marks.size();
+    if (count == 0) return 0;
+    if (++planEpoch == 0) {
+        std::fill(marks.begin(), marks.end(), 0); // Epoch wrapped
+        planEpoch = 1;
+    }
+
+    // Adjacent entries, nearest first, alternating below and above (the usual scrolling direction is down)
+    for (uint32_t distance = 1; distance <= budget.neighbors; ++distance) {
+        if (current + distance < count && !consider(current + distance, current, isWarm, out)) return out.size() - before;
+        if (current >= distance && !consider(current - distance, current, isWarm, out)) return out.size() - before;
+    }
+
+    uint32_t taken = 0;
+    for (uint32_t index : recentList) {
+        if (index == current) continue;
+        if (taken++ >= budget.recent) break;
+        if (!consider(index, current, isWarm, out)) return out.size() - before;
+    }
+
+    // Most opened servers; only ones opened at least twice say anything about habits
+    ranked.clear();
+    for (uint32_t index = 0; index < count; ++index) {
+        if (openCount[index] >= 2 && index != current) ranked.push_back(index);
+    }
+    size_t top = std::min<size_t>(budget.frequent, ranked.size());
+    std::partial_sort(ranked.begin(), ranked.begin() + top, ranked.end(),
+        [this](uint32_t a, uint32_t b) { return openCount[a] != openCount[b] ? openCount[a] > openCount[b] : a < b; });
+    for (size_t i = 0; i < top; ++i) {
+        if (!consider(ranked[i], current, isWarm, out)) break;
+    }
+    return out.size() - before;
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// Picks which servers to query ahead of the admin opening them: the combo entries next to the
+// selection, then recently opened, then frequently opened servers. Servers are the selector's
+// indices. Queries are paid from a token bucket so prefetching never exceeds its budget.
+class Prefetcher {
+public:
+    struct Budget {
+        uint32_t queriesPerMinute = 20;  // Sustained prefetch rate; each server costs kQueriesPerServer
+        uint32_t burst = 8;              // Queries that may be spent at once after a quiet spell
+        uint32_t freshMs = 30000;        // Snapshots younger than this are not fetched again
+        uint32_t neighbors = 1;          // Entries on each side of the selection
+        uint32_t recent = 3;
+        uint32_t frequent = 3;
+    };
+
+    static const uint32_t kQueriesPerServer = 2; // getstatus and rcon status
+
+    Prefetcher();
+
+    void setBudget(const Budget& value);
+    const Budget& getBudget() const { return budget; }
+
+    // Sizes the history for serverCount servers, keeping it for indices that still exist.
+    void resize(size_t serverCount);
+    // Records that the admin opened index.
+    void opened(uint32_t index);
+
+    // Appends the servers worth prefetching around current, best first, and charges the budget for
+    // them. isWarm says which servers already have a fresh enough snapshot.
+    size_t plan(uint32_t current, uint64_t nowMs, const std::function<bool(uint32_t)>& isWarm, std::vector<uint32_t>& out);
+
+    double tokens() const { return available; }
+
+private:
+    void refill(uint64_t nowMs);
+    bool consider(uint32_t index, uint32_t current, const std::function<bool(uint32_t)>& isWarm, std::vector<uint32_t>& out);
+
+    static const size_t kRecentCapacity = 8;
+
+    Budget budget;
+    double available = 0;
+    uint64_t lastRefillMs = 0;
+    bool started = false;
+    std::vector<uint32_t> openCount;  // Per index
+    std::vector<uint32_t> recentList; // Most recent first
+    std::vector<uint32_t> marks;      // Per index: planEpoch when already considered this plan
+    std::vector<uint32_t> ranked;     // Scratch for the frequency ranking
+    uint32_t planEpoch = 0;
+};
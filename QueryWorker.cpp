@@ -0,0 +1,111 @@
+// --- xRcon\QueryWorker.cpp ---
+// Implementation of the background query thread and its cancellation.
+// Cancelled work is freed when it is cancelled, not when the thread would have reached it.
+
+#include "QueryWorker.h"
+#include <chrono>
+#include <utility>
+
+QueryWorker::~QueryWorker() {
+    shutdown();
+}
+
+void QueryWorker::shutdown() {
+    std::deque<Job> abandoned;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+        if (current) current->store(true, std::memory_order_release);
+        for (Job& job : jobs) job.token.state->store(true, std::memory_order_release);
+        abandoned.swap(jobs);
+    }
+    wake.notify_all();
+    if (thread.joinable()) thread.join();
+}
+
+void QueryWorker::submit(const CancelToken& token, Task task) {
+    enqueue(token, std::move(task), false);
+}
+
+void QueryWorker::submitFirst(const CancelToken& token, Task task) {
+    enqueue(token, std::move(task), true);
+}
+
+void QueryWorker::enqueue(const CancelToken& token, Task task, bool first) {
+    if (token.cancelled()) {
+        skipped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (stopping) return;
+        if (first) jobs.push_front(Job{ token, std::move(task) });
+        else jobs.push_back(Job{ token, std::move(task) });
+        if (!thread.joinable()) thread = std::thread(&QueryWorker::run, this);
+    }
+    wake.notify_all();
+}
+
+void QueryWorker::cancel(const CancelToken& token) {
+    std::deque<Job> abandoned; // Destroyed outside the lock: captured servers and buffers go here
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        token.state->store(true, std::memory_order_release);
+        for (auto it = jobs.begin(); it != jobs.end();) {
+            if (it->token.state == token.state) {
+                abandoned.push_back(std::move(*it));
+                it = jobs.erase(it);
+            }
+            else {
+                ++it;
+            }
+        }
+        skipped.fetch_add(abandoned.size(), std::memory_order_relaxed);
+    }
+    wake.notify_all();
+    idle.notify_all();
+}
+
+bool QueryWorker::sleepFor(const CancelToken& token, uint32_t ms) {
+    std::unique_lock<std::mutex> lock(mutex);
+    wake.wait_for(lock, std::chrono::milliseconds(ms), [&] { return stopping || token.cancelled(); });
+    return !token.cancelled();
+}
+
+void QueryWorker::waitIdle() {
+    std::unique_lock<std::mutex> lock(mutex);
+    idle.wait(lock, [this] { return jobs.empty() && !running; });
+}
+
+size_t QueryWorker::queued() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return jobs.size();
+}
+
+void QueryWorker::run() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wake.wait(lock, [this] { return stopping || !jobs.empty(); });
+        if (jobs.empty()) return; // Stopping with nothing left
+        {
+            Job job = std::move(jobs.front());
+            jobs.pop_front();
+            running = true;
+            current = job.token.state;
+            lock.unlock();
+
+            if (job.token.cancelled()) {
+                skipped.fetch_add(1, std::memory_order_relaxed);
+            }
+            else {
+                job.task(job.token);
+                ran.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        lock.lock();
+        running = false;
+        current.reset();
+        if (jobs.empty()) idle.notify_all();
+    }
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+// Cancellation flag shared by a piece of queued work and whoever may abandon it. Copies share the flag.
+class CancelToken {
+public:
+    CancelToken() : state(std::make_shared<std::atomic<bool>>(false)) {}
+    bool cancelled() const { return state->load(std::memory_order_acquire); }
+
+private:
+    friend class QueryWorker;
+    std::shared_ptr<std::atomic<bool>> state;
+};
+
+// One background thread that runs queries in submission order, so blocking GameServerQuery calls stay
+// off the UI thread. Work cancelled before it starts is removed from the queue without running, and a
+// running task sees the cancellation at its next cancelled() or sleepFor() check.
+class QueryWorker {
+public:
+    using Task = std::function<void(const CancelToken&)>;
+
+    QueryWorker() = default;
+    ~QueryWorker();               // shutdown()
+    QueryWorker(const QueryWorker&) = delete;
+    QueryWorker& operator=(const QueryWorker&) = delete;
+
+    // The thread starts with the first submission.
+    void submit(const CancelToken& token, Task task);
+    // Queues task ahead of everything already waiting, for work the admin is waiting on.
+    void submitFirst(const CancelToken& token, Task task);
+    // Marks token cancelled, frees queued work that carries it and wakes a task sleeping on it.
+    void cancel(const CancelToken& token);
+    // Waits up to ms on the worker thread. Returns false as soon as token is cancelled.
+    bool sleepFor(const CancelToken& token, uint32_t ms);
+    // Blocks until the queue is empty and no task is running.
+    void waitIdle();
+    // Cancels everything queued and the running task, waits for it to return and takes no more work.
+    void shutdown();
+
+    size_t queued() const;
+    uint64_t executed() const { return ran.load(std::memory_order_relaxed); }
+    uint64_t dropped() const { return skipped.load(std::memory_order_relaxed); }
+
+private:
+    struct Job {
+        CancelToken token;
+        Task task;
+    };
+
+    void enqueue(const CancelToken& token, Task task, bool first);
+    void run();
+
+    mutable std::mutex mutex;
+    std::condition_variable wake;  // New work, a cancellation, or shutdown
+    std::condition_variable idle;
+    std::deque<Job> jobs;
+    std::thread thread;
+    std::shared_ptr<std::atomic<bool>> current; // Token of the running task, cancelled on shutdown
+    bool running = false;         // A task is executing
+    bool stopping = false;
+    std::atomic<uint64_t> ran{ 0 };
+    std::atomic<uint64_t> skipped{ 0 };
+};
@@ -0,0 +1,227 @@
+// --- xRcon\RconBatch.cpp ---
+// Implementation of pipelined batch commands.
+// Every server paces its own commands; one socket and one poll loop serve all of them.
+
+#include "RconBatch.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+static uint64_t batchNowMs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+bool RconBatch::add(const Server& server, std::string_view slot, std::string_view name, std::string_view verb) {
+    RconCommand command(verb);
+    command.arg(slot);
+    return add(server, command, slot, name);
+}
+
+bool RconBatch::add(const Server& server, const RconCommand& command, std::string_view slot, std::string_view name) {
+    if (!command.valid() || command.empty()) {
+        return false;
+    }
+    uint32_t target = 0;
+    while (target < targets.size() && targets[target].server.name != server.name) ++target;
+    if (target == targets.size()) {
+        targets.emplace_back();
+        targets.back().server = server;
+    }
+    BatchItem item;
+    item.target = target;
+    item.slot.assign(slot.data(), slot.size());
+    item.name.assign(name.data(), name.size());
+    item.command.assign(command.c_str(), command.size());
+    targets[target].order.push_back(static_cast<uint32_t>(items.size()));
+    items.push_back(std::move(item));
+    ++remaining;
+    return true;
+}
+
+void RconBatch::clear() {
+    targets.clear();
+    items.clear();
+    remaining = 0;
+}
+
+void RconBatch::finish(BatchItem& item, bool replied, std::string_view reply, uint64_t nowMs) {
+    if (item.done) return;
+    item.done = true;
+    item.replied = replied;
+    item.reply.assign(reply.data(), reply.size());
+    item.replyMs = nowMs;
+    --remaining;
+}
+
+static const char* const kUnreliable = "Unreliable, an earlier reply was lost: ";
+
+void RconBatch::finishReply(Target& target, uint32_t index, std::string_view reply, uint64_t nowMs) {
+    if (index >= target.trustFrom) {
+        finish(items[index], true, reply, nowMs);
+        return;
+    }
+    std::string text = kUnreliable;
+    text.append(reply.data(), reply.size());
+    finish(items[index], false, text, nowMs);
+}
+
+// A lost reply shifts the ones after it onto the wrong commands, so nothing answered while it was
+// outstanding can be trusted: neither what already came nor what the window still waits for.
+void RconBatch::distrust(Target& target, uint32_t lost) {
+    uint64_t sentMs = items[lost].sentMs;
+    for (uint32_t index : target.order) {
+        BatchItem& item = items[index];
+        if (item.done && item.replied && item.replyMs >= sentMs) {
+            item.replied = false;
+            item.reply.insert(0, kUnreliable);
+        }
+    }
+    target.trustFrom = target.order[target.nextSend - 1] + 1;
+}
+
+void RconBatch::begin(uint64_t nowMs) {
+    for (Target& target : targets) {
+        const Server& server = target.server;
+        const char* failure = nullptr;
+        if (server.rconPassword.empty()) failure = "No rcon password set";
+        else if (!target.header.setHeader(server.protocolId, server.rconPassword)) failure = "Rcon password cannot be sent";
+        else if (server.port <= 0 || server.port > 65535 ||
+            !UdpSocket::resolve(server.ipOrHostname, static_cast<uint16_t>(server.port), target.endpoint)) {
+            failure = "Cannot resolve server address";
+        }
+        target.usable = failure == nullptr;
+        target.tokens = pacing.burst;
+        target.refillMs = nowMs;
+        if (!failure) continue;
+        for (uint32_t index : target.order) finish(items[index], false, failure, nowMs);
+        target.nextSend = target.order.size();
+    }
+}
+
+uint32_t RconBatch::pump(UdpSocket& socket, uint64_t nowMs) {
+    uint64_t wakeMs = UINT64_MAX;
+    for (Target& target : targets) {
+        if (!target.usable) continue;
+        while (!target.inFlight.empty()) {
+            BatchItem& front = items[target.inFlight.front()];
+            if (pacing.quietMs > 0 && front.replyMs != 0) {
+                // Collecting a split reply: it is complete once the server has gone quiet
+                if (nowMs - front.replyMs < pacing.quietMs) break;
+                std::string reply = std::move(front.reply);
+                while (!reply.empty() && (reply.back() == '\n' || reply.back() == '\0')) reply.pop_back();
+                finishReply(target, target.inFlight.front(), reply, front.replyMs);
+            }
+            else if (nowMs - front.sentMs >= pacing.replyTimeoutMs) {
+                finish(front, false, "No reply", nowMs);
+                distrust(target, target.inFlight.front());
+            }
+            else {
+                break;
+            }
+            target.inFlight.pop_front();
+        }
+        if (nowMs > target.refillMs) {
+            target.tokens = std::min(static_cast<double>(pacing.burst),
+                target.tokens + (nowMs - target.refillMs) * pacing.perSecond / 1000.0);
+            target.refillMs = nowMs;
+        }
+
+        while (target.nextSend < target.order.size() && target.tokens >= 1.0 && target.inFlight.size() < pacing.window) {
+            BatchItem& item = items[target.order[target.nextSend++]];
+            RconCommand command(item.command);
+            if (target.header.send(socket, target.endpoint, command) < 0) {
+                finish(item, false, "Send failed", nowMs);
+                continue;
+            }
+            item.sent = true;
+            item.sentMs = nowMs;
+            target.tokens -= 1.0;
+            target.inFlight.push_back(target.order[target.nextSend - 1]);
+        }
+
+        if (!target.inFlight.empty()) {
+            const BatchItem& front = items[target.inFlight.front()];
+            wakeMs = std::min(wakeMs, pacing.quietMs > 0 && front.replyMs != 0 ? front.replyMs + pacing.quietMs
+                : front.sentMs + pacing.replyTimeoutMs);
+        }
+        if (target.nextSend < target.order.size() && target.inFlight.size() < pacing.window && pacing.perSecond > 0) {
+            uint64_t refillIn = static_cast<uint64_t>((1.0 - target.tokens) * 1000.0 / pacing.perSecond) + 1;
+            wakeMs = std::min(wakeMs, nowMs + refillIn);
+        }
+    }
+    if (wakeMs == UINT64_MAX) return pacing.replyTimeoutMs;
+    return wakeMs > nowMs ? static_cast<uint32_t>(std::min<uint64_t>(wakeMs - nowMs, pacing.replyTimeoutMs)) : 0;
+}
+
+void RconBatch::onDatagram(const UdpEndpoint& from, const char* data, size_t length, uint64_t nowMs) {
+    if (length < 5 || std::memcmp(data, "\xff\xff\xff\xff", 4) != 0) return;
+    size_t pos = 4;
+    if (data[pos] == '\x01') ++pos; // MOHAA server direction byte
+    if (length - pos < 5 || std::memcmp(data + pos, "print", 5) != 0) return;
+    pos += 5;
+    if (pos < length && data[pos] == '\n') ++pos;
+    std::string_view text(data + pos, length - pos);
+
+    for (Target& target : targets) {
+        if (!target.usable || !(target.endpoint == from)) continue;
+        if (target.inFlight.empty()) return; // A reply that already timed out
+        BatchItem& item = items[target.inFlight.front()];
+        if (pacing.quietMs > 0) {
+            // Split output carries on where the previous packet stopped; pump finishes it
+            while (!text.empty() && text.back() == '\0') text.remove_suffix(1);
+            item.reply.append(text.data(), text.size());
+            item.replyMs = nowMs;
+            return;
+        }
+        while (!text.empty() && (text.back() == '\n' || text.back() == '\0')) text.remove_suffix(1);
+        finishReply(target, target.inFlight.front(), text, nowMs);
+        target.inFlight.pop_front();
+        return;
+    }
+}
+
+void RconBatch::abandon(const char* reason) {
+    uint64_t now = batchNowMs();
+    for (BatchItem& item : items) {
+        // A sent command may still have been carried out
+        finish(item, false, item.sent ? "No reply before the batch was cancelled" : reason, now);
+    }
+    for (Target& target : targets) {
+        target.inFlight.clear();
+        target.nextSend = target.order.size();
+    }
+}
+
+void RconBatch::run(const std::function<bool()>& cancelled) {
+    if (finished()) return;
+    UdpSocket::startup();
+    {
+        UdpSocket socket;
+        if (!socket.open(0, 0)) {
+            abandon("Cannot open a UDP socket");
+        }
+        else {
+            begin(batchNowMs());
+            UdpPoller poller;
+            poller.add(socket);
+            std::vector<size_t> ready;
+            char buffer[2048];
+            while (!finished()) {
+                if (cancelled && cancelled()) {
+                    abandon("Cancelled");
+                    break;
+                }
+                uint32_t waitMs = pump(socket, batchNowMs());
+                if (finished()) break;
+                poller.wait(static_cast<int>(std::min<uint32_t>(waitMs, 50)), ready); // Short waits keep cancellation prompt
+                UdpEndpoint from;
+                int received;
+                while ((received = socket.receiveFrom(buffer, sizeof(buffer), from)) > 0) {
+                    onDatagram(from, buffer, static_cast<size_t>(received), batchNowMs());
+                }
+            }
+        }
+    }
+    UdpSocket::cleanup();
+}
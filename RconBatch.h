@@ -0,0 +1,98 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "ServerManager.h"
+#include "RconPacket.h"
+#include "UdpSocket.h"
+
+// One command of a batch and what became of it.
+struct BatchItem {
+    uint32_t target = 0;          // Index into the batch's servers
+    std::string slot;
+    std::string name;             // Player in the slot when the batch was built
+    std::string command;          // Without the "rcon <password>" prefix
+    bool done = false;
+    bool sent = false;
+    bool replied = false;
+    std::string reply;            // Print text, or why there is none
+    uint64_t sentMs = 0;
+    uint64_t replyMs = 0;
+};
+
+// Player commands for one or more servers, sent from a single socket and paced by a per-server token
+// bucket so the server's rcon flood protection does not drop them. Rcon replies carry nothing that
+// names their command, so they are matched in send order per server: one packet each, or every packet
+// until a quiet gap with Pacing::quietMs. With the default window of one command per server a lost
+// reply is reported as such; with a wider window it would shift the replies after it onto the wrong
+// commands, so when one times out every reply received while it was outstanding is reported as
+// unreliable. A reply that comes after its timeout can still be taken for the next command's, so
+// replyTimeoutMs stays well above the round trip. Commands are never resent, because resending a kick
+// could hit whoever took the slot since.
+class RconBatch {
+public:
+    struct Pacing {
+        uint32_t burst = 3;           // Commands a server takes back to back
+        uint32_t perSecond = 2;       // Sustained rate per server after the burst, under the usual flood limit
+        uint32_t window = 1;          // Commands awaiting a reply per server
+        uint32_t replyTimeoutMs = 2000;
+        uint32_t quietMs = 0;         // 0: each reply packet answers one command. Otherwise a command's
+                                      // reply is every packet until none came for quietMs, for output
+                                      // the server splits; keep window at 1
+    };
+
+    // Adds "verb slot" for server. Returns false (and adds nothing) if the slot is not a plain token.
+    bool add(const Server& server, std::string_view slot, std::string_view name, std::string_view verb);
+    // Adds a finished command; slot and name say which player it is about, if any.
+    bool add(const Server& server, const RconCommand& command, std::string_view slot, std::string_view name);
+    void clear();
+    bool empty() const { return items.empty(); }
+    size_t size() const { return items.size(); }
+    size_t serverCount() const { return targets.size(); }
+    const Server& server(uint32_t target) const { return targets[target].server; }
+    const std::vector<BatchItem>& results() const { return items; }
+
+    void setPacing(const Pacing& value) { pacing = value; }
+    const Pacing& getPacing() const { return pacing; }
+
+    // Runs the whole batch on its own socket, blocking until every command is answered, timed out or
+    // cancelled. For the query worker.
+    void run(const std::function<bool()>& cancelled);
+
+    // The same as steps, for callers that own the socket and the clock. begin resolves the servers;
+    // commands for servers that cannot be resolved or lack an rcon password finish at once.
+    void begin(uint64_t nowMs);
+    // Sends what the pacing allows and times out missing replies. Returns ms until the next send or timeout.
+    uint32_t pump(UdpSocket& socket, uint64_t nowMs);
+    void onDatagram(const UdpEndpoint& from, const char* data, size_t length, uint64_t nowMs);
+    // Finishes every unfinished command with reason.
+    void abandon(const char* reason);
+    bool finished() const { return remaining == 0; }
+
+private:
+    struct Target {
+        Server server;
+        UdpEndpoint endpoint;
+        RconPacket header;
+        bool usable = false;
+        double tokens = 0;
+        uint64_t refillMs = 0;
+        std::vector<uint32_t> order;  // Items for this server in add order
+        size_t nextSend = 0;          // Into order
+        std::deque<uint32_t> inFlight;
+        uint32_t trustFrom = 0;       // Replies to items below this index were in flight with a lost one
+    };
+
+    void finish(BatchItem& item, bool replied, std::string_view reply, uint64_t nowMs);
+    void finishReply(Target& target, uint32_t index, std::string_view reply, uint64_t nowMs);
+    void distrust(Target& target, uint32_t lost);
+
+    Pacing pacing;
+    std::vector<Target> targets;
+    std::vector<BatchItem> items;
+    size_t remaining = 0;
+};
@@ -0,0 +1,115 @@
+// --- xRcon\RconPacket.cpp ---
+// Implementation of the in-place rcon command and datagram builders.
+// Keeps user-supplied values inside their argument and every line within the engine's limit.
+
+#include "RconPacket.h"
+#include <charconv>
+#include <cstring>
+
+static bool isControl(char c) {
+    return static_cast<unsigned char>(c) < 0x20 || c == 0x7F;
+}
+
+bool RconCommand::reserve(size_t extra) {
+    if (!ok || extra > kMaxRconLine - length) {
+        ok = false;
+        return false;
+    }
+    return true;
+}
+
+RconCommand& RconCommand::raw(std::string_view chars) {
+    if (!reserve(chars.size())) return *this;
+    std::memcpy(text + length, chars.data(), chars.size());
+    length += chars.size();
+    text[length] = '\0';
+    return *this;
+}
+
+RconCommand& RconCommand::arg(std::string_view token) {
+    if (token.empty()) {
+        ok = false;
+        return *this;
+    }
+    for (char c : token) {
+        if (c == ' ' || c == ';' || c == '"' || isControl(c)) {
+            ok = false;
+            return *this;
+        }
+    }
+    if (!reserve(token.size() + 1)) return *this;
+    text[length++] = ' ';
+    std::memcpy(text + length, token.data(), token.size());
+    length += token.size();
+    text[length] = '\0';
+    return *this;
+}
+
+RconCommand& RconCommand::arg(long long value) {
+    char digits[24];
+    std::to_chars_result result = std::to_chars(digits, digits + sizeof(digits), value);
+    return arg(std::string_view(digits, static_cast<size_t>(result.ptr - digits)));
+}
+
+RconCommand& RconCommand::quoted(std::string_view value) {
+    if (!reserve(3)) return *this; // Space and both quotes
+    size_t start = length;
+    text[length++] = ' ';
+    text[length++] = '"';
+    for (char c : value) {
+        if (c == '"' || isControl(c)) continue;
+        if (length + 1 >= kMaxRconLine) {
+            length = start;
+            text[length] = '\0';
+            ok = false;
+            return *this;
+        }
+        text[length++] = c;
+    }
+    text[length++] = '"';
+    text[length] = '\0';
+    return *this;
+}
+
+bool RconPacket::setHeader(int protocolId, std::string_view password) {
+    headLength = 0;
+    prefixLength = 0;
+    // "rcon " + quoted password + " " + at least one command character
+    if (password.size() + 5 + 2 + 1 + 1 > kMaxRconLine) return false;
+    bool needsQuotes = password.empty();
+    for (char c : password) {
+        if (c == '"' || isControl(c)) return false;
+        if (c == ' ' || c == ';') needsQuotes = true;
+    }
+    std::memcpy(head, "\xff\xff\xff\xff", 4);
+    size_t at = 4;
+    if (protocolId == 1) head[at++] = '\x02';
+    prefixLength = at;
+    std::memcpy(head + at, "rcon ", 5);
+    at += 5;
+    if (needsQuotes) head[at++] = '"';
+    std::memcpy(head + at, password.data(), password.size());
+    at += password.size();
+    if (needsQuotes) head[at++] = '"';
+    head[at++] = ' ';
+    headLength = at;
+    return true;
+}
+
+bool RconPacket::fits(const RconCommand& command) const {
+    return headLength != 0 && command.valid() && !command.empty() &&
+        headLength - prefixLength + command.size() <= kMaxRconLine;
+}
+
+size_t RconPacket::build(const RconCommand& command, char* out, size_t capacity) const {
+    if (!fits(command) || headLength + command.size() > capacity) return 0;
+    std::memcpy(out, head, headLength);
+    std::memcpy(out + headLength, command.c_str(), command.size());
+    return headLength + command.size();
+}
+
+int RconPacket::send(UdpSocket& socket, const UdpEndpoint& to, const RconCommand& command) const {
+    if (!fits(command)) return -1;
+    UdpBuffer parts[2] = { { head, headLength }, { command.c_str(), command.size() } };
+    return socket.sendv(to, parts, 2);
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include "UdpSocket.h"
+
+// id Tech 3 servers (MOHAA, CoD) tokenize at most MAX_STRING_CHARS - 1 characters of a command line.
+const size_t kMaxRconLine = 1023;
+
+// Command text built in place, without heap allocations. Arguments that would let a value end the
+// command or start another (";", quotes, line breaks) are refused and mark the command invalid, as
+// does running past kMaxRconLine.
+class RconCommand {
+public:
+    RconCommand() { text[0] = '\0'; }
+    // Starts with verb exactly as given, e.g. "clientkick" or a console line typed by the user.
+    explicit RconCommand(std::string_view verb) : RconCommand() { raw(verb); }
+
+    RconCommand& raw(std::string_view chars);
+    // Appends " token". Tokens must be non-empty and free of whitespace, ';', '"' and control characters.
+    RconCommand& arg(std::string_view token);
+    RconCommand& arg(long long value);
+    // Appends " \"value\"". The engine has no escape for '"' inside quotes, so quotes and control
+    // characters are dropped; ';' is harmless inside quotes and kept.
+    RconCommand& quoted(std::string_view value);
+
+    bool valid() const { return ok; }
+    bool empty() const { return length == 0; }
+    const char* c_str() const { return text; }
+    size_t size() const { return length; }
+    std::string_view view() const { return std::string_view(text, length); }
+
+private:
+    bool reserve(size_t extra);
+
+    char text[kMaxRconLine + 1];
+    size_t length = 0;
+    bool ok = true;
+};
+
+// Out-of-band rcon datagram: 0xFFFFFFFF, MOHAA's 0x02 direction byte, then "rcon <password> <command>".
+// The header is built once per server; each command is sent after it with a vectored send, so
+// neither part is copied and no packet touches the heap.
+class RconPacket {
+public:
+    // False if the password cannot be sent (contains '"' or control characters) or leaves no room for a command.
+    bool setHeader(int protocolId, std::string_view password);
+    std::string_view header() const { return std::string_view(head, headLength); }
+
+    // Whether command fits after this header within the engine's line limit.
+    bool fits(const RconCommand& command) const;
+    // Writes the whole datagram to out. Returns its length, or 0 if it is invalid or out is too small.
+    size_t build(const RconCommand& command, char* out, size_t capacity) const;
+    // Sends header and command as one datagram. Returns bytes sent, or -1.
+    int send(UdpSocket& socket, const UdpEndpoint& to, const RconCommand& command) const;
+
+private:
+    char head[5 + 5 + kMaxRconLine + 3];  // OOB marker, "rcon ", quoted password, separator
+    size_t headLength = 0;
+    size_t prefixLength = 0;              // OOB marker and direction byte, not part of the command line
+};
@@ -5,47 +5,147 @@
 #include "RconPage.h"
 #include "UIRcon.h"
 #include "UIComponents.h"
-#include "GameServerQuery.h"
 #include "ServerManager.h"
+#include "ListCatalog.h"
+#include "ServerQuery.h"
+#include "PlayerActions.h"
+#include "RconBatch.h"
 #include <commctrl.h>
 #include <vector>
 #include <sstream>
 #include <string>
-#include <map>
 #include <thread>
 #include <chrono>
 
 #pragma comment(lib, "comctl32.lib") // Link Common Controls library
 #pragma comment(lib, "Ws2_32.lib")   // Link Winsock library
-#pragma comment(lib, "GameServerQuery.lib") // Link GameServerQuery library
 
-// Sends an RCON command to the specified server and displays the response.
-void RconPage::sendRconCommand(HWND hwnd, const Server& server, const char* command) {
+static RconBatch queuedBatch;            // Player commands collected across servers until the admin runs them
+
+// Player table context menu commands
+static const UINT MENU_ACT_SELECTED = 1;     // + action column: run on the selected players now
+static const UINT MENU_QUEUE_SELECTED = 16;  // + action column: add the selected players to the queued batch
+static const UINT MENU_RUN_QUEUED = 32;
+static const UINT MENU_CLEAR_QUEUED = 33;
+static const UINT MENU_BAN_LIST = 34;        // Add the selected players to the central ban list
+
+// Sends an RCON command to the specified server and displays the response. Returns false if it could not be sent.
+bool RconPage::sendRconCommand(HWND hwnd, const Server& server, const RconCommand& command) {
     if (server.ipOrHostname.empty() || server.port == 0) {
         UIComponents::setOutputMessage(hwnd, "Invalid server details: IP/hostname or port is invalid.");
+        return false;
+    }
+
+    UIComponents::appendOutput(hwnd, command.view(), server.name, ConsoleKind::Command);
+    std::string response;
+    if (!ServerQuery::rcon(server, command, response)) {
+        UIComponents::appendOutput(hwnd, "Command failed: " + response, server.name, ConsoleKind::Error);
+        return false;
+    }
+    UIComponents::appendOutput(hwnd, response, server.name, ConsoleKind::Reply);
+    return true;
+}
+
+// Slot numbers of the selected player table rows.
+static std::vector<std::string> selectedSlots(HWND playerTable) {
+    std::vector<std::string> slots;
+    WCHAR buffer[64];
+    char slot[64];
+    for (int item = ListView_GetNextItem(playerTable, -1, LVNI_SELECTED); item >= 0;
+        item = ListView_GetNextItem(playerTable, item, LVNI_SELECTED)) {
+        ListView_GetItemText(playerTable, item, 0, buffer, sizeof(buffer) / sizeof(WCHAR));
+        WideCharToMultiByte(CP_UTF8, 0, buffer, -1, slot, sizeof(slot), nullptr, nullptr);
+        slots.push_back(slot);
+    }
+    return slots;
+}
+
+// Adds verb for every selected player table row to batch. Returns how many rows were added.
+static size_t addSelectedPlayers(HWND playerTable, const Server& server, const char* verb, RconBatch& batch) {
+    size_t added = 0;
+    for (const std::string& slot : selectedSlots(playerTable)) {
+        if (batch.add(server, slot, UIRcon::playerName(server, slot), verb)) ++added;
+    }
+    return added;
+}
+
+// Asks once for the whole batch, listing its commands per server.
+static bool confirmBatch(HWND hwnd, const RconBatch& batch) {
+    std::string text = "Are you sure you want to send " + std::to_string(batch.size()) + " commands to " +
+        std::to_string(batch.serverCount()) + " server(s)?\n";
+    const size_t kListed = 20;
+    size_t listed = 0;
+    for (uint32_t target = 0; target < batch.serverCount(); ++target) {
+        text.append("\n").append(batch.server(target).name).append(":");
+        for (const BatchItem& item : batch.results()) {
+            if (item.target != target) continue;
+            if (listed++ >= kListed) continue;
+            text.append("\n    ").append(item.command);
+            if (!item.name.empty()) text.append(" (").append(item.name).append(")");
+        }
+    }
+    if (listed > kListed) text.append("\n\n...and " + std::to_string(listed - kListed) + " more");
+    ParseArena arena;
+    return MessageBoxW(hwnd, arena.widen(text, ColorCodes::Strip), L"Confirm Batch", MB_YESNO | MB_ICONWARNING) == IDYES;
+}
+
+// Right-click menu on the player table: batch kicks and bans for the selected rows, and the queued batch.
+static void showPlayerMenu(HWND hwnd, const Server& server) {
+    HWND playerTable = GetDlgItem(hwnd, 501);
+    const GameTraits& traits = GameTraits::get(server.gameId);
+    int selected = ListView_GetSelectedCount(playerTable);
+    HMENU menu = CreatePopupMenu();
+    if (!menu) {
         return;
     }
+    for (int i = 0; i < traits.actionCount; ++i) {
+        if (PlayerActions::effectOf(traits.actions[i].command) != ActionEffect::Removes) continue;
+        UINT flags = MF_STRING | (selected > 0 ? 0 : MF_GRAYED);
+        std::wstring title = traits.actions[i].title;
+        AppendMenuW(menu, flags, MENU_ACT_SELECTED + i, (title + L" selected (" + std::to_wstring(selected) + L")").c_str());
+        AppendMenuW(menu, flags, MENU_QUEUE_SELECTED + i, (L"Add to batch: " + title + L" selected").c_str());
+    }
+    AppendMenuW(menu, MF_STRING | (selected > 0 ? 0 : MF_GRAYED), MENU_BAN_LIST,
+        (L"Ban selected on all servers (" + std::to_wstring(selected) + L")").c_str());
+    AppendMenuW(menu, MF_SEPARATOR, 0, nullptr);
+    UINT queuedFlags = MF_STRING | (queuedBatch.empty() ? MF_GRAYED : 0);
+    AppendMenuW(menu, queuedFlags, MENU_RUN_QUEUED, (L"Run batch (" + std::to_wstring(queuedBatch.size()) + L" commands, " +
+        std::to_wstring(queuedBatch.serverCount()) + L" servers)").c_str());
+    AppendMenuW(menu, queuedFlags, MENU_CLEAR_QUEUED, L"Clear batch");
 
-    // Construct full RCON command
-    std::string fullCommand = std::string("rcon ") + command;
-    const char* response = ProcessGameServerCommand(
-        server.protocolId,
-        false,
-        server.ipOrHostname.c_str(),
-        server.port,
-        fullCommand.c_str(),
-        server.rconPassword.empty() ? "" : server.rconPassword.c_str()
-    );
+    POINT pt;
+    GetCursorPos(&pt);
+    UINT choice = static_cast<UINT>(TrackPopupMenu(menu, TPM_RETURNCMD | TPM_RIGHTBUTTON | TPM_NONOTIFY, pt.x, pt.y, 0, hwnd, nullptr));
+    DestroyMenu(menu);
 
-    // Handle response or error
-    if (!response || strncmp(response, "error=", 6) == 0) {
-        std::string error = response ? response : "No response from server";
-        UIComponents::setOutputMessage(hwnd, ("Command failed: " + error).c_str());
+    if (choice >= MENU_ACT_SELECTED && choice < MENU_ACT_SELECTED + static_cast<UINT>(traits.actionCount)) {
+        RconBatch batch;
+        addSelectedPlayers(playerTable, server, traits.actions[choice - MENU_ACT_SELECTED].command, batch);
+        if (!batch.empty() && confirmBatch(hwnd, batch)) {
+            UIRcon::runBatch(hwnd, std::move(batch), GetTickCount64());
+        }
+    }
+    else if (choice >= MENU_QUEUE_SELECTED && choice < MENU_QUEUE_SELECTED + static_cast<UINT>(traits.actionCount)) {
+        size_t added = addSelectedPlayers(playerTable, server, traits.actions[choice - MENU_QUEUE_SELECTED].command, queuedBatch);
+        UIComponents::appendOutput(hwnd, "Added " + std::to_string(added) + " commands to the batch (" +
+            std::to_string(queuedBatch.size()) + " queued)", server.name, ConsoleKind::Info);
+    }
+    else if (choice == MENU_RUN_QUEUED) {
+        if (confirmBatch(hwnd, queuedBatch)) {
+            UIRcon::runBatch(hwnd, std::move(queuedBatch), GetTickCount64());
+            queuedBatch.clear(); // Moved-from
+        }
     }
-    else {
-        UIComponents::setOutputMessage(hwnd, response);
+    else if (choice == MENU_CLEAR_QUEUED) {
+        queuedBatch.clear();
+    }
+    else if (choice == MENU_BAN_LIST) {
+        std::wstring text = L"Add the " + std::to_wstring(selected) + L" selected player(s) to the ban list?\n\n"
+            L"They are kicked from every server now and whenever they join one again.";
+        if (MessageBoxW(hwnd, text.c_str(), L"Confirm Ban", MB_YESNO | MB_ICONWARNING) == IDYES) {
+            UIRcon::banPlayers(hwnd, server, selectedSlots(playerTable), "Banned from the player table");
+        }
     }
-    if (response) FreeGameServerResponse(response); // Free allocated response memory
 }
 
 // Handles messages for the RCON page, including commands, notifications, and timers.
@@ -62,8 +162,7 @@ void RconPage::handleRconPage(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam)
             if (index != CB_ERR) {
                 auto servers = ServerManager::loadServers();
                 if (index < static_cast<int>(servers.size())) {
-                    UIRcon::updatePlayerTable(hwnd, servers[index]);
-                    UIRcon::updateServerSettings(hwnd, servers[index]);
+                    UIRcon::refreshServer(hwnd, servers[index]);
                 }
             }
         }
@@ -101,15 +200,26 @@ void RconPage::handleRconPage(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam)
                         return;
                     }
                 }
-                sendRconCommand(hwnd, servers[index], ansiBuffer);
+                sendRconCommand(hwnd, servers[index], RconCommand(command));
                 // Update UI for player-affecting commands
                 if (command.find("kick") != std::string::npos || command.find("ban") != std::string::npos ||
                     command.find("rename") != std::string::npos || command.find("unbind") != std::string::npos) {
-                    UIRcon::updatePlayerTable(hwnd, servers[index]);
-                    UIRcon::updateServerSettings(hwnd, servers[index]);
+                    UIRcon::refreshServer(hwnd, servers[index]);
                 }
             }
         }
+        else if (id == 524) { // Find player
+            WCHAR buffer[1024];
+            char ansiBuffer[1024];
+            GetDlgItemTextW(hwnd, 502, buffer, sizeof(buffer) / sizeof(WCHAR));
+            WideCharToMultiByte(CP_UTF8, 0, buffer, -1, ansiBuffer, sizeof(ansiBuffer), nullptr, nullptr);
+            std::string query = ansiBuffer;
+            if (query.empty()) {
+                UIComponents::setOutputMessage(hwnd, "Error: Type a name, IP, IP range (a.b.c.0/24) or GUID to find");
+                return;
+            }
+            UIRcon::findPlayers(hwnd, query);
+        }
         else if (id == 512) { // Apply hostname
             WCHAR buffer[1024];
             char ansiBuffer[1024];
@@ -140,9 +250,8 @@ void RconPage::handleRconPage(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam)
                 if (result != IDYES) {
                     return;
                 }
-                std::string command = "sv_hostname \"" + hostname + "\"";
-                sendRconCommand(hwnd, servers[index], command.c_str());
-                UIRcon::updateServerSettings(hwnd, servers[index]);
+                sendRconCommand(hwnd, servers[index], RconCommand("sv_hostname").quoted(hostname));
+                UIRcon::refreshServer(hwnd, servers[index]);
             }
         }
         else if (id == 515) { // Apply map
@@ -161,20 +270,19 @@ void RconPage::handleRconPage(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam)
 
             auto servers = ServerManager::loadServers();
             if (serverIndex < static_cast<int>(servers.size())) {
-                std::map<std::string, std::string> mapList = ServerManager::parseList(servers[serverIndex].maps);
-                auto it = mapList.begin();
-                std::advance(it, mapIndex);
-                std::string mapValue = it->first;
+                const CatalogEntry* map = ListCatalog::get(servers[serverIndex].maps).at(mapIndex);
+                if (!map) {
+                    UIComponents::setOutputMessage(hwnd, "Error: Selected map is no longer in the server's map list");
+                    return;
+                }
                 std::wstring confirmMsg = L"Are you sure you want to change the map to:\n" +
-                    std::wstring(it->second.begin(), it->second.end()) + L"?";
+                    std::wstring(map->name.begin(), map->name.end()) + L"?";
                 int result = MessageBoxW(hwnd, confirmMsg.c_str(), L"Confirm Map Change", MB_YESNO | MB_ICONWARNING);
                 if (result != IDYES) {
                     return;
                 }
-                std::string command = "map " + mapValue;
-                sendRconCommand(hwnd, servers[serverIndex], command.c_str());
-                UIRcon::updatePlayerTable(hwnd, servers[serverIndex]);
-                UIRcon::updateServerSettings(hwnd, servers[serverIndex]);
+                sendRconCommand(hwnd, servers[serverIndex], RconCommand("map").arg(map->id));
+                UIRcon::refreshServer(hwnd, servers[serverIndex]);
             }
         }
         else if (id == 518) { // Apply gametype
@@ -193,34 +301,35 @@ void RconPage::handleRconPage(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam)
 
             auto servers = ServerManager::loadServers();
             if (serverIndex < static_cast<int>(servers.size())) {
-                bool isMOHAA = servers[serverIndex].game == "Medal of Honor: Allied Assault";
-                std::map<std::string, std::string> gametypeList = ServerManager::parseList(servers[serverIndex].gametypes);
-                auto it = gametypeList.begin();
-                std::advance(it, gametypeIndex);
-                std::string gametypeValue = it->first;
+                const GameTraits& traits = GameTraits::get(servers[serverIndex].gameId);
+                const CatalogEntry* gametype = ListCatalog::get(servers[serverIndex].gametypes).at(gametypeIndex);
+                if (!gametype) {
+                    UIComponents::setOutputMessage(hwnd, "Error: Selected gametype is no longer in the server's gametype list");
+                    return;
+                }
                 std::wstring confirmMsg = L"Are you sure you want to change the gametype to:\n" +
-                    std::wstring(it->second.begin(), it->second.end()) + L"?";
+                    std::wstring(gametype->name.begin(), gametype->name.end()) + L"?";
                 int result = MessageBoxW(hwnd, confirmMsg.c_str(), L"Confirm Gametype Change", MB_YESNO | MB_ICONWARNING);
                 if (result != IDYES) {
                     return;
                 }
-                std::string command = "g_gametype " + gametypeValue;
-                sendRconCommand(hwnd, servers[serverIndex], command.c_str());
-                if (isMOHAA) {
-                    std::map<std::string, std::string> mapList = ServerManager::parseList(servers[serverIndex].maps);
+                sendRconCommand(hwnd, servers[serverIndex], RconCommand("g_gametype").arg(gametype->id));
+                if (traits.mapAfterGametype) {
                     int mapIndex = static_cast<int>(SendMessage(GetDlgItem(hwnd, 514), CB_GETCURSEL, 0, 0));
-                    auto mapIt = mapList.begin();
-                    std::advance(mapIt, mapIndex);
-                    std::string mapCommand = "map " + mapIt->first;
-                    sendRconCommand(hwnd, servers[serverIndex], mapCommand.c_str());
+                    const CatalogEntry* map = ListCatalog::get(servers[serverIndex].maps).at(mapIndex);
+                    if (map) {
+                        sendRconCommand(hwnd, servers[serverIndex], RconCommand("map").arg(map->id));
+                    }
+                    else {
+                        UIComponents::setOutputMessage(hwnd, "Error: Select a map to load the new gametype");
+                    }
                 }
                 else {
                     // Add a one second delay before running the map_restart command
                     std::this_thread::sleep_for(std::chrono::seconds(1));
-                    sendRconCommand(hwnd, servers[serverIndex], "map_restart");
+                    sendRconCommand(hwnd, servers[serverIndex], RconCommand("map_restart"));
                 }
-                UIRcon::updatePlayerTable(hwnd, servers[serverIndex]);
-                UIRcon::updateServerSettings(hwnd, servers[serverIndex]);
+                UIRcon::refreshServer(hwnd, servers[serverIndex]);
             }
         }
         else if (id == 521 || id == 522 || id == 523) { // Restart actions
@@ -237,22 +346,18 @@ void RconPage::handleRconPage(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam)
 
             auto servers = ServerManager::loadServers();
             if (index < static_cast<int>(servers.size())) {
-                std::string command;
-                if (id == 521) {
-                    bool isMOHAA = servers[index].game == "Medal of Honor: Allied Assault";
-                    command = isMOHAA ? "restart" : "map_restart";
-                }
-                else if (id == 522) command = "fast_restart";
-                else if (id == 523) command = "map_rotate";
+                RconCommand command;
+                if (id == 521) command.raw(GameTraits::get(servers[index].gameId).restartCommand);
+                else if (id == 522) command.raw("fast_restart");
+                else if (id == 523) command.raw("map_rotate");
                 std::wstring confirmMsg = L"Are you sure you want to execute:\n" +
-                    std::wstring(command.begin(), command.end()) + L"?";
+                    std::wstring(command.view().begin(), command.view().end()) + L"?";
                 int result = MessageBoxW(hwnd, confirmMsg.c_str(), L"Confirm Action", MB_YESNO | MB_ICONWARNING);
                 if (result != IDYES) {
                     return;
                 }
-                sendRconCommand(hwnd, servers[index], command.c_str());
-                UIRcon::updatePlayerTable(hwnd, servers[index]);
-                UIRcon::updateServerSettings(hwnd, servers[index]);
+                sendRconCommand(hwnd, servers[index], command);
+                UIRcon::refreshServer(hwnd, servers[index]);
             }
         }
     }
@@ -286,64 +391,46 @@ void RconPage::handleRconPage(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam)
                 const Server& server = servers[index];
 
                 // Determine game-specific commands
-                bool isMOHAA = server.game == "Medal of Honor: Allied Assault" || server.game == "Medal of Honor: AA Spearhead";
-                bool isMOHSHBT = server.game == "Medal of Honor: AA Breakthrough";
-                bool isCOD = server.game.find("Call of Duty") != std::string::npos;
+                const GameTraits& traits = GameTraits::get(server.gameId);
 
-                std::string command;
+                RconCommand command;
                 WCHAR buffer[1024];
                 char ansiNum[512];
                 ListView_GetItemText(playerTable, hit.iItem, 0, buffer, sizeof(buffer) / sizeof(WCHAR));
                 WideCharToMultiByte(CP_UTF8, 0, buffer, -1, ansiNum, sizeof(ansiNum), nullptr, nullptr);
 
-                if (isMOHAA) {
-                    if (hit.iSubItem == 5) command = "set namechange " + std::string(ansiNum);
-                    else if (hit.iSubItem == 6) command = "set unbindplayer " + std::string(ansiNum);
-                    else if (hit.iSubItem == 7) command = "clientkick " + std::string(ansiNum);
-                }
-                else if (isMOHSHBT && hit.iSubItem == 5) {
-                    command = "clientkick " + std::string(ansiNum);
-                }
-                else if (isCOD) {
-                    if (hit.iSubItem == 5) command = "clientkick " + std::string(ansiNum);
-                    else if (hit.iSubItem == 6) command = "banclient " + std::string(ansiNum);
+                int action = hit.iSubItem - 5;
+                if (action < traits.actionCount) {
+                    command.raw(traits.actions[action].command).arg(ansiNum);
                 }
 
                 if (!command.empty()) {
                     std::wstring confirmMsg = L"Are you sure you want to execute:\n" +
-                        std::wstring(command.begin(), command.end()) + L" on this player?";
+                        std::wstring(command.view().begin(), command.view().end()) + L" on this player?";
                     int result = MessageBoxW(hwnd, confirmMsg.c_str(), L"Confirm action", MB_YESNO | MB_ICONWARNING);
                     if (result != IDYES) {
                         return;
                     }
 
-                    sendRconCommand(hwnd, server, command.c_str());
-                    UIRcon::updatePlayerTable(hwnd, server);
-                    UIRcon::updateServerSettings(hwnd, server);
+                    // The table shows the result as soon as the server accepts the command
+                    ULONGLONG clickMs = GetTickCount64();
+                    if (sendRconCommand(hwnd, server, command)) {
+                        UIRcon::playerActionSent(hwnd, server, ansiNum, command.view(), clickMs);
+                    }
                 }
             }
         }
-    }
-    else if (msg == WM_TIMER) {
-        if (wParam == 1001) { // Refresh timer
-            HWND hwndServerCombo = GetDlgItem(hwnd, 500);
-            if (!hwndServerCombo) {
-                UIComponents::setOutputMessage(hwnd, "Error: Server selector not available");
-                return;
-            }
-            int index = static_cast<int>(SendMessage(hwndServerCombo, CB_GETCURSEL, 0, 0));
-            if (index == CB_ERR) {
-                UIComponents::setOutputMessage(hwnd, "No server selected for refresh");
-                return;
-            }
+        else if (nmhdr->idFrom == 501 && nmhdr->code == NM_RCLICK) { // Player table context menu
+            int index = static_cast<int>(SendMessage(GetDlgItem(hwnd, 500), CB_GETCURSEL, 0, 0));
             auto servers = ServerManager::loadServers();
-            if (index < static_cast<int>(servers.size())) {
-                UIRcon::updatePlayerTable(hwnd, servers[index]);
-                UIRcon::updateServerSettings(hwnd, servers[index]);
-            }
-            else {
-                UIComponents::setOutputMessage(hwnd, "Error: Invalid server index");
+            if (index != CB_ERR && index < static_cast<int>(servers.size())) {
+                showPlayerMenu(hwnd, servers[index]);
             }
         }
     }
+    else if (msg == WM_TIMER) {
+        if (wParam == 1001) { // Refresh scheduler tick
+            UIRcon::onRefreshTimer(hwnd);
+        }
+    }
 }
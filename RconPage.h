@@ -1,10 +1,11 @@
 #pragma once
 #include <Windows.h>
 #include "ServerManager.h"
+#include "RconPacket.h"
 
 class RconPage {
 public:
     static void handleRconPage(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam);
 private:
-    static void sendRconCommand(HWND hwnd, const Server& server, const char* command);
+    static bool sendRconCommand(HWND hwnd, const Server& server, const RconCommand& command);
 };
\ No newline at end of file
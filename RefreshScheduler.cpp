@@ -0,0 +1,255 @@
+// --- xRcon\RefreshScheduler.cpp ---
+// Implementation of the per-server refresh scheduler.
+// A hierarchical timer wheel holds one deadline per server; expired servers are released through a fixed-size send window.
+
+#include "RefreshScheduler.h"
+#include <algorithm>
+
+// Creates an empty wheel whose next processed tick is startTick.
+TimerWheel::TimerWheel(uint64_t startTick)
+    : heads(kLevels * kSlots, kInvalid), current(startTick) {
+}
+
+// Makes room for ids [0, idCount) so scheduling never reallocates.
+void TimerWheel::reserve(size_t idCount) {
+    if (nodes.size() < idCount) {
+        nodes.resize(idCount);
+    }
+}
+
+// Schedules (or reschedules) id to expire at dueTick. Past deadlines expire on the next advance.
+void TimerWheel::schedule(uint32_t id, uint64_t dueTick) {
+    if (id >= nodes.size()) {
+        nodes.resize(static_cast<size_t>(id) + 1);
+    }
+    if (nodes[id].bucket != kInvalid) {
+        unlink(id);
+    }
+    nodes[id].due = std::max(dueTick, current);
+    link(id);
+}
+
+// Removes id from the wheel if it is scheduled.
+void TimerWheel::cancel(uint32_t id) {
+    if (id < nodes.size() && nodes[id].bucket != kInvalid) {
+        unlink(id);
+    }
+}
+
+// Returns true if id currently has a deadline.
+bool TimerWheel::isScheduled(uint32_t id) const {
+    return id < nodes.size() && nodes[id].bucket != kInvalid;
+}
+
+// Returns the deadline of id, or 0 if it is not scheduled.
+uint64_t TimerWheel::dueTick(uint32_t id) const {
+    return isScheduled(id) ? nodes[id].due : 0;
+}
+
+// Inserts id into the slot matching its distance from the current tick.
+void TimerWheel::link(uint32_t id) {
+    Node& node = nodes[id];
+    uint64_t delta = node.due - current;
+    uint64_t due = node.due;
+    int level = 0;
+    if (delta >= (1ull << (kSlotBits * kLevels))) {
+        due = current + (1ull << (kSlotBits * kLevels)) - 1; // Clamp; re-linked on cascade
+        level = kLevels - 1;
+    }
+    else {
+        while (level < kLevels - 1 && delta >= (1ull << (kSlotBits * (level + 1)))) {
+            ++level;
+        }
+    }
+    uint32_t slot = static_cast<uint32_t>(due >> (kSlotBits * level)) & (kSlots - 1);
+    uint32_t bucket = static_cast<uint32_t>(level) * kSlots + slot;
+
+    node.bucket = bucket;
+    node.prev = kInvalid;
+    node.next = heads[bucket];
+    if (node.next != kInvalid) {
+        nodes[node.next].prev = id;
+    }
+    heads[bucket] = id;
+    ++count;
+}
+
+// Detaches id from its slot list.
+void TimerWheel::unlink(uint32_t id) {
+    Node& node = nodes[id];
+    if (node.prev != kInvalid) {
+        nodes[node.prev].next = node.next;
+    }
+    else {
+        heads[node.bucket] = node.next;
+    }
+    if (node.next != kInvalid) {
+        nodes[node.next].prev = node.prev;
+    }
+    node.prev = node.next = node.bucket = kInvalid;
+    --count;
+}
+
+// Redistributes one slot of a higher level into the levels below it.
+void TimerWheel::cascade(int level, uint32_t slot) {
+    uint32_t bucket = static_cast<uint32_t>(level) * kSlots + slot;
+    uint32_t id = heads[bucket];
+    heads[bucket] = kInvalid;
+    while (id != kInvalid) {
+        uint32_t next = nodes[id].next;
+        nodes[id].prev = nodes[id].next = nodes[id].bucket = kInvalid;
+        --count;
+        link(id);
+        id = next;
+    }
+}
+
+// Processes every tick up to and including nowTick.
+void TimerWheel::advance(uint64_t nowTick, std::vector<uint32_t>& expired) {
+    while (current <= nowTick) {
+        if (count == 0) {
+            current = nowTick + 1; // Nothing scheduled; jump straight to the end
+            return;
+        }
+        uint32_t index = static_cast<uint32_t>(current) & (kSlots - 1);
+        for (int level = 1; level < kLevels && index == 0; ++level) {
+            index = static_cast<uint32_t>(current >> (kSlotBits * level)) & (kSlots - 1);
+            cascade(level, index);
+        }
+        uint32_t bucket = static_cast<uint32_t>(current) & (kSlots - 1);
+        while (heads[bucket] != kInvalid) {
+            uint32_t id = heads[bucket];
+            unlink(id);
+            expired.push_back(id);
+        }
+        ++current;
+    }
+}
+
+// Creates a scheduler that allows sendWindow refreshes in flight at once.
+RefreshScheduler::RefreshScheduler(size_t sendWindow, uint64_t seed)
+    : window(sendWindow ? sendWindow : 1), rng(seed ? seed : 1) {
+}
+
+// Schedules serverCount servers with first deadlines spread across one busy interval.
+void RefreshScheduler::reset(size_t serverCount, uint64_t nowMs) {
+    wheel = TimerWheel(toTick(nowMs));
+    wheel.reserve(serverCount);
+    state.assign(serverCount, ServerState());
+    ready.clear();
+    expired.clear();
+    readyHead = 0;
+    inFlight = 0;
+    focus = TimerWheel::kInvalid;
+    for (size_t i = 0; i < serverCount; ++i) {
+        rng ^= rng >> 12; rng ^= rng << 25; rng ^= rng >> 27;
+        uint64_t offset = (rng * 0x2545F4914F6CDD1Dull) % (intervals.busyMs ? intervals.busyMs : 1);
+        wheel.schedule(static_cast<uint32_t>(i), toTick(nowMs + offset));
+    }
+}
+
+// Marks id as the server in view and pulls its deadline in to the focus interval.
+void RefreshScheduler::setFocus(uint32_t id, uint64_t nowMs) {
+    if (id >= state.size()) {
+        focus = TimerWheel::kInvalid;
+        return;
+    }
+    focus = id;
+    if (state[id].inFlight || state[id].queued) {
+        return; // Already on its way
+    }
+    uint64_t due = toTick(nowMs + jitter(intervals.focusMs));
+    if (!wheel.isScheduled(id) || wheel.dueTick(id) > due) {
+        wheel.schedule(id, due);
+    }
+}
+
+// Expires due servers and releases queued ones while the send window has room.
+size_t RefreshScheduler::acquire(uint64_t nowMs, std::vector<uint32_t>& toSend) {
+    expired.clear();
+    wheel.advance(toTick(nowMs), expired);
+    for (uint32_t id : expired) {
+        if (id < state.size() && !state[id].queued && !state[id].inFlight) {
+            state[id].queued = true;
+            ready.push_back(id);
+        }
+    }
+
+    size_t released = 0;
+    while (inFlight < window && readyHead < ready.size()) {
+        uint32_t id = ready[readyHead++];
+        if (id >= state.size() || !state[id].queued) {
+            continue; // Completed out of band while queued
+        }
+        state[id].queued = false;
+        state[id].inFlight = true;
+        ++inFlight;
+        toSend.push_back(id);
+        ++released;
+    }
+    if (readyHead == ready.size()) {
+        ready.clear();
+        readyHead = 0;
+    }
+    return released;
+}
+
+// Records the outcome of a refresh and schedules the next one.
+void RefreshScheduler::complete(uint32_t id, RefreshOutcome outcome, uint64_t nowMs) {
+    if (id >= state.size()) {
+        return;
+    }
+    ServerState& s = state[id];
+    if (s.inFlight) {
+        s.inFlight = false;
+        --inFlight;
+    }
+    s.queued = false;
+    if (outcome == RefreshOutcome::Down) {
+        ++s.failures;
+    }
+    else if (outcome != RefreshOutcome::Skipped) {
+        s.failures = 0;
+    }
+    if (outcome != RefreshOutcome::Skipped) {
+        s.last = outcome;
+    }
+    wheel.schedule(id, toTick(nowMs + jitter(intervalFor(id))));
+}
+
+// Returns true if id has been released and not yet completed.
+bool RefreshScheduler::isInFlight(uint32_t id) const {
+    return id < state.size() && state[id].inFlight;
+}
+
+// Returns the next deadline of id in milliseconds, or 0 if none.
+uint64_t RefreshScheduler::deadlineMs(uint32_t id) const {
+    return wheel.dueTick(id) * kTickMs;
+}
+
+// Picks the base polling interval for a server from its focus and last outcome.
+uint32_t RefreshScheduler::intervalFor(uint32_t id) const {
+    const ServerState& s = state[id];
+    if (id == focus) {
+        return intervals.focusMs;
+    }
+    if (s.last == RefreshOutcome::Down && s.failures > 0) {
+        uint64_t backoff = static_cast<uint64_t>(intervals.downBaseMs) << std::min<uint32_t>(s.failures - 1, 16);
+        return static_cast<uint32_t>(std::min<uint64_t>(backoff, intervals.downMaxMs));
+    }
+    if (s.last == RefreshOutcome::Empty) {
+        return intervals.emptyMs;
+    }
+    return intervals.busyMs;
+}
+
+// Spreads an interval by +/- jitterPercent using a xorshift generator.
+uint32_t RefreshScheduler::jitter(uint32_t intervalMs) {
+    uint32_t span = static_cast<uint32_t>(static_cast<uint64_t>(intervalMs) * intervals.jitterPercent / 100);
+    if (span == 0) {
+        return intervalMs;
+    }
+    rng ^= rng >> 12; rng ^= rng << 25; rng ^= rng >> 27;
+    uint32_t r = static_cast<uint32_t>((rng * 0x2545F4914F6CDD1Dull) >> 32) % (2 * span + 1);
+    return intervalMs - span + r;
+}
@@ -0,0 +1,115 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+// Hierarchical timer wheel keyed by small integer ids.
+// Four levels of 256 slots; insert, cancel and per-tick expiry are O(1).
+class TimerWheel {
+public:
+    static constexpr uint32_t kInvalid = 0xFFFFFFFFu;
+
+    explicit TimerWheel(uint64_t startTick = 0);
+
+    void reserve(size_t idCount);
+    void schedule(uint32_t id, uint64_t dueTick);
+    void cancel(uint32_t id);
+    bool isScheduled(uint32_t id) const;
+    uint64_t dueTick(uint32_t id) const;
+    uint64_t currentTick() const { return current; }
+    size_t size() const { return count; }
+
+    // Advances the wheel to nowTick and appends every expired id to expired.
+    void advance(uint64_t nowTick, std::vector<uint32_t>& expired);
+
+private:
+    static const int kLevels = 4;
+    static const int kSlotBits = 8;
+    static const uint32_t kSlots = 1u << kSlotBits;
+
+    struct Node {
+        uint32_t prev = kInvalid;
+        uint32_t next = kInvalid;
+        uint64_t due = 0;
+        uint32_t bucket = kInvalid; // level * kSlots + slot, kInvalid when unlinked
+    };
+
+    void link(uint32_t id);
+    void unlink(uint32_t id);
+    void cascade(int level, uint32_t slot);
+
+    std::vector<Node> nodes;
+    std::vector<uint32_t> heads;
+    uint64_t current;
+    size_t count = 0;
+};
+
+// Outcome of a refresh, used to pick the next polling interval.
+enum class RefreshOutcome {
+    Busy,    // Server answered with at least one player
+    Empty,   // Server answered with no players
+    Down,    // Query failed or timed out
+    Skipped  // Deadline expired but no query was sent
+};
+
+// Per-server refresh deadlines backed by a TimerWheel.
+// The focused server and busy servers are polled often, empty and down servers back off,
+// and every deadline is jittered so a large fleet does not fire at once.
+// Expired servers queue up and are released through a fixed-size send window.
+class RefreshScheduler {
+public:
+    struct Intervals {
+        uint32_t focusMs = 15000;
+        uint32_t busyMs = 60000;
+        uint32_t emptyMs = 180000;
+        uint32_t downBaseMs = 60000;
+        uint32_t downMaxMs = 900000;
+        uint32_t jitterPercent = 10;
+    };
+
+    static const uint32_t kTickMs = 250;
+
+    explicit RefreshScheduler(size_t sendWindow = 8, uint64_t seed = 0x9E3779B97F4A7C15ull);
+
+    void setIntervals(const Intervals& value) { intervals = value; }
+    const Intervals& getIntervals() const { return intervals; }
+
+    // Drops all state and schedules serverCount servers with spread-out first deadlines.
+    void reset(size_t serverCount, uint64_t nowMs);
+    void setFocus(uint32_t id, uint64_t nowMs);
+    uint32_t getFocus() const { return focus; }
+
+    // Moves expired servers into the ready queue and releases as many as the send window allows.
+    size_t acquire(uint64_t nowMs, std::vector<uint32_t>& toSend);
+    // Reports the result of a refresh released by acquire (or refreshed out of band) and reschedules it.
+    void complete(uint32_t id, RefreshOutcome outcome, uint64_t nowMs);
+
+    bool isInFlight(uint32_t id) const;
+    size_t inFlightCount() const { return inFlight; }
+    size_t readyCount() const { return ready.size() - readyHead; }
+    size_t serverCount() const { return state.size(); }
+    uint64_t deadlineMs(uint32_t id) const;
+
+private:
+    struct ServerState {
+        uint32_t failures = 0;
+        bool inFlight = false;
+        bool queued = false;
+        RefreshOutcome last = RefreshOutcome::Skipped;
+    };
+
+    uint32_t intervalFor(uint32_t id) const;
+    uint32_t jitter(uint32_t intervalMs);
+    static uint64_t toTick(uint64_t ms) { return (ms + kTickMs - 1) / kTickMs; }
+
+    TimerWheel wheel;
+    Intervals intervals;
+    std::vector<ServerState> state;
+    std::vector<uint32_t> ready;
+    std::vector<uint32_t> expired;
+    size_t readyHead = 0;
+    size_t window;
+    size_t inFlight = 0;
+    uint32_t focus = TimerWheel::kInvalid;
+    uint64_t rng;
+};
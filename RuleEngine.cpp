@@ -0,0 +1,592 @@
+// --- xRcon\RuleEngine.cpp ---
+// Implementation of the automated server rules: the condition compiler, its stack machine and the
+// per-server state that keeps re-checks down to the rules whose fields changed.
+
+#include "RuleEngine.h"
+#include "BanList.h"
+#include "PlayerIndex.h"
+#include <algorithm>
+#include <charconv>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+
+static bool parseNumber(std::string_view text, double& number) {
+    if (text.empty()) return false;
+    const char* end = text.data() + text.size();
+    std::from_chars_result result = std::from_chars(text.data(), end, number);
+    return result.ec == std::errc() && result.ptr == end;
+}
+
+static std::string lowercase(std::string_view text) {
+    std::string result(text);
+    for (char& c : result) c = c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+    return result;
+}
+
+static uint32_t bit(RuleField field) {
+    return 1u << static_cast<int>(field);
+}
+
+void RuleFacts::set(RuleField field, std::string_view value) {
+    int i = static_cast<int>(field);
+    text[i] = PlayerIndex::normalize(value);
+    numeric[i] = parseNumber(text[i], number[i]);
+}
+
+// Recursive descent over the condition, emitting postfix code.
+class RuleCompiler {
+public:
+    RuleCompiler(std::string_view source, RulePredicate& predicate) : source(source), out(predicate) {}
+
+    bool run(std::string& error) {
+        out.code.clear();
+        out.texts.clear();
+        out.mask = 0;
+        next();
+        if (token.kind == Kind::End) fail("the condition is empty");
+        else parseOr();
+        if (message.empty() && token.kind != Kind::End) fail("unexpected '" + std::string(token.text) + "'");
+        error = message;
+        return message.empty();
+    }
+
+private:
+    enum class Kind { End, Number, Text, Word, Symbol };
+    struct Token {
+        Kind kind = Kind::End;
+        std::string_view text;
+    };
+    using Op = RulePredicate::Op;
+
+    void next() {
+        while (position < source.size() && (source[position] == ' ' || source[position] == '\t')) ++position;
+        size_t start = position;
+        token.text = std::string_view();
+        if (position == source.size()) {
+            token.kind = Kind::End;
+            return;
+        }
+        char c = source[position];
+        if (c == '"') {
+            size_t end = source.find('"', position + 1);
+            if (end == std::string_view::npos) {
+                fail("unterminated string");
+                token.kind = Kind::End;
+                position = source.size();
+                return;
+            }
+            token.kind = Kind::Text;
+            token.text = source.substr(position + 1, end - position - 1);
+            position = end + 1;
+            return;
+        }
+        if ((c >= '0' && c <= '9') || c == '-' || c == '.') {
+            ++position;
+            while (position < source.size() && ((source[position] >= '0' && source[position] <= '9') || source[position] == '.')) ++position;
+            token.kind = Kind::Number;
+        }
+        else if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_') {
+            while (position < source.size()) {
+                char w = source[position];
+                if (!((w >= 'a' && w <= 'z') || (w >= 'A' && w <= 'Z') || (w >= '0' && w <= '9') || w == '_' || w == '.')) break;
+                ++position;
+            }
+            token.kind = Kind::Word;
+        }
+        else {
+            static const char* const symbols[] = { "||", "&&", "==", "!=", "<=", ">=", "<", ">", "!", "(", ")" };
+            token.kind = Kind::Symbol;
+            for (const char* symbol : symbols) {
+                std::string_view s(symbol);
+                if (source.substr(position, s.size()) == s) {
+                    position += s.size();
+                    token.text = s;
+                    return;
+                }
+            }
+            ++position;
+        }
+        token.text = source.substr(start, position - start);
+    }
+
+    bool is(std::string_view symbol) const {
+        return (token.kind == Kind::Symbol && token.text == symbol) ||
+            (token.kind == Kind::Word && lowercase(token.text) == (symbol == "||" ? "or" : symbol == "&&" ? "and" : symbol == "!" ? "not" : ""));
+    }
+
+    void fail(const std::string& text) {
+        if (message.empty()) message = text;
+    }
+
+    void emit(Op op, RuleField field = RuleField::Count, uint32_t text = 0, double number = 0) {
+        out.code.push_back({ op, field, text, number });
+        depth += op <= Op::Cvar ? 1 : op == Op::Not || op >= Op::JumpIfFalse ? 0 : -1;
+        if (depth > static_cast<int>(RulePredicate::kMaxDepth)) fail("the condition is nested too deeply");
+    }
+
+    uint32_t addText(std::string text) {
+        out.texts.push_back(std::move(text));
+        return static_cast<uint32_t>(out.texts.size() - 1);
+    }
+
+    // left, a jump past the rest when left decides, right, then the operator that combines them
+    void parseOr() {
+        parseAnd();
+        while (message.empty() && is("||")) {
+            next();
+            size_t jump = out.code.size();
+            emit(Op::JumpIfTrue);
+            parseAnd();
+            emit(Op::Or);
+            out.code[jump].text = static_cast<uint32_t>(out.code.size());
+        }
+    }
+
+    void parseAnd() {
+        parseNot();
+        while (message.empty() && is("&&")) {
+            next();
+            size_t jump = out.code.size();
+            emit(Op::JumpIfFalse);
+            parseNot();
+            emit(Op::And);
+            out.code[jump].text = static_cast<uint32_t>(out.code.size());
+        }
+    }
+
+    void parseNot() {
+        if (is("!")) {
+            next();
+            parseNot();
+            emit(Op::Not);
+            return;
+        }
+        parseComparison();
+    }
+
+    void parseComparison() {
+        parseValue();
+        static const std::pair<const char*, Op> comparisons[] = { { "==", Op::Equal }, { "!=", Op::NotEqual },
+            { "<", Op::Less }, { "<=", Op::LessEqual }, { ">", Op::Greater }, { ">=", Op::GreaterEqual } };
+        for (const auto& comparison : comparisons) {
+            if (!message.empty() || token.kind != Kind::Symbol || token.text != comparison.first) continue;
+            next();
+            parseValue();
+            if (!message.empty()) return;
+            Op op = comparison.second;
+            // A glob literal on the right turns equality into a match
+            const RulePredicate::Instruction& right = out.code.back();
+            if ((op == Op::Equal || op == Op::NotEqual) && right.op == Op::Text &&
+                out.texts[right.text].find_first_of("*?") != std::string::npos) {
+                op = op == Op::Equal ? Op::Match : Op::NoMatch;
+            }
+            emit(op);
+            return;
+        }
+    }
+
+    void parseValue() {
+        if (!message.empty()) return;
+        if (token.kind == Kind::Symbol && token.text == "(") {
+            next();
+            parseOr();
+            if (message.empty() && !(token.kind == Kind::Symbol && token.text == ")")) fail("expected ')'");
+            next();
+            return;
+        }
+        if (token.kind == Kind::Number || token.kind == Kind::Text) {
+            std::string text = PlayerIndex::normalize(token.text);
+            double number = 0;
+            if (parseNumber(text, number)) emit(Op::Number, RuleField::Count, addText(std::move(text)), number);
+            else if (token.kind == Kind::Number) fail("bad number '" + std::string(token.text) + "'");
+            else emit(Op::Text, RuleField::Count, addText(std::move(text)));
+            next();
+            return;
+        }
+        if (token.kind == Kind::Word) {
+            static const std::pair<const char*, RuleField> fields[] = { { "players", RuleField::Players },
+                { "maxclients", RuleField::MaxClients }, { "map", RuleField::Map }, { "gametype", RuleField::Gametype },
+                { "hostname", RuleField::Hostname }, { "slot", RuleField::Slot }, { "name", RuleField::Name },
+                { "ping", RuleField::Ping }, { "score", RuleField::Score } };
+            std::string word = lowercase(token.text);
+            if (word.compare(0, 5, "cvar.") == 0 && word.size() > 5) {
+                emit(Op::Cvar, RuleField::Cvar, addText(word.substr(5)));
+                out.mask |= bit(RuleField::Cvar);
+                next();
+                return;
+            }
+            for (const auto& field : fields) {
+                if (word != field.first) continue;
+                emit(Op::Field, field.second);
+                out.mask |= bit(field.second);
+                next();
+                return;
+            }
+            fail("unknown field '" + std::string(token.text) + "'");
+            return;
+        }
+        fail(token.kind == Kind::End ? "the condition ends early" : "expected a value at '" + std::string(token.text) + "'");
+    }
+
+    std::string_view source;
+    RulePredicate& out;
+    size_t position = 0;
+    Token token;
+    int depth = 0;
+    std::string message;
+};
+
+bool RulePredicate::compile(std::string_view text, std::string& error) {
+    return RuleCompiler(text, *this).run(error);
+}
+
+namespace {
+struct RuleValue {
+    std::string_view text;
+    double number;
+    bool numeric;
+};
+}
+
+static bool truth(const RuleValue& value) {
+    return value.numeric ? value.number != 0 : !value.text.empty();
+}
+
+bool RulePredicate::evaluate(const RuleFacts& server, const RuleFacts* player) const {
+    RuleValue stack[kMaxDepth];
+    size_t top = 0;
+    for (size_t at = 0; at < code.size(); ++at) {
+        const Instruction& instruction = code[at];
+        switch (instruction.op) {
+        case Op::Number:
+            stack[top++] = { texts[instruction.text], instruction.number, true };
+            break;
+        case Op::Text:
+            stack[top++] = { texts[instruction.text], 0, false };
+            break;
+        case Op::Field: {
+            int i = static_cast<int>(instruction.field);
+            const RuleFacts* facts = (bit(instruction.field) & kPlayerRuleFields) ? player : &server;
+            stack[top++] = facts ? RuleValue{ facts->text[i], facts->number[i], facts->numeric[i] } : RuleValue{ {}, 0, false };
+            break;
+        }
+        case Op::Cvar: {
+            RuleValue value{ {}, 0, false };
+            for (const auto& cvar : server.cvars) {
+                if (cvar.first != texts[instruction.text]) continue;
+                value.text = cvar.second;
+                value.numeric = parseNumber(cvar.second, value.number);
+                break;
+            }
+            stack[top++] = value;
+            break;
+        }
+        case Op::Not:
+            stack[top - 1] = { {}, truth(stack[top - 1]) ? 0.0 : 1.0, true };
+            break;
+        case Op::JumpIfFalse:
+        case Op::JumpIfTrue:
+            // The left side stays on the stack as the result
+            if (truth(stack[top - 1]) == (instruction.op == Op::JumpIfTrue)) at = instruction.text - 1;
+            break;
+        default: {
+            const RuleValue& a = stack[top - 2];
+            const RuleValue& b = stack[top - 1];
+            bool numbers = a.numeric && b.numeric;
+            int order = numbers ? (a.number < b.number ? -1 : a.number > b.number ? 1 : 0) : a.text.compare(b.text);
+            bool result = false;
+            switch (instruction.op) {
+            case Op::Equal: result = order == 0; break;
+            case Op::NotEqual: result = order != 0; break;
+            case Op::Match: result = BanList::wildcardMatch(b.text, a.text); break;
+            case Op::NoMatch: result = !BanList::wildcardMatch(b.text, a.text); break;
+            case Op::Less: result = order < 0; break;
+            case Op::LessEqual: result = order <= 0; break;
+            case Op::Greater: result = order > 0; break;
+            case Op::GreaterEqual: result = order >= 0; break;
+            case Op::And: result = truth(a) && truth(b); break;
+            case Op::Or: result = truth(a) || truth(b); break;
+            default: break;
+            }
+            --top;
+            stack[top - 1] = { {}, result ? 1.0 : 0.0, true };
+            break;
+        }
+        }
+    }
+    return top == 1 && truth(stack[0]);
+}
+
+bool RuleEngine::add(Rule rule, std::string& error) {
+    std::string label = "Rule '" + rule.name + "': ";
+    if (!rule.predicate.compile(rule.condition, error)) {
+        error = label + error;
+        return false;
+    }
+    if (rule.actions.empty()) {
+        error = label + "no do= action";
+        return false;
+    }
+    rule.servers = lowercase(rule.servers.empty() ? "*" : rule.servers);
+    list.push_back(std::move(rule));
+    ++generation;
+    return true;
+}
+
+void RuleEngine::clear() {
+    list.clear();
+    ++generation;
+}
+
+// One [rule] section per rule with name, servers, when, do (repeatable) and cooldown (seconds) keys.
+size_t RuleEngine::load(const std::string& path, std::vector<std::string>& errors) {
+    clear();
+    std::ifstream file(path);
+    stamp(path, fileSize, writeTime);
+    if (!file.is_open()) {
+        return 0;
+    }
+    Rule rule;
+    bool inRule = false;
+    auto finish = [&]() {
+        if (!inRule) return;
+        std::string error;
+        if (!add(std::move(rule), error)) errors.push_back(error);
+        rule = Rule();
+        inRule = false;
+    };
+    std::string line;
+    while (std::getline(file, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty() || line[0] == ';') continue;
+        if (line[0] == '[') {
+            finish();
+            inRule = line == "[rule]";
+            continue;
+        }
+        size_t equals = line.find('=');
+        if (!inRule || equals == std::string::npos) continue;
+        std::string key = line.substr(0, equals);
+        std::string value = line.substr(equals + 1);
+        if (key == "name") rule.name = value;
+        else if (key == "servers") rule.servers = value;
+        else if (key == "when") rule.condition = value;
+        else if (key == "do") rule.actions.push_back(value);
+        else if (key == "cooldown") rule.cooldownMs = std::strtoull(value.c_str(), nullptr, 10) * 1000;
+    }
+    finish();
+    return list.size();
+}
+
+void RuleEngine::stamp(const std::string& path, uintmax_t& size, int64_t& time) {
+    namespace fs = std::filesystem;
+    std::error_code error;
+    bool exists = fs::is_regular_file(path, error);
+    size = exists ? fs::file_size(path, error) : 0;
+    time = exists ? static_cast<int64_t>(fs::last_write_time(path, error).time_since_epoch().count()) : 0;
+}
+
+bool RuleEngine::changedOnDisk(const std::string& path) const {
+    uintmax_t size = 0;
+    int64_t time = 0;
+    stamp(path, size, time);
+    return size != fileSize || time != writeTime;
+}
+
+void RuleEngine::retain(const std::vector<std::string>& names) {
+    for (auto it = servers.begin(); it != servers.end();) {
+        if (std::find(names.begin(), names.end(), it->first) != names.end()) ++it;
+        else it = servers.erase(it);
+    }
+}
+
+// Starts server over with the rules whose servers pattern matches its name.
+void RuleEngine::resolve(const std::string& name, ServerState& state) const {
+    state = ServerState();
+    state.generation = generation;
+    std::string key = lowercase(name);
+    for (uint32_t i = 0; i < list.size(); ++i) {
+        if (!BanList::wildcardMatch(list[i].servers, key)) continue;
+        (list[i].predicate.perPlayer() ? state.playerRules : state.serverRules).push_back(i);
+        state.fields |= list[i].predicate.fields();
+    }
+    state.states.resize(state.serverRules.size());
+}
+
+// Moves a rule's state on by one check. Returns true if it fires now.
+bool RuleEngine::step(RuleState& state, bool holds, const Rule& rule, uint64_t nowMs) const {
+    if (!holds) {
+        state.holding = state.pending = false;
+        return false;
+    }
+    if (!state.holding) {
+        state.holding = true;
+        state.pending = true;
+    }
+    if (state.pending && (state.firedMs == 0 || nowMs - state.firedMs >= rule.cooldownMs)) {
+        state.pending = false;
+        state.firedMs = nowMs;
+        return true;
+    }
+    return false;
+}
+
+// Fills in rule's actions. Polled values are untrusted: quotes, ';' and control characters are dropped
+// so a player name cannot end the command or start another one.
+void RuleEngine::fire(uint32_t rule, const std::string& server, const StatusView& status, size_t playerCount,
+    const PlayerView* player, std::vector<RuleFiring>& out) const {
+    std::string count = std::to_string(playerCount);
+    for (const std::string& action : list[rule].actions) {
+        RuleFiring firing;
+        firing.rule = rule;
+        if (player) {
+            firing.slot.assign(player->slot.data(), player->slot.size());
+            firing.name.assign(player->name.data(), player->name.size());
+        }
+        for (size_t i = 0; i < action.size(); ++i) {
+            size_t close = action[i] == '{' ? action.find('}', i) : std::string::npos;
+            if (close == std::string::npos) {
+                firing.command += action[i];
+                continue;
+            }
+            std::string_view placeholder(action.data() + i + 1, close - i - 1);
+            std::string_view value;
+            bool known = true;
+            if (placeholder == "slot") value = player ? player->slot : std::string_view();
+            else if (placeholder == "name") value = player ? player->name : std::string_view();
+            else if (placeholder == "ping") value = player ? player->ping : std::string_view();
+            else if (placeholder == "score") value = player ? player->score : std::string_view();
+            else if (placeholder == "map") value = status.mapname;
+            else if (placeholder == "gametype") value = status.gametype;
+            else if (placeholder == "hostname") value = status.hostname;
+            else if (placeholder == "players") value = count;
+            else if (placeholder == "server") value = server;
+            else known = false;
+            if (!known) {
+                firing.command += action[i];
+                continue;
+            }
+            for (char c : value) {
+                if (c != '"' && c != ';' && static_cast<unsigned char>(c) >= 0x20 && c != 0x7F) firing.command += c;
+            }
+            i = close;
+        }
+        out.push_back(std::move(firing));
+    }
+}
+
+static uint64_t hashCvars(const StatusView& status) {
+    uint64_t hash = 14695981039346656037ull;
+    auto mix = [&hash](std::string_view text) {
+        for (char c : text) hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+        hash = (hash ^ 0xFF) * 1099511628211ull;
+    };
+    for (size_t i = 0; i < status.cvarCount; ++i) {
+        mix(status.cvars[i].key);
+        mix(status.cvars[i].value);
+    }
+    return hash;
+}
+
+size_t RuleEngine::evaluate(const std::string& server, const StatusView& status, const PlayersView& players,
+    uint64_t nowMs, std::vector<RuleFiring>& out) {
+    ServerState& state = servers[server];
+    if (state.generation != generation) resolve(server, state);
+    if (state.serverRules.empty() && state.playerRules.empty()) {
+        return 0;
+    }
+
+    // Which of the fields the rules read changed since the last poll; everything counts as changed on the first
+    uint32_t changed = state.polls == 0 ? ~0u : 0;
+    ++state.polls;
+    RuleFacts& facts = state.facts;
+    auto update = [&](RuleField field, std::string_view value) {
+        if (!(state.fields & bit(field))) return;
+        std::string normalized = PlayerIndex::normalize(value);
+        int i = static_cast<int>(field);
+        if (normalized == facts.text[i] && state.polls > 1) return;
+        facts.text[i] = std::move(normalized);
+        facts.numeric[i] = parseNumber(facts.text[i], facts.number[i]);
+        changed |= bit(field);
+    };
+    char digits[24];
+    std::to_chars_result printed = std::to_chars(digits, digits + sizeof(digits), players.count);
+    update(RuleField::Players, std::string_view(digits, static_cast<size_t>(printed.ptr - digits)));
+    update(RuleField::MaxClients, status.maxclients);
+    update(RuleField::Map, status.mapname);
+    update(RuleField::Gametype, status.gametype);
+    update(RuleField::Hostname, status.hostname);
+    if (state.fields & bit(RuleField::Cvar)) {
+        uint64_t hash = hashCvars(status);
+        if (hash != state.cvarHash || state.polls == 1) {
+            state.cvarHash = hash;
+            facts.cvars.clear();
+            for (size_t i = 0; i < status.cvarCount; ++i) {
+                facts.cvars.emplace_back(lowercase(status.cvars[i].key), PlayerIndex::normalize(status.cvars[i].value));
+            }
+            changed |= bit(RuleField::Cvar);
+        }
+    }
+
+    size_t evaluated = 0;
+    for (size_t i = 0; i < state.serverRules.size(); ++i) {
+        uint32_t index = state.serverRules[i];
+        const Rule& rule = list[index];
+        RuleState& ruleState = state.states[i];
+        if (!(rule.predicate.fields() & changed) && !ruleState.pending) continue;
+        ++evaluated;
+        if (step(ruleState, rule.predicate.evaluate(facts, nullptr), rule, nowMs)) {
+            fire(index, server, status, players.count, nullptr, out);
+        }
+    }
+
+    if (!state.playerRules.empty()) {
+        for (size_t row = 0; row < players.count; ++row) {
+            const PlayerView& player = players.rows[row];
+            key.assign(player.slot.data(), player.slot.size()).append(1, '\n').append(player.name.data(), player.name.size());
+            auto found = state.players.find(key);
+            if (found == state.players.end()) {
+                found = state.players.emplace(key, PlayerState()).first;
+                found->second.rules.resize(state.playerRules.size());
+            }
+            PlayerState& known = found->second;
+            uint32_t rowChanged = changed;
+            if (known.seen == 0) rowChanged = ~0u; // Joined
+            if (known.ping != player.ping) {
+                known.ping.assign(player.ping.data(), player.ping.size());
+                rowChanged |= bit(RuleField::Ping);
+            }
+            if (known.score != player.score) {
+                known.score.assign(player.score.data(), player.score.size());
+                rowChanged |= bit(RuleField::Score);
+            }
+            known.seen = state.polls;
+
+            bool filled = false;
+            for (size_t i = 0; i < state.playerRules.size(); ++i) {
+                uint32_t index = state.playerRules[i];
+                const Rule& rule = list[index];
+                RuleState& ruleState = known.rules[i];
+                if (!(rule.predicate.fields() & rowChanged) && !ruleState.pending) continue;
+                if (!filled) {
+                    playerFacts.set(RuleField::Slot, player.slot);
+                    playerFacts.set(RuleField::Name, player.name);
+                    playerFacts.set(RuleField::Ping, player.ping);
+                    playerFacts.set(RuleField::Score, player.score);
+                    filled = true;
+                }
+                ++evaluated;
+                if (step(ruleState, rule.predicate.evaluate(facts, &playerFacts), rule, nowMs)) {
+                    fire(index, server, status, players.count, &player, out);
+                }
+            }
+        }
+        // Players who left take their rule states with them
+        for (auto it = state.players.begin(); it != state.players.end();) {
+            if (it->second.seen == state.polls) ++it;
+            else it = state.players.erase(it);
+        }
+    }
+    return evaluated;
+}
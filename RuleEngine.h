@@ -0,0 +1,149 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "StatusParser.h"
+
+// What a rule condition can read. Server fields come from getstatus plus the row count of rcon status;
+// a condition that reads a player field is checked once per player.
+enum class RuleField : uint8_t {
+    Players,
+    MaxClients,
+    Map,
+    Gametype,
+    Hostname,
+    Cvar,                         // Any cvar.<name>
+    Slot,
+    Name,
+    Ping,
+    Score,
+    Count
+};
+
+constexpr uint32_t kPlayerRuleFields = 1u << static_cast<int>(RuleField::Slot) | 1u << static_cast<int>(RuleField::Name) |
+    1u << static_cast<int>(RuleField::Ping) | 1u << static_cast<int>(RuleField::Score);
+
+// One poll's values as conditions see them. Text is color-stripped and lowercased; number is set where
+// the whole text is numeric. Server facts fill the server fields and cvars, player facts the player fields.
+struct RuleFacts {
+    std::string text[static_cast<int>(RuleField::Count)];
+    double number[static_cast<int>(RuleField::Count)] = {};
+    bool numeric[static_cast<int>(RuleField::Count)] = {};
+    std::vector<std::pair<std::string, std::string>> cvars; // Lowercased name, normalized value
+
+    void set(RuleField field, std::string_view value);
+};
+
+// A rule condition compiled to postfix code for a small fixed-size stack machine, so checking it
+// allocates nothing; && and || skip their right side when the left decides. Operators: || && ! (also or, and, not), == != < <= > >=, parentheses; "strings",
+// numbers, field names and cvar.<name>. Two numbers compare as numbers, anything else as normalized
+// text; == and != against a literal containing * or ? are glob matches.
+class RulePredicate {
+public:
+    static const size_t kMaxDepth = 16;
+
+    bool compile(std::string_view text, std::string& error);
+    // player is null for a condition that reads no player field.
+    bool evaluate(const RuleFacts& server, const RuleFacts* player) const;
+    uint32_t fields() const { return mask; } // 1 << RuleField for every field read
+    bool perPlayer() const { return (mask & kPlayerRuleFields) != 0; }
+
+private:
+    enum class Op : uint8_t { Number, Text, Field, Cvar, Equal, NotEqual, Match, NoMatch, Less, LessEqual, Greater, GreaterEqual,
+        And, Or, Not, JumpIfFalse, JumpIfTrue };
+    struct Instruction {
+        Op op;
+        RuleField field;
+        uint32_t text;            // Into texts: literal or cvar name; for jumps, the instruction to go on from
+        double number;
+    };
+    friend class RuleCompiler;
+
+    std::vector<Instruction> code;
+    std::vector<std::string> texts;
+    uint32_t mask = 0;
+};
+
+// One automated action: when condition becomes true on a server (or for a player on it), each action
+// is sent there, at most once per cooldown.
+struct Rule {
+    std::string name;
+    std::string servers = "*";    // Glob on the server name, case-insensitive
+    std::string condition;
+    std::vector<std::string> actions; // Console lines; {slot} {name} {ping} {score} {map} {gametype} {players} {server} are filled in
+    uint64_t cooldownMs = 60000;
+    RulePredicate predicate;      // Compiled by RuleEngine::add
+};
+
+struct RuleFiring {
+    uint32_t rule = 0;            // Index into RuleEngine::rules()
+    std::string command;          // Filled in; polled values lose the characters that could end or split the command
+    std::string slot;             // Player rules only
+    std::string name;
+};
+
+// Rules from an ini file, checked against every poll as it arrives. Each server remembers the fields
+// of its last poll and where every rule stood, so a poll only re-checks the rules that read a field
+// that changed, and the rules list per server is resolved once per load. Fires on the edge from false
+// to true; an edge inside the cooldown fires once the cooldown is over if the condition still holds.
+// Used from the UI thread only.
+class RuleEngine {
+public:
+    // Replaces the rules with path's. Rules that do not compile are skipped and described in errors.
+    size_t load(const std::string& path, std::vector<std::string>& errors);
+    // True if path was written since the last load.
+    bool changedOnDisk(const std::string& path) const;
+    bool add(Rule rule, std::string& error);
+    void clear();
+    const std::vector<Rule>& rules() const { return list; }
+
+    // Checks server's rules against one complete poll and adds what fires to out. Returns how many
+    // conditions were evaluated.
+    size_t evaluate(const std::string& server, const StatusView& status, const PlayersView& players,
+        uint64_t nowMs, std::vector<RuleFiring>& out);
+    // Drops servers that are no longer in the list.
+    void retain(const std::vector<std::string>& servers);
+
+private:
+    struct RuleState {
+        bool holding = false;     // Condition true at the last check
+        bool pending = false;     // Became true and has not fired yet
+        uint64_t firedMs = 0;
+    };
+    struct PlayerState {
+        std::string ping;
+        std::string score;
+        uint64_t seen = 0;        // Poll that last showed the player
+        std::vector<RuleState> rules; // Parallel to ServerState::playerRules
+    };
+    struct ServerState {
+        uint64_t generation = 0;  // Rules generation the lists below were built for
+        std::vector<uint32_t> serverRules;
+        std::vector<uint32_t> playerRules;
+        uint32_t fields = 0;      // Read by any of them
+        std::vector<RuleState> states; // Parallel to serverRules
+        RuleFacts facts;
+        uint64_t cvarHash = 0;
+        uint64_t polls = 0;
+        std::unordered_map<std::string, PlayerState> players; // By slot and name
+    };
+
+    static void stamp(const std::string& path, uintmax_t& size, int64_t& time);
+
+    void resolve(const std::string& name, ServerState& state) const;
+    bool step(RuleState& state, bool holds, const Rule& rule, uint64_t nowMs) const;
+    void fire(uint32_t rule, const std::string& server, const StatusView& status, size_t playerCount,
+        const PlayerView* player, std::vector<RuleFiring>& out) const;
+
+    std::vector<Rule> list;
+    uint64_t generation = 1;      // Bumped by every change to list
+    std::unordered_map<std::string, ServerState> servers;
+    std::string key;              // Scratch for player lookups
+    RuleFacts playerFacts;
+    uintmax_t fileSize = 0;
+    int64_t writeTime = 0;
+};
@@ -3,10 +3,12 @@
 // Handles loading, saving, validating, and deleting game server configurations.
 
 #include "ServerManager.h"
+#include "DefaultsCatalog.h"
+#include "ListCatalog.h"
+#include "Validation.h"
 #include <fstream>
 #include <sstream>
 #include <algorithm>
-#include <regex>
 #include <ctime>
 
 // Logs a debug message to debug.log with a timestamp.
@@ -15,7 +17,11 @@ void ServerManager::logDebug(const std::string& message) {
     if (logFile.is_open()) {
         std::time_t now = std::time(nullptr);
         char timeStr[26];
+#ifdef _WIN32
         ctime_s(timeStr, sizeof(timeStr), &now);
+#else
+        ctime_r(&now, timeStr);
+#endif
         timeStr[24] = '\0'; // Remove newline
         logFile << "[" << timeStr << "] " << message << "\n";
         logFile.close();
@@ -24,93 +30,22 @@ void ServerManager::logDebug(const std::string& message) {
 
 // Validates an IP address or hostname.
 bool ServerManager::validateIpOrHostname(const std::string& input) {
-    if (input.empty()) {
-        return false; // Empty input is invalid
-    }
-
-    // Validate IP address format
-    std::regex ipRegex(R"(^(\d{1,3})\.(\d{1,3})\.(\d{1,3})\.(\d{1,3})$)");
-    std::smatch match;
-    if (std::regex_match(input, match, ipRegex)) {
-        for (size_t i = 1; i <= 4; ++i) {
-            std::string segment = match[i].str();
-            if (segment.size() > 1 && segment[0] == '0') {
-                return false; // Leading zeros are invalid
-            }
-            try {
-                size_t pos;
-                int num = std::stoi(segment, &pos);
-                if (pos != segment.size() || num < 0 || num > 255) {
-                    return false; // Invalid segment
-                }
-            }
-            catch (...) {
-                return false; // Conversion error
-            }
-        }
-        return true;
-    }
-
-    // Validate hostname format
-    if (input.size() > 255) {
-        return false; // Hostname too long
-    }
-    std::regex hostnameRegex(R"(^[a-zA-Z0-9][a-zA-Z0-9-]*(\.[a-zA-Z0-9][a-zA-Z0-9-]*)+$)");
-    if (!std::regex_match(input, hostnameRegex)) {
-        return false; // Invalid hostname format
-    }
-    if (input.find("..") != std::string::npos || input[0] == '-' || input[input.size() - 1] == '-') {
-        return false; // Invalid characters or structure
-    }
-    return true;
+    return Validation::isIpOrHostname(input);
 }
 
 // Validates a network port number.
 bool ServerManager::validatePort(int port) {
-    return port >= 1 && port <= 65535; // Valid port range
+    return Validation::isPort(port); // Valid port range
 }
 
 // Validates the format of a comma-separated key:value list.
 bool ServerManager::validateListFormat(const std::string& input) {
-    if (input.empty()) {
-        return true; // Empty list is valid
-    }
-    std::stringstream ss(input);
-    std::string pair;
-    while (std::getline(ss, pair, ',')) {
-        size_t pos = pair.find(':');
-        if (pos == std::string::npos || pos == 0 || pos == pair.size() - 1) {
-            return false; // Invalid pair format
-        }
-    }
-    return true;
+    return Validation::isListFormat(input);
 }
 
-// Validates a server configuration.
+// Validates a server configuration (fields are trimmed before checking).
 bool ServerManager::validateServer(const Server& server) {
-    // Trim whitespace from strings
-    std::string name = server.name;
-    name.erase(0, name.find_first_not_of(" \t\r\n"));
-    name.erase(name.find_last_not_of(" \t\r\n") + 1);
-
-    std::string ipOrHostname = server.ipOrHostname;
-    ipOrHostname.erase(0, ipOrHostname.find_first_not_of(" \t\r\n"));
-    ipOrHostname.erase(ipOrHostname.find_last_not_of(" \t\r\n") + 1);
-
-    std::string gametypes = server.gametypes;
-    gametypes.erase(0, gametypes.find_first_not_of(" \t\r\n"));
-    gametypes.erase(gametypes.find_last_not_of(" \t\r\n") + 1);
-
-    std::string maps = server.maps;
-    maps.erase(0, maps.find_first_not_of(" \t\r\n"));
-    maps.erase(maps.find_last_not_of(" \t\r\n") + 1);
-
-    // Check all required fields
-    return !name.empty() &&
-        validateIpOrHostname(ipOrHostname) &&
-        validatePort(server.port) &&
-        validateListFormat(gametypes) &&
-        validateListFormat(maps);
+    return Validation::checkServer(server) == ValidationError::None;
 }
 
 // Loads server configurations from servers.ini.
@@ -146,7 +81,10 @@ std::vector<Server> ServerManager::loadServers() {
             try { server.port = std::stoi(value); }
             catch (...) { server.port = -1; }
         }
-        else if (key == "game") server.game = value;
+        else if (key == "game") {
+            server.game = value;
+            server.gameId = GameTraits::resolve(value);
+        }
         else if (key == "protocol") {
             try { server.protocolId = std::stoi(value); }
             catch (...) { server.protocolId = 0; }
@@ -160,6 +98,11 @@ std::vector<Server> ServerManager::loadServers() {
         servers.push_back(server);
     }
     file.close();
+    // Build the shared map and gametype catalogs now rather than on the first refresh
+    for (const Server& loaded : servers) {
+        ListCatalog::get(loaded.maps);
+        ListCatalog::get(loaded.gametypes);
+    }
     return servers;
 }
 
@@ -219,54 +162,17 @@ void ServerManager::deleteServer(const std::string& name) {
 
 // Returns a list of supported games and their protocol IDs.
 std::vector<std::pair<std::string, int>> ServerManager::getGameOptions() {
-    return {
-        {"Medal of Honor: Allied Assault", 1},
-        {"Medal of Honor: AA Spearhead", 1},
-        {"Medal of Honor: AA Breakthrough", 1},
-        {"Call of Duty", 2},
-        {"Call of Duty: United Offensive", 2},
-        {"Call of Duty 2", 2},
-        {"Call of Duty 4: Modern Warfare", 2},
-        {"Call of Duty: World at War", 2}
-    };
+    return GameTraits::gameOptions();
 }
 
 // Retrieves default maps for a game from default_maps.ini.
 std::string ServerManager::getDefaultMaps(const std::string& game) {
-    std::ifstream file("default_maps.ini");
-    std::string line, section, maps;
-    while (std::getline(file, line)) {
-        if (line.empty()) continue;
-        if (line[0] == '[' && line.back() == ']') {
-            section = line.substr(1, line.size() - 2);
-            continue;
-        }
-        if (section == game && line.find("maps=") == 0) {
-            maps = line.substr(5);
-            break;
-        }
-    }
-    file.close();
-    return maps;
+    return std::string(DefaultsCatalog::maps().current()->find(game));
 }
 
 // Retrieves default gametypes for a game from default_gametypes.ini.
 std::string ServerManager::getDefaultGametypes(const std::string& game) {
-    std::ifstream file("default_gametypes.ini");
-    std::string line, section, gametypes;
-    while (std::getline(file, line)) {
-        if (line.empty()) continue;
-        if (line[0] == '[' && line.back() == ']') {
-            section = line.substr(1, line.size() - 2);
-            continue;
-        }
-        if (section == game && line.find("gametypes=") == 0) {
-            gametypes = line.substr(10);
-            break;
-        }
-    }
-    file.close();
-    return gametypes;
+    return std::string(DefaultsCatalog::gametypes().current()->find(game));
 }
 
 // Parses a comma-separated key:value list into a map.
@@ -1,14 +1,15 @@
 #pragma once
 #include <string>
 #include <vector>
-#include <Windows.h>
 #include <map>
+#include "GameTraits.h"
 
 struct Server {
     std::string name;
     std::string ipOrHostname;
     int port = -1;
     std::string game;
+    GameId gameId = GameId::Unknown; // Resolved from game when loaded
     int protocolId = 0;
     std::string rconPassword;
     std::string gametypes; // Format: "id:humanreadable,id2:humanreadable2"
@@ -4,8 +4,8 @@
 #include "ServerManager.h"
 #include "UIComponents.h"
 #include "UIRcon.h"
+#include "Validation.h"
 #include <commctrl.h>
-#include <regex>
 
 // Declaration for hideAllPageControls from main.cpp
 extern void hideAllPageControls(HWND hwnd, bool showingServerPage);
@@ -44,6 +44,7 @@ void ServerPage::handleServerPage(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lPa
             if (gameIndex >= 0 && gameIndex < static_cast<int>(games.size())) {
                 server.game = games[gameIndex].first;
                 server.protocolId = games[gameIndex].second;
+                server.gameId = GameTraits::resolve(server.game);
             }
             else {
                 UIComponents::setOutputMessage(hwnd, "Error: Invalid game selection");
@@ -85,10 +86,10 @@ void ServerPage::handleServerPage(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lPa
                 return;
             }
             if (!ServerManager::validateIpOrHostname(server.ipOrHostname)) {
-                std::regex ipAttempt(R"(^(\d{1,3})\.(\d{1,3})\.(\d{1,3})\.(\d{1,3})$)");
-                std::string errorMsg = std::regex_match(server.ipOrHostname, ipAttempt)
-                    ? "Error: Invalid IP address (use format: 192.168.0.1)"
-                    : "Error: Invalid hostname (use format: example.com)";
+                ValidationError error = Validation::looksLikeIPv4(server.ipOrHostname) ? ValidationError::BadIPv4
+                    : Validation::isIPv6(server.ipOrHostname) ? ValidationError::IPv6Unsupported
+                    : ValidationError::BadHostname;
+                std::string errorMsg = std::string("Error: ") + Validation::describe(error);
                 UIComponents::setOutputMessage(hwnd, errorMsg.c_str());
                 return;
             }
@@ -0,0 +1,92 @@
+// --- xRcon\ServerQuery.cpp ---
+// Implementation of the query layer over GameServerQuery.
+// Serializes queries into the DLL, releases its replies, and records the exchange when a capture is active.
+
+#include "ServerQuery.h"
+#include "GameServerQuery.h"
+#include "TrafficCapture.h"
+#include <cstring>
+#include <mutex>
+
+#pragma comment(lib, "GameServerQuery.lib") // Link GameServerQuery library
+
+// GameServerQuery makes no thread-safety promises; refreshes run on the query worker while rcon
+// commands are sent from the UI thread, so queries take turns. Freeing a reply needs no lock.
+static std::mutex dllMutex;
+
+// Hands a null-terminated command to the DLL, attaching the password to rcon commands.
+static const char* process(const Server& server, std::string_view command, uint32_t& sequence) {
+    bool isRcon = command.compare(0, 4, "rcon") == 0;
+    sequence = TrafficCapture::recordRequest(server.ipOrHostname, server.port, server.protocolId, server.gameId, command);
+    std::lock_guard<std::mutex> lock(dllMutex);
+    return ProcessGameServerCommand(
+        server.protocolId,
+        false,
+        server.ipOrHostname.c_str(),
+        server.port,
+        command.data(),
+        isRcon && !server.rconPassword.empty() ? server.rconPassword.c_str() : ""
+    );
+}
+
+// Sends a query or RCON command and keeps the DLL's reply buffer for in-place parsing.
+bool ServerQuery::query(const Server& server, const std::string& command, QueryReply& reply) {
+    reply.release();
+    uint32_t sequence = 0;
+    const char* raw = process(server, command, sequence);
+
+    reply.owned = raw;
+    reply.success = raw && strncmp(raw, "error=", 6) != 0;
+    reply.reply = raw ? std::string_view(raw) : std::string_view("No response from server");
+
+    TrafficCapture::recordResponse(sequence, server.ipOrHostname, server.port, server.protocolId, server.gameId, reply.success, reply.reply);
+    return reply.success;
+}
+
+// Sends an RCON command built with RconCommand.
+bool ServerQuery::rcon(const Server& server, const RconCommand& command, std::string& response) {
+    if (!command.valid() || command.empty()) {
+        response = command.valid() ? "Command is empty" : "Command is too long or has an argument the server would misread";
+        return false;
+    }
+    char line[5 + kMaxRconLine + 1];
+    std::memcpy(line, "rcon ", 5);
+    std::memcpy(line + 5, command.c_str(), command.size() + 1);
+
+    uint32_t sequence = 0;
+    const char* reply = process(server, std::string_view(line, 5 + command.size()), sequence);
+
+    bool ok = reply && strncmp(reply, "error=", 6) != 0;
+    response = reply ? reply : "No response from server";
+    if (reply) FreeGameServerResponse(reply); // Free allocated response memory
+
+    TrafficCapture::recordResponse(sequence, server.ipOrHostname, server.port, server.protocolId, server.gameId, ok, response);
+    return ok;
+}
+
+QueryReply::QueryReply(QueryReply&& other) noexcept
+    : owned(other.owned), reply(other.reply), success(other.success) {
+    other.owned = nullptr;
+    other.reply = std::string_view();
+    other.success = false;
+}
+
+QueryReply& QueryReply::operator=(QueryReply&& other) noexcept {
+    if (this != &other) {
+        release();
+        owned = other.owned;
+        reply = other.reply;
+        success = other.success;
+        other.owned = nullptr;
+        other.reply = std::string_view();
+        other.success = false;
+    }
+    return *this;
+}
+
+void QueryReply::release() {
+    if (owned) FreeGameServerResponse(owned); // Free allocated response memory
+    owned = nullptr;
+    reply = std::string_view();
+    success = false;
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include "ServerManager.h"
+#include "RconPacket.h"
+
+// A GameServerQuery reply used in place. Owns the DLL's buffer and returns it with
+// FreeGameServerResponse when destroyed or reassigned, so views parsed from text() stay valid
+// exactly as long as the QueryReply they came from.
+class QueryReply {
+public:
+    QueryReply() = default;
+    ~QueryReply() { release(); }
+    QueryReply(const QueryReply&) = delete;
+    QueryReply& operator=(const QueryReply&) = delete;
+    QueryReply(QueryReply&& other) noexcept;
+    QueryReply& operator=(QueryReply&& other) noexcept;
+
+    // The reply, or the error text when ok() is false.
+    std::string_view text() const { return reply; }
+    bool ok() const { return success; }
+    void release();
+
+private:
+    friend class ServerQuery;
+
+    const char* owned = nullptr;  // DLL allocation, null for the built-in "No response" text
+    std::string_view reply;
+    bool success = false;
+};
+
+// Single entry point for queries and commands sent through GameServerQuery.
+class ServerQuery {
+public:
+    // Sends command to server; reply takes over the DLL's buffer, or holds the error text on failure. Its
+    // previous contents are released first. The RCON password is attached to commands starting with "rcon".
+    static bool query(const Server& server, const std::string& command, QueryReply& reply);
+    // Sends "rcon <command>" with the server's password. The line is assembled on the stack; an invalid
+    // or over-long command fails without being sent.
+    static bool rcon(const Server& server, const RconCommand& command, std::string& response);
+};
@@ -0,0 +1,618 @@
+// --- xRcon\SessionLog.cpp ---
+// Implementation of the persistent player session log.
+// Journals are replayed into memory on open; segments are mapped and searched through their sorted indexes.
+
+#include "SessionLog.h"
+#include "PlayerIndex.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <queue>
+#include <unordered_map>
+
+static uint32_t fnv1a(std::string_view text, uint32_t hash = 2166136261u) {
+    for (char c : text) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static size_t padded(size_t length) {
+    return (length + 7) & ~static_cast<size_t>(7);
+}
+
+static FILE* openFile(const std::string& path, const char* mode) {
+    FILE* file = nullptr;
+#ifdef _WIN32
+    if (fopen_s(&file, path.c_str(), mode) != 0) file = nullptr;
+#else
+    file = fopen(path.c_str(), mode);
+#endif
+    return file;
+}
+
+static void removeFile(const std::string& path) {
+    std::error_code error;
+    std::filesystem::remove(path, error);
+}
+
+uint32_t SessionLog::nameHash(std::string_view name) {
+    return fnv1a(PlayerIndex::normalize(name));
+}
+
+uint32_t SessionLog::serverHash(std::string_view server) {
+    return fnv1a(server);
+}
+
+std::string SessionLog::journalPath(uint32_t number) const {
+    char name[32];
+    snprintf(name, sizeof(name), "journal-%08u.dat", number);
+    return (std::filesystem::path(directory) / name).string();
+}
+
+std::string SessionLog::segmentPath(uint32_t first, uint32_t last) const {
+    char name[40];
+    snprintf(name, sizeof(name), "seg-%08u-%08u.dat", first, last);
+    return (std::filesystem::path(directory) / name).string();
+}
+
+// Builds one segment: strings are stored once, rows must arrive in join order.
+namespace {
+struct Interned {
+    uint32_t ref;
+    uint32_t nameHash;
+    uint32_t serverHash;
+};
+
+class SegmentWriter {
+public:
+    const Interned& intern(std::string_view text) {
+        text = text.substr(0, 0xFFFF);
+        auto it = interned.find(text);
+        if (it != interned.end()) return it->second;
+        Interned entry{ static_cast<uint32_t>(strings.size()), SessionLog::nameHash(text), SessionLog::serverHash(text) };
+        uint16_t length = static_cast<uint16_t>(text.size());
+        strings.append(reinterpret_cast<const char*>(&length), sizeof(length));
+        strings.append(text.data(), text.size());
+        keys.emplace_back(text);
+        return interned.emplace(keys.back(), entry).first->second;
+    }
+
+    void add(uint64_t joinUnixMs, uint32_t durationMs, uint32_t ip, const Interned& server, const Interned& name, const Interned& guid) {
+        uint64_t row = rows.size();
+        SessionRow entry;
+        std::memset(&entry, 0, sizeof(entry));
+        entry.joinUnixMs = joinUnixMs;
+        entry.durationMs = durationMs;
+        entry.ip = ip;
+        entry.server = server.ref;
+        entry.name = name.ref;
+        entry.guid = guid.ref;
+        rows.push_back(entry);
+        byAddress.push_back(static_cast<uint64_t>(ip) << 32 | row);
+        byName.push_back(static_cast<uint64_t>(name.nameHash) << 32 | row);
+        byServer.push_back(static_cast<uint64_t>(server.serverHash) << 32 | row);
+        firstJoin = std::min(firstJoin, joinUnixMs);
+        lastLeave = std::max(lastLeave, joinUnixMs + durationMs);
+        maxDuration = std::max(maxDuration, durationMs);
+    }
+
+    size_t size() const { return rows.size(); }
+
+    // Writes through a temporary file, so a segment either exists whole or not at all.
+    bool write(const std::string& path, uint32_t firstJournal, uint32_t lastJournal) {
+        std::sort(byAddress.begin(), byAddress.end());
+        std::sort(byName.begin(), byName.end());
+        std::sort(byServer.begin(), byServer.end());
+
+        SessionSegmentHeader header;
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, "XRSESS\0\0", 8);
+        header.version = kSessionVersion;
+        header.rowCount = static_cast<uint32_t>(rows.size());
+        header.firstJoinUnixMs = firstJoin;
+        header.lastLeaveUnixMs = lastLeave;
+        header.firstJournal = firstJournal;
+        header.lastJournal = lastJournal;
+        header.maxDurationMs = maxDuration;
+        header.stringsLength = static_cast<uint32_t>(strings.size());
+        header.stringsOffset = sizeof(header) + rows.size() * sizeof(SessionRow);
+        header.indexOffset = header.stringsOffset + padded(strings.size());
+
+        std::string temporary = path + ".tmp";
+        FILE* file = openFile(temporary, "wb");
+        if (!file) return false;
+        setvbuf(file, nullptr, _IOFBF, 1 << 16);
+        static const char zeros[8] = {};
+        size_t padding = padded(strings.size()) - strings.size();
+        bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+        ok = ok && fwrite(rows.data(), sizeof(SessionRow), rows.size(), file) == rows.size();
+        ok = ok && fwrite(strings.data(), 1, strings.size(), file) == strings.size();
+        ok = ok && fwrite(zeros, 1, padding, file) == padding;
+        for (const std::vector<uint64_t>* index : { &byAddress, &byName, &byServer }) {
+            ok = ok && fwrite(index->data(), sizeof(uint64_t), index->size(), file) == index->size();
+        }
+        ok = fclose(file) == 0 && ok;
+
+        std::error_code error;
+        if (ok) std::filesystem::rename(temporary, path, error);
+        if (!ok || error) {
+            removeFile(temporary);
+            return false;
+        }
+        return true;
+    }
+
+private:
+    std::string strings;
+    std::deque<std::string> keys;                   // Stable storage for the map's keys
+    std::unordered_map<std::string_view, Interned> interned;
+    std::vector<SessionRow> rows;
+    std::vector<uint64_t> byAddress;
+    std::vector<uint64_t> byName;
+    std::vector<uint64_t> byServer;
+    uint64_t firstJoin = UINT64_MAX;
+    uint64_t lastLeave = 0;
+    uint32_t maxDuration = 0;
+};
+}
+
+bool SessionLog::openSegment(const std::string& path, Segment& segment) {
+    segment.path = path;
+    segment.file.reset(new MappedFile());
+    MappedFile& file = *segment.file;
+    if (!file.openRead(path) || file.size() < sizeof(SessionSegmentHeader)) {
+        return false;
+    }
+    SessionSegmentHeader& header = segment.header;
+    std::memcpy(&header, file.data(), sizeof(header));
+    uint64_t rowsEnd = sizeof(header) + static_cast<uint64_t>(header.rowCount) * sizeof(SessionRow);
+    if (std::memcmp(header.magic, "XRSESS\0\0", 8) != 0 || header.version != kSessionVersion ||
+        header.rowCount == 0 || header.stringsOffset != rowsEnd ||
+        header.indexOffset != header.stringsOffset + padded(header.stringsLength) ||
+        header.indexOffset + 3 * static_cast<uint64_t>(header.rowCount) * sizeof(uint64_t) != file.size()) {
+        return false;
+    }
+    // Every part starts on an 8-byte boundary of a page-aligned mapping
+    segment.rows = reinterpret_cast<const SessionRow*>(file.data() + sizeof(header));
+    segment.strings = file.data() + header.stringsOffset;
+    segment.indexes = reinterpret_cast<const uint64_t*>(file.data() + header.indexOffset);
+    return true;
+}
+
+std::string_view SessionLog::stringAt(const Segment& segment, uint32_t ref) {
+    uint64_t limit = segment.header.stringsLength;
+    if (static_cast<uint64_t>(ref) + 2 > limit) return std::string_view();
+    uint16_t length;
+    std::memcpy(&length, segment.strings + ref, sizeof(length));
+    if (static_cast<uint64_t>(ref) + 2 + length > limit) return std::string_view();
+    return std::string_view(reinterpret_cast<const char*>(segment.strings) + ref + 2, length);
+}
+
+bool SessionLog::openJournal(uint32_t number) {
+    FILE* file = openFile(journalPath(number), "ab");
+    if (!file) return false;
+    if (journal) fclose(journal);
+    journal = file;
+    journalNumber = number;
+    return true;
+}
+
+// Adds the intact records of a journal to rows; a torn last record ends the replay.
+static size_t replayJournal(const std::string& path, SessionRows& rows) {
+    MappedFile file;
+    if (!file.openRead(path)) return 0;
+    const unsigned char* data = file.data();
+    size_t size = file.size();
+    size_t at = 0;
+    size_t added = 0;
+    while (size - at >= sizeof(SessionJournalRecord)) {
+        SessionJournalRecord record;
+        std::memcpy(&record, data + at, sizeof(record));
+        size_t body = static_cast<size_t>(record.serverLength) + record.nameLength + record.guidLength;
+        if (body > size - at - sizeof(record)) break;
+        const char* bytes = reinterpret_cast<const char*>(data + at + sizeof(record));
+        if (fnv1a(std::string_view(bytes, body)) != record.checksum) break;
+        at += sizeof(record) + std::min(padded(body), size - at - sizeof(record));
+
+        SessionRecord session;
+        session.server.assign(bytes, record.serverLength);
+        session.name.assign(bytes + record.serverLength, record.nameLength);
+        session.guid.assign(bytes + record.serverLength + record.nameLength, record.guidLength);
+        session.ip = record.ip;
+        session.joinUnixMs = record.joinUnixMs;
+        session.leaveUnixMs = record.joinUnixMs + record.durationMs;
+        rows.nameHashes.push_back(SessionLog::nameHash(session.name));
+        rows.rows.push_back(std::move(session));
+        ++added;
+    }
+    return added;
+}
+
+bool SessionLog::open(const std::string& path) {
+    close();
+    namespace fs = std::filesystem;
+    directory = path;
+    std::error_code error;
+    fs::create_directories(directory, error);
+    if (!fs::is_directory(directory, error)) {
+        return false;
+    }
+
+    std::vector<Segment> found;
+    std::vector<std::pair<uint32_t, std::string>> journals;
+    for (fs::directory_iterator it(directory, error), end; !error && it != end; it.increment(error)) {
+        std::string name = it->path().filename().string();
+        std::string file = it->path().string();
+        unsigned first = 0, last = 0;
+        if (name.size() > 4 && name.compare(name.size() - 4, 4, ".tmp") == 0) {
+            removeFile(file); // An interrupted seal or merge
+        }
+        else if (sscanf(name.c_str(), "seg-%8u-%8u.dat", &first, &last) == 2) {
+            Segment segment;
+            if (openSegment(file, segment) && segment.header.firstJournal == first && segment.header.lastJournal == last) {
+                found.push_back(std::move(segment));
+            }
+        }
+        else if (sscanf(name.c_str(), "journal-%8u.dat", &first) == 1) {
+            journals.emplace_back(first, file);
+        }
+    }
+
+    // A merge that was interrupted after writing its output leaves inputs it covers; the wider one wins
+    std::sort(found.begin(), found.end(), [](const Segment& a, const Segment& b) {
+        return a.header.firstJournal != b.header.firstJournal ? a.header.firstJournal < b.header.firstJournal
+            : a.header.lastJournal > b.header.lastJournal;
+    });
+    uint32_t covered = 0;
+    for (Segment& segment : found) {
+        if (!segments.empty() && segment.header.lastJournal <= segments.back().header.lastJournal) {
+            segment.file.reset();
+            removeFile(segment.path);
+            continue;
+        }
+        covered = std::max(covered, segment.header.lastJournal);
+        segments.push_back(std::move(segment));
+    }
+
+    // Journals a segment holds are leftovers of an interrupted seal; the rest are replayed
+    std::sort(journals.begin(), journals.end());
+    uint32_t next = covered + 1;
+    pendingFirstJournal = 0;
+    for (const auto& entry : journals) {
+        next = std::max(next, entry.first + 1);
+        if (entry.first <= covered || replayJournal(entry.second, pending) == 0) {
+            removeFile(entry.second);
+            continue;
+        }
+        if (pendingFirstJournal == 0) pendingFirstJournal = entry.first;
+    }
+    if (pendingFirstJournal == 0) pendingFirstJournal = next;
+    sealLeftovers = !pending.rows.empty();
+    if (!openJournal(next)) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void SessionLog::close() {
+    if (journal) {
+        fclose(journal);
+        journal = nullptr;
+    }
+    segments.clear();
+    pending = SessionRows();
+    sealing.reset();
+    jobRunning = false;
+    sealLeftovers = false;
+}
+
+bool SessionLog::append(const std::vector<SessionRecord>& sessions) {
+    if (!journal) {
+        return false;
+    }
+    static const char zeros[8] = {};
+    bool ok = true;
+    for (const SessionRecord& session : sessions) {
+        std::string_view server = std::string_view(session.server).substr(0, 0xFFFF);
+        std::string_view name = std::string_view(session.name).substr(0, 0xFFFF);
+        std::string_view guid = std::string_view(session.guid).substr(0, 0xFFFF);
+        SessionJournalRecord record;
+        std::memset(&record, 0, sizeof(record));
+        record.joinUnixMs = session.joinUnixMs;
+        uint64_t duration = session.leaveUnixMs > session.joinUnixMs ? session.leaveUnixMs - session.joinUnixMs : 0;
+        record.durationMs = static_cast<uint32_t>(std::min<uint64_t>(duration, UINT32_MAX));
+        record.ip = session.ip;
+        record.serverLength = static_cast<uint16_t>(server.size());
+        record.nameLength = static_cast<uint16_t>(name.size());
+        record.guidLength = static_cast<uint16_t>(guid.size());
+        record.checksum = fnv1a(guid, fnv1a(name, fnv1a(server)));
+        size_t body = server.size() + name.size() + guid.size();
+        ok = ok && fwrite(&record, sizeof(record), 1, journal) == 1;
+        ok = ok && fwrite(server.data(), 1, server.size(), journal) == server.size();
+        ok = ok && fwrite(name.data(), 1, name.size(), journal) == name.size();
+        ok = ok && fwrite(guid.data(), 1, guid.size(), journal) == guid.size();
+        ok = ok && fwrite(zeros, 1, padded(body) - body, journal) == padded(body) - body;
+
+        SessionRecord kept;
+        kept.server.assign(server.data(), server.size());
+        kept.name.assign(name.data(), name.size());
+        kept.guid.assign(guid.data(), guid.size());
+        kept.ip = session.ip;
+        kept.joinUnixMs = session.joinUnixMs;
+        kept.leaveUnixMs = session.joinUnixMs + record.durationMs;
+        pending.nameHashes.push_back(nameHash(kept.name));
+        pending.rows.push_back(std::move(kept));
+    }
+    return fflush(journal) == 0 && ok;
+}
+
+uint64_t SessionLog::rowCount() const {
+    uint64_t count = pending.rows.size() + (sealing ? sealing->rows.size() : 0);
+    for (const Segment& segment : segments) count += segment.header.rowCount;
+    return count;
+}
+
+size_t SessionLog::query(const SessionQuery& query, std::vector<SessionRecord>& out) const {
+    out.clear();
+    std::string key;
+    uint32_t hash = 0;
+    uint64_t low = 0, last = 0; // Index entries [low, last] are candidates
+    int index = 0;
+    if (query.by == SessionQuery::By::Address) {
+        low = static_cast<uint64_t>(query.ipBase & query.ipMask) << 32;
+        last = static_cast<uint64_t>(query.ipBase | ~query.ipMask) << 32 | 0xFFFFFFFFull;
+    }
+    else {
+        if (query.by == SessionQuery::By::Name) {
+            key = PlayerIndex::normalize(query.text);
+            hash = fnv1a(key);
+            index = 1;
+        }
+        else {
+            hash = serverHash(query.text);
+            index = 2;
+        }
+        low = static_cast<uint64_t>(hash) << 32;
+        last = low | 0xFFFFFFFFull;
+    }
+    auto inTime = [&query](uint64_t joinUnixMs, uint64_t leaveUnixMs) {
+        return joinUnixMs <= query.untilUnixMs && leaveUnixMs >= query.sinceUnixMs;
+    };
+
+    struct Hit {
+        uint64_t joinUnixMs;
+        const SessionRecord* record;  // Or a segment row
+        const Segment* segment;
+        uint32_t row;
+    };
+    std::vector<Hit> hits;
+
+    for (const SessionRows* rows : { &pending, sealing.get() }) {
+        if (!rows) continue;
+        for (size_t i = 0; i < rows->rows.size(); ++i) {
+            const SessionRecord& row = rows->rows[i];
+            bool match = query.by == SessionQuery::By::Address ? (row.ip & query.ipMask) == (query.ipBase & query.ipMask)
+                : query.by == SessionQuery::By::Name ? rows->nameHashes[i] == hash && PlayerIndex::normalize(row.name) == key
+                : row.server == query.text;
+            if (match && inTime(row.joinUnixMs, row.leaveUnixMs)) hits.push_back(Hit{ row.joinUnixMs, &row, nullptr, 0 });
+        }
+    }
+
+    std::unordered_map<uint32_t, bool> verified; // String ref -> matches, per segment
+    for (const Segment& segment : segments) {
+        const SessionSegmentHeader& header = segment.header;
+        if (header.lastLeaveUnixMs < query.sinceUnixMs || header.firstJoinUnixMs > query.untilUnixMs) continue;
+        const uint64_t* begin = segment.indexes + static_cast<size_t>(index) * header.rowCount;
+        const uint64_t* end = begin + header.rowCount;
+        const uint64_t* from = std::lower_bound(begin, end, low);
+        const uint64_t* to = std::upper_bound(from, end, last);
+        // Rows are in join order, so one key's entries are too: the time window is a subrange of them
+        if (query.by != SessionQuery::By::Address) {
+            const SessionRow* rows = segment.rows;
+            uint64_t earliest = query.sinceUnixMs > header.maxDurationMs ? query.sinceUnixMs - header.maxDurationMs : 0;
+            from = std::partition_point(from, to, [rows, earliest](uint64_t entry) {
+                return rows[static_cast<uint32_t>(entry)].joinUnixMs < earliest;
+            });
+            to = std::partition_point(from, to, [rows, &query](uint64_t entry) {
+                return rows[static_cast<uint32_t>(entry)].joinUnixMs <= query.untilUnixMs;
+            });
+        }
+        verified.clear();
+        for (const uint64_t* entry = from; entry != to; ++entry) {
+            uint32_t r = static_cast<uint32_t>(*entry);
+            if (r >= header.rowCount) continue;
+            const SessionRow& row = segment.rows[r];
+            if (!inTime(row.joinUnixMs, row.joinUnixMs + row.durationMs)) continue;
+            if (query.by != SessionQuery::By::Address) {
+                // Hashes can collide; each distinct string is checked once
+                uint32_t ref = query.by == SessionQuery::By::Name ? row.name : row.server;
+                auto known = verified.find(ref);
+                if (known == verified.end()) {
+                    std::string_view text = stringAt(segment, ref);
+                    bool match = query.by == SessionQuery::By::Name ? PlayerIndex::normalize(text) == key : text == query.text;
+                    known = verified.emplace(ref, match).first;
+                }
+                if (!known->second) continue;
+            }
+            hits.push_back(Hit{ row.joinUnixMs, nullptr, &segment, r });
+        }
+    }
+
+    size_t keep = std::min(query.limit, hits.size());
+    std::partial_sort(hits.begin(), hits.begin() + keep, hits.end(),
+        [](const Hit& a, const Hit& b) { return a.joinUnixMs > b.joinUnixMs; });
+    out.reserve(keep);
+    for (size_t i = 0; i < keep; ++i) {
+        const Hit& hit = hits[i];
+        if (hit.record) {
+            out.push_back(*hit.record);
+            continue;
+        }
+        const SessionRow& row = hit.segment->rows[hit.row];
+        SessionRecord session;
+        std::string_view text = stringAt(*hit.segment, row.server);
+        session.server.assign(text.data(), text.size());
+        text = stringAt(*hit.segment, row.name);
+        session.name.assign(text.data(), text.size());
+        text = stringAt(*hit.segment, row.guid);
+        session.guid.assign(text.data(), text.size());
+        session.ip = row.ip;
+        session.joinUnixMs = row.joinUnixMs;
+        session.leaveUnixMs = row.joinUnixMs + row.durationMs;
+        out.push_back(std::move(session));
+    }
+    return hits.size();
+}
+
+// Size class of a segment: merging kMergeFanIn segments of one class yields the next class.
+static uint32_t sizeClass(uint64_t rows) {
+    uint32_t result = 0;
+    for (uint64_t limit = SessionLog::kSealRows; rows > limit; limit *= SessionLog::kMergeFanIn) ++result;
+    return result;
+}
+
+std::unique_ptr<SessionJob> SessionLog::nextJob() {
+    if (jobRunning || !journal) {
+        return nullptr;
+    }
+    std::unique_ptr<SessionJob> job(new SessionJob());
+    if (!pending.rows.empty() && (pending.rows.size() >= kSealRows || sealLeftovers)) {
+        // New sessions go to the next journal while this one is sealed
+        uint32_t sealed = journalNumber;
+        if (!openJournal(sealed + 1)) return nullptr;
+        job->firstJournal = pendingFirstJournal;
+        job->lastJournal = sealed;
+        job->output = segmentPath(job->firstJournal, job->lastJournal);
+        job->rows = sealing = std::make_shared<const SessionRows>(std::move(pending));
+        pending = SessionRows();
+        pendingFirstJournal = journalNumber;
+        sealLeftovers = false;
+        jobRunning = true;
+        return job;
+    }
+
+    if (segments.size() < kMergeFanIn) {
+        return nullptr;
+    }
+    size_t first = segments.size() - kMergeFanIn;
+    uint32_t size = sizeClass(segments[first].header.rowCount);
+    uint64_t rows = 0;
+    for (size_t i = first; i < segments.size(); ++i) {
+        if (sizeClass(segments[i].header.rowCount) != size) return nullptr;
+        rows += segments[i].header.rowCount;
+        job->inputs.push_back(segments[i].path);
+    }
+    if (rows > kMaxSegmentRows) {
+        return nullptr;
+    }
+    job->firstJournal = segments[first].header.firstJournal;
+    job->lastJournal = segments.back().header.lastJournal;
+    job->output = segmentPath(job->firstJournal, job->lastJournal);
+    jobRunning = true;
+    return job;
+}
+
+void SessionLog::runJob(SessionJob& job) {
+    auto started = std::chrono::steady_clock::now();
+    SegmentWriter writer;
+    if (job.rows) {
+        const std::vector<SessionRecord>& rows = job.rows->rows;
+        std::vector<uint32_t> order(rows.size());
+        for (size_t i = 0; i < order.size(); ++i) order[i] = static_cast<uint32_t>(i);
+        std::stable_sort(order.begin(), order.end(),
+            [&rows](uint32_t a, uint32_t b) { return rows[a].joinUnixMs < rows[b].joinUnixMs; });
+        for (uint32_t i : order) {
+            const SessionRecord& row = rows[i];
+            uint64_t duration = row.leaveUnixMs > row.joinUnixMs ? row.leaveUnixMs - row.joinUnixMs : 0;
+            writer.add(row.joinUnixMs, static_cast<uint32_t>(std::min<uint64_t>(duration, UINT32_MAX)), row.ip,
+                writer.intern(row.server), writer.intern(row.name), writer.intern(row.guid));
+        }
+    }
+    else {
+        // Inputs are each sorted by join time; their rows are merged through a heap
+        std::vector<Segment> inputs(job.inputs.size());
+        std::vector<std::vector<std::pair<uint32_t, Interned>>> remap(inputs.size()); // Input ref -> output entry
+        for (size_t i = 0; i < inputs.size(); ++i) {
+            if (!openSegment(job.inputs[i], inputs[i])) return;
+            for (uint32_t ref = 0; ref + 2 <= inputs[i].header.stringsLength;) {
+                std::string_view text = stringAt(inputs[i], ref);
+                remap[i].emplace_back(ref, writer.intern(text));
+                ref += 2 + static_cast<uint32_t>(text.size());
+            }
+        }
+        auto lookup = [&remap](size_t input, uint32_t ref) {
+            const auto& table = remap[input];
+            auto it = std::lower_bound(table.begin(), table.end(), ref,
+                [](const std::pair<uint32_t, Interned>& entry, uint32_t value) { return entry.first < value; });
+            return it != table.end() && it->first == ref ? it->second : table.front().second;
+        };
+        using Head = std::pair<uint64_t, std::pair<uint32_t, uint32_t>>; // Join time, input, row
+        std::priority_queue<Head, std::vector<Head>, std::greater<Head>> heads;
+        for (uint32_t i = 0; i < inputs.size(); ++i) heads.push(Head(inputs[i].rows[0].joinUnixMs, { i, 0u }));
+        while (!heads.empty()) {
+            Head head = heads.top();
+            heads.pop();
+            uint32_t input = head.second.first;
+            uint32_t r = head.second.second;
+            const SessionRow& row = inputs[input].rows[r];
+            writer.add(row.joinUnixMs, row.durationMs, row.ip,
+                lookup(input, row.server), lookup(input, row.name), lookup(input, row.guid));
+            if (++r < inputs[input].header.rowCount) heads.push(Head(inputs[input].rows[r].joinUnixMs, { input, r }));
+        }
+    }
+    job.rowCount = writer.size();
+    job.ok = writer.size() > 0 && writer.write(job.output, job.firstJournal, job.lastJournal);
+    job.elapsedMs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - started).count());
+}
+
+void SessionLog::finishJob(std::unique_ptr<SessionJob> job) {
+    if (!job || !jobRunning) {
+        return; // The log was closed while the job ran; the next open sorts out its files
+    }
+    jobRunning = false;
+    Segment segment;
+    bool adopted = job->ok && openSegment(job->output, segment);
+    if (!adopted) {
+        segment.file.reset();
+        removeFile(job->output);
+    }
+
+    if (job->rows) {
+        if (adopted) {
+            segments.push_back(std::move(segment));
+            for (uint32_t number = job->firstJournal; number <= job->lastJournal; ++number) removeFile(journalPath(number));
+        }
+        else {
+            // The rows stay in memory and their journals on disk; the next seal takes them again
+            SessionRows rows(*sealing);
+            rows.rows.insert(rows.rows.end(), std::make_move_iterator(pending.rows.begin()), std::make_move_iterator(pending.rows.end()));
+            rows.nameHashes.insert(rows.nameHashes.end(), pending.nameHashes.begin(), pending.nameHashes.end());
+            pending = std::move(rows);
+            pendingFirstJournal = job->firstJournal;
+        }
+        sealing.reset();
+        return;
+    }
+
+    if (!adopted) {
+        return;
+    }
+    size_t at = segments.size();
+    for (size_t i = 0; i < segments.size();) {
+        if (std::find(job->inputs.begin(), job->inputs.end(), segments[i].path) == job->inputs.end()) {
+            ++i;
+            continue;
+        }
+        at = std::min(at, i);
+        segments[i].file.reset(); // Unmapped first; Windows will not delete a mapped file
+        removeFile(segments[i].path);
+        segments.erase(segments.begin() + i);
+    }
+    segments.insert(segments.begin() + std::min(at, segments.size()), std::move(segment));
+}
@@ -0,0 +1,169 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "MappedFile.h"
+
+// One visit of a player to a server, from the first poll that showed them to the first that did not.
+struct SessionRecord {
+    std::string server;
+    std::string name;             // As reported, with color codes
+    std::string guid;
+    uint32_t ip = 0;              // IPv4 in host order, 0 when the address has none
+    uint64_t joinUnixMs = 0;
+    uint64_t leaveUnixMs = 0;
+};
+
+struct SessionQuery {
+    enum class By { Address, Name, Server };
+    By by = By::Address;
+    uint32_t ipBase = 0;          // Address: sessions whose ip & ipMask == ipBase
+    uint32_t ipMask = ~0u;
+    std::string text;             // Name (matched color-stripped and case-insensitively), or exact server name
+    uint64_t sinceUnixMs = 0;     // Leaves out sessions that ended before this
+    uint64_t untilUnixMs = UINT64_MAX; // and sessions that began after this
+    size_t limit = 100;
+};
+
+// On-disk layout; all fields little-endian, everything 8-byte aligned.
+// Journal file "journal-<n>.dat": { SessionJournalRecord, server, name, guid bytes, zero padding } ...
+// Segment file "seg-<first>-<last>.dat", holding the sessions of journals first..last:
+//   SessionSegmentHeader
+//   SessionRow[rowCount]          sorted by joinUnixMs
+//   string table                  { uint16 length, bytes } ..., rows refer to entries by byte offset
+//   address index                 uint64[rowCount] ip << 32 | row, sorted
+//   name index                    uint64[rowCount] hash of the color-stripped lowercased name << 32 | row, sorted
+//   server index                  uint64[rowCount] hash of the server name << 32 | row, sorted
+struct SessionJournalRecord {
+    uint64_t joinUnixMs;
+    uint32_t durationMs;
+    uint32_t ip;
+    uint16_t serverLength;
+    uint16_t nameLength;
+    uint16_t guidLength;
+    uint16_t reserved;
+    uint32_t checksum;            // Of the string bytes; a torn last record fails it
+    uint32_t reserved2;
+};
+
+struct SessionSegmentHeader {
+    char magic[8];                // "XRSESS\0\0"
+    uint32_t version;             // kSessionVersion
+    uint32_t rowCount;
+    uint64_t firstJoinUnixMs;
+    uint64_t lastLeaveUnixMs;
+    uint32_t firstJournal;
+    uint32_t lastJournal;
+    uint32_t maxDurationMs;
+    uint32_t stringsLength;
+    uint64_t stringsOffset;
+    uint64_t indexOffset;
+    uint64_t reserved;
+};
+
+struct SessionRow {
+    uint64_t joinUnixMs;
+    uint32_t durationMs;
+    uint32_t ip;
+    uint32_t server;              // String table offsets
+    uint32_t name;
+    uint32_t guid;
+    uint32_t reserved;
+};
+
+static_assert(sizeof(SessionJournalRecord) == 32, "Session journal layout changed");
+static_assert(sizeof(SessionSegmentHeader) == 72, "Session segment header layout changed");
+static_assert(sizeof(SessionRow) == 32, "Session row layout changed");
+
+static const uint32_t kSessionVersion = 1;
+
+// Sessions not sealed into a segment yet, with their name hashes.
+struct SessionRows {
+    std::vector<SessionRecord> rows;
+    std::vector<uint32_t> nameHashes;
+};
+
+// Background work on the session files. A seal writes journal rows into a segment; a merge combines
+// segments into one. Built on the UI thread, run on the query worker, then handed back.
+struct SessionJob {
+    std::string output;
+    uint32_t firstJournal = 0;
+    uint32_t lastJournal = 0;
+    std::shared_ptr<const SessionRows> rows;  // Seal
+    std::vector<std::string> inputs;          // Merge
+    bool ok = false;
+    uint64_t rowCount = 0;
+    uint64_t elapsedMs = 0;
+};
+
+// Who played where, when, and under which name and address, kept for good in a directory. Finished
+// sessions are appended to a journal, which is sealed into an immutable segment with sorted indexes
+// once it is large enough; segments of similar size are merged in the background so a query binary
+// searches a few dozen of them at most. Segments are memory-mapped, so only the index pages and rows a
+// query touches are read. Used from the UI thread, except for runJob.
+class SessionLog {
+public:
+    static const size_t kSealRows = 1 << 16;          // Journal rows per sealed segment
+    static const size_t kMergeFanIn = 4;              // Segments of one size class merged at once
+    static const size_t kMaxSegmentRows = 1 << 22;    // Merges stop growing a segment past this
+
+    SessionLog() = default;
+    ~SessionLog() { close(); }
+    SessionLog(const SessionLog&) = delete;
+    SessionLog& operator=(const SessionLog&) = delete;
+
+    // Opens or creates directory, replaying journals that were not sealed yet. Leftovers of an
+    // interrupted seal or merge are cleaned up.
+    bool open(const std::string& directory);
+    void close();
+    bool isOpen() const { return journal != nullptr; }
+
+    // Appends finished sessions to the journal and flushes it.
+    bool append(const std::vector<SessionRecord>& sessions);
+
+    // Sessions matching query, newest first, at most query.limit of them. Returns how many matched in all.
+    size_t query(const SessionQuery& query, std::vector<SessionRecord>& out) const;
+
+    uint64_t rowCount() const;
+    size_t segmentCount() const { return segments.size(); }
+
+    // The next seal or merge, or null if none is needed or one is still running.
+    std::unique_ptr<SessionJob> nextJob();
+    // Writes job's segment. Touches only files, so it may run on any thread.
+    static void runJob(SessionJob& job);
+    // Adopts the segment runJob wrote and deletes what it replaces, or puts things back if it failed.
+    void finishJob(std::unique_ptr<SessionJob> job);
+
+    static uint32_t nameHash(std::string_view name);
+    static uint32_t serverHash(std::string_view server);
+
+private:
+    struct Segment {
+        std::string path;
+        std::unique_ptr<MappedFile> file;
+        SessionSegmentHeader header;
+        const SessionRow* rows = nullptr;
+        const unsigned char* strings = nullptr;
+        const uint64_t* indexes = nullptr;     // Address, name, server; rowCount entries each
+    };
+
+    static bool openSegment(const std::string& path, Segment& segment);
+    static std::string_view stringAt(const Segment& segment, uint32_t ref);
+    bool openJournal(uint32_t number);
+    std::string journalPath(uint32_t number) const;
+    std::string segmentPath(uint32_t first, uint32_t last) const;
+
+    std::string directory;
+    FILE* journal = nullptr;
+    uint32_t journalNumber = 0;
+    uint32_t pendingFirstJournal = 0;          // Oldest journal whose rows are in pending
+    SessionRows pending;
+    std::shared_ptr<const SessionRows> sealing; // Rows of a running seal, still queried from memory
+    std::vector<Segment> segments;             // Ordered by firstJournal
+    bool jobRunning = false;
+    bool sealLeftovers = false;                // Journals of an earlier run were replayed
+};
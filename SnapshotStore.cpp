@@ -0,0 +1,143 @@
+// --- xRcon\SnapshotStore.cpp ---
+// Implementation of the per-server snapshot cache.
+// Replacing or dropping a snapshot only releases its owner; anything still showing it keeps its own reference.
+// Snapshots also persist to a warm-start file so the last known state can be shown before any query returns.
+
+#include "SnapshotStore.h"
+#include "MappedFile.h"
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <unordered_set>
+#include <utility>
+
+static size_t padded(size_t length) {
+    return (length + 7) & ~static_cast<size_t>(7);
+}
+
+bool SnapshotStore::put(const std::string& server, ServerSnapshot snapshot) {
+    if (!snapshot.complete()) return false;
+    auto it = snapshots.find(server);
+    if (it == snapshots.end()) {
+        snapshots.emplace(server, std::move(snapshot));
+        ++changeCount;
+        return true;
+    }
+    if (!it->second.stale && snapshot.fetchedMs < it->second.fetchedMs) return false; // A slower, older reply
+    it->second = std::move(snapshot);
+    ++changeCount;
+    return true;
+}
+
+const ServerSnapshot* SnapshotStore::find(const std::string& server) const {
+    auto it = snapshots.find(server);
+    return it == snapshots.end() ? nullptr : &it->second;
+}
+
+bool SnapshotStore::isWarm(const std::string& server, uint64_t nowMs, uint64_t maxAgeMs) const {
+    const ServerSnapshot* snapshot = find(server);
+    return snapshot && !snapshot->stale && nowMs - snapshot->fetchedMs <= maxAgeMs;
+}
+
+void SnapshotStore::retain(const std::vector<std::string>& names) {
+    std::unordered_set<std::string_view> keep(names.begin(), names.end());
+    for (auto it = snapshots.begin(); it != snapshots.end();) {
+        if (keep.count(it->first)) ++it;
+        else it = snapshots.erase(it);
+    }
+}
+
+bool SnapshotStore::save(const std::string& path, uint64_t nowMs, uint64_t nowUnixMs) const {
+    std::string temporary = path + ".tmp";
+    FILE* file = nullptr;
+#ifdef _WIN32
+    if (fopen_s(&file, temporary.c_str(), "wb") != 0) file = nullptr;
+#else
+    file = fopen(temporary.c_str(), "wb");
+#endif
+    if (!file) {
+        return false;
+    }
+    setvbuf(file, nullptr, _IOFBF, 1 << 16);
+
+    SnapshotFileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, "XRSNAP\0\0", 8);
+    header.version = kSnapshotVersion;
+    header.count = static_cast<uint32_t>(snapshots.size());
+    header.savedUnixMs = nowUnixMs;
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+
+    static const char zeros[8] = {};
+    for (const auto& entry : snapshots) {
+        const ServerSnapshot& snapshot = entry.second;
+        SnapshotRecordHeader record;
+        std::memset(&record, 0, sizeof(record));
+        uint64_t age = nowMs > snapshot.fetchedMs ? nowMs - snapshot.fetchedMs : 0;
+        record.fetchedUnixMs = nowUnixMs > age ? nowUnixMs - age : 0;
+        record.nameLength = static_cast<uint32_t>(entry.first.size());
+        record.statusLength = static_cast<uint32_t>(snapshot.status.size());
+        record.playersLength = static_cast<uint32_t>(snapshot.players.size());
+        size_t body = entry.first.size() + snapshot.status.size() + snapshot.players.size();
+        ok = ok && fwrite(&record, sizeof(record), 1, file) == 1;
+        ok = ok && fwrite(entry.first.data(), 1, entry.first.size(), file) == entry.first.size();
+        ok = ok && fwrite(snapshot.status.data(), 1, snapshot.status.size(), file) == snapshot.status.size();
+        ok = ok && fwrite(snapshot.players.data(), 1, snapshot.players.size(), file) == snapshot.players.size();
+        ok = ok && fwrite(zeros, 1, padded(body) - body, file) == padded(body) - body;
+    }
+    ok = fclose(file) == 0 && ok;
+
+    std::error_code error;
+    if (ok) std::filesystem::rename(temporary, path, error);
+    if (!ok || error) {
+        std::filesystem::remove(temporary, error);
+        return false;
+    }
+    return true;
+}
+
+size_t SnapshotStore::load(const std::string& path, uint64_t nowMs, uint64_t nowUnixMs) {
+    MappedFile file;
+    if (!file.openRead(path) || file.size() < sizeof(SnapshotFileHeader)) {
+        return 0;
+    }
+    SnapshotFileHeader header;
+    std::memcpy(&header, file.data(), sizeof(header));
+    if (std::memcmp(header.magic, "XRSNAP\0\0", 8) != 0 || header.version != kSnapshotVersion) {
+        return 0;
+    }
+
+    // Snapshots point into one copy of the records, so the file is unmapped again straight away and
+    // the next save can replace it (Windows will not replace a file that is still mapped)
+    auto records = std::make_shared<std::string>(reinterpret_cast<const char*>(file.data()) + sizeof(header),
+        file.size() - sizeof(header));
+    file.close();
+
+    size_t added = 0;
+    size_t at = 0;
+    for (uint32_t i = 0; i < header.count && records->size() - at >= sizeof(SnapshotRecordHeader); ++i) {
+        SnapshotRecordHeader record;
+        std::memcpy(&record, records->data() + at, sizeof(record));
+        at += sizeof(record);
+        uint64_t body = static_cast<uint64_t>(record.nameLength) + record.statusLength + record.playersLength;
+        if (body > records->size() - at) break; // Truncated file
+        const char* bytes = records->data() + at;
+        at += padded(static_cast<size_t>(body));
+        if (at > records->size()) at = records->size();
+
+        std::string name(bytes, record.nameLength);
+        if (name.empty() || snapshots.count(name)) continue;
+        ServerSnapshot snapshot;
+        snapshot.owner = records;
+        snapshot.status = std::string_view(bytes + record.nameLength, record.statusLength);
+        snapshot.players = std::string_view(bytes + record.nameLength + record.statusLength, record.playersLength);
+        snapshot.statusOk = snapshot.playersOk = true;
+        uint64_t age = nowUnixMs > record.fetchedUnixMs ? nowUnixMs - record.fetchedUnixMs : 0;
+        snapshot.fetchedMs = nowMs > age ? nowMs - age : 0;
+        snapshot.stale = true;
+        snapshots.emplace(std::move(name), std::move(snapshot));
+        ++added;
+    }
+    if (added) ++changeCount;
+    return added;
+}
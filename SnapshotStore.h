@@ -0,0 +1,71 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Replies from one refresh of a server. The views point into buffers kept alive by owner, so a
+// snapshot can be shown, stored and shown again without copying the reply text.
+struct ServerSnapshot {
+    std::shared_ptr<const void> owner;
+    std::string_view status;      // getstatus reply, or its error text
+    std::string_view players;     // rcon status reply, or its error text
+    bool statusOk = false;
+    bool playersOk = false;
+    uint64_t fetchedMs = 0;       // Tick count when the replies arrived
+    bool stale = false;           // Loaded from the warm-start file and not refreshed since
+
+    bool complete() const { return statusOk && playersOk; }
+};
+
+// Warm-start file layout. All fields are little-endian and every record starts on an 8-byte boundary:
+//   SnapshotFileHeader
+//   { SnapshotRecordHeader, name bytes, status bytes, players bytes, zero padding } ...
+struct SnapshotFileHeader {
+    char magic[8];                // "XRSNAP\0\0"
+    uint32_t version;             // kSnapshotVersion
+    uint32_t count;               // Records that follow
+    uint64_t savedUnixMs;
+    uint64_t reserved;
+};
+
+struct SnapshotRecordHeader {
+    uint64_t fetchedUnixMs;
+    uint32_t nameLength;
+    uint32_t statusLength;
+    uint32_t playersLength;
+    uint32_t reserved;
+};
+
+static_assert(sizeof(SnapshotFileHeader) == 32, "Snapshot header layout changed");
+static_assert(sizeof(SnapshotRecordHeader) == 24, "Snapshot record layout changed");
+
+static const uint32_t kSnapshotVersion = 1;
+
+// Last complete snapshot per server name, filled by refreshes and prefetches alike so switching to
+// a server can show it before its own refresh returns. Used from the UI thread only.
+class SnapshotStore {
+public:
+    // Keeps snapshot if it is complete and newer than what is held for server (or what is held is stale).
+    bool put(const std::string& server, ServerSnapshot snapshot);
+    const ServerSnapshot* find(const std::string& server) const;
+    // Held, not stale, and fetched no more than maxAgeMs before nowMs.
+    bool isWarm(const std::string& server, uint64_t nowMs, uint64_t maxAgeMs) const;
+    // Drops servers that are no longer in the list.
+    void retain(const std::vector<std::string>& names);
+    void clear() { snapshots.clear(); }
+    size_t size() const { return snapshots.size(); }
+    uint64_t changes() const { return changeCount; } // Bumped by every stored snapshot
+
+    // Writes every snapshot to path through a temporary file, so an interrupted save leaves the old file.
+    // nowMs is the tick count the snapshots' fetchedMs is measured in; nowUnixMs the matching wall clock.
+    bool save(const std::string& path, uint64_t nowMs, uint64_t nowUnixMs) const;
+    // Maps path and adds its snapshots for servers not held yet, marked stale. Returns how many were added.
+    size_t load(const std::string& path, uint64_t nowMs, uint64_t nowUnixMs);
+
+private:
+    std::unordered_map<std::string, ServerSnapshot> snapshots;
+    uint64_t changeCount = 0;
+};
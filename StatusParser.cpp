@@ -0,0 +1,264 @@
+// --- xRcon\StatusParser.cpp ---
+// Implementation of the status reply parser.
+// Extracts server settings from getstatus replies and player rows from rcon status replies.
+
+#include "StatusParser.h"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
+// Compares two player tables by slot and name, merging slot-sorted indexes.
+void StatusParser::diffPlayers(const PlayersView& previous, const PlayersView& current, PlayerDiff& diff) {
+    diff.joined.clear();
+    diff.left.clear();
+    diff.changed.clear();
+    auto sortBySlot = [](const PlayersView& players, std::vector<size_t>& order) {
+        order.resize(players.count);
+        for (size_t i = 0; i < players.count; ++i) order[i] = i;
+        const PlayerView* rows = players.rows;
+        std::sort(order.begin(), order.end(), [rows](size_t a, size_t b) {
+            int bySlot = rows[a].slot.compare(rows[b].slot);
+            return bySlot != 0 ? bySlot < 0 : rows[a].name < rows[b].name;
+        });
+    };
+    sortBySlot(previous, diff.previousOrder);
+    sortBySlot(current, diff.currentOrder);
+
+    size_t p = 0, c = 0;
+    while (p < diff.previousOrder.size() && c < diff.currentOrder.size()) {
+        const PlayerView& before = previous.rows[diff.previousOrder[p]];
+        const PlayerView& after = current.rows[diff.currentOrder[c]];
+        int order = before.slot.compare(after.slot);
+        if (order == 0) order = before.name.compare(after.name);
+        if (order < 0) {
+            diff.left.push_back(diff.previousOrder[p++]);
+        }
+        else if (order > 0) {
+            diff.joined.push_back(diff.currentOrder[c++]);
+        }
+        else {
+            if (before.score != after.score || before.ping != after.ping || before.address != after.address) {
+                diff.changed.push_back(diff.currentOrder[c]);
+            }
+            ++p;
+            ++c;
+        }
+    }
+    while (p < diff.previousOrder.size()) diff.left.push_back(diff.previousOrder[p++]);
+    while (c < diff.currentOrder.size()) diff.joined.push_back(diff.currentOrder[c++]);
+}
+
+static const size_t npos = std::string_view::npos;
+
+static size_t skipSpace(std::string_view json, size_t pos) {
+    while (pos < json.size() && isspace(static_cast<unsigned char>(json[pos]))) ++pos;
+    return pos;
+}
+
+// Reads the string starting at the opening quote at pos. Returns the position after the closing quote.
+// Escapes are kept as-is, like extractField.
+static size_t scanString(std::string_view json, size_t pos, std::string_view& out) {
+    size_t start = pos + 1;
+    size_t from = start;
+    while (from < json.size()) {
+        const void* quote = std::memchr(json.data() + from, '"', json.size() - from);
+        if (!quote) break;
+        size_t at = static_cast<size_t>(static_cast<const char*>(quote) - json.data());
+        size_t slashes = 0;
+        while (at - slashes > start && json[at - slashes - 1] == '\\') ++slashes;
+        if (slashes % 2 == 0) {
+            out = json.substr(start, at - start);
+            return at + 1;
+        }
+        from = at + 1; // Escaped quote
+    }
+    return npos;
+}
+
+// Skips the array at pos, counting the objects directly inside it. Returns the position after the array.
+static size_t countArrayObjects(std::string_view json, size_t pos, size_t& objects) {
+    int depth = 0;
+    for (size_t i = pos; i < json.size(); ++i) {
+        char c = json[i];
+        if (c == '"') {
+            std::string_view ignored;
+            i = scanString(json, i, ignored);
+            if (i == npos) return npos;
+            --i;
+        }
+        else if (c == '{' || c == '[') {
+            if (c == '{' && depth == 1) ++objects;
+            ++depth;
+        }
+        else if ((c == '}' || c == ']') && --depth == 0) {
+            return i + 1;
+        }
+    }
+    return npos;
+}
+
+// Reads any value at pos: strings without quotes, objects and arrays as raw text, scalars up to the next delimiter.
+static size_t scanValue(std::string_view json, size_t pos, std::string_view& out) {
+    if (pos >= json.size()) return npos;
+    if (json[pos] == '"') return scanString(json, pos, out);
+    if (json[pos] == '{' || json[pos] == '[') {
+        int depth = 0;
+        for (size_t i = pos; i < json.size(); ++i) {
+            char c = json[i];
+            if (c == '"') {
+                std::string_view ignored;
+                i = scanString(json, i, ignored);
+                if (i == npos) return npos;
+                --i;
+            }
+            else if (c == '{' || c == '[') {
+                ++depth;
+            }
+            else if ((c == '}' || c == ']') && --depth == 0) {
+                out = json.substr(pos, i + 1 - pos);
+                return i + 1;
+            }
+        }
+        return npos;
+    }
+    size_t end = pos;
+    while (end < json.size() && json[end] != ',' && json[end] != '}' && json[end] != ']' &&
+        !isspace(static_cast<unsigned char>(json[end]))) ++end;
+    out = json.substr(pos, end - pos);
+    return end;
+}
+
+// Appends to an arena array, doubling it into fresh arena storage when full.
+template <typename T>
+static void pushBack(ParseArena& arena, T*& items, size_t& count, size_t& capacity, const T& item) {
+    if (count == capacity) {
+        size_t grown = capacity ? capacity * 2 : 16;
+        T* larger = arena.allocateArray<T>(grown);
+        for (size_t i = 0; i < count; ++i) larger[i] = items[i];
+        items = larger;
+        capacity = grown;
+    }
+    items[count++] = item;
+}
+
+// Walks the top-level object once, keeping every field as a view and counting player objects.
+void StatusParser::parseServerStatus(std::string_view json, bool gametypeIsString, ParseArena& arena, StatusView& status) {
+    status = StatusView();
+    std::string_view text = json;
+    std::string_view gametypeKey = gametypeIsString ? "g_gametypestring" : "g_gametype";
+    CvarView* cvars = nullptr;
+    size_t capacity = 0;
+
+    size_t pos = skipSpace(text, 0);
+    if (pos >= text.size() || text[pos] != '{') return;
+    ++pos;
+    while (true) {
+        pos = skipSpace(text, pos);
+        if (pos >= text.size() || text[pos] != '"') break;
+        CvarView field;
+        pos = scanString(text, pos, field.key);
+        if (pos == npos) break;
+        pos = skipSpace(text, pos);
+        if (pos >= text.size() || text[pos] != ':') break;
+        pos = skipSpace(text, pos + 1);
+        if (field.key == "players" && pos < text.size() && text[pos] == '[') {
+            pos = countArrayObjects(text, pos, status.playerCount);
+            if (pos == npos) break;
+        }
+        else {
+            pos = scanValue(text, pos, field.value);
+            if (pos == npos) break;
+            if (field.key == "sv_hostname") status.hostname = field.value;
+            else if (field.key == "mapname") status.mapname = field.value;
+            else if (field.key == gametypeKey) status.gametype = field.value;
+            else if (field.key == "sv_maxclients") status.maxclients = field.value;
+            pushBack(arena, cvars, status.cvarCount, capacity, field);
+        }
+
+        pos = skipSpace(text, pos);
+        if (pos < text.size() && text[pos] == ',') ++pos;
+    }
+    status.cvars = cvars;
+}
+
+// Reads the players array in place. Rows without a slot or name are skipped, as in the copying parser.
+bool StatusParser::parsePlayers(std::string_view json, ParseArena& arena, PlayersView& players, std::string& error) {
+    players = PlayersView();
+    std::string_view text = json;
+    size_t pos = text.find("\"players\":");
+    if (pos == npos) {
+        error = "Invalid response format";
+        return false;
+    }
+    pos = skipSpace(text, pos + 10);
+    if (pos >= text.size() || text[pos] != '[') {
+        error = "Invalid response format: Could not find array end";
+        return false;
+    }
+    ++pos;
+
+    PlayerView* rows = nullptr;
+    size_t count = 0, capacity = 0;
+    while (true) {
+        pos = skipSpace(text, pos);
+        if (pos < text.size() && text[pos] == ',') {
+            ++pos;
+            continue;
+        }
+        if (pos >= text.size()) {
+            error = "Invalid response format: Could not find array end";
+            return false;
+        }
+        if (text[pos] == ']') break;
+        if (text[pos] != '{') {
+            std::string_view ignored;
+            pos = scanValue(text, pos, ignored); // Not a player object
+            if (pos == npos) {
+                error = "Invalid response format: Could not find array end";
+                return false;
+            }
+            continue;
+        }
+
+        // One player object
+        PlayerView row;
+        ++pos;
+        while (true) {
+            pos = skipSpace(text, pos);
+            if (pos < text.size() && text[pos] == ',') {
+                ++pos;
+                continue;
+            }
+            if (pos >= text.size()) {
+                error = "Invalid response format: Malformed player object";
+                return false;
+            }
+            if (text[pos] == '}') {
+                ++pos;
+                break;
+            }
+            std::string_view key, value;
+            if (text[pos] != '"' || (pos = scanString(text, pos, key)) == npos) {
+                error = "Invalid response format: Malformed player object";
+                return false;
+            }
+            pos = skipSpace(text, pos);
+            if (pos >= text.size() || text[pos] != ':' || (pos = scanValue(text, skipSpace(text, pos + 1), value)) == npos) {
+                error = "Invalid response format: Malformed player object";
+                return false;
+            }
+            if (key == "slot") row.slot = value;
+            else if (key == "name") row.name = value;
+            else if (key == "address") row.address = value;
+            else if (key == "score") row.score = value;
+            else if (key == "ping") row.ping = value;
+            else if (key == "guid") row.guid = value;
+        }
+        if (!row.slot.empty() && !row.name.empty()) {
+            pushBack(arena, rows, count, capacity, row);
+        }
+    }
+    players.rows = rows;
+    players.count = count;
+    return true;
+}
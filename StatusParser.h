@@ -0,0 +1,58 @@
+#pragma once
+#include "ParseArena.h"
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Views of one parsed reply. Strings point into the reply text and the arrays live in a ParseArena,
+// so a view stays valid until that arena is reset. Values are the raw JSON text between the quotes.
+struct CvarView {
+    std::string_view key;
+    std::string_view value;
+};
+
+struct PlayerView {
+    std::string_view slot;
+    std::string_view name;
+    std::string_view address;
+    std::string_view score;
+    std::string_view ping;
+    std::string_view guid;        // Empty when the server does not report one
+};
+
+struct StatusView {
+    std::string_view hostname;
+    std::string_view mapname;
+    std::string_view gametype;
+    std::string_view maxclients;
+    const CvarView* cvars = nullptr; // Top-level fields in reply order (players excluded)
+    size_t cvarCount = 0;
+    size_t playerCount = 0;
+};
+
+struct PlayersView {
+    const PlayerView* rows = nullptr;
+    size_t count = 0;
+};
+
+// Differences between two player tables, as indexes into the previous and current lists.
+// Players are matched by slot and name; reuse one instance across refreshes to avoid reallocating.
+struct PlayerDiff {
+    std::vector<size_t> joined;  // In current but not previous
+    std::vector<size_t> left;    // In previous but not current
+    std::vector<size_t> changed; // In both, with a different score, ping or address (index into current)
+    std::vector<size_t> previousOrder;
+    std::vector<size_t> currentOrder;
+
+    bool empty() const { return joined.empty() && left.empty() && changed.empty(); }
+};
+
+// Parses the JSON replies produced by GameServerQuery. Independent of the UI so it can be replayed and benchmarked.
+class StatusParser {
+public:
+    // Allocation-free: views point into json and tables go into arena, so json must outlive the arena
+    // contents; the refresh keeps each reply in its QueryReply, shared by the ServerSnapshot.
+    static void parseServerStatus(std::string_view json, bool gametypeIsString, ParseArena& arena, StatusView& status);
+    static bool parsePlayers(std::string_view json, ParseArena& arena, PlayersView& players, std::string& error);
+    static void diffPlayers(const PlayersView& previous, const PlayersView& current, PlayerDiff& diff);
+};
@@ -0,0 +1,234 @@
+// --- xRcon\TextCodec.cpp ---
+// Implementation of the display text conversions.
+// One pass per string: color codes are dropped while decoding, and plain ASCII is widened in SIMD blocks.
+
+#include "TextCodec.h"
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TEXTCODEC_SSE2 1
+#include <emmintrin.h>
+#endif
+
+// Windows-1252 0x80-0x9F. The five unassigned bytes map to the matching C1 control, as Windows does.
+static const uint16_t kCp1252High[32] = {
+    0x20AC, 0x0081, 0x201A, 0x0192, 0x201E, 0x2026, 0x2020, 0x2021,
+    0x02C6, 0x2030, 0x0160, 0x2039, 0x0152, 0x008D, 0x017D, 0x008F,
+    0x0090, 0x2018, 0x2019, 0x201C, 0x201D, 0x2022, 0x2013, 0x2014,
+    0x02DC, 0x2122, 0x0161, 0x203A, 0x0153, 0x009D, 0x017E, 0x0178
+};
+
+// Decodes the character at p. Returns the bytes it used (at least 1) and stores the code point.
+static size_t decode(const unsigned char* p, const unsigned char* end, uint32_t& codePoint) {
+    uint32_t c = *p;
+    if (c < 0x80) {
+        codePoint = c;
+        return 1;
+    }
+    int extra = (c >> 5) == 0x6 ? 1 : (c >> 4) == 0xE ? 2 : (c >> 3) == 0x1E ? 3 : -1;
+    if (extra > 0 && end - p > extra) {
+        uint32_t value = c & (0x3F >> extra);
+        bool valid = true;
+        for (int i = 1; i <= extra; ++i) {
+            if ((p[i] & 0xC0) != 0x80) {
+                valid = false;
+                break;
+            }
+            value = (value << 6) | (p[i] & 0x3F);
+        }
+        // Reject overlong forms, surrogates and values past U+10FFFF
+        static const uint32_t minimum[] = { 0, 0x80, 0x800, 0x10000 };
+        if (valid && value >= minimum[extra] && (value < 0xD800 || value > 0xDFFF) && value <= 0x10FFFF) {
+            codePoint = value;
+            return static_cast<size_t>(extra) + 1;
+        }
+    }
+    codePoint = c < 0xA0 ? kCp1252High[c - 0x80] : c; // Windows-1252
+    return 1;
+}
+
+// A color code is '^' followed by any ASCII character other than '^' (Q_IsColorString).
+static bool isColorCode(const unsigned char* p, const unsigned char* end) {
+    return p[0] == '^' && end - p > 1 && p[1] != '^' && p[1] < 0x80;
+}
+
+static wchar_t* putWide(wchar_t* out, uint32_t c) {
+    if (sizeof(wchar_t) == 2 && c >= 0x10000) {
+        c -= 0x10000;
+        *out++ = static_cast<wchar_t>(0xD800 + (c >> 10));
+        *out++ = static_cast<wchar_t>(0xDC00 + (c & 0x3FF));
+    }
+    else {
+        *out++ = static_cast<wchar_t>(c);
+    }
+    return out;
+}
+
+static char* putUtf8(char* out, uint32_t c) {
+    if (c < 0x80) {
+        *out++ = static_cast<char>(c);
+    }
+    else if (c < 0x800) {
+        *out++ = static_cast<char>(0xC0 | (c >> 6));
+        *out++ = static_cast<char>(0x80 | (c & 0x3F));
+    }
+    else if (c < 0x10000) {
+        *out++ = static_cast<char>(0xE0 | (c >> 12));
+        *out++ = static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+        *out++ = static_cast<char>(0x80 | (c & 0x3F));
+    }
+    else {
+        *out++ = static_cast<char>(0xF0 | (c >> 18));
+        *out++ = static_cast<char>(0x80 | ((c >> 12) & 0x3F));
+        *out++ = static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+        *out++ = static_cast<char>(0x80 | (c & 0x3F));
+    }
+    return out;
+}
+
+// Handles the single character (or color code) at p and returns where the next one starts.
+static const unsigned char* stepWide(const unsigned char* p, const unsigned char* end, wchar_t*& out, bool strip) {
+    if (strip && isColorCode(p, end)) return p + 2;
+    uint32_t c;
+    size_t used = decode(p, end, c);
+    out = putWide(out, c);
+    return p + used;
+}
+
+static const unsigned char* stepUtf8(const unsigned char* p, const unsigned char* end, char*& out, bool strip) {
+    if (strip && isColorCode(p, end)) return p + 2;
+    uint32_t c;
+    size_t used = decode(p, end, c);
+    out = putUtf8(out, c);
+    return p + used;
+}
+
+size_t TextCodec::toWideScalar(std::string_view text, wchar_t* out, ColorCodes colors) {
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(text.data());
+    const unsigned char* end = p + text.size();
+    wchar_t* w = out;
+    bool strip = colors == ColorCodes::Strip;
+    while (p < end) p = stepWide(p, end, w, strip);
+    *w = L'\0';
+    return static_cast<size_t>(w - out);
+}
+
+size_t TextCodec::toUtf8Scalar(std::string_view text, char* out, ColorCodes colors) {
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(text.data());
+    const unsigned char* end = p + text.size();
+    char* o = out;
+    bool strip = colors == ColorCodes::Strip;
+    while (p < end) p = stepUtf8(p, end, o, strip);
+    *o = '\0';
+    return static_cast<size_t>(o - out);
+}
+
+#ifdef TEXTCODEC_SSE2
+
+// Below this, colored names spend more on block setup than they save, so they go straight to scalar
+static const size_t kSimdMinimum = 32;
+
+static int lowestBit(unsigned mask) {
+    int bit = 0;
+    while (!(mask & 1u)) {
+        mask >>= 1;
+        ++bit;
+    }
+    return bit;
+}
+
+// Bit i is set where byte i needs the scalar path: non-ASCII, or '^' when stripping.
+static unsigned specialBytes(__m128i block, bool strip) {
+    unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(block));
+    if (strip) mask |= static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, _mm_set1_epi8('^'))));
+    return mask;
+}
+
+// Writes all 16 bytes widened; the caller advances by however many were plain ASCII.
+// Safe because output never runs ahead of input, and 16 input bytes remain.
+static void storeWide(wchar_t* out, __m128i block) {
+    const __m128i zero = _mm_setzero_si128();
+    __m128i low = _mm_unpacklo_epi8(block, zero);
+    __m128i high = _mm_unpackhi_epi8(block, zero);
+    if (sizeof(wchar_t) == 2) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), low);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 8), high);
+    }
+    else {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_unpacklo_epi16(low, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 4), _mm_unpackhi_epi16(low, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 8), _mm_unpacklo_epi16(high, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 12), _mm_unpackhi_epi16(high, zero));
+    }
+}
+
+size_t TextCodec::toWide(std::string_view text, wchar_t* out, ColorCodes colors) {
+    if (text.size() < kSimdMinimum) return toWideScalar(text, out, colors);
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(text.data());
+    const unsigned char* end = p + text.size();
+    wchar_t* w = out;
+    bool strip = colors == ColorCodes::Strip;
+    while (end - p >= 16) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        unsigned special = specialBytes(block, strip);
+        storeWide(w, block);
+        if (!special) {
+            p += 16;
+            w += 16;
+            continue;
+        }
+        int plain = lowestBit(special);
+        p += plain;
+        w += plain;
+        p = stepWide(p, end, w, strip);
+    }
+    while (p < end) p = stepWide(p, end, w, strip);
+    *w = L'\0';
+    return static_cast<size_t>(w - out);
+}
+
+size_t TextCodec::toUtf8(std::string_view text, char* out, ColorCodes colors) {
+    if (text.size() < kSimdMinimum) return toUtf8Scalar(text, out, colors);
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(text.data());
+    const unsigned char* end = p + text.size();
+    char* o = out;
+    bool strip = colors == ColorCodes::Strip;
+    while (end - p >= 16) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        unsigned special = specialBytes(block, strip);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(o), block);
+        if (!special) {
+            p += 16;
+            o += 16;
+            continue;
+        }
+        int plain = lowestBit(special);
+        p += plain;
+        o += plain;
+        p = stepUtf8(p, end, o, strip);
+    }
+    while (p < end) p = stepUtf8(p, end, o, strip);
+    *o = '\0';
+    return static_cast<size_t>(o - out);
+}
+
+bool TextCodec::simdEnabled() {
+    return true;
+}
+
+#else
+
+size_t TextCodec::toWide(std::string_view text, wchar_t* out, ColorCodes colors) {
+    return toWideScalar(text, out, colors);
+}
+
+size_t TextCodec::toUtf8(std::string_view text, char* out, ColorCodes colors) {
+    return toUtf8Scalar(text, out, colors);
+}
+
+bool TextCodec::simdEnabled() {
+    return false;
+}
+
+#endif
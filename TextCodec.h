@@ -0,0 +1,28 @@
+#pragma once
+#include <cstddef>
+#include <string_view>
+
+// What to do with Quake-style ^N color codes.
+enum class ColorCodes {
+    Keep,
+    Strip                         // Drop '^' and the character after it unless that is another '^'
+};
+
+// Converts text from game servers for display. Bytes that form valid UTF-8 are decoded as UTF-8;
+// any other byte is read as Windows-1252, which is what older servers and clients send.
+// ASCII runs are handled 16 bytes at a time with SSE2 where the build targets it; the scalar
+// versions are the reference and the fallback on other targets.
+class TextCodec {
+public:
+    // out needs room for text.size() + 1 elements (output never has more code units than input bytes).
+    // Writes a terminating null and returns the length before it. wchar_t is UTF-16 on Windows, UTF-32 elsewhere.
+    static size_t toWide(std::string_view text, wchar_t* out, ColorCodes colors = ColorCodes::Keep);
+    static size_t toWideScalar(std::string_view text, wchar_t* out, ColorCodes colors = ColorCodes::Keep);
+
+    // out needs room for 3 * text.size() + 1 bytes. Writes valid UTF-8 and a terminating null.
+    static size_t toUtf8(std::string_view text, char* out, ColorCodes colors = ColorCodes::Keep);
+    static size_t toUtf8Scalar(std::string_view text, char* out, ColorCodes colors = ColorCodes::Keep);
+
+    // Whether toWide/toUtf8 were built with the SSE2 path.
+    static bool simdEnabled();
+};
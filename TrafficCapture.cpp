@@ -0,0 +1,226 @@
+// --- xRcon\TrafficCapture.cpp ---
+// Implementation of query capture and replay.
+// Writes requests and replies to a compact binary log and plays them back through the status parser.
+
+#include "TrafficCapture.h"
+#include "StatusParser.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+static std::mutex captureMutex;                 // Guards the capture writer state
+static FILE* captureFile = nullptr;             // Open capture, or null when not capturing
+static std::chrono::steady_clock::time_point captureStart;
+static uint32_t captureSequence = 0;            // Last sequence handed out
+
+// Writes one record with its alignment padding. Caller holds captureMutex.
+static void writeRecord(CaptureKind kind, uint32_t sequence, const std::string& host, int port, int protocolId,
+    GameId gameId, const char* payload, size_t payloadLength) {
+    CaptureRecordHeader record;
+    std::memset(&record, 0, sizeof(record));
+    record.timeUs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - captureStart).count());
+    record.sequence = sequence;
+    record.kind = static_cast<uint16_t>(kind);
+    record.protocolId = static_cast<uint8_t>(protocolId);
+    record.gameId = static_cast<uint8_t>(gameId);
+    record.port = static_cast<uint16_t>(port);
+    record.hostLength = static_cast<uint16_t>(host.size() > 0xFFFF ? 0xFFFF : host.size());
+    record.payloadLength = static_cast<uint32_t>(payloadLength);
+
+    static const char padding[8] = { 0 };
+    size_t body = record.hostLength + record.payloadLength;
+    fwrite(&record, sizeof(record), 1, captureFile);
+    fwrite(host.data(), 1, record.hostLength, captureFile);
+    fwrite(payload, 1, payloadLength, captureFile);
+    fwrite(padding, 1, (8 - body % 8) % 8, captureFile);
+}
+
+// Starts capturing to path, replacing any existing file.
+bool TrafficCapture::start(const std::string& path) {
+    std::lock_guard<std::mutex> lock(captureMutex);
+    if (captureFile) {
+        fclose(captureFile);
+        captureFile = nullptr;
+    }
+#ifdef _WIN32
+    if (fopen_s(&captureFile, path.c_str(), "wb") != 0) captureFile = nullptr;
+#else
+    captureFile = fopen(path.c_str(), "wb");
+#endif
+    if (!captureFile) {
+        return false;
+    }
+    setvbuf(captureFile, nullptr, _IOFBF, 1 << 16);
+
+    CaptureFileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, "XRCAP\0\0\0", 8);
+    header.version = kCaptureVersion;
+    header.startUnixMs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+    fwrite(&header, sizeof(header), 1, captureFile);
+    captureStart = std::chrono::steady_clock::now();
+    captureSequence = 0;
+    return true;
+}
+
+// Flushes and closes the capture.
+void TrafficCapture::stop() {
+    std::lock_guard<std::mutex> lock(captureMutex);
+    if (captureFile) {
+        fclose(captureFile);
+        captureFile = nullptr;
+    }
+}
+
+// Returns true while a capture is being written.
+bool TrafficCapture::isActive() {
+    std::lock_guard<std::mutex> lock(captureMutex);
+    return captureFile != nullptr;
+}
+
+// Logs an outgoing command and returns the sequence number to pair its reply with.
+uint32_t TrafficCapture::recordRequest(const std::string& host, int port, int protocolId, GameId gameId, std::string_view command) {
+    std::lock_guard<std::mutex> lock(captureMutex);
+    if (!captureFile) {
+        return 0;
+    }
+    uint32_t sequence = ++captureSequence;
+    writeRecord(CaptureKind::Request, sequence, host, port, protocolId, gameId, command.data(), command.size());
+    return sequence;
+}
+
+// Logs the reply (or error) for a previously recorded request.
+void TrafficCapture::recordResponse(uint32_t sequence, const std::string& host, int port, int protocolId, GameId gameId, bool ok,
+    std::string_view payload) {
+    std::lock_guard<std::mutex> lock(captureMutex);
+    if (!captureFile || sequence == 0) {
+        return;
+    }
+    writeRecord(ok ? CaptureKind::Response : CaptureKind::Error, sequence, host, port, protocolId, gameId, payload.data(), payload.size());
+}
+
+// Maps a capture file and checks its header.
+bool CaptureReader::open(const std::string& path) {
+    close();
+    if (!file.openRead(path) || file.size() < sizeof(CaptureFileHeader)) {
+        file.close();
+        return false;
+    }
+    if (std::memcmp(header().magic, "XRCAP\0\0\0", 8) != 0 || header().version == 0 || header().version > kCaptureVersion) {
+        file.close();
+        return false;
+    }
+    offset = sizeof(CaptureFileHeader);
+    return true;
+}
+
+// Unmaps the capture.
+void CaptureReader::close() {
+    file.close();
+    offset = 0;
+}
+
+// Restarts reading at the first record.
+void CaptureReader::rewind() {
+    offset = file.isOpen() ? sizeof(CaptureFileHeader) : 0;
+}
+
+// Reads the next record in place.
+bool CaptureReader::next(CaptureRecord& record) {
+    if (!file.isOpen() || offset + sizeof(CaptureRecordHeader) > file.size()) {
+        return false;
+    }
+    const CaptureRecordHeader* raw = reinterpret_cast<const CaptureRecordHeader*>(file.data() + offset);
+    size_t body = static_cast<size_t>(raw->hostLength) + raw->payloadLength;
+    size_t padded = body + (8 - body % 8) % 8;
+    if (offset + sizeof(CaptureRecordHeader) + body > file.size()) {
+        return false; // Truncated record (capture still being written or cut short)
+    }
+    const char* base = reinterpret_cast<const char*>(raw + 1);
+    record.timeUs = raw->timeUs;
+    record.sequence = raw->sequence;
+    record.kind = static_cast<CaptureKind>(raw->kind);
+    record.protocolId = raw->protocolId;
+    record.gameId = raw->gameId < static_cast<uint8_t>(GameId::Count) ? static_cast<GameId>(raw->gameId) : GameId::Unknown;
+    record.port = raw->port;
+    record.host = std::string_view(base, raw->hostLength);
+    record.payload = std::string_view(base + raw->hostLength, raw->payloadLength);
+    offset += sizeof(CaptureRecordHeader) + padded;
+    return true;
+}
+
+// Walks the capture, pairing each reply with its request.
+CaptureReplay::Stats CaptureReplay::run(CaptureReader& reader, Pace pace, double speed, const ExchangeHandler& onExchange) {
+    Stats stats;
+    std::unordered_map<uint32_t, CaptureRecord> outstanding;
+    auto started = std::chrono::steady_clock::now();
+    if (speed <= 0.0) speed = 1.0;
+
+    reader.rewind();
+    CaptureRecord record;
+    while (reader.next(record)) {
+        if (pace == Pace::RecordedTiming) {
+            std::this_thread::sleep_until(started + std::chrono::microseconds(static_cast<int64_t>(record.timeUs / speed)));
+        }
+        if (record.kind == CaptureKind::Request) {
+            ++stats.requests;
+            outstanding[record.sequence] = record;
+            continue;
+        }
+        if (record.kind == CaptureKind::Error) ++stats.errors;
+        else ++stats.responses;
+        auto it = outstanding.find(record.sequence);
+        if (it != outstanding.end()) {
+            if (onExchange) onExchange(it->second, record);
+            outstanding.erase(it);
+        }
+    }
+
+    stats.elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+    return stats;
+}
+
+// Replays every successful status exchange through the parser.
+CaptureReplay::Stats CaptureReplay::replayParser(CaptureReader& reader, Pace pace, double speed) {
+    size_t statusReplies = 0, playerReplies = 0, players = 0, failures = 0;
+    ParseArena arena;
+    StatusView status;
+    PlayersView rows;
+    std::string error;
+
+    // Replies are parsed in place in the mapped file; the arena only holds the parsed tables
+    Stats stats = run(reader, pace, speed, [&](const CaptureRecord& request, const CaptureRecord& response) {
+        if (response.kind != CaptureKind::Response) {
+            return;
+        }
+        arena.reset();
+        if (request.payload == "getstatus") {
+            // Version 1 captures only know the protocol, which cannot tell Allied Assault from Spearhead
+            bool gametypeIsString = request.gameId != GameId::Unknown ? GameTraits::get(request.gameId).gametypeIsString
+                : request.protocolId == 1;
+            StatusParser::parseServerStatus(response.payload, gametypeIsString, arena, status);
+            ++statusReplies;
+        }
+        else if (request.payload == "rcon status") {
+            if (StatusParser::parsePlayers(response.payload, arena, rows, error)) {
+                players += rows.count;
+            }
+            else {
+                ++failures;
+            }
+            ++playerReplies;
+        }
+    });
+
+    stats.statusReplies = statusReplies;
+    stats.playerReplies = playerReplies;
+    stats.players = players;
+    stats.parseFailures = failures;
+    return stats;
+}
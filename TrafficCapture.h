@@ -0,0 +1,107 @@
+#pragma once
+#include "GameTraits.h"
+#include "MappedFile.h"
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+
+// Capture file layout. All fields are little-endian and every record starts on an 8-byte boundary,
+// so a mapped capture can be walked in place:
+//   CaptureFileHeader
+//   { CaptureRecordHeader, host bytes, payload bytes, zero padding } ...
+struct CaptureFileHeader {
+    char magic[8];        // "XRCAP\0\0\0"
+    uint32_t version;     // kCaptureVersion
+    uint32_t reserved;
+    uint64_t startUnixMs; // Wall clock time of the first record
+    uint64_t reserved2;
+};
+
+struct CaptureRecordHeader {
+    uint64_t timeUs;        // Microseconds since capture start
+    uint32_t sequence;      // Pairs a response with its request
+    uint16_t kind;          // CaptureKind
+    uint8_t protocolId;
+    uint8_t gameId;         // GameId; 0 (Unknown) in version 1 captures
+    uint16_t port;
+    uint16_t hostLength;
+    uint32_t payloadLength;
+};
+
+static_assert(sizeof(CaptureFileHeader) == 32, "Capture header layout changed");
+static_assert(sizeof(CaptureRecordHeader) == 24, "Capture record layout changed");
+
+static const uint32_t kCaptureVersion = 2; // Version 1 files are read too
+
+enum class CaptureKind : uint16_t {
+    Request = 1,  // Command sent (RCON password is never recorded)
+    Response = 2, // Reply returned by GameServerQuery
+    Error = 3     // Error text or missing reply
+};
+
+// A record viewed in place inside a mapped capture file.
+struct CaptureRecord {
+    uint64_t timeUs = 0;
+    uint32_t sequence = 0;
+    CaptureKind kind = CaptureKind::Request;
+    int protocolId = 0;
+    GameId gameId = GameId::Unknown;
+    uint16_t port = 0;
+    std::string_view host;
+    std::string_view payload;
+};
+
+// Process-wide capture writer. Every query sent through ServerQuery is logged while a capture is active.
+class TrafficCapture {
+public:
+    static bool start(const std::string& path);
+    static void stop();
+    static bool isActive();
+    static uint32_t recordRequest(const std::string& host, int port, int protocolId, GameId gameId, std::string_view command);
+    static void recordResponse(uint32_t sequence, const std::string& host, int port, int protocolId, GameId gameId, bool ok,
+        std::string_view payload);
+};
+
+// Sequential reader over a mapped capture file.
+class CaptureReader {
+public:
+    bool open(const std::string& path);
+    void close();
+    void rewind();
+    // Returns the next record, or false at the end of the file or on a truncated record.
+    bool next(CaptureRecord& record);
+    const CaptureFileHeader& header() const { return *reinterpret_cast<const CaptureFileHeader*>(file.data()); }
+    size_t size() const { return file.size(); }
+
+private:
+    MappedFile file;
+    size_t offset = 0;
+};
+
+// Feeds a capture back through the status parser, either as fast as possible or at the recorded pace.
+class CaptureReplay {
+public:
+    enum class Pace {
+        AsFastAsPossible,
+        RecordedTiming
+    };
+
+    struct Stats {
+        size_t requests = 0;
+        size_t responses = 0;
+        size_t errors = 0;
+        size_t statusReplies = 0;
+        size_t playerReplies = 0;
+        size_t players = 0;
+        size_t parseFailures = 0;
+        double elapsedMs = 0.0;
+    };
+
+    typedef std::function<void(const CaptureRecord& request, const CaptureRecord& response)> ExchangeHandler;
+
+    // Calls onExchange for every request/response pair. speed scales recorded timing (2.0 = twice as fast).
+    static Stats run(CaptureReader& reader, Pace pace, double speed, const ExchangeHandler& onExchange);
+    // Replays getstatus replies through StatusParser::parseServerStatus and rcon status replies through parsePlayers.
+    static Stats replayParser(CaptureReader& reader, Pace pace, double speed);
+};
@@ -3,13 +3,24 @@
 // Provides functionality to create a sidebar with navigation buttons and an output box for messages.
 
 #include "UIComponents.h"
+#include "ParseArena.h"
 #include <commctrl.h>
+#include <chrono>
+#include <cstdio>
+#include <ctime>
 
 #pragma comment(lib, "comctl32.lib") // Link Common Controls library
 
 // Static UI control handle
 static HWND outputBox = nullptr; // Edit box for displaying output messages
 
+// Scrollback lives in the console buffer; the edit box only shows the newest part of it.
+// Line records and text are allocated once and only touched as they fill.
+static const size_t kConsoleLines = 1 << 20;
+static const size_t kConsoleTextBytes = 32 << 20;
+static const int kVisibleChars = 256 * 1024;   // Edit box text is trimmed from the top past this
+static uint64_t shownThrough = 0;              // Console sequence the edit box is up to
+
 // Creates the sidebar with navigation buttons and version label.
 void UIComponents::createSidebar(HWND hwnd, HINSTANCE hInstance) {
     // Create "Servers" navigation button
@@ -38,17 +49,87 @@ void UIComponents::createOutputBox(HWND hwnd, HINSTANCE hInstance) {
         160, 495, 600, 100, hwnd, (HMENU)400, hInstance, nullptr);
 
     if (outputBox) {
-        SendMessage(outputBox, EM_SETLIMITTEXT, 32768, 0); // Set text limit to 32KB
+        SendMessage(outputBox, EM_SETLIMITTEXT, 2 * kVisibleChars, 0); // Room for the visible window plus one append
     }
 }
 
-// Sets the message displayed in the output box.
-void UIComponents::setOutputMessage(HWND hwnd, const char* message) {
-    HWND hwndOutputBox = GetDlgItem(hwnd, 400); // Get output box handle
-    if (hwndOutputBox) {
-        WCHAR buffer[4096];
-        // Convert UTF-8 message to wide string
-        MultiByteToWideChar(CP_UTF8, 0, message, -1, buffer, sizeof(buffer) / sizeof(WCHAR));
-        SendMessage(hwndOutputBox, WM_SETTEXT, 0, (LPARAM)buffer); // Set message text
+ConsoleBuffer& UIComponents::console() {
+    static ConsoleBuffer buffer(kConsoleLines, kConsoleTextBytes);
+    return buffer;
+}
+
+// Drops whole lines from the top of the edit box so extra more characters stay within kVisibleChars.
+static void trimVisible(HWND box, int extra) {
+    int length = GetWindowTextLength(box);
+    int excess = length + extra - kVisibleChars;
+    if (excess <= 0) return;
+    int cut = length;
+    if (excess < length) {
+        int line = (int)SendMessage(box, EM_LINEFROMCHAR, excess, 0);
+        int next = (int)SendMessage(box, EM_LINEINDEX, line + 1, 0);
+        if (next >= 0) cut = next;
+    }
+    SendMessage(box, EM_SETSEL, 0, cut);
+    SendMessage(box, EM_REPLACESEL, FALSE, (LPARAM)L"");
+}
+
+// Appends console lines the edit box has not shown yet, as "[hh:mm:ss] [server] text".
+static void showNewLines(HWND box) {
+    ConsoleBuffer& buffer = UIComponents::console();
+    if (shownThrough < buffer.firstSequence()) shownThrough = buffer.firstSequence();
+    if (shownThrough == buffer.endSequence()) return;
+
+    static ParseArena text;
+    static std::wstring pending;
+    text.reset();
+    pending.clear();
+    bool first = GetWindowTextLength(box) == 0;
+    ConsoleLine line;
+    for (uint64_t s = shownThrough; buffer.line(s, line); ++s) {
+        time_t seconds = static_cast<time_t>(line.timeMs / 1000);
+        tm local = {};
+        localtime_s(&local, &seconds);
+        wchar_t stamp[16];
+        swprintf_s(stamp, L"[%02d:%02d:%02d] ", local.tm_hour, local.tm_min, local.tm_sec);
+        if (!first) pending += L"\r\n";
+        first = false;
+        pending += stamp;
+        if (line.tag) {
+            pending += L'[';
+            pending += text.widen(buffer.tagName(line.tag));
+            pending += L"] ";
+        }
+        if (line.kind == ConsoleKind::Command) pending += L"> ";
+        pending += text.widen(line.text);
     }
-}
\ No newline at end of file
+    shownThrough = buffer.endSequence();
+
+    // Past the visible window only the tail of a large append is worth showing
+    if (pending.size() > static_cast<size_t>(kVisibleChars)) {
+        size_t from = pending.find(L'\n', pending.size() - kVisibleChars);
+        pending.erase(0, from == std::wstring::npos ? pending.size() - kVisibleChars : from + 1);
+        SetWindowText(box, L"");
+    }
+    SendMessage(box, WM_SETREDRAW, FALSE, 0);
+    trimVisible(box, static_cast<int>(pending.size()));
+    int end = GetWindowTextLength(box);
+    SendMessage(box, EM_SETSEL, end, end);
+    SendMessage(box, EM_REPLACESEL, FALSE, (LPARAM)pending.c_str());
+    SendMessage(box, WM_SETREDRAW, TRUE, 0);
+    InvalidateRect(box, nullptr, TRUE);
+    SendMessage(box, EM_SCROLLCARET, 0, 0);
+}
+
+void UIComponents::appendOutput(HWND hwnd, std::string_view text, const std::string& serverName, ConsoleKind kind) {
+    ConsoleBuffer& buffer = console();
+    int64_t now = static_cast<int64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+    buffer.append(text, buffer.tagFor(serverName), kind, now);
+    HWND hwndOutputBox = GetDlgItem(hwnd, 400);
+    if (hwndOutputBox) showNewLines(hwndOutputBox);
+}
+
+// Adds a message to the output console.
+void UIComponents::setOutputMessage(HWND hwnd, const char* message) {
+    appendOutput(hwnd, message, std::string(), ConsoleKind::Info);
+}
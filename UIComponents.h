@@ -3,13 +3,18 @@
 
 #include <windows.h>
 #include <string>
+#include <string_view>
 #include "ServerManager.h"
+#include "ConsoleBuffer.h"
 
 class UIComponents {
 public:
     static void createSidebar(HWND hwnd, HINSTANCE hInstance);
     static void createOutputBox(HWND hwnd, HINSTANCE hInstance);
     static void setOutputMessage(HWND hwnd, const char* message);
+    // Appends to the console scrollback, tagged with the server it concerns, and shows the new lines.
+    static void appendOutput(HWND hwnd, std::string_view text, const std::string& serverName, ConsoleKind kind);
+    static ConsoleBuffer& console();
 };
 
 #endif
\ No newline at end of file
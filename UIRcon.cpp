@@ -4,16 +4,34 @@
 
 #include "UIRcon.h"
 #include "UIComponents.h"
-#include "GameServerQuery.h"
 #include "ServerManager.h"
+#include "ListCatalog.h"
+#include "ServerQuery.h"
+#include "QueryWorker.h"
+#include "SnapshotStore.h"
+#include "Prefetcher.h"
+#include "PlayerActions.h"
+#include "RconBatch.h"
+#include "PlayerIndex.h"
+#include "SessionLog.h"
+#include "BanList.h"
+#include "RuleEngine.h"
+#include "JobScheduler.h"
+#include "CvarStore.h"
+#include "LogTailer.h"
+#include "StatusParser.h"
 #include <commctrl.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <utility>
 #include <vector>
 #include <sstream>
 #include <string>
 
 #pragma comment(lib, "comctl32.lib") // Link Common Controls library
 #pragma comment(lib, "Ws2_32.lib")   // Link Winsock library
-#pragma comment(lib, "GameServerQuery.lib") // Link GameServerQuery library
 
 // Static UI control handles
 static HWND playerTable = nullptr;       // List view for player information
@@ -33,9 +51,101 @@ static HWND fastRestartButton = nullptr; // Button for fast server restart
 static HWND mapRotateButton = nullptr;   // Button for map rotation
 static bool rconPageCreated = false;     // Flag to track if RCON page is created
 static const UINT_PTR REFRESH_TIMER_ID = 1001; // Timer ID for periodic refresh
+static const UINT REFRESH_TICK_MS = 1000;      // Scheduler tick; per-server intervals live in refreshScheduler
+static RefreshScheduler refreshScheduler;      // Per-server refresh deadlines (timer wheel)
+static std::vector<std::string> scheduledServers; // Server names indexed by scheduler id
+static ArenaPair statusArenas;           // Parsed settings for the selected server
+static ArenaPair playerArenas;           // Parsed rows for the selected server
+static std::shared_ptr<const void> playerOwner; // Keeps the rcon status reply the rows point into alive
+static PlayersView playerSnapshot;       // Rows shown in the player table, backed by playerArenas and playerOwner
 static std::vector<WCHAR*> mapData;      // Stores map names for combo box
 static std::vector<WCHAR*> gametypeData; // Stores gametype names for combo box
-static std::string lastGame;             // Tracks last game type for column preservation
+static GameId lastColumnsGame = GameId::Count; // Game the action columns were built for (Count = none yet)
+static QueryWorker queryWorker;          // Runs refresh queries off the UI thread
+static CancelToken refreshToken;         // Token of the pending refresh
+static std::string refreshingServer;     // Server of the pending refresh, empty when none is pending
+static std::string displayedServer;      // Server the page currently shows
+static SnapshotStore snapshots;          // Last complete refresh per server, from refreshes and prefetches
+static Prefetcher prefetcher;            // Picks servers to warm up while one is displayed
+static CancelToken prefetchToken;        // Shared by the queued prefetches
+static const char* const SNAPSHOT_FILE = "snapshots.dat"; // Warm-start copy of the snapshot store
+static const ULONGLONG SNAPSHOT_SAVE_MS = 5 * 60 * 1000; // Periodic save interval while snapshots change
+static uint64_t savedChanges = 0;        // snapshots.changes() at the last save or load
+static ULONGLONG lastSnapshotSave = 0;
+static PlayerActions playerActions;      // Kicks, bans and renames shown before a player list confirms them
+static QueryWorker batchWorker;          // Runs rcon batches, so a paced batch never holds up refreshes and polls
+static CancelToken batchToken;           // Shared by running batches; not cancelled by selection changes
+static PlayerIndex playerIndex;          // Online players of every polled server, for the player search
+static CancelToken pollToken;            // Shared by queued background polls
+static std::vector<std::string> pollingServers; // Servers with a background poll queued or running
+static SessionLog sessionLog;            // Every session seen, for the player history
+static const char* const SESSION_DIRECTORY = "sessions";
+static const uint64_t HISTORY_DAYS = 90; // How far back the player search looks in the history
+static BanList banList;                  // Central ban list, enforced on every polled server
+static IpFilterSync banFilters;          // IP filters each server was last sent
+static const char* const BAN_FILE = "bans.ini";
+static const char* const BAN_SYNC_FILE = "bans_pushed.ini";
+static const ULONGLONG BAN_SYNC_MS = 10 * 60 * 1000; // Periodic filter sync; retries failures and retires expired bans
+static uint64_t enforcedBanVersion = 0;  // banList.version() last applied to everyone online
+static uint64_t syncedBanVersion = 0;    // banList.version() last synced to the servers
+static ULONGLONG lastBanSync = 0;
+static bool banSyncRunning = false;
+static bool banSyncPartial = false;      // The running sync left changes for the next one
+static const size_t BAN_SYNC_MAX_CHANGES = 60; // Filter changes per server and sync; about 30 s at the default pacing
+static RuleEngine ruleEngine;            // Automated actions, checked against every poll
+static const char* const RULE_FILE = "rules.ini";
+static JobScheduler jobScheduler;        // Cron jobs, by next run time
+static JobHistory jobHistory;            // Every job run, also appended to JOB_HISTORY_FILE
+static const char* const JOB_FILE = "jobs.ini";
+static const char* const JOB_HISTORY_FILE = "jobs_history.log";
+static const uint64_t JOB_TIMER_MAX_MS = 60 * 1000; // Longest timer wait; also how often jobs.ini is checked for edits
+static const uint32_t JOB_REPLY_QUIET_MS = 250; // A job command's reply is complete after this long without a packet
+static CvarStore cvarStore;              // Every polled server's cvars, checked against the baselines
+static const char* const CVAR_BASELINE_FILE = "cvar_baselines.ini";
+static GameLogs gameLogs;                // Local log files of self-hosted servers, read every tick
+static const char* const LOG_FILE = "logs.ini";
+static const size_t LOG_POLL_BYTES = 1 << 20; // Most read from one log per tick; a backlog is read over several
+
+// Replies for one refresh, posted from the query worker to the UI thread with WM_RCON_REFRESHED.
+struct RefreshResult {
+    CancelToken token;
+    Server server;
+    bool prefetch = false;               // Only fills the snapshot store
+    bool poll = false;                   // Scheduled poll of a server that is not displayed
+    uint64_t queriedMs = 0;              // Before rcon status was sent
+    QueryReply players;                  // rcon status
+    QueryReply status;                   // getstatus
+    uint64_t fetchedMs = 0;
+};
+
+// A finished batch, posted from the query worker to the UI thread with WM_RCON_BATCHDONE.
+struct BatchResult {
+    RconBatch batch;
+    ULONGLONG clickMs = 0;
+    ULONGLONG startedMs = 0;
+    ULONGLONG finishedMs = 0;
+    bool banSync = false;                // IP filter changes from the ban list rather than player commands
+    std::vector<JobRun> jobRuns;         // Scheduled job commands, parallel to the batch's results
+};
+
+// Finished session files work, posted from the query worker to the UI thread with WM_RCON_SESSIONJOB.
+struct SessionJobResult {
+    std::unique_ptr<SessionJob> job;
+};
+
+// Runs both refresh queries on the query worker and posts the result. Cancelled between the two, the
+// half result is freed rather than spending a second query on it; cancelled once both replies are in,
+// it is still posted, and onRefreshResult stores it without showing it.
+static void runRefresh(HWND hwnd, std::unique_ptr<RefreshResult> result, const CancelToken& token) {
+    result->queriedMs = GetTickCount64();
+    ServerQuery::query(result->server, "rcon status", result->players);
+    if (token.cancelled()) return;
+    ServerQuery::query(result->server, "getstatus", result->status);
+    result->fetchedMs = GetTickCount64();
+    if (PostMessage(hwnd, WM_RCON_REFRESHED, 0, (LPARAM)result.get())) {
+        result.release(); // Owned by the message now
+    }
+}
 
 // Creates the RCON UI page with controls for server management.
 void UIRcon::createRconPage(HWND hwnd, HINSTANCE hInstance) {
@@ -48,7 +158,7 @@ void UIRcon::createRconPage(HWND hwnd, HINSTANCE hInstance) {
         160, 10, 600, 200, hwnd, (HMENU)500, hInstance, nullptr);
 
     // Create player table (list view)
-    playerTable = CreateWindow(WC_LISTVIEW, L"", WS_CHILD | WS_VISIBLE | LVS_REPORT | LVS_SINGLESEL | WS_TABSTOP,
+    playerTable = CreateWindow(WC_LISTVIEW, L"", WS_CHILD | WS_VISIBLE | LVS_REPORT | WS_TABSTOP,
         160, 50, 600, 400, hwnd, (HMENU)501, hInstance, nullptr);
     if (playerTable) {
         // Enable full row selection, grid lines, and header drag-drop
@@ -115,17 +225,21 @@ void UIRcon::createRconPage(HWND hwnd, HINSTANCE hInstance) {
 
     // Create RCON command input
     commandInput = CreateWindow(L"EDIT", L"", WS_CHILD | WS_VISIBLE | WS_BORDER | ES_AUTOHSCROLL,
-        160, 460, 475, 25, hwnd, (HMENU)502, hInstance, nullptr);
+        160, 460, 385, 25, hwnd, (HMENU)502, hInstance, nullptr);
     if (commandInput) {
         SendMessage(commandInput, EM_SETLIMITTEXT, 1024, 0); // Limit input to 1024 characters
     }
 
+    // Create player search button (searches every polled server for the text in the command box)
+    CreateWindow(L"BUTTON", L"Find Player", WS_CHILD | WS_VISIBLE | BS_PUSHBUTTON,
+        550, 460, 85, 25, hwnd, (HMENU)524, hInstance, nullptr);
+
     // Create send command button
     sendButton = CreateWindow(L"BUTTON", L"Send Command", WS_CHILD | WS_VISIBLE | BS_PUSHBUTTON,
         640, 460, 120, 25, hwnd, (HMENU)503, hInstance, nullptr);
 
     rconPageCreated = true;
-    SetTimer(hwnd, REFRESH_TIMER_ID, 60000, nullptr); // Start 60-second refresh timer
+    SetTimer(hwnd, REFRESH_TIMER_ID, REFRESH_TICK_MS, nullptr); // Start refresh scheduler tick
     updateServerSelector(hwnd); // Populate server list
 }
 
@@ -155,6 +269,7 @@ void UIRcon::showRconPage(HWND hwnd) {
     ShowWindow(GetDlgItem(hwnd, 521), SW_SHOW);
     ShowWindow(GetDlgItem(hwnd, 522), SW_SHOW);
     ShowWindow(GetDlgItem(hwnd, 523), SW_SHOW);
+    ShowWindow(GetDlgItem(hwnd, 524), SW_SHOW);
     ShowWindow(GetDlgItem(hwnd, 400), SW_SHOW); // Unknown control (possibly parent or output)
 
     // Ensure player table is focused and on top
@@ -172,17 +287,116 @@ void UIRcon::showRconPage(HWND hwnd) {
         if (index != CB_ERR) {
             auto servers = ServerManager::loadServers();
             if (index < static_cast<int>(servers.size())) {
-                UIRcon::updatePlayerTable(hwnd, servers[index]);
-                UIRcon::updateServerSettings(hwnd, servers[index]);
+                UIRcon::refreshServer(hwnd, servers[index]);
             }
         }
     }
 }
 
-// Hides the RCON page by stopping the refresh timer.
+// Returns the scheduler id of the named server, or -1.
+static int scheduledId(const std::string& name) {
+    for (size_t id = 0; id < scheduledServers.size(); ++id) {
+        if (scheduledServers[id] == name) return static_cast<int>(id);
+    }
+    return -1;
+}
+
+static uint64_t unixNowMs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+}
+
+// Logs the sessions of players who left. Their times are tick counts, converted to wall clock here.
+static void endSessions(const std::vector<IndexedPlayer>& left, uint64_t leftMs) {
+    if (left.empty() || !sessionLog.isOpen()) {
+        return;
+    }
+    uint64_t nowMs = GetTickCount64();
+    uint64_t nowUnixMs = unixNowMs();
+    auto toUnix = [nowMs, nowUnixMs](uint64_t tickMs) {
+        uint64_t age = nowMs > tickMs ? nowMs - tickMs : 0;
+        return nowUnixMs > age ? nowUnixMs - age : 0;
+    };
+    std::vector<SessionRecord> sessions(left.size());
+    for (size_t i = 0; i < left.size(); ++i) {
+        sessions[i].server = left[i].server;
+        sessions[i].name = left[i].name;
+        sessions[i].guid = left[i].guid;
+        sessions[i].ip = left[i].ip;
+        sessions[i].joinUnixMs = toUnix(left[i].joinedMs);
+        sessions[i].leaveUnixMs = toUnix(leftMs);
+    }
+    if (!sessionLog.append(sessions)) {
+        ServerManager::logDebug("Failed to write player sessions to " + std::string(SESSION_DIRECTORY));
+    }
+}
+
+static void enforceBans(HWND hwnd, const std::vector<uint32_t>& ids); // With the batch functions below
+static void applyRules(HWND hwnd, const Server& server, const StatusView& status, const PlayersView& players);
+static void checkDrift(HWND hwnd, const Server& server, const StatusView& status);
+
+// Abandons the pending refresh: queued work is freed now, one that already has both replies is stored
+// but not shown (see runRefresh), and the scheduler gets the server back.
+static void cancelRefresh() {
+    if (refreshingServer.empty()) return;
+    queryWorker.cancel(refreshToken);
+    int id = scheduledId(refreshingServer);
+    if (id >= 0) refreshScheduler.complete(static_cast<uint32_t>(id), RefreshOutcome::Skipped, GetTickCount64());
+    refreshingServer.clear();
+}
+
+// Abandons queued background polls and hands their servers back to the scheduler.
+static void cancelPolls() {
+    queryWorker.cancel(pollToken);
+    pollToken = CancelToken();
+    ULONGLONG now = GetTickCount64();
+    for (const std::string& name : pollingServers) {
+        int id = scheduledId(name);
+        if (id >= 0) refreshScheduler.complete(static_cast<uint32_t>(id), RefreshOutcome::Skipped, now);
+    }
+    pollingServers.clear();
+}
+
+// Polls a server that is not displayed, so its snapshot and the player index stay current.
+static void startPoll(HWND hwnd, const Server& server) {
+    pollingServers.push_back(server.name);
+    queryWorker.submit(pollToken, [hwnd, server](const CancelToken& token) {
+        std::unique_ptr<RefreshResult> result(new RefreshResult{ token, server });
+        result->poll = true;
+        runRefresh(hwnd, std::move(result), token);
+    });
+}
+
+// Queues prefetches for the servers the admin is likely to open after current, within the prefetch budget.
+static void startPrefetch(HWND hwnd, const std::string& current) {
+    int id = scheduledId(current);
+    if (id < 0) return;
+    ULONGLONG now = GetTickCount64();
+    uint32_t freshMs = prefetcher.getBudget().freshMs;
+    std::vector<uint32_t> picks;
+    prefetcher.plan(static_cast<uint32_t>(id), now, [now, freshMs](uint32_t index) {
+        return snapshots.isWarm(scheduledServers[index], now, freshMs);
+    }, picks);
+    if (picks.empty()) return;
+
+    auto servers = ServerManager::loadServers();
+    prefetchToken = CancelToken();
+    for (uint32_t index : picks) {
+        if (index >= servers.size() || servers[index].ipOrHostname.empty() || servers[index].port == 0) continue;
+        queryWorker.submit(prefetchToken, [hwnd, server = servers[index]](const CancelToken& token) {
+            std::unique_ptr<RefreshResult> result(new RefreshResult{ token, server, true });
+            runRefresh(hwnd, std::move(result), token);
+        });
+    }
+}
+
+// Hides the RCON page by stopping the refresh timer, any pending refresh and queued prefetches.
 void UIRcon::hideRconPage(HWND hwnd) {
     if (rconPageCreated) {
         KillTimer(hwnd, REFRESH_TIMER_ID); // Stop refresh timer
+        cancelRefresh();
+        cancelPolls();
+        queryWorker.cancel(prefetchToken);
     }
 }
 
@@ -195,25 +409,36 @@ void UIRcon::updateServerSelector(HWND hwnd) {
 
     SendMessage(hwndServerCombo, CB_RESETCONTENT, 0, 0); // Clear existing items
     auto servers = ServerManager::loadServers(); // Load server list
+    cancelRefresh(); // Scheduler ids are about to change
+    cancelPolls();
+    queryWorker.cancel(prefetchToken);
 
-    std::vector<std::wstring> serverNames;
+    // Give every server a refresh deadline
+    scheduledServers.clear();
+    for (const auto& server : servers) {
+        scheduledServers.push_back(server.name);
+    }
+    refreshScheduler.reset(scheduledServers.size(), GetTickCount64());
+    prefetcher.resize(scheduledServers.size());
+    snapshots.retain(scheduledServers); // Forget deleted servers
+    std::vector<IndexedPlayer> left;
+    playerIndex.retain(scheduledServers, &left);
+    banFilters.retain(scheduledServers);
+    ruleEngine.retain(scheduledServers);
+    cvarStore.retain(scheduledServers);
+    endSessions(left, GetTickCount64());
+
+    ParseArena names; // The combo box copies each string
     for (const auto& server : servers) {
         if (server.name.empty()) {
             continue; // Skip servers with empty names
         }
-        WCHAR buffer[4096];
-        int len = MultiByteToWideChar(CP_UTF8, 0, server.name.c_str(), -1, buffer, sizeof(buffer) / sizeof(WCHAR));
-        if (len == 0) {
-            continue; // Skip if conversion fails
-        }
-        serverNames.emplace_back(buffer);
-        SendMessage(hwndServerCombo, CB_ADDSTRING, 0, (LPARAM)serverNames.back().c_str());
+        SendMessage(hwndServerCombo, CB_ADDSTRING, 0, (LPARAM)names.widen(server.name));
     }
 
     if (!servers.empty()) {
         SendMessage(hwndServerCombo, CB_SETCURSEL, 0, 0); // Select first server
-        updatePlayerTable(hwnd, servers[0]); // Update player table
-        updateServerSettings(hwnd, servers[0]); // Update server settings
+        refreshServer(hwnd, servers[0]); // Update player table and server settings
         EnableWindow(GetDlgItem(hwnd, 503), TRUE); // Enable send button
     }
     else {
@@ -227,92 +452,915 @@ void UIRcon::updateServerSelector(HWND hwnd) {
     UpdateWindow(hwndServerCombo);
 }
 
-// Schedules a refresh of server data using a timer.
-void UIRcon::scheduleRefresh(HWND hwnd, const Server& server) {
-    SetTimer(hwnd, REFRESH_TIMER_ID, 60000, nullptr); // Set 60-second timer
+// Reports a refresh outcome to the scheduler and keeps the scheduler tick running.
+void UIRcon::scheduleRefresh(HWND hwnd, const Server& server, RefreshOutcome outcome) {
+    ULONGLONG now = GetTickCount64();
+    int id = scheduledId(server.name);
+    if (id >= 0) {
+        refreshScheduler.setFocus(static_cast<uint32_t>(id), now); // Displayed server is polled most often
+        refreshScheduler.complete(static_cast<uint32_t>(id), outcome, now);
+    }
+    SetTimer(hwnd, REFRESH_TIMER_ID, REFRESH_TICK_MS, nullptr);
 }
 
-// Updates server settings controls (hostname, map, gametype, players).
-void UIRcon::updateServerSettings(HWND hwnd, const Server& server) {
-    // Get control handles
-    HWND hwndHostnameInput = GetDlgItem(hwnd, 511);
-    HWND hwndMapSelector = GetDlgItem(hwnd, 514);
-    HWND hwndGametypeSelector = GetDlgItem(hwnd, 517);
-    HWND hwndPlayersLabel = GetDlgItem(hwnd, 520);
+void UIRcon::refreshServer(HWND hwnd, const Server& server) {
+    cancelRefresh();
+    queryWorker.cancel(prefetchToken); // Planned around the previous selection
+
+    // Switching shows the stored snapshot at once; the refresh below replaces it
+    if (server.name != displayedServer) {
+        displayedServer = server.name;
+        int id = scheduledId(server.name);
+        if (id >= 0) prefetcher.opened(static_cast<uint32_t>(id));
+        const ServerSnapshot* cached = snapshots.find(server.name);
+        if (cached) showSnapshot(hwnd, server, *cached, true);
+    }
 
-    if (!hwndHostnameInput || !hwndMapSelector || !hwndGametypeSelector || !hwndPlayersLabel) {
-        scheduleRefresh(hwnd, server); // Retry later if controls are missing
+    if (server.ipOrHostname.empty() || server.port == 0) {
+        UIComponents::setOutputMessage(hwnd, "Invalid server details: IP/hostname or port is invalid.");
+        scheduleRefresh(hwnd, server, RefreshOutcome::Down);
         return;
     }
 
-    // Determine game type for conditional logic
-    bool isMOHAA = server.game == "Medal of Honor: Allied Assault";
-    bool isMOHSHBT = server.game == "Medal of Honor: AA Spearhead" || server.game == "Medal of Honor: AA Breakthrough";
-    bool isCOD = server.game.find("Call of Duty") != std::string::npos;
-    bool isCOD2Plus = server.game == "Call of Duty 2" || server.game == "Call of Duty 4: Modern Warfare" || server.game == "Call of Duty: World at War";
+    refreshToken = CancelToken();
+    refreshingServer = server.name;
+    queryWorker.submitFirst(refreshToken, [hwnd, server](const CancelToken& token) {
+        std::unique_ptr<RefreshResult> result(new RefreshResult{ token, server });
+        // Brief delay to handle server response timing; a newer selection ends it early
+        if (!queryWorker.sleepFor(token, 500)) return;
+        runRefresh(hwnd, std::move(result), token);
+    });
+}
 
-    // Show/hide action buttons based on game type
-    ShowWindow(GetDlgItem(hwnd, 521), isMOHAA || isMOHSHBT || isCOD ? SW_SHOW : SW_HIDE); // Restart
-    ShowWindow(GetDlgItem(hwnd, 522), isCOD2Plus ? SW_SHOW : SW_HIDE); // Fast Restart
-    ShowWindow(GetDlgItem(hwnd, 523), isCOD && !isMOHAA && !isMOHSHBT ? SW_SHOW : SW_HIDE); // Map Rotate
-
-    // Query server status
-    const char* response = ProcessGameServerCommand(
-        server.protocolId,
-        false,
-        server.ipOrHostname.c_str(),
-        server.port,
-        "getstatus",
-        ""
-    );
-
-    if (!response || strncmp(response, "error=", 6) == 0) {
-        std::string error = response ? response : "No response from server";
-        UIComponents::setOutputMessage(hwnd, ("Failed to fetch server status: " + error).c_str());
-        if (response) FreeGameServerResponse(response);
-        scheduleRefresh(hwnd, server);
+// Stores a refresh or prefetch the query worker finished and shows it if it is still wanted.
+void UIRcon::onRefreshResult(HWND hwnd, LPARAM lParam) {
+    std::shared_ptr<RefreshResult> result(reinterpret_cast<RefreshResult*>(lParam));
+    if (!result) {
         return;
     }
+    ServerSnapshot snapshot;
+    snapshot.owner = result;
+    snapshot.status = result->status.text();
+    snapshot.players = result->players.text();
+    snapshot.statusOk = result->status.ok();
+    snapshot.playersOk = result->players.ok();
+    snapshot.fetchedMs = result->fetchedMs;
+    snapshots.put(result->server.name, snapshot);
+
+    // Every getstatus reply feeds the cvar store, and the rules with the player list below
+    static ParseArena statusArena;
+    statusArena.reset();
+    StatusView status;
+    if (snapshot.statusOk) {
+        StatusParser::parseServerStatus(snapshot.status, GameTraits::get(result->server.gameId).gametypeIsString, statusArena, status);
+        checkDrift(hwnd, result->server, status);
+    }
+
+    // Every player list feeds the player index and settles pending player actions
+    static ParseArena arena; // Scratch; the table is parsed again if the result is shown
+    arena.reset();
+    PlayersView players;
+    std::string error;
+    bool parsed = snapshot.playersOk && StatusParser::parsePlayers(snapshot.players, arena, players, error);
+    if (parsed) {
+        std::vector<IndexedPlayer> left;
+        std::vector<uint32_t> joined;
+        playerIndex.update(result->server.name, players, result->fetchedMs, &left, &joined);
+        endSessions(left, result->fetchedMs);
+        enforceBans(hwnd, joined);
+        if (snapshot.statusOk) applyRules(hwnd, result->server, status, players);
+        if (playerActions.hasPending(result->server.name)) {
+            std::vector<PlayerAction> settled;
+            playerActions.reconcile(result->server.name, players, result->queriedMs, GetTickCount64(), settled);
+            reportSettled(hwnd, settled);
+        }
+    }
+
+    if (result->poll) {
+        auto polling = std::find(pollingServers.begin(), pollingServers.end(), result->server.name);
+        if (polling != pollingServers.end() && !result->token.cancelled()) {
+            pollingServers.erase(polling);
+            int id = scheduledId(result->server.name);
+            RefreshOutcome outcome = !snapshot.complete() ? RefreshOutcome::Down
+                : players.count > 0 ? RefreshOutcome::Busy : RefreshOutcome::Empty;
+            if (id >= 0) refreshScheduler.complete(static_cast<uint32_t>(id), outcome, GetTickCount64());
+        }
+    }
+    if (result->prefetch || result->poll || result->token.cancelled()) {
+        return; // Warm for later, not for display now
+    }
 
-    std::string json = response;
-    FreeGameServerResponse(response);
+    refreshingServer.clear();
+    showSnapshot(hwnd, result->server, snapshot, false);
+    startPrefetch(hwnd, result->server.name);
+}
 
-    // Helper to extract JSON fields
-    auto extractField = [](const std::string& json, const std::string& field) {
-        size_t pos = json.find("\"" + field + "\":");
-        if (pos == std::string::npos) return std::string();
-        pos += field.length() + 3;
-        if (json[pos] == '"') {
-            pos++;
-            size_t end = json.find('"', pos);
-            return json.substr(pos, end - pos);
+// Reports actions a player list did not confirm, and the running totals once nothing is left pending.
+void UIRcon::reportSettled(HWND hwnd, const std::vector<PlayerAction>& settled) {
+    for (const PlayerAction& action : settled) {
+        if (action.state == ActionState::RolledBack) {
+            UIComponents::appendOutput(hwnd, action.command + " did not take effect: " + action.name + " is still in slot " + action.slot,
+                action.server, ConsoleKind::Error);
         }
-        else {
-            size_t end = json.find_first_of(",}", pos);
-            return json.substr(pos, end - pos);
+        else if (action.state == ActionState::Expired) {
+            UIComponents::appendOutput(hwnd, action.command + " could not be confirmed; showing " + action.name + " again",
+                action.server, ConsoleKind::Error);
         }
-        };
+    }
+    if (settled.empty() || playerActions.pendingCount() > 0) {
+        return;
+    }
+    const ActionStats& stats = playerActions.stats();
+    char summary[256];
+    snprintf(summary, sizeof(summary),
+        "Player actions: %llu issued, %llu confirmed, %llu rolled back, %llu expired, %llu verify queries; "
+        "command avg %llu ms (max %llu), confirmation avg %llu ms (max %llu)",
+        (unsigned long long)stats.issued, (unsigned long long)stats.confirmed, (unsigned long long)stats.rolledBack,
+        (unsigned long long)stats.expired, (unsigned long long)stats.verifyQueries,
+        (unsigned long long)(stats.issued ? stats.commandMsTotal / stats.issued : 0), (unsigned long long)stats.commandMsMax,
+        (unsigned long long)(stats.confirmed ? stats.settleMsTotal / stats.confirmed : 0), (unsigned long long)stats.settleMsMax);
+    ServerManager::logDebug(summary);
+}
 
-    // Extract server information
-    std::string hostname = extractField(json, "sv_hostname");
-    std::string mapname = extractField(json, "mapname");
-    std::string gametype = extractField(json, isMOHAA ? "g_gametypestring" : "g_gametype");
-    std::string maxclients = extractField(json, "sv_maxclients");
-    size_t playerCount = 0;
-    size_t playersPos = json.find("\"players\":");
-    if (playersPos != std::string::npos) {
-        std::string playersJson = json.substr(playersPos + 10);
-        if (playersJson != "[]") {
-            for (size_t i = 0; i < playersJson.length(); ++i) {
-                if (playersJson[i] == '{') ++playerCount; // Count player objects
+// Applies a player action whose rcon command succeeded to the displayed table, then queries the
+// server to confirm it. Actions clicked in quick succession share one verification, as each
+// refresh replaces the pending one.
+void UIRcon::playerActionSent(HWND hwnd, const Server& server, std::string_view slot, std::string_view command, ULONGLONG clickMs) {
+    playerActions.applied(server.name, slot, playerName(server, slot), command, clickMs, GetTickCount64());
+    verifyPlayerActions(hwnd, server);
+}
+
+std::string_view UIRcon::playerName(const Server& server, std::string_view slot) {
+    if (server.name != displayedServer) {
+        return std::string_view();
+    }
+    for (size_t i = 0; i < playerSnapshot.count; ++i) {
+        if (playerSnapshot.rows[i].slot == slot) return playerSnapshot.rows[i].name;
+    }
+    return std::string_view();
+}
+
+// Searches the players of every polled server and lists the matches in the output box.
+void UIRcon::findPlayers(HWND hwnd, const std::string& query) {
+    std::vector<uint32_t> ids;
+    auto started = std::chrono::steady_clock::now();
+    playerIndex.search(query, 50, ids);
+    auto micros = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - started).count();
+
+    char summary[160];
+    snprintf(summary, sizeof(summary), "Find \"%.60s\": %zu match(es) among %zu online players (%lld us)",
+        query.c_str(), ids.size(), playerIndex.size(), static_cast<long long>(micros));
+    UIComponents::appendOutput(hwnd, summary, "", ConsoleKind::Info);
+    for (uint32_t id : ids) {
+        const IndexedPlayer& player = playerIndex.player(id);
+        std::string line = "slot " + player.slot + "  " + player.name + "^7  " + player.address;
+        if (!player.guid.empty()) line.append("  ").append(player.guid);
+        UIComponents::appendOutput(hwnd, line, player.server, ConsoleKind::Info);
+    }
+    findSessions(hwnd, query);
+}
+
+// Lists past sessions for an address or CIDR range, else for a name; an empty query lists the displayed server's.
+void UIRcon::findSessions(HWND hwnd, const std::string& query) {
+    if (!sessionLog.isOpen()) {
+        return;
+    }
+    SessionQuery sessions;
+    if (PlayerIndex::parseCidr(query, sessions.ipBase, sessions.ipMask)) {
+        sessions.by = SessionQuery::By::Address;
+    }
+    else if (!query.empty()) {
+        sessions.by = SessionQuery::By::Name;
+        sessions.text = query;
+    }
+    else if (!displayedServer.empty()) {
+        sessions.by = SessionQuery::By::Server;
+        sessions.text = displayedServer;
+    }
+    else {
+        return;
+    }
+    uint64_t nowUnixMs = unixNowMs();
+    sessions.sinceUnixMs = nowUnixMs - HISTORY_DAYS * 24 * 3600 * 1000;
+    sessions.limit = 50;
+
+    std::vector<SessionRecord> found;
+    auto started = std::chrono::steady_clock::now();
+    size_t total = sessionLog.query(sessions, found);
+    auto micros = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - started).count();
+    char summary[192];
+    snprintf(summary, sizeof(summary), "History: %zu session(s) in the last %llu days, newest %zu shown (%llu sessions logged, %lld us)",
+        total, (unsigned long long)HISTORY_DAYS, found.size(), (unsigned long long)sessionLog.rowCount(), static_cast<long long>(micros));
+    UIComponents::appendOutput(hwnd, summary, "", ConsoleKind::Info);
+    for (const SessionRecord& session : found) {
+        time_t seconds = static_cast<time_t>(session.joinUnixMs / 1000);
+        tm local = {};
+        localtime_s(&local, &seconds);
+        uint64_t minutes = (session.leaveUnixMs - session.joinUnixMs) / 60000;
+        char line[96];
+        snprintf(line, sizeof(line), "%04d-%02d-%02d %02d:%02d  %lluh%02llum  %u.%u.%u.%u  ",
+            local.tm_year + 1900, local.tm_mon + 1, local.tm_mday, local.tm_hour, local.tm_min,
+            (unsigned long long)(minutes / 60), (unsigned long long)(minutes % 60),
+            session.ip >> 24, (session.ip >> 16) & 255, (session.ip >> 8) & 255, session.ip & 255);
+        std::string text = line + session.name + "^7";
+        if (!session.guid.empty()) text.append("  ").append(session.guid);
+        UIComponents::appendOutput(hwnd, text, session.server, ConsoleKind::Info);
+    }
+}
+
+// Shows pending actions on server if it is displayed and queries it to confirm them.
+void UIRcon::verifyPlayerActions(HWND hwnd, const Server& server) {
+    if (!playerActions.hasPending(server.name)) {
+        return; // Nothing visible to confirm
+    }
+    const ServerSnapshot* shown = snapshots.find(server.name);
+    if (shown && shown->playersOk && server.name == displayedServer) {
+        updatePlayerTable(hwnd, server, *shown);
+    }
+    if (server.name == displayedServer) {
+        playerActions.verifying();
+        refreshServer(hwnd, server);
+    }
+}
+
+// Runs a batch on the query worker and posts the result back.
+static void submitBatch(HWND hwnd, std::unique_ptr<BatchResult> batch) {
+    auto result = std::make_shared<std::unique_ptr<BatchResult>>(std::move(batch));
+    batchWorker.submit(batchToken, [hwnd, result](const CancelToken& token) {
+        std::unique_ptr<BatchResult> done = std::move(*result);
+        done->startedMs = GetTickCount64();
+        done->batch.run([&token] { return token.cancelled(); });
+        done->finishedMs = GetTickCount64();
+        if (PostMessage(hwnd, WM_RCON_BATCHDONE, 0, (LPARAM)done.get())) {
+            done.release(); // Owned by the message now
+        }
+    });
+}
+
+void UIRcon::runBatch(HWND hwnd, RconBatch&& batch, ULONGLONG clickMs) {
+    if (batch.empty()) {
+        return;
+    }
+    UIComponents::appendOutput(hwnd, "Sending " + std::to_string(batch.size()) + " commands to " +
+        std::to_string(batch.serverCount()) + " server(s)", "", ConsoleKind::Info);
+    submitBatch(hwnd, std::unique_ptr<BatchResult>(new BatchResult{ std::move(batch), clickMs }));
+}
+
+// Kicks the online players among ids that fall under a ban rule, through the paced batch path.
+static void enforceBans(HWND hwnd, const std::vector<uint32_t>& ids) {
+    if (ids.empty() || banList.rules().empty()) {
+        return;
+    }
+    uint64_t nowUnixMs = unixNowMs();
+    RconBatch batch;
+    std::vector<Server> servers;
+    for (uint32_t id : ids) {
+        const IndexedPlayer& player = playerIndex.player(id);
+        const BanRule* rule = player.live ? banList.match(player.key, player.ip, player.guid, nowUnixMs) : nullptr;
+        if (!rule) continue;
+        if (servers.empty()) servers = ServerManager::loadServers();
+        auto server = std::find_if(servers.begin(), servers.end(), [&player](const Server& s) { return s.name == player.server; });
+        if (server == servers.end() || server->rconPassword.empty()) continue;
+        std::string line = "Ban list: " + player.name + "^7 matches " + rule->pattern;
+        if (!rule->reason.empty()) line += " (" + rule->reason + ")";
+        UIComponents::appendOutput(hwnd, line + ", kicking", player.server, ConsoleKind::Info);
+        batch.add(*server, player.slot, player.name, kKickColumn.command);
+    }
+    UIRcon::runBatch(hwnd, std::move(batch), GetTickCount64());
+}
+
+// Sends every server with IP filter commands the addip/removeip diff between the ban list and what it
+// was last sent, at most BAN_SYNC_MAX_CHANGES per server so kicks queued behind a sync do not wait for
+// minutes; the rest follow as soon as it finishes. Servers that miss a change get it again on the next sync.
+static void syncBans(HWND hwnd) {
+    if (banSyncRunning) {
+        return;
+    }
+    lastBanSync = GetTickCount64();
+    syncedBanVersion = banList.version();
+    std::vector<std::string> desired, add, remove;
+    banList.ipFilters(unixNowMs(), desired);
+    RconBatch batch;
+    bool partial = false;
+    for (const Server& server : ServerManager::loadServers()) {
+        const GameTraits& traits = GameTraits::get(server.gameId);
+        if (!traits.ipBanCommand || server.rconPassword.empty()) continue;
+        banFilters.diff(server.name, desired, add, remove);
+        // The filter takes the place of the slot as the command's argument
+        size_t changes = 0;
+        for (size_t i = 0; i < remove.size() && changes < BAN_SYNC_MAX_CHANGES; ++i, ++changes) {
+            batch.add(server, remove[i], "", traits.ipUnbanCommand);
+        }
+        for (size_t i = 0; i < add.size() && changes < BAN_SYNC_MAX_CHANGES; ++i, ++changes) {
+            batch.add(server, add[i], "", traits.ipBanCommand);
+        }
+        partial = partial || remove.size() + add.size() > changes;
+    }
+    if (batch.empty()) {
+        return;
+    }
+    banSyncRunning = true;
+    banSyncPartial = partial;
+    UIComponents::appendOutput(hwnd, "Ban list: sending " + std::to_string(batch.size()) + " IP filter changes to " +
+        std::to_string(batch.serverCount()) + " server(s)", "", ConsoleKind::Info);
+    std::unique_ptr<BatchResult> result(new BatchResult{ std::move(batch), GetTickCount64() });
+    result->banSync = true;
+    submitBatch(hwnd, std::move(result));
+}
+
+// Records the filter changes the servers acknowledged.
+static void reportBanSync(HWND hwnd, const BatchResult& result) {
+    banSyncRunning = false;
+    const RconBatch& batch = result.batch;
+    size_t applied = 0;
+    for (const BatchItem& item : batch.results()) {
+        const Server& server = batch.server(item.target);
+        if (!item.replied) {
+            UIComponents::appendOutput(hwnd, item.command + ": " + item.reply, server.name, ConsoleKind::Error);
+            continue;
+        }
+        const char* ban = GameTraits::get(server.gameId).ipBanCommand;
+        banFilters.applied(server.name, item.slot, ban && item.command == std::string(ban) + " " + item.slot);
+        ++applied;
+    }
+    if (applied > 0 && !banFilters.save(BAN_SYNC_FILE)) {
+        ServerManager::logDebug("Failed to save the ban sync state to " + std::string(BAN_SYNC_FILE));
+    }
+    UIComponents::appendOutput(hwnd, "Ban list: " + std::to_string(applied) + " of " + std::to_string(batch.size()) +
+        " IP filter changes applied", "", applied == batch.size() ? ConsoleKind::Info : ConsoleKind::Error);
+    if (banSyncPartial && applied > 0) {
+        syncBans(hwnd); // The next part; stops when a round gets nothing through
+    }
+}
+
+// Picks up edits to the ban file, applies changed rules to everyone online and syncs the IP filters.
+static void maintainBans(HWND hwnd, ULONGLONG now) {
+    if (banList.changedOnDisk(BAN_FILE)) {
+        UIRcon::loadBans();
+    }
+    if (banList.version() != enforcedBanVersion) {
+        enforcedBanVersion = banList.version();
+        std::vector<uint32_t> online;
+        for (uint32_t id = 0; id < playerIndex.idLimit(); ++id) {
+            if (playerIndex.player(id).live) online.push_back(id);
+        }
+        enforceBans(hwnd, online);
+    }
+    if (banList.version() != syncedBanVersion || now - lastBanSync >= BAN_SYNC_MS) {
+        syncBans(hwnd);
+    }
+}
+
+// Checks the rules against a poll and sends what fires through the paced batch path.
+static void applyRules(HWND hwnd, const Server& server, const StatusView& status, const PlayersView& players) {
+    if (ruleEngine.rules().empty() || server.rconPassword.empty()) {
+        return;
+    }
+    std::vector<RuleFiring> firings;
+    ruleEngine.evaluate(server.name, status, players, GetTickCount64(), firings);
+    RconBatch batch;
+    for (const RuleFiring& firing : firings) {
+        const std::string& rule = ruleEngine.rules()[firing.rule].name;
+        RconCommand command(firing.command);
+        if (!batch.add(server, command, firing.slot, firing.name)) {
+            UIComponents::appendOutput(hwnd, "Rule " + rule + ": command too long, not sent", server.name, ConsoleKind::Error);
+            continue;
+        }
+        UIComponents::appendOutput(hwnd, "Rule " + rule + ": " + firing.command, server.name, ConsoleKind::Info);
+    }
+    UIRcon::runBatch(hwnd, std::move(batch), GetTickCount64());
+}
+
+// Loads the rules again when the file was edited, and says what came of it.
+static void maintainRules(HWND hwnd) {
+    if (!ruleEngine.changedOnDisk(RULE_FILE)) {
+        return;
+    }
+    std::vector<std::string> errors;
+    size_t loaded = ruleEngine.load(RULE_FILE, errors);
+    UIComponents::appendOutput(hwnd, "Rules: " + std::to_string(loaded) + " loaded from " + RULE_FILE, "",
+        errors.empty() ? ConsoleKind::Info : ConsoleKind::Error);
+    for (const std::string& error : errors) {
+        UIComponents::appendOutput(hwnd, error + "; skipped", "", ConsoleKind::Error);
+    }
+}
+
+void UIRcon::loadRules() {
+    std::vector<std::string> errors;
+    ruleEngine.load(RULE_FILE, errors);
+    for (const std::string& error : errors) {
+        ServerManager::logDebug(std::string(RULE_FILE) + ": " + error + "; skipped");
+    }
+}
+
+// "key is value, baseline expected" for the first few differences.
+static std::string describeDrift(const std::vector<CvarDiff>& drift) {
+    const size_t shown = 6;
+    std::string text;
+    for (size_t i = 0; i < drift.size() && i < shown; ++i) {
+        if (!text.empty()) text += "; ";
+        text += drift[i].key + (drift[i].missing ? " missing" : " is " + drift[i].actual) + ", baseline " + drift[i].expected;
+    }
+    if (drift.size() > shown) text += "; " + std::to_string(drift.size() - shown) + " more";
+    return text;
+}
+
+// Records a poll's cvars and says so when the server's drift from its baseline changes.
+static void checkDrift(HWND hwnd, const Server& server, const StatusView& status) {
+    if (!cvarStore.update(server.name, server.game, status, unixNowMs())) {
+        return;
+    }
+    const std::vector<CvarDiff>* drift = cvarStore.drift(server.name);
+    if (!drift || drift->empty()) {
+        UIComponents::appendOutput(hwnd, "Config drift: back in line with the baseline", server.name, ConsoleKind::Info);
+        return;
+    }
+    UIComponents::appendOutput(hwnd, "Config drift: " + describeDrift(*drift), server.name, ConsoleKind::Error);
+}
+
+// Loads the baselines again when the file was edited and reports every server polled so far against them.
+static void maintainBaselines(HWND hwnd) {
+    if (!cvarStore.changedOnDisk(CVAR_BASELINE_FILE)) {
+        return;
+    }
+    std::vector<std::string> errors;
+    size_t loaded = cvarStore.loadProfiles(CVAR_BASELINE_FILE, errors);
+    UIComponents::appendOutput(hwnd, "Cvar baselines: " + std::to_string(loaded) + " loaded from " + CVAR_BASELINE_FILE, "",
+        errors.empty() ? ConsoleKind::Info : ConsoleKind::Error);
+    for (const std::string& error : errors) {
+        UIComponents::appendOutput(hwnd, error + "; skipped", "", ConsoleKind::Error);
+    }
+    std::vector<std::pair<std::string, const std::vector<CvarDiff>*>> drifting;
+    size_t checked = cvarStore.fleetDrift(drifting);
+    if (checked == 0) {
+        return;
+    }
+    UIComponents::appendOutput(hwnd, "Config drift: " + std::to_string(drifting.size()) + " of " + std::to_string(checked) +
+        " polled servers differ from their baseline", "", drifting.empty() ? ConsoleKind::Info : ConsoleKind::Error);
+    for (const auto& server : drifting) {
+        UIComponents::appendOutput(hwnd, "Config drift: " + describeDrift(*server.second), server.first, ConsoleKind::Error);
+    }
+}
+
+void UIRcon::loadBaselines() {
+    std::vector<std::string> errors;
+    cvarStore.loadProfiles(CVAR_BASELINE_FILE, errors);
+    for (const std::string& error : errors) {
+        ServerManager::logDebug(std::string(CVAR_BASELINE_FILE) + ": " + error + "; skipped");
+    }
+}
+
+// Server names with their protocols, for matching logs.ini to servers.ini.
+static std::vector<std::pair<std::string, int>> serverProtocols() {
+    std::vector<std::pair<std::string, int>> protocols;
+    for (const Server& server : ServerManager::loadServers()) protocols.emplace_back(server.name, server.protocolId);
+    return protocols;
+}
+
+// One console line for a log event, or empty for the ones not shown (damage, map end).
+static std::string describeLogEvent(const LogEvent& event) {
+    std::string name = event.name.empty() ? "Slot " + std::string(event.slot) : std::string(event.name);
+    switch (event.kind) {
+    case LogEventKind::Join: return name + " joined";
+    case LogEventKind::Quit: return name + " left";
+    case LogEventKind::Kill:
+        return (event.name.empty() ? std::string("The world") : std::string(event.name)) + " killed " +
+            std::string(event.victimName) + " (" + std::string(event.weapon) + ")";
+    case LogEventKind::Say: return name + ": " + std::string(event.text);
+    case LogEventKind::SayTeam: return name + " (team): " + std::string(event.text);
+    case LogEventKind::MapStart: {
+        size_t at = event.text.find("\\mapname\\");
+        if (at == std::string_view::npos) return "Map started";
+        std::string_view map = event.text.substr(at + 9);
+        return "Map " + std::string(map.substr(0, map.find('\\'))) + " started";
+    }
+    default: return std::string();
+    }
+}
+
+// Shows what the local game logs gained. A join or quit in a log polls that server at once, so the player
+// index, bans and rules see it without waiting for its next scheduled poll.
+static void maintainLogs(HWND hwnd) {
+    if (gameLogs.changedOnDisk(LOG_FILE)) {
+        std::vector<std::string> errors;
+        size_t loaded = gameLogs.load(LOG_FILE, serverProtocols(), errors);
+        UIComponents::appendOutput(hwnd, "Game logs: " + std::to_string(loaded) + " followed from " + LOG_FILE, "",
+            errors.empty() ? ConsoleKind::Info : ConsoleKind::Error);
+        for (const std::string& error : errors) {
+            UIComponents::appendOutput(hwnd, error + "; skipped", "", ConsoleKind::Error);
+        }
+    }
+    if (gameLogs.sources().empty()) {
+        return;
+    }
+    static std::vector<GameLogs::Event> events; // Views into the tailers' buffers, valid until the next poll
+    gameLogs.poll(events, LOG_POLL_BYTES);
+    std::vector<std::string> changed;
+    for (const GameLogs::Event& item : events) {
+        const std::string& server = gameLogs.sources()[item.source].server;
+        std::string text = describeLogEvent(item.event);
+        if (!text.empty()) UIComponents::appendOutput(hwnd, text, server, ConsoleKind::Reply);
+        if ((item.event.kind == LogEventKind::Join || item.event.kind == LogEventKind::Quit) &&
+            std::find(changed.begin(), changed.end(), server) == changed.end()) {
+            changed.push_back(server);
+        }
+    }
+    if (changed.empty()) {
+        return;
+    }
+    for (const Server& server : ServerManager::loadServers()) {
+        if (std::find(changed.begin(), changed.end(), server.name) == changed.end() || server.name == refreshingServer ||
+            std::find(pollingServers.begin(), pollingServers.end(), server.name) != pollingServers.end()) {
+            continue;
+        }
+        if (server.name == displayedServer) UIRcon::refreshServer(hwnd, server);
+        else startPoll(hwnd, server);
+    }
+}
+
+void UIRcon::loadLogs() {
+    std::vector<std::string> errors;
+    gameLogs.load(LOG_FILE, serverProtocols(), errors);
+    for (const std::string& error : errors) {
+        ServerManager::logDebug(std::string(LOG_FILE) + ": " + error + "; skipped");
+    }
+}
+
+void UIRcon::loadJobs() {
+    std::vector<std::string> errors;
+    jobScheduler.load(JOB_FILE, unixNowMs(), errors);
+    for (const std::string& error : errors) {
+        ServerManager::logDebug(std::string(JOB_FILE) + ": " + error + "; skipped");
+    }
+}
+
+// Sends the commands of the job runs that came due, reloading jobs.ini first if it was edited, and
+// sets the timer for the next run.
+void UIRcon::onJobTimer(HWND hwnd) {
+    uint64_t nowUnixMs = unixNowMs();
+    if (jobScheduler.changedOnDisk(JOB_FILE)) {
+        std::vector<std::string> errors;
+        size_t loaded = jobScheduler.load(JOB_FILE, nowUnixMs, errors);
+        UIComponents::appendOutput(hwnd, "Jobs: " + std::to_string(loaded) + " loaded from " + JOB_FILE, "",
+            errors.empty() ? ConsoleKind::Info : ConsoleKind::Error);
+        for (const std::string& error : errors) {
+            UIComponents::appendOutput(hwnd, error + "; skipped", "", ConsoleKind::Error);
+        }
+    }
+
+    std::vector<JobDue> due;
+    jobScheduler.due(nowUnixMs, due);
+    if (!due.empty()) {
+        std::unique_ptr<BatchResult> result(new BatchResult{ RconBatch(), GetTickCount64() });
+        // Job commands can print more than one packet holds, so each server gets one at a time and its
+        // reply is every packet until the server goes quiet
+        RconBatch::Pacing pacing = result->batch.getPacing();
+        pacing.window = 1;
+        pacing.quietMs = JOB_REPLY_QUIET_MS;
+        result->batch.setPacing(pacing);
+        std::vector<JobRun> missed, rejected;
+        std::vector<Server> servers = ServerManager::loadServers();
+        for (const JobDue& run : due) {
+            const Job& job = jobScheduler.jobs()[run.job];
+            for (const Server& server : servers) {
+                if (!JobScheduler::targets(job, server.name)) continue;
+                for (const std::string& line : job.commands) {
+                    JobRun record{ job.name, server.name, line, run.scheduledUnixMs, nowUnixMs };
+                    if (run.missed) {
+                        record.result = "missed (xRcon was not running or the machine was asleep)";
+                        missed.push_back(std::move(record));
+                    }
+                    else if (result->batch.add(server, RconCommand(line), "", job.name)) {
+                        result->jobRuns.push_back(std::move(record));
+                    }
+                    else {
+                        UIComponents::appendOutput(hwnd, "Job " + job.name + ": command too long, not sent", server.name, ConsoleKind::Error);
+                        record.result = "command too long, not sent";
+                        rejected.push_back(std::move(record));
+                    }
+                }
+            }
+        }
+        if (!missed.empty()) {
+            UIComponents::appendOutput(hwnd, "Jobs: " + std::to_string(missed.size()) + " command(s) missed their time and were skipped",
+                "", ConsoleKind::Error);
+            jobHistory.append(JOB_HISTORY_FILE, missed);
+        }
+        if (!rejected.empty() && !jobHistory.append(JOB_HISTORY_FILE, rejected)) {
+            ServerManager::logDebug("Failed to write the job history to " + std::string(JOB_HISTORY_FILE));
+        }
+        if (!result->batch.empty()) {
+            UIComponents::appendOutput(hwnd, "Jobs: sending " + std::to_string(result->batch.size()) + " command(s) to " +
+                std::to_string(result->batch.serverCount()) + " server(s)", "", ConsoleKind::Info);
+            submitBatch(hwnd, std::move(result));
+        }
+    }
+
+    uint64_t next = jobScheduler.nextDueUnixMs();
+    uint64_t waitMs = next <= nowUnixMs ? 0 : std::min(next - nowUnixMs, JOB_TIMER_MAX_MS);
+    SetTimer(hwnd, JOB_TIMER_ID, static_cast<UINT>(std::max<uint64_t>(waitMs, 100)), nullptr);
+}
+
+// Records what became of each job command.
+static void reportJobRuns(HWND hwnd, BatchResult& result) {
+    const std::vector<BatchItem>& items = result.batch.results();
+    size_t ok = 0;
+    for (size_t i = 0; i < items.size() && i < result.jobRuns.size(); ++i) {
+        JobRun& run = result.jobRuns[i];
+        run.ok = items[i].replied;
+        run.result = items[i].reply;
+        ok += run.ok ? 1 : 0;
+        if (!run.ok) {
+            UIComponents::appendOutput(hwnd, "Job " + run.job + ": " + items[i].command + ": " + items[i].reply, run.server,
+                ConsoleKind::Error);
+        }
+    }
+    UIComponents::appendOutput(hwnd, "Jobs: " + std::to_string(ok) + " of " + std::to_string(items.size()) + " command(s) answered",
+        "", ok == items.size() ? ConsoleKind::Info : ConsoleKind::Error);
+    if (!jobHistory.append(JOB_HISTORY_FILE, result.jobRuns)) {
+        ServerManager::logDebug("Failed to write the job history to " + std::string(JOB_HISTORY_FILE));
+    }
+}
+
+// Loads the ban list and what each server was last sent.
+void UIRcon::loadBans() {
+    size_t skipped = banList.load(BAN_FILE);
+    if (skipped > 0) {
+        ServerManager::logDebug(std::to_string(skipped) + " invalid or duplicate rule(s) in " + BAN_FILE + " skipped");
+    }
+    banFilters.load(BAN_SYNC_FILE);
+}
+
+// Adds displayed players to the ban list by address, else by GUID, else by name, then kicks them
+// everywhere and syncs the filters.
+void UIRcon::banPlayers(HWND hwnd, const Server& server, const std::vector<std::string>& slots, const std::string& reason) {
+    if (server.name != displayedServer) {
+        return;
+    }
+    uint64_t nowUnixMs = unixNowMs();
+    size_t added = 0;
+    for (const std::string& slot : slots) {
+        for (size_t i = 0; i < playerSnapshot.count; ++i) {
+            const PlayerView& player = playerSnapshot.rows[i];
+            if (player.slot != slot) continue;
+            BanRule rule;
+            uint32_t ip = 0, bits = 0;
+            if (BanList::parseAddress(player.address, ip, bits)) {
+                rule.kind = BanKind::Address;
+                rule.pattern.assign(player.address.data(), player.address.size());
+            }
+            else if (!player.guid.empty()) {
+                rule.kind = BanKind::Guid;
+                rule.pattern.assign(player.guid.data(), player.guid.size());
+            }
+            else {
+                rule.kind = BanKind::Name;
+                rule.pattern.assign(player.name.data(), player.name.size());
+            }
+            rule.reason = reason;
+            rule.addedUnixMs = nowUnixMs;
+            std::string name(player.name.data(), player.name.size());
+            if (banList.add(rule)) {
+                ++added;
+                UIComponents::appendOutput(hwnd, "Ban list: added " + banList.rules().back().pattern + " for " + name + "^7",
+                    server.name, ConsoleKind::Info);
+            }
+            break;
+        }
+    }
+    if (added > 0 && !banList.save(BAN_FILE)) {
+        ServerManager::logDebug("Failed to save the ban list to " + std::string(BAN_FILE));
+    }
+    maintainBans(hwnd, GetTickCount64());
+}
+
+// Reports a finished batch in one block per server, and applies what the servers accepted to the player table.
+void UIRcon::onBatchResult(HWND hwnd, LPARAM lParam) {
+    std::unique_ptr<BatchResult> result(reinterpret_cast<BatchResult*>(lParam));
+    if (!result) {
+        return;
+    }
+    if (result->banSync) {
+        reportBanSync(hwnd, *result);
+        return;
+    }
+    if (!result->jobRuns.empty()) {
+        reportJobRuns(hwnd, *result);
+        return;
+    }
+    const RconBatch& batch = result->batch;
+    size_t answered = 0;
+    for (const BatchItem& item : batch.results()) answered += item.replied ? 1 : 0;
+    char summary[160];
+    snprintf(summary, sizeof(summary), "Batch finished in %.1f s: %zu of %zu commands answered on %zu server(s)",
+        (result->finishedMs - result->clickMs) / 1000.0, answered, batch.size(), batch.serverCount());
+    UIComponents::appendOutput(hwnd, summary, "", answered == batch.size() ? ConsoleKind::Info : ConsoleKind::Error);
+
+    for (uint32_t target = 0; target < batch.serverCount(); ++target) {
+        const Server& server = batch.server(target);
+        std::string replies, failures;
+        for (const BatchItem& item : batch.results()) {
+            if (item.target != target) continue;
+            std::string& out = item.replied ? replies : failures;
+            out.append(item.command).append(": ").append(item.reply.empty() ? "(empty reply)" : item.reply).append("\n");
+            if (item.replied) {
+                playerActions.applied(server.name, item.slot, item.name, item.command, result->clickMs, item.replyMs);
+            }
+        }
+        if (!replies.empty()) UIComponents::appendOutput(hwnd, replies, server.name, ConsoleKind::Reply);
+        if (!failures.empty()) UIComponents::appendOutput(hwnd, failures, server.name, ConsoleKind::Error);
+        verifyPlayerActions(hwnd, server);
+    }
+}
+
+// Shows a snapshot; a cached one is left out of the refresh schedule and its errors are not reported again.
+void UIRcon::showSnapshot(HWND hwnd, const Server& server, const ServerSnapshot& snapshot, bool cached) {
+    updatePlayerTable(hwnd, server, snapshot);
+    updateServerSettings(hwnd, server, snapshot, cached);
+}
+
+// Loads the last known state of every server, shown marked as stale until it is refreshed.
+void UIRcon::loadSnapshots() {
+    snapshots.load(SNAPSHOT_FILE, GetTickCount64(), unixNowMs());
+    savedChanges = snapshots.changes();
+    lastSnapshotSave = GetTickCount64();
+}
+
+// Saves the snapshot store if it changed since the last save.
+void UIRcon::saveSnapshots() {
+    if (snapshots.changes() == savedChanges) {
+        return;
+    }
+    ULONGLONG now = GetTickCount64();
+    if (snapshots.save(SNAPSHOT_FILE, now, unixNowMs())) {
+        savedChanges = snapshots.changes();
+    }
+    else {
+        ServerManager::logDebug("Failed to save server snapshots to " + std::string(SNAPSHOT_FILE));
+    }
+    lastSnapshotSave = now;
+}
+
+// Opens the session history, replaying what the last run left in its journal.
+void UIRcon::openSessionLog() {
+    if (!sessionLog.open(SESSION_DIRECTORY)) {
+        ServerManager::logDebug("Failed to open the player session log in " + std::string(SESSION_DIRECTORY));
+    }
+}
+
+// Stops the query and batch workers before the window goes away.
+void UIRcon::shutdown() {
+    refreshingServer.clear();
+    pollingServers.clear();
+    queryWorker.shutdown();
+    batchWorker.shutdown();
+}
+
+// Ends the sessions of everyone still online and closes the history.
+void UIRcon::closeSessionLog() {
+    std::vector<IndexedPlayer> left;
+    playerIndex.clear(&left);
+    endSessions(left, GetTickCount64());
+    sessionLog.close();
+}
+
+// Starts the next seal or merge of the session files on the query worker, if one is due.
+static void maintainSessionLog(HWND hwnd) {
+    static CancelToken sessionToken; // Never cancelled; a seal left unfinished is redone on the next start
+    std::unique_ptr<SessionJob> job = sessionLog.nextJob();
+    if (!job) {
+        return;
+    }
+    auto result = std::make_shared<std::unique_ptr<SessionJobResult>>(new SessionJobResult{ std::move(job) });
+    queryWorker.submit(sessionToken, [hwnd, result](const CancelToken&) {
+        std::unique_ptr<SessionJobResult> done = std::move(*result);
+        SessionLog::runJob(*done->job);
+        if (PostMessage(hwnd, WM_RCON_SESSIONJOB, 0, (LPARAM)done.get())) {
+            done.release(); // Owned by the message now
+        }
+    });
+}
+
+// Adopts a finished seal or merge.
+void UIRcon::onSessionJobDone(HWND hwnd, LPARAM lParam) {
+    std::unique_ptr<SessionJobResult> result(reinterpret_cast<SessionJobResult*>(lParam));
+    if (!result || !result->job) {
+        return;
+    }
+    const SessionJob& job = *result->job;
+    char summary[160];
+    snprintf(summary, sizeof(summary), "Session log: %s %llu rows into journals %u-%u in %llu ms%s",
+        job.rows ? "sealed" : "merged", (unsigned long long)job.rowCount, job.firstJournal, job.lastJournal,
+        (unsigned long long)job.elapsedMs, job.ok ? "" : " (failed)");
+    ServerManager::logDebug(summary);
+    sessionLog.finishJob(std::move(result->job));
+    maintainSessionLog(hwnd); // Sealing can make a merge due
+}
+
+// Handles a scheduler tick: refreshes the selected server once its deadline has passed.
+void UIRcon::onRefreshTimer(HWND hwnd) {
+    std::vector<uint32_t> due;
+    ULONGLONG now = GetTickCount64();
+    if (now - lastSnapshotSave >= SNAPSHOT_SAVE_MS) {
+        saveSnapshots();
+    }
+    maintainSessionLog(hwnd);
+    maintainBans(hwnd, now);
+    maintainRules(hwnd);
+    maintainBaselines(hwnd);
+    maintainLogs(hwnd);
+    int index = static_cast<int>(SendMessage(GetDlgItem(hwnd, 500), CB_GETCURSEL, 0, 0));
+    std::vector<Server> servers;
+
+    // Player actions: give up on unconfirmed ones, and check again once the grace period is over
+    if (playerActions.pendingCount() > 0) {
+        std::vector<PlayerAction> settled;
+        playerActions.expire(now, settled);
+        reportSettled(hwnd, settled);
+        servers = ServerManager::loadServers();
+        if (index >= 0 && index < static_cast<int>(servers.size())) {
+            const Server& server = servers[index];
+            bool shownExpired = false;
+            for (const PlayerAction& action : settled) shownExpired = shownExpired || action.server == displayedServer;
+            const ServerSnapshot* shown = snapshots.find(server.name);
+            if (shownExpired && shown && shown->playersOk && server.name == displayedServer) {
+                updatePlayerTable(hwnd, server, *shown); // Brings the rows back
+            }
+            if (refreshingServer.empty() && playerActions.needsVerify(server.name, now)) {
+                playerActions.verifying();
+                refreshServer(hwnd, server);
             }
         }
     }
 
+    refreshScheduler.acquire(now, due);
+    if (due.empty()) {
+        return; // Nothing due this tick
+    }
+
+    for (uint32_t id : due) {
+        if (static_cast<int>(id) == index) {
+            if (servers.empty()) {
+                servers = ServerManager::loadServers();
+            }
+            if (index < static_cast<int>(servers.size())) {
+                // A refresh already pending for it completes this deadline too
+                if (refreshingServer != servers[index].name) {
+                    refreshServer(hwnd, servers[index]); // Completes via scheduleRefresh when the reply is shown
+                }
+                continue;
+            }
+        }
+        // Other servers are polled in the background, completing when their result arrives
+        if (servers.empty()) {
+            servers = ServerManager::loadServers();
+        }
+        if (id < servers.size() && !servers[id].ipOrHostname.empty() && servers[id].port != 0 &&
+            servers[id].name != refreshingServer) {
+            startPoll(hwnd, servers[id]);
+            continue;
+        }
+        refreshScheduler.complete(id, RefreshOutcome::Skipped, now);
+    }
+}
+
+// Updates server settings controls (hostname, map, gametype, players) from a snapshot's getstatus reply.
+void UIRcon::updateServerSettings(HWND hwnd, const Server& server, const ServerSnapshot& snapshot, bool cached) {
+    // Get control handles
+    HWND hwndHostnameInput = GetDlgItem(hwnd, 511);
+    HWND hwndMapSelector = GetDlgItem(hwnd, 514);
+    HWND hwndGametypeSelector = GetDlgItem(hwnd, 517);
+    HWND hwndPlayersLabel = GetDlgItem(hwnd, 520);
+
+    if (!hwndHostnameInput || !hwndMapSelector || !hwndGametypeSelector || !hwndPlayersLabel) {
+        if (!cached) scheduleRefresh(hwnd, server, RefreshOutcome::Skipped); // Retry later if controls are missing
+        return;
+    }
+
+    // Show/hide action buttons based on game type
+    const GameTraits& traits = GameTraits::get(server.gameId);
+    ShowWindow(GetDlgItem(hwnd, 521), traits.restartButton ? SW_SHOW : SW_HIDE); // Restart
+    ShowWindow(GetDlgItem(hwnd, 522), traits.fastRestartButton ? SW_SHOW : SW_HIDE); // Fast Restart
+    ShowWindow(GetDlgItem(hwnd, 523), traits.mapRotateButton ? SW_SHOW : SW_HIDE); // Map Rotate
+
+    // Server status is parsed in the DLL's buffer, with cvar views in the spare snapshot arena
+    ParseArena& arena = statusArenas.next();
+    if (!snapshot.statusOk) {
+        if (cached) return;
+        UIComponents::appendOutput(hwnd, "Failed to fetch server status: " + std::string(snapshot.status), server.name, ConsoleKind::Error);
+        scheduleRefresh(hwnd, server, RefreshOutcome::Down);
+        return;
+    }
+
+    // Extract server information
+    StatusView status;
+    StatusParser::parseServerStatus(snapshot.status, traits.gametypeIsString, arena, status);
+    std::string_view mapname = status.mapname;
+    std::string_view gametype = status.gametype;
+    size_t playerCount = status.playerCount;
+
     // Update hostname input
-    WCHAR buffer[4096];
-    MultiByteToWideChar(CP_UTF8, 0, hostname.c_str(), -1, buffer, sizeof(buffer) / sizeof(WCHAR));
-    SetWindowTextW(hwndHostnameInput, buffer);
+    SetWindowTextW(hwndHostnameInput, arena.widen(status.hostname));
 
     // Clear existing map and gametype data
     for (WCHAR* ptr : mapData) free(ptr);
@@ -322,57 +1370,63 @@ void UIRcon::updateServerSettings(HWND hwnd, const Server& server) {
 
     // Populate map selector
     SendMessage(hwndMapSelector, CB_RESETCONTENT, 0, 0);
-    std::map<std::string, std::string> mapList = ServerManager::parseList(server.maps);
-    int selectedMapIndex = -1, index = 0;
-    for (const auto& pair : mapList) {
-        MultiByteToWideChar(CP_UTF8, 0, pair.second.c_str(), -1, buffer, sizeof(buffer) / sizeof(WCHAR));
-        SendMessage(hwndMapSelector, CB_ADDSTRING, 0, (LPARAM)buffer);
-        WCHAR* data = _wcsdup(buffer);
+    const ListCatalog& mapList = ListCatalog::get(server.maps);
+    int index = 0;
+    for (const CatalogEntry& entry : mapList.entries()) {
+        const wchar_t* name = arena.widen(entry.name);
+        SendMessage(hwndMapSelector, CB_ADDSTRING, 0, (LPARAM)name);
+        WCHAR* data = _wcsdup(name);
         SendMessage(hwndMapSelector, CB_SETITEMDATA, index, (LPARAM)data);
         mapData.push_back(data);
-        if (pair.first == mapname) selectedMapIndex = index;
         ++index;
     }
+    int selectedMapIndex = mapList.indexOfId(mapname);
     if (selectedMapIndex >= 0) {
         SendMessage(hwndMapSelector, CB_SETCURSEL, selectedMapIndex, 0);
     }
 
     // Populate gametype selector
     SendMessage(hwndGametypeSelector, CB_RESETCONTENT, 0, 0);
-    std::map<std::string, std::string> gametypeList = ServerManager::parseList(server.gametypes);
-    int selectedGametypeIndex = -1;
+    const ListCatalog& gametypeList = ListCatalog::get(server.gametypes);
     index = 0;
-    for (const auto& pair : gametypeList) {
-        MultiByteToWideChar(CP_UTF8, 0, pair.second.c_str(), -1, buffer, sizeof(buffer) / sizeof(WCHAR));
-        SendMessage(hwndGametypeSelector, CB_ADDSTRING, 0, (LPARAM)buffer);
-        WCHAR* data = _wcsdup(buffer);
+    for (const CatalogEntry& entry : gametypeList.entries()) {
+        const wchar_t* name = arena.widen(entry.name);
+        SendMessage(hwndGametypeSelector, CB_ADDSTRING, 0, (LPARAM)name);
+        WCHAR* data = _wcsdup(name);
         SendMessage(hwndGametypeSelector, CB_SETITEMDATA, index, (LPARAM)data);
         gametypeData.push_back(data);
-        if (pair.first == gametype || (isMOHAA && pair.second == gametype)) selectedGametypeIndex = index;
         ++index;
     }
+    // MOHAA reports g_gametypestring, which is the display name rather than the id
+    int selectedGametypeIndex = gametypeList.indexOfId(gametype);
+    if (selectedGametypeIndex < 0 && traits.gametypeIsString) selectedGametypeIndex = gametypeList.indexOfName(gametype);
     if (selectedGametypeIndex >= 0) {
         SendMessage(hwndGametypeSelector, CB_SETCURSEL, selectedGametypeIndex, 0);
     }
 
     // Update player count label
-    std::string playersText = std::to_string(playerCount) + "/" + maxclients;
-    MultiByteToWideChar(CP_UTF8, 0, playersText.c_str(), -1, buffer, sizeof(buffer) / sizeof(WCHAR));
-    SetWindowTextW(hwndPlayersLabel, buffer);
-
-    scheduleRefresh(hwnd, server); // Schedule next refresh
+    char playersText[64];
+    int playersLength = snprintf(playersText, sizeof(playersText), "%zu/%.*s%s", playerCount,
+        static_cast<int>(status.maxclients.size()), status.maxclients.data(),
+        snapshot.stale ? " (last known)" : "");
+    SetWindowTextW(hwndPlayersLabel, arena.widen(std::string_view(playersText, playersLength > 0 ? playersLength : 0)));
+
+    statusArenas.publish(); // Replaces the previous settings snapshot
+    if (!cached) {
+        scheduleRefresh(hwnd, server, playerCount > 0 ? RefreshOutcome::Busy : RefreshOutcome::Empty); // Schedule next refresh
+    }
 }
 
-// Updates the player table with current server player data.
-void UIRcon::updatePlayerTable(HWND hwnd, const Server& server) {
-    Sleep(500); // Brief delay to handle server response timing
+// Updates the player table from a snapshot's rcon status reply.
+void UIRcon::updatePlayerTable(HWND hwnd, const Server& server, const ServerSnapshot& snapshot) {
     HWND hwndPlayerTable = GetDlgItem(hwnd, 501);
     if (!hwndPlayerTable) {
         return; // Player table not found
     }
 
     // Recreate columns if game type changes
-    if (lastGame != server.game) {
+    const GameTraits& traits = GameTraits::get(server.gameId);
+    if (lastColumnsGame != server.gameId) {
         ListView_DeleteAllItems(hwndPlayerTable);
         while (ListView_DeleteColumn(hwndPlayerTable, 0)) {}
         LVCOLUMN col = { 0 };
@@ -387,217 +1441,71 @@ void UIRcon::updatePlayerTable(HWND hwnd, const Server& server) {
         }
 
         // Add game-specific action columns
-        WCHAR renameText[] = L"Rename";
-        WCHAR unbindText[] = L"Unbind";
-        WCHAR kickText[] = L"Kick";
-        WCHAR banText[] = L"Ban";
-        bool isMOHAA = server.game == "Medal of Honor: Allied Assault" || server.game == "Medal of Honor: AA Spearhead";
-        bool isMOHSHBT = server.game == "Medal of Honor: AA Breakthrough";
-        bool isCOD = server.game.find("Call of Duty") != std::string::npos;
-
-        if (isMOHAA) {
-            int actionWidths[] = { 60, 60, 60 };
-            col.cx = actionWidths[0]; col.pszText = renameText; ListView_InsertColumn(hwndPlayerTable, colCount++, &col);
-            col.cx = actionWidths[1]; col.pszText = unbindText; ListView_InsertColumn(hwndPlayerTable, colCount++, &col);
-            col.cx = actionWidths[2]; col.pszText = kickText; ListView_InsertColumn(hwndPlayerTable, colCount++, &col);
-        }
-        else if (isMOHSHBT) {
-            col.cx = 80; col.pszText = kickText; ListView_InsertColumn(hwndPlayerTable, colCount++, &col);
-        }
-        else if (isCOD) {
-            int actionWidths[] = { 80, 80 };
-            col.cx = actionWidths[0]; col.pszText = kickText; ListView_InsertColumn(hwndPlayerTable, colCount++, &col);
-            col.cx = actionWidths[1]; col.pszText = banText; ListView_InsertColumn(hwndPlayerTable, colCount++, &col);
-        }
-        lastGame = server.game;
+        for (int i = 0; i < traits.actionCount; ++i) {
+            col.cx = traits.actions[i].width;
+            col.pszText = (LPWSTR)traits.actions[i].title;
+            ListView_InsertColumn(hwndPlayerTable, colCount++, &col);
+        }
+        lastColumnsGame = server.gameId;
     }
     else {
         ListView_DeleteAllItems(hwndPlayerTable); // Clear items, preserve columns
     }
 
-    // Validate server details
-    if (server.ipOrHostname.empty() || server.port == 0) {
-        UIComponents::setOutputMessage(hwnd, "Invalid server details: IP/hostname or port is invalid.");
-        return;
-    }
-
-    // Query player status
-    const char* response = ProcessGameServerCommand(
-        server.protocolId,
-        false,
-        server.ipOrHostname.c_str(),
-        server.port,
-        "rcon status",
-        server.rconPassword.empty() ? "" : server.rconPassword.c_str()
-    );
-
-    if (!response || strncmp(response, "error=", 6) == 0) {
-        std::string error = response ? response : "No response from server";
-        UIComponents::setOutputMessage(hwnd, ("Server may be OFFLINE or changing map: " + error).c_str());
-        if (response) FreeGameServerResponse(response);
+    // Rows point into the reply, row arrays go in the spare snapshot arena
+    ParseArena& arena = playerArenas.next();
+    if (!snapshot.playersOk) {
+        UIComponents::appendOutput(hwnd, "Server may be OFFLINE or changing map: " + std::string(snapshot.players), server.name, ConsoleKind::Error);
         return;
     }
 
-    std::string json = response;
-    FreeGameServerResponse(response);
-
-    std::vector<std::wstring> strings;
-    int index = 0;
-
-    // Parse players array
-    size_t playersPos = json.find("\"players\":");
-    if (playersPos == std::string::npos) {
-        UIComponents::setOutputMessage(hwnd, "Invalid response format");
+    PlayersView players;
+    std::string error;
+    if (!StatusParser::parsePlayers(snapshot.players, arena, players, error)) {
+        UIComponents::appendOutput(hwnd, error, server.name, ConsoleKind::Error);
         return;
     }
-    json = json.substr(playersPos + 10);
 
-    // Find the end of the players array, accounting for quoted strings
-    size_t arrayEnd = std::string::npos;
-    bool inQuotes = false;
-    for (size_t i = 0; i < json.length(); ++i) {
-        if (json[i] == '"' && (i == 0 || json[i - 1] != '\\')) {
-            inQuotes = !inQuotes; // Toggle quote state
+    // Add each player, as pending kicks, bans and renames will leave them
+    int row = 0;
+    for (size_t i = 0; i < players.count; ++i) {
+        const PlayerAction* action = playerActions.pendingFor(server.name, players.rows[i]);
+        if (!action) {
+            addPlayerRow(hwnd, players.rows[i], row++, arena, traits);
         }
-        else if (json[i] == ']' && !inQuotes) {
-            arrayEnd = i;
-            break;
+        else if (action->effect == ActionEffect::Renames) {
+            PlayerView renaming = players.rows[i];
+            renaming.name = arena.copy(std::string(renaming.name) + "^7 (renaming)");
+            addPlayerRow(hwnd, renaming, row++, arena, traits);
         }
     }
-    if (arrayEnd == std::string::npos) {
-        UIComponents::setOutputMessage(hwnd, "Invalid response format: Could not find array end");
-        return;
-    }
-    json = json.substr(0, arrayEnd);
 
-    if (json.empty() || json == "[]") {
-        return; // No players to display
-    }
-
-    // Determine game type for action buttons
-    bool isMOHAA = server.game == "Medal of Honor: Allied Assault" || server.game == "Medal of Honor: AA Spearhead";
-    bool isMOHSHBT = server.game == "Medal of Honor: AA Breakthrough";
-    bool isCOD = server.game.find("Call of Duty") != std::string::npos;
-
-    // Process each player
-    size_t start = 0;
-    if (json[0] == '[') start = 1; // Skip opening bracket
-    while (start < json.length()) {
-        size_t objStart = json.find('{', start);
-        if (objStart == std::string::npos) break;
-
-        // Find the end of the current player object
-        size_t objEnd = std::string::npos;
-        int braceCount = 1;
-        inQuotes = false;
-        for (size_t i = objStart + 1; i < json.length(); ++i) {
-            if (json[i] == '"' && (i == 0 || json[i - 1] != '\\')) {
-                inQuotes = !inQuotes;
-            }
-            else if (!inQuotes) {
-                if (json[i] == '{') ++braceCount;
-                else if (json[i] == '}') {
-                    --braceCount;
-                    if (braceCount == 0) {
-                        objEnd = i;
-                        break;
-                    }
-                }
-            }
-        }
-        if (objEnd == std::string::npos) {
-            UIComponents::setOutputMessage(hwnd, "Invalid response format: Malformed player object");
-            return;
-        }
-
-        std::string playerJson = json.substr(objStart, objEnd - objStart + 1);
-        parseAndAddPlayer(hwnd, playerJson, index++, strings, isMOHAA, isMOHSHBT, isCOD);
-        start = objEnd + 1;
-
-        // Skip comma or whitespace
-        while (start < json.length() && (json[start] == ',' || isspace(json[start]))) ++start;
-    }
+    playerSnapshot = players;
+    playerArenas.publish(); // Replaces the previous player snapshot
+    playerOwner = snapshot.owner; // Releases the reply the previous rows pointed into
 }
 
-// Parses and adds a player to the player table.
-void UIRcon::parseAndAddPlayer(HWND hwnd, std::string playerJson, int index, std::vector<std::wstring>& strings, bool isMOHAA, bool isMOHSHBT, bool isCOD) {
+// Adds a parsed player to the player table. Cell text is converted in the snapshot arena; the list view keeps its own copy.
+void UIRcon::addPlayerRow(HWND hwnd, const PlayerView& player, int index, ParseArena& arena, const GameTraits& traits) {
     HWND hwndPlayerTable = GetDlgItem(hwnd, 501);
     if (!hwndPlayerTable) {
         return; // Player table not found
     }
 
-    WCHAR buffer[4096];
-    std::string num, name, ip, score, ping;
-
-    // Helper to extract JSON fields
-    auto extractField = [](const std::string& json, const std::string& field) {
-        size_t pos = json.find("\"" + field + "\":");
-        if (pos == std::string::npos) return std::string();
-        pos += field.length() + 3;
-        if (json[pos] == '"') {
-            pos++;
-            size_t end = json.find('"', pos);
-            return json.substr(pos, end - pos);
-        }
-        else {
-            size_t end = json.find_first_of(",}", pos);
-            return json.substr(pos, end - pos);
-        }
-        };
-
-    // Extract player information
-    num = extractField(playerJson, "slot");
-    name = extractField(playerJson, "name");
-    ip = extractField(playerJson, "address");
-    score = extractField(playerJson, "score");
-    ping = extractField(playerJson, "ping");
-
-    if (num.empty() || name.empty()) {
-        return; // Skip invalid player data
-    }
-
     // Add player to table
     LVITEM item = { 0 };
     item.mask = LVIF_TEXT;
     item.iItem = index;
-
-    MultiByteToWideChar(CP_UTF8, 0, num.c_str(), -1, buffer, sizeof(buffer) / sizeof(WCHAR));
-    strings.emplace_back(buffer);
-    item.pszText = (LPWSTR)strings.back().c_str();
+    item.pszText = (LPWSTR)arena.widen(player.slot);
     ListView_InsertItem(hwndPlayerTable, &item);
 
-    MultiByteToWideChar(CP_UTF8, 0, name.c_str(), -1, buffer, sizeof(buffer) / sizeof(WCHAR));
-    strings.emplace_back(buffer);
-    ListView_SetItemText(hwndPlayerTable, index, 1, (LPWSTR)strings.back().c_str());
-
-    MultiByteToWideChar(CP_UTF8, 0, ip.c_str(), -1, buffer, sizeof(buffer) / sizeof(WCHAR));
-    strings.emplace_back(buffer);
-    ListView_SetItemText(hwndPlayerTable, index, 2, (LPWSTR)strings.back().c_str());
-
-    MultiByteToWideChar(CP_UTF8, 0, score.c_str(), -1, buffer, sizeof(buffer) / sizeof(WCHAR));
-    strings.emplace_back(buffer);
-    ListView_SetItemText(hwndPlayerTable, index, 3, (LPWSTR)strings.back().c_str());
-
-    MultiByteToWideChar(CP_UTF8, 0, ping.c_str(), -1, buffer, sizeof(buffer) / sizeof(WCHAR));
-    strings.emplace_back(buffer);
-    ListView_SetItemText(hwndPlayerTable, index, 4, (LPWSTR)strings.back().c_str());
+    ListView_SetItemText(hwndPlayerTable, index, 1, (LPWSTR)arena.widen(player.name, ColorCodes::Strip));
+    ListView_SetItemText(hwndPlayerTable, index, 2, (LPWSTR)arena.widen(player.address));
+    ListView_SetItemText(hwndPlayerTable, index, 3, (LPWSTR)arena.widen(player.score));
+    ListView_SetItemText(hwndPlayerTable, index, 4, (LPWSTR)arena.widen(player.ping));
 
     // Add game-specific action buttons
-    WCHAR renameText[] = L"Rename";
-    WCHAR unbindText[] = L"Unbind";
-    WCHAR kickText[] = L"Kick";
-    WCHAR banText[] = L"Ban";
-    int colIndex = 5;
-    if (isMOHAA) {
-        strings.emplace_back(renameText); ListView_SetItemText(hwndPlayerTable, index, colIndex++, (LPWSTR)strings.back().c_str());
-        strings.emplace_back(unbindText); ListView_SetItemText(hwndPlayerTable, index, colIndex++, (LPWSTR)strings.back().c_str());
-        strings.emplace_back(kickText); ListView_SetItemText(hwndPlayerTable, index, colIndex, (LPWSTR)strings.back().c_str());
-    }
-    else if (isMOHSHBT) {
-        strings.emplace_back(kickText); ListView_SetItemText(hwndPlayerTable, index, colIndex, (LPWSTR)strings.back().c_str());
-    }
-    else if (isCOD) {
-        strings.emplace_back(kickText); ListView_SetItemText(hwndPlayerTable, index, colIndex++, (LPWSTR)strings.back().c_str());
-        strings.emplace_back(banText); ListView_SetItemText(hwndPlayerTable, index, colIndex, (LPWSTR)strings.back().c_str());
+    for (int i = 0; i < traits.actionCount; ++i) {
+        ListView_SetItemText(hwndPlayerTable, index, 5 + i, (LPWSTR)traits.actions[i].title);
     }
 }
\ No newline at end of file
@@ -3,8 +3,24 @@
 
 #include <windows.h>
 #include <string>
+#include <string_view>
 #include <vector>
 #include "ServerManager.h"
+#include "RefreshScheduler.h"
+#include "StatusParser.h"
+
+struct ServerSnapshot;
+struct PlayerAction;
+class RconBatch;
+
+// Posted to the main window by the query worker; lParam is the refresh result, freed by onRefreshResult.
+const UINT WM_RCON_REFRESHED = WM_APP + 1;
+// Posted when a batch of player commands has finished; lParam is the batch result, freed by onBatchResult.
+const UINT WM_RCON_BATCHDONE = WM_APP + 2;
+// Posted when the session log's background seal or merge has finished; lParam is freed by onSessionJobDone.
+const UINT WM_RCON_SESSIONJOB = WM_APP + 3;
+// Scheduled jobs timer; runs on every page and is re-armed for the next due job.
+const UINT_PTR JOB_TIMER_ID = 1002;
 
 class UIRcon {
 public:
@@ -12,11 +28,56 @@ public:
     static void showRconPage(HWND hwnd);
     static void hideRconPage(HWND hwnd);
     static void updateServerSelector(HWND hwnd);
-    static void updatePlayerTable(HWND hwnd, const Server& server);
-    static void updateServerSettings(HWND hwnd, const Server& server);
-    static void parseAndAddPlayer(HWND hwnd, std::string playerJson, int index, std::vector<std::wstring>& strings, bool isMOHAA, bool isMOHSHBT, bool isCOD);
+    // Queries server on the query worker and shows the result when it arrives. A refresh still
+    // pending for any server is cancelled, so only the latest selection is ever queried. Switching
+    // to a server with a stored snapshot shows that snapshot straight away.
+    static void refreshServer(HWND hwnd, const Server& server);
+    static void onRefreshResult(HWND hwnd, LPARAM lParam);
+    // Shows the expected result of a kick, ban or rename at once and confirms it with the next player list.
+    static void playerActionSent(HWND hwnd, const Server& server, std::string_view slot, std::string_view command, ULONGLONG clickMs);
+    // Sends a batch of player commands on the query worker; the results are reported together.
+    static void runBatch(HWND hwnd, RconBatch&& batch, ULONGLONG clickMs);
+    static void onBatchResult(HWND hwnd, LPARAM lParam);
+    // Central ban list: load before the window opens. banPlayers adds displayed players to it by address,
+    // GUID or name, kicks them from every server and syncs the servers' IP filters.
+    static void loadBans();
+    static void banPlayers(HWND hwnd, const Server& server, const std::vector<std::string>& slots, const std::string& reason);
+    // Automated rules: load before the window opens; rules.ini is reloaded when it changes.
+    static void loadRules();
+    // Cvar baselines: load before the window opens; cvar_baselines.ini is reloaded when it changes, and
+    // every poll reports servers whose cvars stray from their game's baseline.
+    static void loadBaselines();
+    // Local game logs: load before the window opens; logs.ini lists each self-hosted server's log file,
+    // whose kills, chat and joins are shown as they are written.
+    static void loadLogs();
+    // Scheduled jobs: load before the window opens, then onJobTimer arms the timer and sends what is due.
+    static void loadJobs();
+    static void onJobTimer(HWND hwnd);
+    // Lists players matching query (name, address/CIDR or GUID) across every polled server, then their
+    // past sessions from the session log.
+    static void findPlayers(HWND hwnd, const std::string& query);
+    // Name of the displayed player in slot, valid until the table is next refreshed; empty if server is not displayed.
+    static std::string_view playerName(const Server& server, std::string_view slot);
+    static void addPlayerRow(HWND hwnd, const PlayerView& player, int index, ParseArena& arena, const GameTraits& traits);
+    static void onRefreshTimer(HWND hwnd);
+    // Warm start: load before the window opens, save on exit (and periodically from the refresh tick).
+    static void loadSnapshots();
+    static void saveSnapshots();
+    // Stops the background workers: cancels all queued and running queries and batches and waits for them.
+    // Call first thing on exit, before saving snapshots or closing the session log.
+    static void shutdown();
+    // Player session history: open before the window opens, close on exit.
+    static void openSessionLog();
+    static void closeSessionLog();
+    static void onSessionJobDone(HWND hwnd, LPARAM lParam);
 private:
-    static void scheduleRefresh(HWND hwnd, const Server& server);
+    static void showSnapshot(HWND hwnd, const Server& server, const ServerSnapshot& snapshot, bool cached);
+    static void updatePlayerTable(HWND hwnd, const Server& server, const ServerSnapshot& snapshot);
+    static void updateServerSettings(HWND hwnd, const Server& server, const ServerSnapshot& snapshot, bool cached);
+    static void verifyPlayerActions(HWND hwnd, const Server& server);
+    static void reportSettled(HWND hwnd, const std::vector<PlayerAction>& settled);
+    static void findSessions(HWND hwnd, const std::string& query);
+    static void scheduleRefresh(HWND hwnd, const Server& server, RefreshOutcome outcome);
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,236 @@
+// --- xRcon\UdpSocket.cpp ---
+// Implementation of a small portable UDP socket wrapper.
+// Used by RconBatch to send rcon commands to many servers at once, and by the game server simulator and the
+// headless tools. Status refreshes and single commands still go through GameServerQuery.
+
+#include "UdpSocket.h"
+#include <cstring>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment(lib, "Ws2_32.lib") // Link Winsock library
+typedef WSAPOLLFD PollFd;
+typedef int SockLen;
+static int pollSockets(PollFd* fds, size_t count, int timeoutMs) { return WSAPoll(fds, static_cast<ULONG>(count), timeoutMs); }
+static bool wouldBlock() { int e = WSAGetLastError(); return e == WSAEWOULDBLOCK || e == WSAECONNRESET; }
+static void closeHandle(intptr_t fd) { closesocket(static_cast<SOCKET>(fd)); }
+#else
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <cerrno>
+typedef pollfd PollFd;
+typedef socklen_t SockLen;
+static int pollSockets(PollFd* fds, size_t count, int timeoutMs) { return poll(fds, static_cast<nfds_t>(count), timeoutMs); }
+static bool wouldBlock() { return errno == EAGAIN || errno == EWOULDBLOCK || errno == ECONNREFUSED; }
+static void closeHandle(intptr_t fd) { ::close(static_cast<int>(fd)); }
+#endif
+
+// Initializes the socket library (Winsock only; a no-op elsewhere).
+bool UdpSocket::startup() {
+#ifdef _WIN32
+    WSADATA data;
+    return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+#else
+    return true;
+#endif
+}
+
+// Releases the socket library.
+void UdpSocket::cleanup() {
+#ifdef _WIN32
+    WSACleanup();
+#endif
+}
+
+// Resolves an IPv4 address or hostname.
+bool UdpSocket::resolve(const std::string& host, uint16_t port, UdpEndpoint& out) {
+    in_addr addr;
+    if (inet_pton(AF_INET, host.c_str(), &addr) == 1) {
+        out.address = ntohl(addr.s_addr);
+        out.port = port;
+        return true;
+    }
+    addrinfo hints;
+    std::memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_DGRAM;
+    addrinfo* result = nullptr;
+    if (getaddrinfo(host.c_str(), nullptr, &hints, &result) != 0 || !result) {
+        return false;
+    }
+    out.address = ntohl(reinterpret_cast<sockaddr_in*>(result->ai_addr)->sin_addr.s_addr);
+    out.port = port;
+    freeaddrinfo(result);
+    return true;
+}
+
+UdpSocket::~UdpSocket() {
+    close();
+}
+
+UdpSocket::UdpSocket(UdpSocket&& other) noexcept : fd(other.fd) {
+    other.fd = kInvalidHandle;
+}
+
+UdpSocket& UdpSocket::operator=(UdpSocket&& other) noexcept {
+    if (this != &other) {
+        close();
+        fd = other.fd;
+        other.fd = kInvalidHandle;
+    }
+    return *this;
+}
+
+// Creates a non-blocking socket bound to bindAddress:bindPort (0 = any port).
+bool UdpSocket::open(uint16_t bindPort, uint32_t bindAddress) {
+    close();
+#ifdef _WIN32
+    SOCKET s = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (s == INVALID_SOCKET) {
+        return false;
+    }
+    u_long nonBlocking = 1;
+    ioctlsocket(s, FIONBIO, &nonBlocking);
+#else
+    int s = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (s < 0) {
+        return false;
+    }
+    fcntl(s, F_SETFL, fcntl(s, F_GETFL, 0) | O_NONBLOCK);
+#endif
+    fd = static_cast<intptr_t>(s);
+
+    sockaddr_in local;
+    std::memset(&local, 0, sizeof(local));
+    local.sin_family = AF_INET;
+    local.sin_port = htons(bindPort);
+    local.sin_addr.s_addr = htonl(bindAddress);
+    if (bind(s, reinterpret_cast<sockaddr*>(&local), sizeof(local)) != 0) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+// Closes the socket if open.
+void UdpSocket::close() {
+    if (fd != kInvalidHandle) {
+        closeHandle(fd);
+        fd = kInvalidHandle;
+    }
+}
+
+// Returns the bound local port, or 0 if unknown.
+uint16_t UdpSocket::localPort() const {
+    sockaddr_in local;
+    SockLen len = sizeof(local);
+    if (fd == kInvalidHandle || getsockname(fd, reinterpret_cast<sockaddr*>(&local), &len) != 0) {
+        return 0;
+    }
+    return ntohs(local.sin_port);
+}
+
+// Sends one datagram.
+int UdpSocket::sendTo(const UdpEndpoint& to, const void* data, size_t length) {
+    sockaddr_in remote;
+    std::memset(&remote, 0, sizeof(remote));
+    remote.sin_family = AF_INET;
+    remote.sin_port = htons(to.port);
+    remote.sin_addr.s_addr = htonl(to.address);
+    int sent = static_cast<int>(sendto(fd, static_cast<const char*>(data), static_cast<int>(length), 0,
+        reinterpret_cast<sockaddr*>(&remote), sizeof(remote)));
+    return sent < 0 ? -1 : sent;
+}
+
+int UdpSocket::sendv(const UdpEndpoint& to, const UdpBuffer* parts, size_t count) {
+    if (count == 0 || count > kMaxParts) return -1;
+    sockaddr_in remote;
+    std::memset(&remote, 0, sizeof(remote));
+    remote.sin_family = AF_INET;
+    remote.sin_port = htons(to.port);
+    remote.sin_addr.s_addr = htonl(to.address);
+#ifdef _WIN32
+    WSABUF buffers[kMaxParts];
+    for (size_t i = 0; i < count; ++i) {
+        buffers[i].buf = const_cast<char*>(static_cast<const char*>(parts[i].data));
+        buffers[i].len = static_cast<ULONG>(parts[i].length);
+    }
+    DWORD sent = 0;
+    int result = WSASendTo(static_cast<SOCKET>(fd), buffers, static_cast<DWORD>(count), &sent, 0,
+        reinterpret_cast<sockaddr*>(&remote), sizeof(remote), nullptr, nullptr);
+    return result == 0 ? static_cast<int>(sent) : -1;
+#else
+    iovec buffers[kMaxParts];
+    for (size_t i = 0; i < count; ++i) {
+        buffers[i].iov_base = const_cast<void*>(parts[i].data);
+        buffers[i].iov_len = parts[i].length;
+    }
+    msghdr message;
+    std::memset(&message, 0, sizeof(message));
+    message.msg_name = &remote;
+    message.msg_namelen = sizeof(remote);
+    message.msg_iov = buffers;
+    message.msg_iovlen = count;
+    ssize_t sent = sendmsg(static_cast<int>(fd), &message, 0);
+    return sent < 0 ? -1 : static_cast<int>(sent);
+#endif
+}
+
+// Receives one datagram without blocking.
+int UdpSocket::receiveFrom(void* buffer, size_t capacity, UdpEndpoint& from) {
+    sockaddr_in remote;
+    SockLen len = sizeof(remote);
+    int received = static_cast<int>(recvfrom(fd, static_cast<char*>(buffer), static_cast<int>(capacity), 0,
+        reinterpret_cast<sockaddr*>(&remote), &len));
+    if (received < 0) {
+        return wouldBlock() ? 0 : -1;
+    }
+    from.address = ntohl(remote.sin_addr.s_addr);
+    from.port = ntohs(remote.sin_port);
+    return received;
+}
+
+// Registers a socket with the poller.
+void UdpPoller::add(const UdpSocket& socket) {
+    handles.push_back(socket.handle());
+    pollState.resize(handles.size() * sizeof(PollFd));
+    PollFd* fds = reinterpret_cast<PollFd*>(pollState.data());
+    for (size_t i = 0; i < handles.size(); ++i) {
+        fds[i].fd = static_cast<decltype(fds[i].fd)>(handles[i]);
+        fds[i].events = POLLIN;
+        fds[i].revents = 0;
+    }
+}
+
+// Removes all sockets from the poller.
+void UdpPoller::clear() {
+    handles.clear();
+    pollState.clear();
+}
+
+// Waits up to timeoutMs for any registered socket to become readable.
+int UdpPoller::wait(int timeoutMs, std::vector<size_t>& ready) {
+    ready.clear();
+    if (handles.empty()) {
+        return 0;
+    }
+    PollFd* fds = reinterpret_cast<PollFd*>(pollState.data());
+    int result = pollSockets(fds, handles.size(), timeoutMs);
+    if (result <= 0) {
+        return result;
+    }
+    for (size_t i = 0; i < handles.size(); ++i) {
+        if (fds[i].revents & (POLLIN | POLLERR)) {
+            ready.push_back(i);
+        }
+        fds[i].revents = 0;
+    }
+    return static_cast<int>(ready.size());
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// IPv4 endpoint in host byte order.
+struct UdpEndpoint {
+    uint32_t address = 0;
+    uint16_t port = 0;
+
+    bool operator==(const UdpEndpoint& other) const { return address == other.address && port == other.port; }
+};
+
+// One piece of a datagram sent with UdpSocket::sendv.
+struct UdpBuffer {
+    const void* data;
+    size_t length;
+};
+
+// Thin portable wrapper around a non-blocking IPv4 UDP socket (Winsock or BSD sockets).
+class UdpSocket {
+public:
+    static const uint32_t kLoopback = 0x7F000001u;
+
+    UdpSocket() = default;
+    ~UdpSocket();
+    UdpSocket(const UdpSocket&) = delete;
+    UdpSocket& operator=(const UdpSocket&) = delete;
+    UdpSocket(UdpSocket&& other) noexcept;
+    UdpSocket& operator=(UdpSocket&& other) noexcept;
+
+    static bool startup();
+    static void cleanup();
+    static bool resolve(const std::string& host, uint16_t port, UdpEndpoint& out);
+
+    bool open(uint16_t bindPort = 0, uint32_t bindAddress = kLoopback);
+    void close();
+    bool isOpen() const { return fd != kInvalidHandle; }
+    intptr_t handle() const { return fd; }
+    uint16_t localPort() const;
+
+    // Returns bytes sent, or -1 on failure.
+    int sendTo(const UdpEndpoint& to, const void* data, size_t length);
+    // Sends count pieces as one datagram (WSASendTo / sendmsg) without joining them first.
+    // At most kMaxParts pieces; returns bytes sent, or -1 on failure.
+    int sendv(const UdpEndpoint& to, const UdpBuffer* parts, size_t count);
+    static const size_t kMaxParts = 8;
+    // Returns bytes received, 0 if nothing is pending, or -1 on failure.
+    int receiveFrom(void* buffer, size_t capacity, UdpEndpoint& from);
+
+private:
+    static const intptr_t kInvalidHandle = -1;
+    intptr_t fd = kInvalidHandle;
+};
+
+// Waits for readability across many sockets with poll/WSAPoll (no FD_SETSIZE limit).
+class UdpPoller {
+public:
+    void add(const UdpSocket& socket);
+    void clear();
+    size_t size() const { return handles.size(); }
+    // Fills ready with the indexes (in add order) of readable sockets. Returns the count, or -1 on failure.
+    int wait(int timeoutMs, std::vector<size_t>& ready);
+
+private:
+    std::vector<intptr_t> handles;
+    std::vector<unsigned char> pollState; // Platform pollfd array, kept opaque to avoid system headers here
+};
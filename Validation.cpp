@@ -0,0 +1,189 @@
+// --- xRcon\Validation.cpp ---
+// Implementation of the server field validators.
+// Hand-written scanners that match the former regex rules without allocating.
+
+#include "Validation.h"
+
+static bool isDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+static bool isAlnum(char c) {
+    return isDigit(c) || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
+
+static bool isHexDigit(char c) {
+    return isDigit(c) || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+}
+
+static bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+// Trims the whitespace set used throughout ServerManager.
+std::string_view Validation::trim(std::string_view text) {
+    size_t start = 0, end = text.size();
+    while (start < end && isSpace(text[start])) ++start;
+    while (end > start && isSpace(text[end - 1])) --end;
+    return text.substr(start, end - start);
+}
+
+bool Validation::looksLikeIPv4(std::string_view text) {
+    size_t pos = 0;
+    for (int group = 0; group < 4; ++group) {
+        size_t digits = 0;
+        while (pos < text.size() && isDigit(text[pos]) && digits < 4) {
+            ++pos;
+            ++digits;
+        }
+        if (digits == 0 || digits > 3) return false;
+        if (group < 3) {
+            if (pos >= text.size() || text[pos] != '.') return false;
+            ++pos;
+        }
+    }
+    return pos == text.size();
+}
+
+bool Validation::isIPv4(std::string_view text) {
+    if (!looksLikeIPv4(text)) return false;
+    size_t pos = 0;
+    for (int group = 0; group < 4; ++group) {
+        size_t start = pos;
+        int value = 0;
+        while (pos < text.size() && isDigit(text[pos])) {
+            value = value * 10 + (text[pos] - '0');
+            ++pos;
+        }
+        if (pos - start > 1 && text[start] == '0') return false; // Leading zeros are invalid
+        if (value > 255) return false;
+        ++pos; // Skip the dot
+    }
+    return true;
+}
+
+// RFC 4291 text form: up to eight hex groups, one "::" run, optional trailing dotted quad,
+// optional surrounding brackets. Zone ids are not accepted.
+bool Validation::isIPv6(std::string_view text) {
+    if (text.size() >= 2 && text.front() == '[' && text.back() == ']') {
+        text = text.substr(1, text.size() - 2);
+    }
+    if (text.size() < 2 || text.size() > 45) return false;
+
+    int groups = 0;
+    bool compressed = false;
+    size_t pos = 0;
+    if (text[0] == ':') {
+        if (text[1] != ':') return false;
+        compressed = true;
+        pos = 2;
+        if (pos == text.size()) return true; // "::"
+    }
+    while (pos < text.size()) {
+        size_t start = pos;
+        while (pos < text.size() && isHexDigit(text[pos]) && pos - start < 5) ++pos;
+        size_t length = pos - start;
+        if (pos < text.size() && text[pos] == '.') {
+            // Embedded IPv4 in the last 32 bits
+            if (!isIPv4(text.substr(start))) return false;
+            groups += 2;
+            pos = text.size();
+            break;
+        }
+        if (length == 0 || length > 4) return false;
+        ++groups;
+        if (pos == text.size()) break;
+        if (text[pos] != ':') return false;
+        ++pos;
+        if (pos < text.size() && text[pos] == ':') {
+            if (compressed) return false; // Only one "::"
+            compressed = true;
+            ++pos;
+            if (pos == text.size()) break;
+        }
+        else if (pos == text.size()) {
+            return false; // Trailing single ':'
+        }
+    }
+    return compressed ? groups < 8 : groups == 8;
+}
+
+bool Validation::isHostname(std::string_view text) {
+    if (text.empty() || text.size() > 255) return false;
+    int labels = 0;
+    size_t pos = 0;
+    while (true) {
+        if (pos >= text.size() || !isAlnum(text[pos])) return false; // Labels start with a letter or digit
+        ++pos;
+        while (pos < text.size() && (isAlnum(text[pos]) || text[pos] == '-')) ++pos;
+        ++labels;
+        if (pos == text.size()) break;
+        if (text[pos] != '.') return false;
+        ++pos;
+    }
+    return labels >= 2 && text.back() != '-';
+}
+
+bool Validation::isIpOrHostname(std::string_view text) {
+    if (text.empty()) return false;
+    if (looksLikeIPv4(text)) return isIPv4(text);
+    return isHostname(text);
+}
+
+bool Validation::isPort(int port) {
+    return port >= 1 && port <= 65535;
+}
+
+// Same acceptance as the getline loop it replaces, which tolerates one trailing comma.
+bool Validation::isListFormat(std::string_view text) {
+    if (text.empty()) return true;
+    size_t start = 0;
+    while (start < text.size()) {
+        size_t end = text.find(',', start);
+        if (end == std::string_view::npos) end = text.size();
+        size_t colon = text.find(':', start);
+        if (colon >= end || colon == start || colon == end - 1) return false;
+        start = end + 1;
+    }
+    return true;
+}
+
+ValidationError Validation::checkServer(const Server& server) {
+    if (trim(server.name).empty()) return ValidationError::EmptyName;
+    std::string_view host = trim(server.ipOrHostname);
+    if (!isIpOrHostname(host)) {
+        if (looksLikeIPv4(host)) return ValidationError::BadIPv4;
+        if (isIPv6(host)) return ValidationError::IPv6Unsupported;
+        return ValidationError::BadHostname;
+    }
+    if (!isPort(server.port)) return ValidationError::BadPort;
+    if (!isListFormat(trim(server.gametypes))) return ValidationError::BadGametypes;
+    if (!isListFormat(trim(server.maps))) return ValidationError::BadMaps;
+    return ValidationError::None;
+}
+
+size_t Validation::validateAll(const std::vector<Server>& servers, std::vector<ValidationIssue>& issues) {
+    size_t invalid = 0;
+    for (size_t i = 0; i < servers.size(); ++i) {
+        ValidationError error = checkServer(servers[i]);
+        if (error != ValidationError::None) {
+            issues.push_back({ i, error });
+            ++invalid;
+        }
+    }
+    return invalid;
+}
+
+const char* Validation::describe(ValidationError error) {
+    switch (error) {
+    case ValidationError::None: return "OK";
+    case ValidationError::EmptyName: return "Server name cannot be empty or whitespace";
+    case ValidationError::BadIPv4: return "Invalid IP address (use format: 192.168.0.1)";
+    case ValidationError::IPv6Unsupported: return "IPv6 addresses are not supported (use an IPv4 address or hostname)";
+    case ValidationError::BadHostname: return "Invalid hostname (use format: example.com)";
+    case ValidationError::BadPort: return "Invalid port (1-65535)";
+    case ValidationError::BadGametypes: return "Invalid gametypes format (id:humanreadable,...)";
+    case ValidationError::BadMaps: return "Invalid maps format (id:humanreadable,...)";
+    }
+    return "Unknown error";
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include <cstddef>
+#include <string_view>
+#include <vector>
+#include "ServerManager.h"
+
+// Why a server entry failed validation.
+enum class ValidationError {
+    None,
+    EmptyName,
+    BadIPv4,         // Dotted quad with an octet over 255 or a leading zero
+    IPv6Unsupported, // Valid IPv6 literal, but GameServerQuery only speaks IPv4
+    BadHostname,
+    BadPort,
+    BadGametypes,
+    BadMaps
+};
+
+struct ValidationIssue {
+    size_t index;          // Position in the validated list
+    ValidationError error;
+};
+
+// Single-pass, allocation-free field checks. ServerManager's validate* functions forward here,
+// so the rules are the ones the config and the server form have always used.
+class Validation {
+public:
+    static std::string_view trim(std::string_view text);
+
+    // Four dot-separated groups of 1-3 digits. Addresses of this shape are checked as IPv4 only.
+    static bool looksLikeIPv4(std::string_view text);
+    static bool isIPv4(std::string_view text);
+    static bool isIPv6(std::string_view text);
+    // Two or more labels of letters, digits and '-', each starting with a letter or digit, at most 255 characters.
+    static bool isHostname(std::string_view text);
+    static bool isIpOrHostname(std::string_view text);
+    static bool isPort(int port);
+    // Comma-separated id:name pairs with non-empty id and name. Empty lists are valid.
+    static bool isListFormat(std::string_view text);
+
+    // Checks one server (fields trimmed first) and returns the first problem found.
+    static ValidationError checkServer(const Server& server);
+    // Checks every server, appends one issue per invalid entry and returns the number of invalid entries.
+    static size_t validateAll(const std::vector<Server>& servers, std::vector<ValidationIssue>& issues);
+    static const char* describe(ValidationError error);
+};
@@ -10,7 +10,10 @@
 #include "ServerPage.h"
 #include "RconPage.h"
 #include "ServerManager.h"
+#include "TrafficCapture.h"
+#include "DefaultsCatalog.h"
 #include "resource.h"
+#include <string>
 
 static HBRUSH g_hOutput = nullptr;        // Brush for output box background
 static HBRUSH g_hFormBackground = nullptr; // Brush for form background
@@ -56,6 +59,7 @@ void hideAllPageControls(HWND hwnd, bool showingServerPage) {
     ShowWindow(GetDlgItem(hwnd, 521), SW_HIDE);
     ShowWindow(GetDlgItem(hwnd, 522), SW_HIDE);
     ShowWindow(GetDlgItem(hwnd, 523), SW_HIDE);
+    ShowWindow(GetDlgItem(hwnd, 524), SW_HIDE);
 
     // Hide shared output box
     ShowWindow(GetDlgItem(hwnd, 400), SW_HIDE);
@@ -86,6 +90,7 @@ LRESULT CALLBACK WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
         UIServers::createServerPage(hwnd, (HINSTANCE)GetWindowLongPtr(hwnd, GWLP_HINSTANCE));
         UIRcon::createRconPage(hwnd, (HINSTANCE)GetWindowLongPtr(hwnd, GWLP_HINSTANCE));
         UIComponents::createOutputBox(hwnd, (HINSTANCE)GetWindowLongPtr(hwnd, GWLP_HINSTANCE));
+        UIRcon::onJobTimer(hwnd); // Arms the scheduled jobs timer
 
         // Fallback: Set icons in WM_CREATE
         HICON hIcon = LoadIcon((HINSTANCE)GetWindowLongPtr(hwnd, GWLP_HINSTANCE), MAKEINTRESOURCE(IDI_ICON1));
@@ -188,14 +193,41 @@ LRESULT CALLBACK WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
     }
 
     case WM_TIMER: {
+        // Scheduled jobs run whichever page is shown
+        if (wParam == JOB_TIMER_ID) {
+            UIRcon::onJobTimer(hwnd);
+        }
         // Handle timers for RCON page
-        if (!isServerPage) {
+        else if (!isServerPage) {
             RconPage::handleRconPage(hwnd, msg, wParam, lParam);
         }
         break;
     }
 
+    case WM_RCON_REFRESHED: {
+        // Refresh replies from the query worker; handled on any page so the result is always freed
+        UIRcon::onRefreshResult(hwnd, lParam);
+        break;
+    }
+
+    case WM_RCON_BATCHDONE: {
+        // Batch results from the query worker, also handled on any page
+        UIRcon::onBatchResult(hwnd, lParam);
+        break;
+    }
+
+    case WM_RCON_SESSIONJOB: {
+        // Session log seals and merges from the query worker, also handled on any page
+        UIRcon::onSessionJobDone(hwnd, lParam);
+        break;
+    }
+
     case WM_DESTROY: {
+        UIRcon::shutdown(); // No query, batch or session job runs past this point
+        TrafficCapture::stop(); // Flush any capture in progress
+        UIRcon::saveSnapshots(); // Last known server state for the next launch
+        UIRcon::closeSessionLog(); // Ends the sessions of everyone still online
+
         // Clean up brushes
         if (g_hOutput) {
             DeleteObject(g_hOutput);
@@ -217,6 +249,31 @@ LRESULT CALLBACK WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
 
 // Application entry point.
 int WINAPI WinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance, _In_ LPSTR lpCmdLine, _In_ int nCmdShow) {
+    // Optional traffic capture: xRcon.exe --capture <file>
+    std::string cmdLine = lpCmdLine ? lpCmdLine : "";
+    size_t captureArg = cmdLine.find("--capture ");
+    if (captureArg != std::string::npos) {
+        std::string capturePath = cmdLine.substr(captureArg + 10);
+        capturePath.erase(0, capturePath.find_first_not_of(" \""));
+        capturePath.erase(capturePath.find_last_not_of(" \"") + 1);
+        if (!TrafficCapture::start(capturePath)) {
+            ServerManager::logDebug("Failed to start traffic capture: " + capturePath);
+        }
+    }
+
+    // Parse the default map and gametype lists once up front; later lookups only stat the files
+    DefaultsCatalog::maps().current();
+    DefaultsCatalog::gametypes().current();
+
+    // Last known server state, so the RCON page has something to show before any query returns
+    UIRcon::loadSnapshots();
+    UIRcon::openSessionLog();
+    UIRcon::loadBans();
+    UIRcon::loadRules();
+    UIRcon::loadBaselines();
+    UIRcon::loadLogs();
+    UIRcon::loadJobs();
+
     // Register window class using WNDCLASSEX
     WNDCLASSEX wc = { 0 };
     wc.cbSize = sizeof(WNDCLASSEX);
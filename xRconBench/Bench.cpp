@@ -0,0 +1,212 @@
+// --- xRconBench\Bench.cpp ---
+// Implementation of the benchmark runner.
+// Calibrates batch sizes, collects per-operation timings and heap counts, and prints text or JSON lines.
+
+#include "Bench.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <new>
+
+AllocationCounters& allocationCounters() {
+    static AllocationCounters counters;
+    return counters;
+}
+
+AllocationExclusion::AllocationExclusion() {
+    AllocationCounters& counters = allocationCounters();
+    startCount = counters.count.load(std::memory_order_relaxed);
+    startBytes = counters.bytes.load(std::memory_order_relaxed);
+}
+
+AllocationExclusion::~AllocationExclusion() {
+    AllocationCounters& counters = allocationCounters();
+    counters.excludedCount.fetch_add(counters.count.load(std::memory_order_relaxed) - startCount, std::memory_order_relaxed);
+    counters.excludedBytes.fetch_add(counters.bytes.load(std::memory_order_relaxed) - startBytes, std::memory_order_relaxed);
+}
+
+// Counting replacements for the global allocation functions. The bench binary is the only user.
+void* operator new(std::size_t size) {
+    AllocationCounters& counters = allocationCounters();
+    counters.count.fetch_add(1, std::memory_order_relaxed);
+    counters.bytes.fetch_add(size, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+typedef std::chrono::steady_clock BenchClock;
+
+static double elapsedNs(BenchClock::time_point start, BenchClock::time_point end) {
+    return std::chrono::duration<double, std::nano>(end - start).count();
+}
+
+// Returns the value at fraction q of sorted samples (nearest rank).
+static double percentile(const std::vector<double>& sorted, double q) {
+    if (sorted.empty()) return 0.0;
+    size_t rank = static_cast<size_t>(q * static_cast<double>(sorted.size() - 1) + 0.5);
+    return sorted[std::min(rank, sorted.size() - 1)];
+}
+
+// Writes s as a JSON string literal.
+static void writeJsonString(FILE* out, const std::string& s) {
+    std::fputc('"', out);
+    for (char c : s) {
+        if (c == '"' || c == '\\') std::fputc('\\', out);
+        if (static_cast<unsigned char>(c) < 0x20) continue;
+        std::fputc(c, out);
+    }
+    std::fputc('"', out);
+}
+
+BenchRunner::BenchRunner(const BenchOptions& value) : options(value) {
+    if (!options.outPath.empty()) {
+#ifdef _WIN32
+        if (fopen_s(&outFile, options.outPath.c_str(), "a") != 0) outFile = nullptr;
+#else
+        outFile = std::fopen(options.outPath.c_str(), "a");
+#endif
+        if (!outFile) {
+            std::fprintf(stderr, "Cannot open %s for writing\n", options.outPath.c_str());
+        }
+    }
+}
+
+BenchRunner::~BenchRunner() {
+    if (outFile) std::fclose(outFile);
+}
+
+// Returns true if name/param passes the --filter substring.
+bool BenchRunner::wants(const std::string& name, const std::string& param) const {
+    if (options.filter.empty()) return true;
+    std::string full = param.empty() ? name : name + "/" + param;
+    return full.find(options.filter) != std::string::npos;
+}
+
+// Warms up, picks a batch size of at least ~20 us, then samples until minTimeMs has elapsed.
+void BenchRunner::run(const std::string& name, const std::string& param, double itemsPerOp, const Operation& op) {
+    if (!wants(name, param)) {
+        return;
+    }
+
+    // Warm-up doubles as calibration
+    uint64_t warmOps = 0;
+    auto warmStart = BenchClock::now();
+    double warmNs = 0.0;
+    do {
+        op();
+        ++warmOps;
+        warmNs = elapsedNs(warmStart, BenchClock::now());
+    } while (warmNs < options.warmupMs * 1e6);
+    double estimateNs = warmNs / static_cast<double>(warmOps);
+    uint64_t batch = estimateNs >= 20000.0 ? 1 : static_cast<uint64_t>(20000.0 / std::max(estimateNs, 1.0)) + 1;
+
+    std::vector<double> samples;
+    samples.reserve(4096);
+    AllocationCounters& counters = allocationCounters();
+    uint64_t allocsBefore = counters.count.load(std::memory_order_relaxed) - counters.excludedCount.load(std::memory_order_relaxed);
+    uint64_t bytesBefore = counters.bytes.load(std::memory_order_relaxed) - counters.excludedBytes.load(std::memory_order_relaxed);
+    uint64_t operations = 0;
+    double totalNs = 0.0;
+    auto started = BenchClock::now();
+    do {
+        auto sampleStart = BenchClock::now();
+        for (uint64_t i = 0; i < batch; ++i) {
+            op();
+        }
+        auto sampleEnd = BenchClock::now();
+        double ns = elapsedNs(sampleStart, sampleEnd);
+        samples.push_back(ns / static_cast<double>(batch));
+        totalNs += ns;
+        operations += batch;
+        if (elapsedNs(started, sampleEnd) >= options.minTimeMs * 1e6) break;
+    } while (true);
+    // Growth of samples past the reserve is counted too; that is one allocation per doubling, negligible per op.
+    uint64_t allocs = counters.count.load(std::memory_order_relaxed) - counters.excludedCount.load(std::memory_order_relaxed) - allocsBefore;
+    uint64_t bytes = counters.bytes.load(std::memory_order_relaxed) - counters.excludedBytes.load(std::memory_order_relaxed) - bytesBefore;
+
+    std::sort(samples.begin(), samples.end());
+    BenchResult result;
+    result.name = name;
+    result.param = param;
+    result.operations = operations;
+    result.itemsPerOp = itemsPerOp;
+    result.meanNs = totalNs / static_cast<double>(operations);
+    result.opsPerSec = result.meanNs > 0.0 ? 1e9 / result.meanNs : 0.0;
+    result.itemsPerSec = result.opsPerSec * itemsPerOp;
+    result.allocsPerOp = static_cast<double>(allocs) / static_cast<double>(operations);
+    result.bytesPerOp = static_cast<double>(bytes) / static_cast<double>(operations);
+    result.p50Ns = percentile(samples, 0.50);
+    result.p90Ns = percentile(samples, 0.90);
+    result.p99Ns = percentile(samples, 0.99);
+    result.maxNs = samples.back();
+    report(result);
+}
+
+// Notes a case that could not run (for example, no free UDP ports).
+void BenchRunner::skip(const std::string& name, const std::string& param, const std::string& reason) {
+    if (!wants(name, param)) {
+        return;
+    }
+    std::fprintf(stderr, "skipped %s/%s: %s\n", name.c_str(), param.c_str(), reason.c_str());
+}
+
+// Prints one result as a table row or JSON line.
+void BenchRunner::report(const BenchResult& result) {
+    all.push_back(result);
+    if (outFile) {
+        writeJson(outFile, result);
+        std::fflush(outFile);
+    }
+    if (options.json) {
+        writeJson(stdout, result);
+        std::fflush(stdout);
+        return;
+    }
+    if (!headerPrinted) {
+        std::printf("%-34s %12s %12s %10s %10s %10s %10s %10s\n",
+            "benchmark", "ops/s", "items/s", "allocs/op", "p50 ns", "p90 ns", "p99 ns", "max ns");
+        headerPrinted = true;
+    }
+    std::string full = result.param.empty() ? result.name : result.name + "/" + result.param;
+    std::printf("%-34s %12.0f %12.0f %10.2f %10.0f %10.0f %10.0f %10.0f\n",
+        full.c_str(), result.opsPerSec, result.itemsPerSec, result.allocsPerOp,
+        result.p50Ns, result.p90Ns, result.p99Ns, result.maxNs);
+    std::fflush(stdout);
+}
+
+// Writes one result as a single-line JSON object (schema 1).
+void BenchRunner::writeJson(FILE* out, const BenchResult& result) const {
+    std::fputs("{\"schema\":1,\"label\":", out);
+    writeJsonString(out, options.label);
+    std::fputs(",\"name\":", out);
+    writeJsonString(out, result.name);
+    std::fputs(",\"param\":", out);
+    writeJsonString(out, result.param);
+    std::fprintf(out, ",\"operations\":%llu,\"ops_per_sec\":%.3f,\"items_per_op\":%.3f,\"items_per_sec\":%.3f,"
+        "\"allocs_per_op\":%.3f,\"bytes_per_op\":%.1f,\"mean_ns\":%.1f,\"p50_ns\":%.1f,\"p90_ns\":%.1f,"
+        "\"p99_ns\":%.1f,\"max_ns\":%.1f}\n",
+        static_cast<unsigned long long>(result.operations), result.opsPerSec, result.itemsPerOp, result.itemsPerSec,
+        result.allocsPerOp, result.bytesPerOp, result.meanNs, result.p50Ns, result.p90Ns, result.p99Ns, result.maxNs);
+}
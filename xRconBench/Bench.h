@@ -0,0 +1,84 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Heap activity counted by the replacement operator new in Bench.cpp.
+struct AllocationCounters {
+    std::atomic<uint64_t> count{ 0 };
+    std::atomic<uint64_t> bytes{ 0 };
+    std::atomic<uint64_t> excludedCount{ 0 }; // Made inside an AllocationExclusion scope
+    std::atomic<uint64_t> excludedBytes{ 0 };
+};
+
+AllocationCounters& allocationCounters();
+
+// Leaves allocations made during its lifetime out of allocs/op, e.g. the in-process simulated servers.
+class AllocationExclusion {
+public:
+    AllocationExclusion();
+    ~AllocationExclusion();
+
+private:
+    uint64_t startCount;
+    uint64_t startBytes;
+};
+
+// Result of one benchmark case. Latencies are per operation in nanoseconds.
+struct BenchResult {
+    std::string name;
+    std::string param;
+    uint64_t operations = 0;
+    double itemsPerOp = 1.0;     // Work units per operation (servers, players, ...) for items/s
+    double opsPerSec = 0.0;
+    double itemsPerSec = 0.0;
+    double allocsPerOp = 0.0;
+    double bytesPerOp = 0.0;
+    double meanNs = 0.0;
+    double p50Ns = 0.0;
+    double p90Ns = 0.0;
+    double p99Ns = 0.0;
+    double maxNs = 0.0;
+};
+
+struct BenchOptions {
+    double minTimeMs = 500.0;    // Measuring time per case after warm-up
+    double warmupMs = 50.0;
+    std::string filter;          // Substring match on "name/param"
+    std::string label;           // Release or build label copied into every JSON line
+    bool json = false;           // JSON lines on stdout instead of the text table
+    std::string outPath;         // Also append JSON lines to this file
+};
+
+// Times benchmark cases and reports throughput, allocations per operation and latency percentiles.
+// Cheap operations are timed in batches so timer overhead stays below a few percent; the
+// percentiles are then over per-operation batch averages.
+class BenchRunner {
+public:
+    typedef std::function<void()> Operation;
+
+    explicit BenchRunner(const BenchOptions& options);
+    ~BenchRunner();
+
+    bool wants(const std::string& name, const std::string& param) const;
+    // Runs op repeatedly and reports it. itemsPerOp scales the items/s column.
+    void run(const std::string& name, const std::string& param, double itemsPerOp, const Operation& op);
+    void skip(const std::string& name, const std::string& param, const std::string& reason);
+
+    const std::vector<BenchResult>& results() const { return all; }
+
+private:
+    void report(const BenchResult& result);
+    void writeJson(FILE* out, const BenchResult& result) const;
+
+    BenchOptions options;
+    std::vector<BenchResult> all;
+    FILE* outFile = nullptr;
+    bool headerPrinted = false;
+};
+
+// Registers every case in BenchCases.cpp with the runner.
+void runAllBenchmarks(BenchRunner& runner, uint16_t basePort);
@@ -0,0 +1,1568 @@
+// --- xRconBench\BenchCases.cpp ---
+// Benchmark cases for config loading, validation, status parsing, player diffs, text conversion, the
+// console buffer, the refresh scheduler, query worker and prefetch, snapshots, player actions, the
+// player index and session log, ban lists, rules, jobs, cvar drift and game logs, plus rcon packets,
+// batches and a full refresh cycle against GameServerSim. Equivalence cases check fast paths against
+// their references.
+
+#include "Bench.h"
+#include "StandInQuery.h"
+#include "BanList.h"
+#include "ServerManager.h"
+#include "ConsoleBuffer.h"
+#include "CvarStore.h"
+#include "DefaultsCatalog.h"
+#include "JobScheduler.h"
+#include "ListCatalog.h"
+#include "LogTailer.h"
+#include "Prefetcher.h"
+#include "PlayerActions.h"
+#include "PlayerIndex.h"
+#include "QueryWorker.h"
+#include "Validation.h"
+#include "StatusParser.h"
+#include "TextCodec.h"
+#include "RconPacket.h"
+#include "RconBatch.h"
+#include "SnapshotStore.h"
+#include "RefreshScheduler.h"
+#include "RuleEngine.h"
+#include "SessionLog.h"
+#include "UdpSocket.h"
+#include "GameServerSim/SimServer.h"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+static const char* kMohMaps =
+    "dm/mohdm1:Southern France,dm/mohdm2:Destroyed Village,dm/mohdm3:Remagen,dm/mohdm4:The Crossroads,"
+    "dm/mohdm5:Snowy Park,dm/mohdm6:Stalingrad,dm/mohdm7:Algiers,obj/obj_team1:The Hunt,"
+    "obj/obj_team2:V2 Rocket Facility,obj/obj_team3:Omaha Beach,obj/obj_team4:The Bridge";
+static const char* kMohGametypes = "1:Free-For-All,2:Team-Match,3:Round-Based,4:Objective-Match";
+static const char* kCodGametypes = "dm:Deathmatch,tdm:Team Deathmatch,sd:Search and Destroy,re:Retrieval,bel:Behind Enemy Lines,hq:Headquarters";
+
+static volatile size_t benchSink = 0; // Results are folded in here so the optimizer keeps the work
+
+// Equivalence cases check a fast path against its reference on generated inputs while they are timed,
+// so every bench run guards them too. A mismatch prints the input and stops the run.
+static void failMismatch(const char* what, std::string_view input) {
+    std::fprintf(stderr, "%s mismatch on %zu bytes:", what, input.size());
+    for (unsigned char c : input) std::fprintf(stderr, " %02x", c);
+    std::fprintf(stderr, "\n");
+    std::abort();
+}
+
+// Builds a realistic servers.ini body with count servers, alternating IPs and hostnames.
+static std::string makeServersIni(size_t count) {
+    std::vector<std::pair<std::string, int>> games = ServerManager::getGameOptions();
+    std::string ini;
+    for (size_t i = 0; i < count; ++i) {
+        const auto& game = games[i % games.size()];
+        ini += "[Server " + std::to_string(i) + "]\n";
+        if (i % 2 == 0) ini += "ip=10." + std::to_string((i >> 8) & 255) + "." + std::to_string(i & 255) + ".7\n";
+        else ini += "ip=game" + std::to_string(i) + ".example.net\n";
+        ini += "port=" + std::to_string(12203 + i % 1000) + "\n";
+        ini += "game=" + game.first + "\n";
+        ini += "protocol=" + std::to_string(game.second) + "\n";
+        ini += "rconPassword=secret" + std::to_string(i) + "\n";
+        ini += std::string("gametypes=") + (game.second == 1 ? kMohGametypes : kCodGametypes) + "\n";
+        ini += std::string("maps=") + kMohMaps + "\n\n";
+    }
+    return ini;
+}
+
+// ServerManager reads servers.ini from the working directory, so each size gets its own scratch directory.
+static void benchConfigLoad(BenchRunner& runner) {
+    namespace fs = std::filesystem;
+    const size_t sizes[] = { 10, 100, 1000, 10000 };
+    std::error_code ec;
+    fs::path previous = fs::current_path(ec);
+    fs::path scratch = fs::temp_directory_path(ec) / "xRconBench-scratch";
+    for (size_t count : sizes) {
+        std::string param = std::to_string(count);
+        if (!runner.wants("loadServers", param)) continue;
+        fs::create_directories(scratch, ec);
+        {
+            std::ofstream ini((scratch / "servers.ini").string(), std::ios::binary);
+            ini << makeServersIni(count);
+        }
+        fs::current_path(scratch, ec);
+        if (ec) {
+            runner.skip("loadServers", param, "cannot enter " + scratch.string());
+            continue;
+        }
+        runner.run("loadServers", param, static_cast<double>(count), [] {
+            std::vector<Server> servers = ServerManager::loadServers();
+            benchSink = benchSink + servers.size();
+        });
+        fs::current_path(previous, ec);
+    }
+    fs::remove_all(scratch, ec);
+}
+
+// A default_maps.ini with 200 games of 2000 maps each (custom map packs), looked up as the server form does.
+static void benchDefaults(BenchRunner& runner) {
+    namespace fs = std::filesystem;
+    if (!runner.wants("defaultMaps", "lookup") && !runner.wants("defaultMaps", "reload")) return;
+    std::error_code ec;
+    fs::path path = fs::temp_directory_path(ec) / "xRconBench-default_maps.ini";
+    {
+        std::ofstream ini(path.string(), std::ios::binary);
+        for (int game = 0; game < 200; ++game) {
+            ini << "[Game " << game << "]\nmaps=";
+            for (int map = 0; map < 2000; ++map) {
+                ini << (map ? "," : "") << "custom/pack" << game << "_map" << map << ":Pack " << game << " Map " << map;
+            }
+            ini << "\n";
+        }
+    }
+    DefaultsCatalog catalog(path.string(), "maps");
+    runner.run("defaultMaps", "lookup", 1.0, [&catalog] {
+        std::string maps(catalog.current()->find("Game 150"));
+        benchSink = benchSink + maps.size();
+    });
+    runner.run("defaultMaps", "reload", 1.0, [&path] {
+        DefaultsCatalog fresh(path.string(), "maps");
+        benchSink = benchSink + fresh.current()->games.size();
+    });
+    fs::remove(path, ec);
+}
+
+static void benchListsAndValidation(BenchRunner& runner) {
+    const std::string maps = kMohMaps;
+    runner.run("parseList", "maps11", 11.0, [&maps] {
+        std::map<std::string, std::string> parsed = ServerManager::parseList(maps);
+        benchSink = benchSink + parsed.size();
+    });
+    const std::string gametypes = kCodGametypes;
+    runner.run("parseList", "gametypes6", 6.0, [&gametypes] {
+        std::map<std::string, std::string> parsed = ServerManager::parseList(gametypes);
+        benchSink = benchSink + parsed.size();
+    });
+
+    // What a selector position or live mapname costs: a fresh parse plus walk, against the interned catalog
+    runner.run("listLookup", "parseList+advance", 1.0, [&maps] {
+        std::map<std::string, std::string> parsed = ServerManager::parseList(maps);
+        auto it = parsed.begin();
+        std::advance(it, 9);
+        benchSink = benchSink + it->first.size();
+    });
+    runner.run("listLookup", "catalog", 1.0, [&maps] {
+        const ListCatalog& catalog = ListCatalog::get(maps);
+        benchSink = benchSink + catalog.at(9)->id.size() + static_cast<size_t>(catalog.indexOfId("dm/mohdm6"));
+    });
+    runner.run("listLookup", "catalogBuild", 11.0, [&maps] {
+        ListCatalog catalog(maps);
+        benchSink = benchSink + catalog.size();
+    });
+
+    Server byIp;
+    byIp.name = "Bench";
+    byIp.ipOrHostname = "192.168.100.254";
+    byIp.port = 12203;
+    byIp.game = "Medal of Honor: Allied Assault";
+    byIp.protocolId = 1;
+    byIp.gametypes = kMohGametypes;
+    byIp.maps = kMohMaps;
+    Server byHost = byIp;
+    byHost.ipOrHostname = "moh.frag-central.example.net";
+    runner.run("validateServer", "ip", 1.0, [&byIp] {
+        bool ok = ServerManager::validateServer(byIp);
+        benchSink = benchSink + (ok ? 1 : 0);
+    });
+    runner.run("validateServer", "hostname", 1.0, [&byHost] {
+        bool ok = ServerManager::validateServer(byHost);
+        benchSink = benchSink + (ok ? 1 : 0);
+    });
+    Server longHost = byIp;
+    longHost.ipOrHostname = std::string(120, 'a') + "." + std::string(120, 'b') + "-";
+    runner.run("validateServer", "rejectLongHost", 1.0, [&longHost] {
+        bool ok = ServerManager::validateServer(longHost);
+        benchSink = benchSink + (ok ? 1 : 0);
+    });
+
+    if (runner.wants("validateAll", "10000")) {
+        std::vector<Server> servers(10000, byIp);
+        for (size_t i = 0; i < servers.size(); i += 2) servers[i].ipOrHostname = byHost.ipOrHostname;
+        for (size_t i = 0; i < servers.size(); i += 97) servers[i].port = 0;
+        std::vector<ValidationIssue> issues;
+        issues.reserve(servers.size());
+        runner.run("validateAll", "10000", static_cast<double>(servers.size()), [&servers, &issues] {
+            issues.clear();
+            size_t invalid = Validation::validateAll(servers, issues);
+            benchSink = benchSink + invalid;
+        });
+    }
+}
+
+// The std::regex and getline rules Validation replaced, kept as the reference for the differential case.
+static bool referenceIpOrHostname(const std::string& input) {
+    if (input.empty()) return false;
+    static const std::regex ipRegex(R"(^(\d{1,3})\.(\d{1,3})\.(\d{1,3})\.(\d{1,3})$)");
+    std::smatch match;
+    if (std::regex_match(input, match, ipRegex)) {
+        for (size_t i = 1; i <= 4; ++i) {
+            std::string segment = match[i].str();
+            if ((segment.size() > 1 && segment[0] == '0') || std::stoi(segment) > 255) return false;
+        }
+        return true;
+    }
+    if (input.size() > 255) return false;
+    static const std::regex hostnameRegex(R"(^[a-zA-Z0-9][a-zA-Z0-9-]*(\.[a-zA-Z0-9][a-zA-Z0-9-]*)+$)");
+    if (!std::regex_match(input, hostnameRegex)) return false;
+    return input.find("..") == std::string::npos && input[0] != '-' && input[input.size() - 1] != '-';
+}
+
+static bool referenceListFormat(const std::string& input) {
+    if (input.empty()) return true;
+    std::stringstream ss(input);
+    std::string pair;
+    while (std::getline(ss, pair, ',')) {
+        size_t pos = pair.find(':');
+        if (pos == std::string::npos || pos == 0 || pos == pair.size() - 1) return false;
+    }
+    return true;
+}
+
+// Validation against the reference on generated near-valid addresses, hostnames, IPv6 literals and
+// id:name lists. Items are inputs checked.
+static void benchValidationDifferential(BenchRunner& runner) {
+    if (!runner.wants("validation", "differential")) {
+        return;
+    }
+    uint32_t seed = 31;
+    auto next = [&seed](uint32_t range) { seed = seed * 1664525u + 1013904223u; return (seed >> 8) % range; };
+    std::string host, list;
+    auto addHostPiece = [&] {
+        static const char kPieces[] = "abcxyzAZ0123456789-.._: ";
+        switch (next(6)) {
+        case 0: host += std::to_string(next(1000)); break;
+        case 1: host += '0'; break;
+        case 2: host += "example"; break;
+        case 3: host += std::string(next(2) ? 63 : 130, 'h'); break;
+        default: host += kPieces[next(sizeof(kPieces) - 1)]; break;
+        }
+    };
+    auto addListPiece = [&] {
+        static const char* const kPieces[] = { "dm", "1", "Team-Match", ":", ":", ",", ",", " " };
+        list += kPieces[next(sizeof(kPieces) / sizeof(kPieces[0]))];
+    };
+    const size_t perOp = 64;
+    runner.run("validation", "differential", static_cast<double>(perOp), [&] {
+        for (size_t i = 0; i < perOp; ++i) {
+            host.clear();
+            switch (next(3)) {
+            case 0: // Dotted quads with stray, missing or extra groups
+                for (uint32_t group = 0, groups = 3 + next(3); group < groups; ++group) {
+                    if (group) host += '.';
+                    host += next(8) ? std::to_string(next(next(2) ? 256 : 1000)) : std::string(next(2) ? "0" : "");
+                    if (!next(10)) addHostPiece();
+                }
+                break;
+            case 1: // IPv6 literals
+                for (uint32_t group = 0, groups = 2 + next(8); group < groups; ++group) {
+                    host += next(4) ? ":" : "::";
+                    host += "fe80"[next(4)];
+                }
+                break;
+            default:
+                for (uint32_t piece = 0, pieces = 1 + next(8); piece < pieces; ++piece) addHostPiece();
+                break;
+            }
+            if (Validation::isIpOrHostname(host) != referenceIpOrHostname(host)) failMismatch("isIpOrHostname", host);
+
+            list.clear();
+            for (uint32_t piece = 0, pieces = next(10); piece < pieces; ++piece) addListPiece();
+            if (Validation::isListFormat(list) != referenceListFormat(list)) failMismatch("isListFormat", list);
+        }
+        benchSink = benchSink + host.size() + list.size();
+    });
+}
+
+// Produces DLL-shaped getstatus and rcon status JSON from a simulated server holding players players.
+static void makeStatusJson(int protocolId, int players, std::string& statusJson, std::string& playersJson) {
+    SimConfig config;
+    config.protocolId = protocolId;
+    config.minPlayers = players;
+    config.maxPlayers = players;
+    config.maxClients = players > 32 ? players : 32;
+    SimServer server(config, 7, 12203);
+    std::string reply;
+    size_t body = 0;
+    const std::string prefix = protocolId == 1 ? std::string("\xff\xff\xff\xff\x02", 5) : std::string("\xff\xff\xff\xff", 4);
+    std::string request = prefix + "getstatus";
+    server.handle(request.data(), request.size(), 0, reply);
+    StandInQuery::classify(reply.data(), reply.size(), body);
+    StandInQuery::statusToJson(reply.data() + body, reply.size() - body, statusJson);
+    request = prefix + "rcon " + config.rconPassword + " status";
+    server.handle(request.data(), request.size(), 0, reply);
+    StandInQuery::classify(reply.data(), reply.size(), body);
+    StandInQuery::rconStatusToJson(reply.data() + body, reply.size() - body, protocolId, playersJson);
+}
+
+// The copying parser the arena path replaced, kept as the baseline for the parse and diff cases.
+// One row of the player table as reported by "rcon status".
+struct PlayerInfo {
+    std::string slot;
+    std::string name;
+    std::string address;
+    std::string score;
+    std::string ping;
+};
+
+// Server settings reported by "getstatus".
+struct ServerStatus {
+    std::string hostname;
+    std::string mapname;
+    std::string gametype;
+    std::string maxclients;
+    size_t playerCount = 0;
+};
+
+// Extracts a top-level "field": value pair from a JSON reply.
+static std::string copyingExtractField(const std::string& json, const std::string& field) {
+    size_t pos = json.find("\"" + field + "\":");
+    if (pos == std::string::npos) return std::string();
+    pos += field.length() + 3;
+    if (pos >= json.size()) return std::string();
+    if (json[pos] == '"') {
+        pos++;
+        size_t end = json.find('"', pos);
+        return json.substr(pos, end - pos);
+    }
+    else {
+        size_t end = json.find_first_of(",}", pos);
+        return json.substr(pos, end - pos);
+    }
+}
+
+// Extracts hostname, map, gametype, max clients and player count from a getstatus reply.
+static void copyingParseServerStatus(const std::string& json, bool gametypeIsString, ServerStatus& status) {
+    status.hostname = copyingExtractField(json, "sv_hostname");
+    status.mapname = copyingExtractField(json, "mapname");
+    status.gametype = copyingExtractField(json, gametypeIsString ? "g_gametypestring" : "g_gametype");
+    status.maxclients = copyingExtractField(json, "sv_maxclients");
+    status.playerCount = 0;
+    size_t playersPos = json.find("\"players\":");
+    if (playersPos != std::string::npos) {
+        for (size_t i = playersPos + 10; i < json.length(); ++i) {
+            if (json[i] == '{') ++status.playerCount; // Count player objects
+        }
+    }
+}
+
+// Splits the players array of an rcon status reply into rows. Returns false with error set on malformed input.
+static bool copyingParsePlayers(const std::string& response, std::vector<PlayerInfo>& players, std::string& error) {
+    players.clear();
+
+    // Parse players array
+    size_t playersPos = response.find("\"players\":");
+    if (playersPos == std::string::npos) {
+        error = "Invalid response format";
+        return false;
+    }
+    std::string json = response.substr(playersPos + 10);
+
+    // Find the end of the players array, accounting for quoted strings
+    size_t arrayEnd = std::string::npos;
+    bool inQuotes = false;
+    for (size_t i = 0; i < json.length(); ++i) {
+        if (json[i] == '"' && (i == 0 || json[i - 1] != '\\')) {
+            inQuotes = !inQuotes; // Toggle quote state
+        }
+        else if (json[i] == ']' && !inQuotes) {
+            arrayEnd = i;
+            break;
+        }
+    }
+    if (arrayEnd == std::string::npos) {
+        error = "Invalid response format: Could not find array end";
+        return false;
+    }
+    json = json.substr(0, arrayEnd);
+
+    if (json.empty() || json == "[]") {
+        return true; // No players
+    }
+
+    // Process each player
+    size_t start = 0;
+    if (json[0] == '[') start = 1; // Skip opening bracket
+    while (start < json.length()) {
+        size_t objStart = json.find('{', start);
+        if (objStart == std::string::npos) break;
+
+        // Find the end of the current player object
+        size_t objEnd = std::string::npos;
+        int braceCount = 1;
+        inQuotes = false;
+        for (size_t i = objStart + 1; i < json.length(); ++i) {
+            if (json[i] == '"' && json[i - 1] != '\\') {
+                inQuotes = !inQuotes;
+            }
+            else if (!inQuotes) {
+                if (json[i] == '{') ++braceCount;
+                else if (json[i] == '}') {
+                    --braceCount;
+                    if (braceCount == 0) {
+                        objEnd = i;
+                        break;
+                    }
+                }
+            }
+        }
+        if (objEnd == std::string::npos) {
+            error = "Invalid response format: Malformed player object";
+            return false;
+        }
+
+        std::string playerJson = json.substr(objStart, objEnd - objStart + 1);
+        PlayerInfo player;
+        player.slot = copyingExtractField(playerJson, "slot");
+        player.name = copyingExtractField(playerJson, "name");
+        player.address = copyingExtractField(playerJson, "address");
+        player.score = copyingExtractField(playerJson, "score");
+        player.ping = copyingExtractField(playerJson, "ping");
+        if (!player.slot.empty() && !player.name.empty()) {
+            players.push_back(std::move(player)); // Skip invalid player data
+        }
+        start = objEnd + 1;
+
+        // Skip comma or whitespace
+        while (start < json.length() && (json[start] == ',' || isspace(static_cast<unsigned char>(json[start])))) ++start;
+    }
+    return true;
+}
+
+// Compares two player tables by slot and name.
+static void copyingDiffPlayers(const std::vector<PlayerInfo>& previous, const std::vector<PlayerInfo>& current, PlayerDiff& diff) {
+    diff.joined.clear();
+    diff.left.clear();
+    diff.changed.clear();
+    auto sortBySlot = [](const std::vector<PlayerInfo>& players, std::vector<size_t>& order) {
+        order.resize(players.size());
+        for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+        std::sort(order.begin(), order.end(), [&players](size_t a, size_t b) {
+            int bySlot = players[a].slot.compare(players[b].slot);
+            return bySlot != 0 ? bySlot < 0 : players[a].name < players[b].name;
+        });
+    };
+    sortBySlot(previous, diff.previousOrder);
+    sortBySlot(current, diff.currentOrder);
+
+    size_t p = 0, c = 0;
+    while (p < diff.previousOrder.size() && c < diff.currentOrder.size()) {
+        const PlayerInfo& before = previous[diff.previousOrder[p]];
+        const PlayerInfo& after = current[diff.currentOrder[c]];
+        int order = before.slot.compare(after.slot);
+        if (order == 0) order = before.name.compare(after.name);
+        if (order < 0) {
+            diff.left.push_back(diff.previousOrder[p++]);
+        }
+        else if (order > 0) {
+            diff.joined.push_back(diff.currentOrder[c++]);
+        }
+        else {
+            if (before.score != after.score || before.ping != after.ping || before.address != after.address) {
+                diff.changed.push_back(diff.currentOrder[c]);
+            }
+            ++p;
+            ++c;
+        }
+    }
+    while (p < diff.previousOrder.size()) diff.left.push_back(diff.previousOrder[p++]);
+    while (c < diff.currentOrder.size()) diff.joined.push_back(diff.currentOrder[c++]);
+}
+
+static void benchParsers(BenchRunner& runner) {
+    const int counts[] = { 0, 16, 64 };
+    for (int protocolId = 1; protocolId <= 2; ++protocolId) {
+        for (int players : counts) {
+            std::string statusJson, playersJson;
+            makeStatusJson(protocolId, players, statusJson, playersJson);
+            std::string param = (protocolId == 1 ? "moh/" : "cod/") + std::to_string(players);
+
+            ServerStatus status;
+            runner.run("parseServerStatus", param, 1.0, [&] {
+                copyingParseServerStatus(statusJson, protocolId == 1, status);
+            });
+            std::vector<PlayerInfo> rows;
+            std::string error;
+            runner.run("parsePlayers", param, players > 0 ? static_cast<double>(players) : 1.0, [&] {
+                copyingParsePlayers(playersJson, rows, error);
+            });
+
+            // Arena path as used by the RCON page: copy the reply into the arena, parse in place, reset next time
+            ParseArena arena;
+            StatusView statusView;
+            runner.run("parseServerStatus", param + "/arena", 1.0, [&] {
+                arena.reset();
+                StatusParser::parseServerStatus(arena.copy(statusJson), protocolId == 1, arena, statusView);
+            });
+            PlayersView rowsView;
+            runner.run("parsePlayers", param + "/arena", players > 0 ? static_cast<double>(players) : 1.0, [&] {
+                arena.reset();
+                StatusParser::parsePlayers(arena.copy(playersJson), arena, rowsView, error);
+                for (size_t i = 0; i < rowsView.count; ++i) {
+                    benchSink = benchSink + (arena.widen(rowsView.rows[i].name)[0] != 0 ? 1 : 0); // Cell text for the list view
+                }
+            });
+        }
+    }
+}
+
+// Diffs two 32-player tables with two joins, two leaves and score/ping changes, as between two refreshes.
+static void benchDiff(BenchRunner& runner) {
+    std::vector<PlayerInfo> before, after;
+    for (int i = 0; i < 32; ++i) {
+        PlayerInfo p;
+        p.slot = std::to_string(i);
+        p.name = "Player" + std::to_string(i * 7919 % 1000);
+        p.address = "10.1." + std::to_string(i) + ".9:12203";
+        p.score = std::to_string(i * 3);
+        p.ping = std::to_string(40 + i);
+        before.push_back(p);
+        if (i == 5 || i == 17) {
+            p.name = "Joiner" + std::to_string(i);
+        }
+        else if (i % 3 == 0) {
+            p.score = std::to_string(i * 3 + 1);
+        }
+        after.push_back(p);
+    }
+    PlayerDiff diff;
+    runner.run("diffPlayers", "32", 32.0, [&] {
+        copyingDiffPlayers(before, after, diff);
+    });
+    runner.run("diffPlayers", "32/unchanged", 32.0, [&] {
+        copyingDiffPlayers(before, before, diff);
+    });
+
+    std::vector<PlayerView> beforeRows, afterRows;
+    for (size_t i = 0; i < before.size(); ++i) {
+        beforeRows.push_back({ before[i].slot, before[i].name, before[i].address, before[i].score, before[i].ping, std::string_view() });
+        afterRows.push_back({ after[i].slot, after[i].name, after[i].address, after[i].score, after[i].ping, std::string_view() });
+    }
+    PlayersView beforeView{ beforeRows.data(), beforeRows.size() };
+    PlayersView afterView{ afterRows.data(), afterRows.size() };
+    runner.run("diffPlayers", "32/views", 32.0, [&] {
+        StatusParser::diffPlayers(beforeView, afterView, diff);
+    });
+}
+
+// Scheduler cost for a large fleet: one simulated second of deadlines per operation.
+static void benchScheduler(BenchRunner& runner) {
+    const size_t sizes[] = { 1000, 10000 };
+    for (size_t count : sizes) {
+        RefreshScheduler scheduler(64);
+        uint64_t nowMs = 0;
+        scheduler.reset(count, nowMs);
+        scheduler.setFocus(0, nowMs);
+        std::vector<uint32_t> toSend;
+        runner.run("refreshScheduler", std::to_string(count), 1.0, [&] {
+            nowMs += 1000;
+            toSend.clear();
+            scheduler.acquire(nowMs, toSend);
+            for (uint32_t id : toSend) {
+                RefreshOutcome outcome = id % 3 == 0 ? RefreshOutcome::Busy : (id % 3 == 1 ? RefreshOutcome::Empty : RefreshOutcome::Down);
+                scheduler.complete(id, outcome, nowMs);
+            }
+        });
+    }
+
+    TimerWheel wheel;
+    wheel.reserve(1024);
+    uint64_t tick = 0;
+    uint64_t rng = 0x2545F4914F6CDD1Dull;
+    std::vector<uint32_t> expired;
+    runner.run("timerWheel", "1024", 1024.0, [&] {
+        for (uint32_t id = 0; id < 1024; ++id) {
+            rng ^= rng << 13;
+            rng ^= rng >> 7;
+            rng ^= rng << 17;
+            wheel.schedule(id, tick + 1 + rng % 100000);
+        }
+        while (wheel.size() > 0) {
+            tick += 997;
+            expired.clear();
+            wheel.advance(tick, expired);
+        }
+    });
+}
+
+// A fleet of simulated servers polled the way the RCON page does it: scheduler releases,
+// getstatus plus rcon status per server, stand-in JSON, parse, diff and reschedule.
+class RefreshCycle {
+public:
+    bool start(size_t count, uint16_t basePort) {
+        SimConfig config;
+        config.minPlayers = 4;
+        config.maxPlayers = 24;
+        config.churn = 0.2;
+        if (!network.start(config, count, basePort, 11, true) || !client.open()) {
+            return false;
+        }
+        this->basePort = basePort;
+        headers.reset(new RconPacket[count]);
+        for (size_t id = 0; id < count; ++id) {
+            const SimConfig& server = network.server(id).getConfig();
+            headers[id].setHeader(server.protocolId, server.rconPassword);
+        }
+        snapshots.reset(new ArenaPair[count]);
+        previous.assign(count, PlayersView());
+        pending.assign(count, 0);
+        scheduler.reset(count, 0);
+        return true;
+    }
+
+    // Refreshes every server once. Returns the number of servers that answered.
+    size_t cycle() {
+        nowMs += 2000000; // Past the longest backoff, so every server is due
+        size_t answered = 0;
+        size_t outstanding = 0;
+        scheduler.acquire(nowMs, toSend);
+        auto lastProgress = std::chrono::steady_clock::now();
+        while (!toSend.empty() || outstanding > 0) {
+            for (uint32_t id : toSend) {
+                send(id);
+                ++outstanding;
+            }
+            toSend.clear();
+
+            {
+                AllocationExclusion serverSide; // Only the client path is being measured
+                network.pump(0);
+            }
+            UdpEndpoint from;
+            int received;
+            while ((received = client.receiveFrom(buffer, sizeof(buffer), from)) > 0) {
+                uint32_t id = static_cast<uint32_t>(from.port - basePort);
+                if (id >= pending.size() || !scheduler.isInFlight(id)) continue;
+                if (handleReply(id, buffer, static_cast<size_t>(received))) {
+                    ++answered;
+                    --outstanding;
+                    lastProgress = std::chrono::steady_clock::now();
+                    scheduler.acquire(nowMs, toSend);
+                }
+            }
+
+            if (outstanding > 0 && std::chrono::steady_clock::now() - lastProgress > std::chrono::seconds(1)) {
+                for (uint32_t id = 0; id < pending.size(); ++id) {
+                    if (scheduler.isInFlight(id)) {
+                        scheduler.complete(id, RefreshOutcome::Down, nowMs);
+                        --outstanding;
+                    }
+                }
+                scheduler.acquire(nowMs, toSend);
+                lastProgress = std::chrono::steady_clock::now();
+            }
+        }
+        return answered;
+    }
+
+private:
+    void send(uint32_t id) {
+        const SimConfig& config = network.server(id).getConfig();
+        UdpEndpoint to;
+        to.address = UdpSocket::kLoopback;
+        to.port = static_cast<uint16_t>(basePort + id);
+        request.assign("\xff\xff\xff\xff", 4);
+        if (config.protocolId == 1) request.push_back('\x02');
+        request.append("getstatus");
+        client.sendTo(to, request.data(), request.size());
+        headers[id].send(client, to, statusCommand);
+        pending[id] = 0;
+    }
+
+    // Returns true once both replies for id are in and the server has been rescheduled.
+    bool handleReply(uint32_t id, const char* data, size_t length) {
+        size_t body = 0;
+        int protocolId = network.server(id).getConfig().protocolId;
+        StandInQuery::ReplyKind kind = StandInQuery::classify(data, length, body);
+        if (kind == StandInQuery::ReplyKind::Status) {
+            // Parsed in place, as the RCON page does with the DLL's reply buffer
+            StandInQuery::statusToJson(data + body, length - body, json);
+            statusArena.reset();
+            StatusParser::parseServerStatus(json, protocolId == 1, statusArena, status);
+            pending[id] |= 1;
+        }
+        else if (kind == StandInQuery::ReplyKind::Print) {
+            // Same double-buffered snapshot as the RCON page: parse into next, diff, publish
+            StandInQuery::rconStatusToJson(data + body, length - body, protocolId, json);
+            ParseArena& arena = snapshots[id].next();
+            PlayersView rows;
+            StatusParser::parsePlayers(arena.copy(json), arena, rows, error);
+            StatusParser::diffPlayers(previous[id], rows, diff);
+            previous[id] = rows;
+            snapshots[id].publish();
+            pending[id] |= 2;
+        }
+        if (pending[id] != 3) {
+            return false;
+        }
+        scheduler.complete(id, previous[id].count == 0 ? RefreshOutcome::Empty : RefreshOutcome::Busy, nowMs);
+        return true;
+    }
+
+    SimNetwork network;
+    UdpSocket client;
+    RefreshScheduler scheduler{ 8 };
+    uint16_t basePort = 0;
+    uint64_t nowMs = 0;
+    std::vector<uint32_t> toSend;
+    std::unique_ptr<RconPacket[]> headers;  // Prebuilt rcon header per server
+    const RconCommand statusCommand{ "status" };
+    std::unique_ptr<ArenaPair[]> snapshots; // Player snapshot per server
+    std::vector<PlayersView> previous;
+    std::vector<unsigned char> pending; // Bit 0: status reply, bit 1: players reply
+    std::string request;
+    std::string json;
+    std::string error;
+    ParseArena statusArena;
+    StatusView status;
+    PlayerDiff diff;
+    char buffer[4096];
+};
+
+// Sixteen kicks against a simulated server 5 ms away: pipelined in one burst, and one at a time with
+// each reply awaited as GameServerQuery sends them.
+static void benchRconBatch(BenchRunner& runner, uint16_t basePort) {
+    const char* modes[] = { "kick16", "kick16/sequential" };
+    for (const char* mode : modes) {
+        if (!runner.wants("rconBatch", mode)) continue;
+        SimConfig config;
+        config.latencyMs = 5;
+        config.minPlayers = config.maxPlayers = 24;
+        SimNetwork network;
+        UdpSocket client;
+        if (!network.start(config, 1, basePort, 11, false) || !client.open()) {
+            runner.skip("rconBatch", mode, "cannot bind UDP port " + std::to_string(basePort));
+            continue;
+        }
+        Server server;
+        server.name = "Bench Server";
+        server.ipOrHostname = "127.0.0.1";
+        server.port = basePort;
+        server.protocolId = config.protocolId;
+        server.rconPassword = config.rconPassword;
+        RconBatch::Pacing pacing;
+        pacing.burst = 16;
+        pacing.perSecond = 1000;
+        pacing.window = std::strcmp(mode, "kick16") == 0 ? 16 : 1;
+        char buffer[2048];
+        runner.run("rconBatch", mode, 16.0, [&] {
+            RconBatch batch;
+            batch.setPacing(pacing);
+            for (int slot = 0; slot < 16; ++slot) batch.add(server, std::to_string(slot), "", "clientkick");
+            auto now = [] {
+                return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::chrono::steady_clock::now().time_since_epoch()).count());
+            };
+            batch.begin(now());
+            while (!batch.finished()) {
+                batch.pump(client, now());
+                network.pump(1);
+                UdpEndpoint from;
+                int received;
+                while ((received = client.receiveFrom(buffer, sizeof(buffer), from)) > 0) {
+                    batch.onDatagram(from, buffer, static_cast<size_t>(received), now());
+                }
+            }
+            benchSink = benchSink + batch.results().size();
+        });
+    }
+}
+
+static void benchRefreshCycle(BenchRunner& runner, uint16_t basePort) {
+    const size_t sizes[] = { 16, 256 };
+    for (size_t count : sizes) {
+        std::string param = std::to_string(count);
+        if (!runner.wants("refreshCycle", param)) continue;
+        RefreshCycle fleet;
+        if (!fleet.start(count, basePort)) {
+            runner.skip("refreshCycle", param, "cannot bind UDP ports from " + std::to_string(basePort));
+            continue;
+        }
+        runner.run("refreshCycle", param, static_cast<double>(count), [&fleet] {
+            size_t answered = fleet.cycle();
+            benchSink = benchSink + answered;
+        });
+    }
+}
+
+// Building and sending one kick: string concatenation into sendTo, against the prebuilt header,
+// an in-place command and a vectored send. Both go to a loopback socket drained after each send.
+static void benchRconPacket(BenchRunner& runner, uint16_t basePort) {
+    runner.run("rconPacket", "build", 1.0, [] {
+        char datagram[1500];
+        RconPacket packet;
+        packet.setHeader(2, "secret7");
+        RconCommand command("sv_hostname");
+        command.quoted("^1Frag ^7Central \"EU\" #3");
+        benchSink = benchSink + packet.build(command, datagram, sizeof(datagram));
+    });
+
+    if (!runner.wants("rconPacket", "concatSend") && !runner.wants("rconPacket", "sendv")) return;
+    UdpSocket client, sink;
+    if (!client.open() || !sink.open(basePort)) {
+        runner.skip("rconPacket", "sendv", "cannot bind UDP port " + std::to_string(basePort));
+        return;
+    }
+    UdpEndpoint to;
+    to.address = UdpSocket::kLoopback;
+    to.port = sink.localPort();
+    std::string password = "secret7";
+    std::string slot = "12";
+    char drain[1500];
+    runner.run("rconPacket", "concatSend", 1.0, [&] {
+        std::string command = "clientkick " + slot;
+        std::string packet = std::string("\xff\xff\xff\xff", 4) + "rcon " + password + " " + command;
+        client.sendTo(to, packet.data(), packet.size());
+        UdpEndpoint from;
+        while (sink.receiveFrom(drain, sizeof(drain), from) > 0) {}
+    });
+    RconPacket header;
+    header.setHeader(2, password);
+    runner.run("rconPacket", "sendv", 1.0, [&] {
+        RconCommand command("clientkick");
+        command.arg(slot);
+        header.send(client, to, command);
+        UdpEndpoint from;
+        while (sink.receiveFrom(drain, sizeof(drain), from) > 0) {}
+    });
+}
+
+// Display conversion of a colored player name, a UTF-8/Windows-1252 hostname and a 4 KB rcon status
+// reply, with the SSE2 path against the scalar reference. Items are input bytes.
+static void benchTextCodec(BenchRunner& runner) {
+    std::string name = "^1[EU]^7Frag^3Master^7";
+    std::string hostname = "^5Caf\xc3\xa9 Gaming ^7| Objective 24/7 | \x80 Caf\xe9";
+    std::string reply;
+    while (reply.size() < 4096) {
+        reply += "  7    25   48 ^2Sergeant^7Rock          0 192.168.100.27:12203    41562 25000\n";
+    }
+    struct Case {
+        const char* param;
+        const std::string* text;
+        ColorCodes colors;
+    };
+    const Case cases[] = {
+        { "name", &name, ColorCodes::Strip },
+        { "hostname", &hostname, ColorCodes::Keep },
+        { "reply4k", &reply, ColorCodes::Strip },
+    };
+    std::vector<wchar_t> wide(reply.size() + 1);
+    std::vector<char> utf8(reply.size() * 3 + 1);
+
+    // The SSE2 paths against the scalar reference on generated text: ASCII runs broken by color codes,
+    // valid and cut-off UTF-8, stray high bytes and nulls, at lengths around the 16-byte blocks.
+    if (runner.wants("textCodec", "equivalence")) {
+        uint32_t seed = 37;
+        auto next = [&seed](uint32_t range) { seed = seed * 1664525u + 1013904223u; return (seed >> 8) % range; };
+        static const char* const kPieces[] = { "a", "Frag", "Master of the server ", " ", "^", "^^", "^1", "^7",
+            "\xc3\xa9", "\xe2\x82\xac", "\xf0\x9f\x92\xa3", "\xc3", "\xe2\x82", "\x80", "\xe9", "\xff", "\0" };
+        const size_t kMaxText = 96;
+        const size_t perOp = 64;
+        char text[kMaxText + 32];
+        std::vector<wchar_t> wideReference(kMaxText + 1);
+        std::vector<char> utf8Reference(kMaxText * 3 + 1);
+        runner.run("textCodec", "equivalence", static_cast<double>(perOp), [&] {
+            for (size_t i = 0; i < perOp; ++i) {
+                size_t length = 0, target = next(kMaxText + 1);
+                while (length < target) {
+                    const char* piece = kPieces[next(sizeof(kPieces) / sizeof(kPieces[0]))];
+                    size_t size = piece[0] ? std::strlen(piece) : 1;
+                    std::memcpy(text + length, piece, size);
+                    length += size;
+                }
+                std::string_view view(text, length < kMaxText ? length : kMaxText);
+                for (ColorCodes colors : { ColorCodes::Keep, ColorCodes::Strip }) {
+                    size_t n = TextCodec::toWide(view, wide.data(), colors);
+                    if (n != TextCodec::toWideScalar(view, wideReference.data(), colors) ||
+                        std::memcmp(wide.data(), wideReference.data(), (n + 1) * sizeof(wchar_t)) != 0) {
+                        failMismatch("toWide", view);
+                    }
+                    n = TextCodec::toUtf8(view, utf8.data(), colors);
+                    if (n != TextCodec::toUtf8Scalar(view, utf8Reference.data(), colors) ||
+                        std::memcmp(utf8.data(), utf8Reference.data(), n + 1) != 0) {
+                        failMismatch("toUtf8", view);
+                    }
+                }
+            }
+            benchSink = benchSink + seed;
+        });
+    }
+
+    for (const Case& c : cases) {
+        const std::string& text = *c.text;
+        ColorCodes colors = c.colors;
+        double bytes = static_cast<double>(text.size());
+        std::string param = c.param;
+        runner.run("toWide", param + "/scalar", bytes, [&text, &wide, colors] {
+            benchSink = benchSink + TextCodec::toWideScalar(text, wide.data(), colors);
+        });
+        runner.run("toWide", param + "/simd", bytes, [&text, &wide, colors] {
+            benchSink = benchSink + TextCodec::toWide(text, wide.data(), colors);
+        });
+        runner.run("toUtf8", param + "/scalar", bytes, [&text, &utf8, colors] {
+            benchSink = benchSink + TextCodec::toUtf8Scalar(text, utf8.data(), colors);
+        });
+        runner.run("toUtf8", param + "/simd", bytes, [&text, &utf8, colors] {
+            benchSink = benchSink + TextCodec::toUtf8(text, utf8.data(), colors);
+        });
+    }
+}
+
+static void benchConsole(BenchRunner& runner) {
+    const std::string line = "  7    25   48 ^2Sergeant^7Rock          0 192.168.100.27:12203    41562 25000";
+    std::string reply;
+    size_t replyLines = 0;
+    while (reply.size() < 4096) {
+        reply += line + "\n";
+        ++replyLines;
+    }
+    // Appends run against a ring that is already full, so every line also evicts one
+    if (runner.wants("consoleAppend", "line") || runner.wants("consoleAppend", "reply4k")) {
+        ConsoleBuffer console(1 << 16, 4 << 20);
+        uint16_t tag = console.tagFor("Bench Server");
+        for (size_t i = 0; i < (1 << 16); ++i) console.append(line, tag, ConsoleKind::Reply, 0);
+        runner.run("consoleAppend", "line", 1.0, [&] {
+            benchSink = benchSink + static_cast<size_t>(console.append(line, tag, ConsoleKind::Reply, 0));
+        });
+        runner.run("consoleAppend", "reply4k", static_cast<double>(replyLines), [&] {
+            benchSink = benchSink + static_cast<size_t>(console.append(reply, tag, ConsoleKind::Reply, 0));
+        });
+    }
+
+    // Two million lines of scrollback; the needle is only on the newest line, so each search scans all of it
+    if (!runner.wants("consoleFind", "2M") && !runner.wants("consoleFind", "2M/perLine")) return;
+    const size_t count = 2000000;
+    ConsoleBuffer console(count, count * (line.size() + 1));
+    uint16_t tag = console.tagFor("Bench Server");
+    for (size_t i = 0; i < count - 1; ++i) console.append(line, tag, ConsoleKind::Reply, 0);
+    console.append("banned player ^1Cheater", tag, ConsoleKind::Reply, 0);
+    runner.run("consoleFind", "2M", static_cast<double>(count), [&console] {
+        benchSink = benchSink + static_cast<size_t>(console.find("CHEATER", 0, true));
+    });
+    runner.run("consoleFind", "2M/perLine", static_cast<double>(count), [&console] {
+        // Reference: fold and search every line on its own
+        ConsoleLine entry;
+        std::string folded;
+        for (uint64_t s = console.firstSequence(); console.line(s, entry); ++s) {
+            folded.assign(entry.text);
+            for (char& c : folded) c = static_cast<char>(c >= 'A' && c <= 'Z' ? c + 32 : c);
+            if (folded.find("cheater") != std::string::npos) {
+                benchSink = benchSink + static_cast<size_t>(s);
+                break;
+            }
+        }
+    });
+}
+
+// Scrolling the server combo through 64 entries. Each selection queues a refresh that waits 1 ms
+// (standing in for the query); with cancellation only the last one should cost anything.
+static void benchQueryWorker(BenchRunner& runner) {
+    if (!runner.wants("queryWorker", "scroll64") && !runner.wants("queryWorker", "scroll64/noCancel")) return;
+    const int selections = 64;
+    QueryWorker worker;
+    std::atomic<size_t> refreshed{ 0 };
+    auto refresh = [&worker, &refreshed](const CancelToken& token) {
+        if (!worker.sleepFor(token, 1)) return;
+        refreshed.fetch_add(1, std::memory_order_relaxed);
+    };
+    runner.run("queryWorker", "scroll64", static_cast<double>(selections), [&] {
+        CancelToken pending;
+        for (int i = 0; i < selections; ++i) {
+            worker.cancel(pending);
+            pending = CancelToken();
+            worker.submit(pending, refresh);
+        }
+        worker.waitIdle();
+        benchSink = benchSink + refreshed.load();
+    });
+    runner.run("queryWorker", "scroll64/noCancel", static_cast<double>(selections), [&] {
+        CancelToken shared;
+        for (int i = 0; i < selections; ++i) worker.submit(shared, refresh);
+        worker.waitIdle();
+        benchSink = benchSink + refreshed.load();
+    });
+}
+
+// Planning prefetches after each switch: neighbors, recent and frequent servers, with warmth looked
+// up in a snapshot store that holds every other server.
+static void benchPrefetch(BenchRunner& runner) {
+    const size_t sizes[] = { 256, 4096 };
+    for (size_t count : sizes) {
+        std::string param = std::to_string(count);
+        if (!runner.wants("prefetchPlan", param)) continue;
+        std::vector<std::string> names;
+        SnapshotStore store;
+        auto reply = std::make_shared<std::string>("statusResponse");
+        for (size_t i = 0; i < count; ++i) {
+            names.push_back("Server " + std::to_string(i));
+            if (i % 2) continue;
+            ServerSnapshot snapshot;
+            snapshot.owner = reply;
+            snapshot.status = snapshot.players = *reply;
+            snapshot.statusOk = snapshot.playersOk = true;
+            store.put(names.back(), snapshot);
+        }
+        Prefetcher prefetcher;
+        Prefetcher::Budget budget;
+        budget.queriesPerMinute = 600000; // Refills faster than the bench spends
+        budget.burst = 1000;
+        prefetcher.setBudget(budget);
+        prefetcher.resize(count);
+        for (uint32_t i = 0; i < 64; ++i) prefetcher.opened((i * 37) % static_cast<uint32_t>(count));
+        std::vector<uint32_t> picks;
+        uint64_t now = 0;
+        uint32_t current = 0;
+        runner.run("prefetchPlan", param, 1.0, [&] {
+            picks.clear();
+            now += 1;
+            current = (current + 1) % static_cast<uint32_t>(count);
+            prefetcher.plan(current, now, [&](uint32_t index) { return store.isWarm(names[index], now, 30000); }, picks);
+            benchSink = benchSink + picks.size();
+        });
+    }
+}
+
+// UI-side cost of a burst of 16 kicks on a 64-player server: recording each one, re-filtering the
+// table after every click, and settling the burst from the verification player list.
+static void benchPlayerActions(BenchRunner& runner) {
+    if (!runner.wants("playerActions", "kick16/64")) return;
+    std::string statusJson, playersJson;
+    makeStatusJson(2, 64, statusJson, playersJson);
+    ParseArena arena;
+    PlayersView before;
+    std::string error;
+    StatusParser::parsePlayers(arena.copy(playersJson), arena, before, error);
+    // The verification list: the same table without the kicked players
+    std::vector<PlayerView> remaining;
+    for (size_t i = 0; i < before.count; ++i) {
+        if (i % 4 != 0) remaining.push_back(before.rows[i]);
+    }
+    PlayersView after{ remaining.data(), remaining.size() };
+    const std::string server = "Bench Server";
+    std::vector<PlayerAction> settled;
+    uint64_t now = 0;
+    runner.run("playerActions", "kick16/64", 16.0, [&] {
+        PlayerActions actions;
+        settled.clear();
+        size_t shown = 0;
+        for (size_t i = 0; i < before.count; i += 4) {
+            std::string command = "clientkick " + std::string(before.rows[i].slot);
+            actions.applied(server, before.rows[i].slot, before.rows[i].name, command, now, now + 40);
+            for (size_t r = 0; r < before.count; ++r) {
+                shown += actions.pendingFor(server, before.rows[r]) ? 0 : 1;
+            }
+        }
+        actions.reconcile(server, after, now + 600, now + 700, settled);
+        now += 1000;
+        benchSink = benchSink + shown + settled.size();
+    });
+}
+
+// Player search over 20,000 online players (625 simulated CoD servers of 32), and the incremental
+// update one poll with two joins and two leaves costs.
+static void benchPlayerIndex(BenchRunner& runner) {
+    const char* cases[] = { "poll", "prefix", "substring", "fuzzy", "cidr16", "guid" };
+    bool wanted = false;
+    for (const char* name : cases) wanted = wanted || runner.wants("playerIndex", std::string(name) + "/20k");
+    if (!wanted) return;
+
+    const size_t serverCount = 625;
+    std::vector<std::unique_ptr<ParseArena>> arenas; // The index copies what it keeps; the views just need to outlive the fill
+    std::vector<PlayersView> tables;
+    std::vector<std::string> names;
+    std::string reply, json, error;
+    for (size_t i = 0; i < serverCount; ++i) {
+        SimConfig config;
+        config.minPlayers = config.maxPlayers = 32;
+        SimServer server(config, 1000 + i, 12203);
+        std::string request = "\xff\xff\xff\xffrcon " + config.rconPassword + " status";
+        server.handle(request.data(), request.size(), 0, reply);
+        size_t body = 0;
+        StandInQuery::classify(reply.data(), reply.size(), body);
+        StandInQuery::rconStatusToJson(reply.data() + body, reply.size() - body, 2, json);
+        arenas.emplace_back(new ParseArena());
+        PlayersView rows;
+        StatusParser::parsePlayers(arenas.back()->copy(json), *arenas.back(), rows, error);
+        tables.push_back(rows);
+        names.push_back("Server " + std::to_string(i));
+    }
+    PlayerIndex index;
+    for (size_t i = 0; i < serverCount; ++i) index.update(names[i], tables[i], 0);
+
+    // The first server alternates between its table and one with two players replaced by two of another server
+    std::vector<PlayerView> changedRows(tables[0].rows, tables[0].rows + tables[0].count);
+    changedRows[3] = tables[1].rows[3];
+    changedRows[17] = tables[1].rows[17];
+    PlayersView changed{ changedRows.data(), changedRows.size() };
+    bool flip = false;
+    runner.run("playerIndex", "poll/20k", 1.0, [&] {
+        flip = !flip;
+        benchSink = benchSink + index.update(names[0], flip ? changed : tables[0], 1);
+    });
+
+    std::vector<uint32_t> out;
+    std::string someone = PlayerIndex::normalize(tables[300].rows[5].name);
+    std::string guid(tables[300].rows[5].guid);
+    runner.run("playerIndex", "prefix/20k", 1.0, [&] {
+        index.findPrefix(someone.substr(0, 4), 50, out);
+        benchSink = benchSink + out.size();
+    });
+    runner.run("playerIndex", "substring/20k", 1.0, [&] {
+        index.findSubstring(someone.substr(1), 50, out);
+        benchSink = benchSink + out.size();
+    });
+    runner.run("playerIndex", "fuzzy/20k", 1.0, [&] {
+        index.findFuzzy(someone.substr(0, someone.size() - 1) + "x", 20, out);
+        benchSink = benchSink + out.size();
+    });
+    runner.run("playerIndex", "cidr16/20k", 1.0, [&] {
+        index.findAddress("10.42.0.0/16", 500, out);
+        benchSink = benchSink + out.size();
+    });
+    runner.run("playerIndex", "guid/20k", 1.0, [&] {
+        index.findGuid(guid, 10, out);
+        benchSink = benchSink + out.size();
+    });
+}
+
+// Warm start for 256 servers with 4 KB replies: writing the file, and mapping it back into a store.
+static void benchSnapshotFile(BenchRunner& runner) {
+    if (!runner.wants("snapshotFile", "save256") && !runner.wants("snapshotFile", "load256")) return;
+    std::string status = "{\"sv_hostname\":\"Bench Server\",\"mapname\":\"mp_carentan\",\"g_gametype\":\"tdm\"}";
+    auto reply = std::make_shared<std::string>();
+    while (reply->size() < 4096) reply->append("{\"slot\":\"7\",\"name\":\"^2Sergeant^7Rock\",\"score\":\"25\",\"ping\":\"48\"},");
+    SnapshotStore store;
+    for (int i = 0; i < 256; ++i) {
+        ServerSnapshot snapshot;
+        snapshot.owner = reply;
+        snapshot.status = status;
+        snapshot.players = *reply;
+        snapshot.statusOk = snapshot.playersOk = true;
+        snapshot.fetchedMs = 1000;
+        store.put("Server " + std::to_string(i), snapshot);
+    }
+    std::string path = (std::filesystem::temp_directory_path() / "xrcon_bench_snapshots.dat").string();
+    runner.run("snapshotFile", "save256", 256.0, [&] {
+        benchSink = benchSink + (store.save(path, 2000, 1700000000000ull) ? 1 : 0);
+    });
+    store.save(path, 2000, 1700000000000ull);
+    runner.run("snapshotFile", "load256", 256.0, [&] {
+        SnapshotStore warm;
+        benchSink = benchSink + warm.load(path, 5000, 1700000003000ull);
+    });
+    std::error_code error;
+    std::filesystem::remove(path, error);
+}
+
+static void benchSessionLog(BenchRunner& runner) {
+    if (!runner.wants("sessionLog", "seal64k") && !runner.wants("sessionLog", "open") && !runner.wants("sessionLog", "ip90d") &&
+        !runner.wants("sessionLog", "cidr24") && !runner.wants("sessionLog", "name90d") && !runner.wants("sessionLog", "server1h")) {
+        return;
+    }
+    // One million sessions over a year: 40 servers, 200k names, 65k addresses
+    std::string directory = (std::filesystem::temp_directory_path() / "xrcon_bench_sessions").string();
+    std::error_code error;
+    std::filesystem::remove_all(directory, error);
+    const uint64_t nowUnixMs = 1700000000000ull;
+    const uint64_t yearMs = 365ull * 24 * 3600 * 1000;
+    uint32_t seed = 12345;
+    auto next = [&seed] { seed = seed * 1664525u + 1013904223u; return seed >> 8; };
+    auto session = [&](uint64_t index, uint64_t count) {
+        SessionRecord record;
+        record.server = "Server " + std::to_string(next() % 40);
+        record.name = "^" + std::to_string(next() % 8) + "Player" + std::to_string(next() % 200000);
+        record.guid = std::to_string(next() % 1000000);
+        record.ip = 0x0A000000u | (next() & 0xFFFF);
+        record.joinUnixMs = nowUnixMs - yearMs + yearMs * index / count;
+        record.leaveUnixMs = record.joinUnixMs + 60000 + next() % 7200000;
+        return record;
+    };
+
+    SessionLog log;
+    log.open(directory);
+    const uint64_t total = 16 * SessionLog::kSealRows;
+    std::vector<SessionRecord> chunk;
+    for (uint64_t i = 0; i < total; ++i) {
+        chunk.push_back(session(i, total));
+        if (chunk.size() < 4096) continue;
+        log.append(chunk);
+        chunk.clear();
+        while (std::unique_ptr<SessionJob> job = log.nextJob()) {
+            SessionLog::runJob(*job);
+            log.finishJob(std::move(job));
+        }
+    }
+
+    auto rows = std::make_shared<SessionRows>();
+    for (size_t i = 0; i < SessionLog::kSealRows; ++i) rows->rows.push_back(session(i, SessionLog::kSealRows));
+    rows->nameHashes.resize(rows->rows.size());
+    SessionJob seal;
+    seal.rows = rows;
+    seal.output = (std::filesystem::path(directory) / "bench-seal.dat").string();
+    runner.run("sessionLog", "seal64k", static_cast<double>(SessionLog::kSealRows), [&] {
+        SessionLog::runJob(seal);
+        benchSink = benchSink + static_cast<size_t>(seal.rowCount);
+    });
+    std::filesystem::remove(seal.output, error);
+
+    runner.run("sessionLog", "open", 1.0, [&] {
+        SessionLog reopened;
+        benchSink = benchSink + (reopened.open(directory) ? static_cast<size_t>(reopened.rowCount()) : 0);
+    });
+    std::vector<SessionRecord> found;
+    SessionQuery byAddress;
+    byAddress.ipBase = 0x0A000000u | 0x1234;
+    byAddress.sinceUnixMs = nowUnixMs - 90ull * 24 * 3600 * 1000;
+    runner.run("sessionLog", "ip90d", 1.0, [&] {
+        benchSink = benchSink + log.query(byAddress, found);
+    });
+    SessionQuery byRange = byAddress;
+    byRange.ipMask = 0xFFFFFF00u;
+    runner.run("sessionLog", "cidr24", 1.0, [&] {
+        benchSink = benchSink + log.query(byRange, found);
+    });
+    SessionQuery byName = byAddress;
+    byName.by = SessionQuery::By::Name;
+    byName.text = "player4242";
+    runner.run("sessionLog", "name90d", 1.0, [&] {
+        benchSink = benchSink + log.query(byName, found);
+    });
+    SessionQuery byServer;
+    byServer.by = SessionQuery::By::Server;
+    byServer.text = "Server 7";
+    byServer.sinceUnixMs = nowUnixMs - 3600 * 1000;
+    runner.run("sessionLog", "server1h", 1.0, [&] {
+        benchSink = benchSink + log.query(byServer, found);
+    });
+    log.close();
+    std::filesystem::remove_all(directory, error);
+}
+
+// A ban list of 100k single addresses and ranges plus 2k names, 200 of them wildcards: matching a
+// joining player, and working out the filter changes for a server after one rule was added.
+static void benchBanList(BenchRunner& runner) {
+    if (!runner.wants("banList", "match100k") && !runner.wants("banList", "filterDiff100k")) return;
+    const uint64_t nowUnixMs = 1700000000000ull;
+    uint32_t seed = 777;
+    auto next = [&seed] { seed = seed * 1664525u + 1013904223u; return seed; };
+    BanList bans;
+    for (size_t i = 0; i < 100000; ++i) {
+        BanRule rule;
+        uint32_t ip = next();
+        uint32_t bits = i % 10 == 0 ? 16 + next() % 13 : 32;
+        rule.pattern = std::to_string(ip >> 24) + "." + std::to_string((ip >> 16) & 255) + "." +
+            std::to_string((ip >> 8) & 255) + "." + std::to_string(ip & 255) + "/" + std::to_string(bits);
+        if (i % 7 == 0) rule.expiresUnixMs = nowUnixMs - 1;
+        bans.add(rule);
+    }
+    for (size_t i = 0; i < 2000; ++i) {
+        BanRule rule;
+        rule.kind = BanKind::Name;
+        rule.pattern = i % 10 == 0 ? "*cheat" + std::to_string(i) + "*" : "griefer" + std::to_string(i);
+        bans.add(rule);
+    }
+    std::vector<uint32_t> ips;
+    for (size_t i = 0; i < 4096; ++i) ips.push_back(next());
+    size_t at = 0;
+    runner.run("banList", "match100k", 1.0, [&] {
+        at = (at + 1) & 4095;
+        benchSink = benchSink + (bans.match("sergeantrock", ips[at], "", nowUnixMs) != nullptr ? 1 : 0);
+    });
+
+    std::vector<std::string> desired, add, remove;
+    bans.ipFilters(nowUnixMs, desired);
+    IpFilterSync sync;
+    for (size_t i = 0; i < desired.size(); ++i) {
+        if (i != desired.size() / 2) sync.applied("Server 0", desired[i], true);
+    }
+    runner.run("banList", "filterDiff100k", 1.0, [&] {
+        bans.ipFilters(nowUnixMs, desired);
+        sync.diff("Server 0", desired, add, remove);
+        benchSink = benchSink + add.size() + remove.size();
+    });
+}
+
+// 300 rules (200 on server fields, 100 per player) against polls of 625 servers with 32 players each,
+// where every poll changes most pings and nothing else; and compiling the rules.
+static void benchRuleEngine(BenchRunner& runner) {
+    if (!runner.wants("ruleEngine", "poll/300rules") && !runner.wants("ruleEngine", "compile300")) return;
+    std::vector<Rule> rules;
+    for (int i = 0; i < 300; ++i) {
+        Rule rule;
+        rule.name = "Rule " + std::to_string(i);
+        if (i % 3 == 2) {
+            rule.condition = "ping > " + std::to_string(150 + i) + " && players >= " + std::to_string(i % 16) + " && name != \"*admin*\"";
+            rule.actions.push_back("say {name}^7: ping {ping} is over the limit");
+        }
+        else if (i % 10 == 0) {
+            rule.condition = "cvar.g_antilag == 0 && gametype == \"tdm\"";
+            rule.actions.push_back("g_antilag 1");
+        }
+        else {
+            rule.condition = "players == " + std::to_string(i % 40) + " && (map != \"mp_carentan\" || gametype == \"s*\")";
+            rule.actions.push_back("map_rotate");
+        }
+        rules.push_back(rule);
+    }
+    RuleEngine engine;
+    std::string error;
+    runner.run("ruleEngine", "compile300", 300.0, [&] {
+        engine.clear();
+        for (const Rule& rule : rules) benchSink = benchSink + (engine.add(rule, error) ? 1 : 0);
+    });
+
+    engine.clear();
+    for (const Rule& rule : rules) engine.add(rule, error);
+    const size_t serverCount = 625;
+    std::vector<std::string> names, slots, playerNames, pings[2];
+    for (size_t i = 0; i < serverCount; ++i) names.push_back("Server " + std::to_string(i));
+    for (size_t i = 0; i < 32; ++i) {
+        slots.push_back(std::to_string(i));
+        playerNames.push_back("^" + std::to_string(i % 8) + "Player" + std::to_string(i));
+        pings[0].push_back(std::to_string(40 + i * 9));
+        pings[1].push_back(std::to_string(i % 4 == 0 ? 40 + i * 9 : 45 + i * 9));
+    }
+    std::vector<PlayerView> rows[2];
+    for (int variant = 0; variant < 2; ++variant) {
+        for (size_t i = 0; i < 32; ++i) rows[variant].push_back({ slots[i], playerNames[i], "10.0.0.1:28960", "0", pings[variant][i], "" });
+    }
+    CvarView cvars[] = { { "g_antilag", "0" }, { "sv_maxclients", "32" }, { "g_gametype", "tdm" } };
+    StatusView status;
+    status.hostname = "^1Bench ^7Server";
+    status.mapname = "mp_harbor";
+    status.gametype = "tdm";
+    status.maxclients = "32";
+    status.cvars = cvars;
+    status.cvarCount = 3;
+    std::vector<RuleFiring> firings;
+    for (size_t i = 0; i < serverCount; ++i) engine.evaluate(names[i], status, PlayersView{ rows[0].data(), 32 }, 1, firings);
+    size_t poll = 0;
+    runner.run("ruleEngine", "poll/300rules", 1.0, [&] {
+        ++poll;
+        firings.clear();
+        const std::vector<PlayerView>& table = rows[(poll / serverCount) & 1];
+        benchSink = benchSink + engine.evaluate(names[poll % serverCount], status, PlayersView{ table.data(), table.size() }, 1 + poll, firings);
+    });
+}
+
+// 5000 jobs: the clock tick when nothing is due, working out a job's next run, and adding 5000
+// every-minute jobs then running the minute in which all of them come due and are rescheduled.
+static void benchJobScheduler(BenchRunner& runner) {
+    if (!runner.wants("jobScheduler", "idle5k") && !runner.wants("jobScheduler", "cronNext") &&
+        !runner.wants("jobScheduler", "due5k")) {
+        return;
+    }
+    const uint64_t startUnixMs = 1700000000000ull;
+    const char* schedules[] = { "0 4 * * *", "*/15 * * * *", "0 20 * * fri-sun", "0-10/5 9-17 * mar-apr mon-fri", "@hourly" };
+    JobScheduler scheduler;
+    std::string error;
+    for (int i = 0; i < 5000; ++i) {
+        Job job;
+        job.name = "Job " + std::to_string(i);
+        job.schedule = schedules[i % 5];
+        job.commands.push_back("say Scheduled announcement");
+        job.jitterSeconds = 30;
+        scheduler.add(job, startUnixMs, error);
+    }
+    std::vector<JobDue> due;
+    uint64_t idleUnixMs = scheduler.nextDueUnixMs() - 1;
+    runner.run("jobScheduler", "idle5k", 1.0, [&] {
+        scheduler.due(idleUnixMs, due);
+        benchSink = benchSink + due.size();
+    });
+    CronSchedule cron;
+    cron.parse(schedules[3], error);
+    uint64_t after = startUnixMs;
+    runner.run("jobScheduler", "cronNext", 1.0, [&] {
+        after = cron.next(after);
+        benchSink = benchSink + static_cast<size_t>(after & 1);
+    });
+    Job every;
+    every.schedule = "* * * * *";
+    every.commands.push_back("say tick");
+    uint64_t nowUnixMs = startUnixMs;
+    runner.run("jobScheduler", "due5k", 5000.0, [&] {
+        JobScheduler minute;
+        for (int i = 0; i < 5000; ++i) minute.add(every, nowUnixMs, error);
+        due.clear();
+        minute.due(nowUnixMs + 60000, due);
+        benchSink = benchSink + due.size();
+    });
+}
+
+static void benchCvarStore(BenchRunner& runner) {
+    if (!runner.wants("cvarStore", "poll1k") && !runner.wants("cvarStore", "fleet1k") &&
+        !runner.wants("cvarStore", "recheck1k")) {
+        return;
+    }
+    // 1,000 servers with 60 cvars each; every tenth one has two settings off its baseline
+    const size_t serverCount = 1000;
+    std::vector<std::string> names, keys, values, drifted;
+    for (size_t i = 0; i < serverCount; ++i) names.push_back("Server " + std::to_string(i));
+    for (size_t k = 0; k < 60; ++k) {
+        keys.push_back("sv_setting" + std::to_string(k));
+        values.push_back(std::to_string(k * 7 % 13));
+        drifted.push_back(k % 30 == 3 ? "99" : values[k]);
+    }
+    std::vector<std::vector<CvarView>> statuses(serverCount);
+    for (size_t i = 0; i < serverCount; ++i) {
+        statuses[i].push_back({ "sv_hostname", names[i] });
+        statuses[i].push_back({ "mapname", i % 2 ? "mp_carentan" : "mp_toujane" });
+        for (size_t k = 0; k < keys.size(); ++k) statuses[i].push_back({ keys[k], i % 10 == 0 ? drifted[k] : values[k] });
+    }
+    CvarProfile profiles[2];
+    for (int p = 0; p < 2; ++p) {
+        profiles[p].name = "Call of Duty 2";
+        for (size_t k = 0; k < 40; ++k) profiles[p].cvars.emplace_back(keys[k], values[k]);
+    }
+    profiles[1].cvars[5].second = "changed";
+    CvarStore store;
+    std::string error;
+    store.addProfile(profiles[0], error);
+    const std::string game = "Call of Duty 2";
+    auto pollAll = [&] {
+        size_t changed = 0;
+        for (size_t i = 0; i < serverCount; ++i) {
+            StatusView status;
+            status.cvars = statuses[i].data();
+            status.cvarCount = statuses[i].size();
+            changed += store.update(names[i], game, status, 0) ? 1 : 0;
+        }
+        return changed;
+    };
+    pollAll();
+    runner.run("cvarStore", "poll1k", 1000.0, [&] {
+        benchSink = benchSink + pollAll();
+    });
+    std::vector<std::pair<std::string, const std::vector<CvarDiff>*>> drifting;
+    runner.run("cvarStore", "fleet1k", 1000.0, [&] {
+        benchSink = benchSink + store.fleetDrift(drifting) + drifting.size();
+    });
+    int next = 1;
+    runner.run("cvarStore", "recheck1k", 1000.0, [&] {
+        store.clearProfiles();
+        store.addProfile(profiles[next], error);
+        next ^= 1;
+        benchSink = benchSink + store.fleetDrift(drifting) + drifting.size();
+    });
+}
+
+static void benchLogTailer(BenchRunner& runner) {
+    if (!runner.wants("logTailer", "split32M") && !runner.wants("logTailer", "parseCod32M") &&
+        !runner.wants("logTailer", "tail32M")) {
+        return;
+    }
+    // A synthetic games_mp.log of a busy server: mostly damage and kills, some chat, joins and quits
+    uint32_t seed = 777;
+    auto next = [&seed] { seed = seed * 1664525u + 1013904223u; return seed >> 8; };
+    std::string log;
+    log.reserve(33 << 20);
+    char line[256];
+    for (uint32_t second = 0; log.size() < (32u << 20); ++second) {
+        unsigned minutes = second / 60, seconds = second % 60;
+        unsigned a = next() % 64, v = next() % 64, kind = next() % 20;
+        if (kind < 12) {
+            snprintf(line, sizeof(line), "%4u:%02u D;%u;%u;axis;^%uVictim%u;%u;%u;allies;^%uAttacker%u;mp44_mp;%u;MOD_RIFLE_BULLET;torso_upper\n",
+                minutes, seconds, 100000 + v, v, v % 8, v, 100000 + a, a, a % 8, a, 20 + next() % 80);
+        }
+        else if (kind < 17) {
+            snprintf(line, sizeof(line), "%4u:%02u K;%u;%u;axis;^%uVictim%u;%u;%u;allies;^%uAttacker%u;kar98k_mp;135;MOD_HEAD_SHOT;head\n",
+                minutes, seconds, 100000 + v, v, v % 8, v, 100000 + a, a, a % 8, a);
+        }
+        else if (kind < 19) {
+            snprintf(line, sizeof(line), "%4u:%02u say;%u;%u;^%uPlayer%u;\x15nice shot, see you on the next map\n",
+                minutes, seconds, 100000 + a, a, a % 8, a);
+        }
+        else {
+            snprintf(line, sizeof(line), "%4u:%02u %s;%u;%u;^%uPlayer%u\n", minutes, seconds, next() % 2 ? "J" : "Q",
+                100000 + a, a, a % 8, a);
+        }
+        log += line;
+    }
+    const double bytes = static_cast<double>(log.size());
+    const size_t chunkBytes = 1 << 20;
+    LineSplitter splitter;
+    std::vector<std::string_view> lines;
+    auto feed = [&](auto&& onLines) {
+        splitter.reset();
+        for (size_t at = 0; at < log.size(); at += chunkBytes) {
+            size_t length = std::min(chunkBytes, log.size() - at);
+            std::memcpy(splitter.reserve(length), log.data() + at, length);
+            splitter.commit(length);
+            lines.clear();
+            splitter.split(lines);
+            onLines();
+        }
+    };
+    runner.run("logTailer", "split32M", bytes, [&] {
+        size_t count = 0;
+        feed([&] { count += lines.size(); });
+        benchSink = benchSink + count;
+    });
+    runner.run("logTailer", "parseCod32M", bytes, [&] {
+        size_t kills = 0;
+        LogEvent event;
+        feed([&] {
+            for (std::string_view text : lines) kills += LogParser::parseCod(text, event) && event.kind == LogEventKind::Kill ? 1 : 0;
+        });
+        benchSink = benchSink + kills;
+    });
+
+    // The same log read from disk through the tailer, 4 MB a poll as the UI would with a large backlog
+    std::string path = (std::filesystem::temp_directory_path() / "xrcon_bench_games_mp.log").string();
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write(log.data(), static_cast<std::streamsize>(log.size()));
+    }
+    runner.run("logTailer", "tail32M", bytes, [&] {
+        LogTailer tailer;
+        tailer.open(path, true);
+        size_t count = 0;
+        while (tailer.poll(lines, 4 << 20) > 0) count += lines.size();
+        benchSink = benchSink + count;
+    });
+    std::error_code error;
+    std::filesystem::remove(path, error);
+}
+
+void runAllBenchmarks(BenchRunner& runner, uint16_t basePort) {
+    benchConfigLoad(runner);
+    benchDefaults(runner);
+    benchListsAndValidation(runner);
+    benchValidationDifferential(runner);
+    benchParsers(runner);
+    benchDiff(runner);
+    benchTextCodec(runner);
+    benchConsole(runner);
+    benchScheduler(runner);
+    benchQueryWorker(runner);
+    benchPrefetch(runner);
+    benchSnapshotFile(runner);
+    benchPlayerActions(runner);
+    benchPlayerIndex(runner);
+    benchSessionLog(runner);
+    benchBanList(runner);
+    benchRuleEngine(runner);
+    benchJobScheduler(runner);
+    benchCvarStore(runner);
+    benchLogTailer(runner);
+    benchRconPacket(runner, basePort);
+    benchRconBatch(runner, basePort);
+    benchRefreshCycle(runner, basePort);
+}
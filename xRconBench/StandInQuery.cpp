@@ -0,0 +1,144 @@
+// --- xRconBench\StandInQuery.cpp ---
+// Implementation of the GameServerQuery stand-in.
+// Turns statusResponse and rcon status datagrams into the JSON produced by the real DLL.
+
+#include "StandInQuery.h"
+#include <cstring>
+
+// Appends s as a JSON string literal.
+static void appendJsonString(std::string& json, const char* s, size_t length) {
+    json.push_back('"');
+    for (size_t i = 0; i < length; ++i) {
+        char c = s[i];
+        if (c == '"' || c == '\\') json.push_back('\\');
+        if (static_cast<unsigned char>(c) < 0x20) continue;
+        json.push_back(c);
+    }
+    json.push_back('"');
+}
+
+// Returns the length of the line starting at data (excluding the newline).
+static size_t lineLength(const char* data, size_t length) {
+    const void* newline = std::memchr(data, '\n', length);
+    return newline ? static_cast<size_t>(static_cast<const char*>(newline) - data) : length;
+}
+
+StandInQuery::ReplyKind StandInQuery::classify(const char* data, size_t length, size_t& bodyOffset) {
+    if (length < 5 || std::memcmp(data, "\xff\xff\xff\xff", 4) != 0) {
+        return ReplyKind::Unknown;
+    }
+    size_t pos = 4;
+    if (data[pos] == '\x01') ++pos; // MOHAA server direction byte
+    size_t kindLength = lineLength(data + pos, length - pos);
+    bodyOffset = pos + kindLength + (pos + kindLength < length ? 1 : 0);
+    if (kindLength == 14 && std::memcmp(data + pos, "statusResponse", 14) == 0) return ReplyKind::Status;
+    if (kindLength == 5 && std::memcmp(data + pos, "print", 5) == 0) return ReplyKind::Print;
+    return ReplyKind::Unknown;
+}
+
+void StandInQuery::statusToJson(const char* body, size_t length, std::string& json) {
+    json.assign("{");
+    size_t infoLength = lineLength(body, length);
+
+    // \key\value pairs
+    size_t pos = 0;
+    bool first = true;
+    while (pos < infoLength && body[pos] == '\\') {
+        size_t keyStart = pos + 1;
+        const char* keyEnd = static_cast<const char*>(std::memchr(body + keyStart, '\\', infoLength - keyStart));
+        if (!keyEnd) break;
+        size_t valueStart = static_cast<size_t>(keyEnd - body) + 1;
+        const char* valueEnd = static_cast<const char*>(std::memchr(body + valueStart, '\\', infoLength - valueStart));
+        size_t valueStop = valueEnd ? static_cast<size_t>(valueEnd - body) : infoLength;
+        if (!first) json.push_back(',');
+        appendJsonString(json, body + keyStart, static_cast<size_t>(keyEnd - body) - keyStart);
+        json.push_back(':');
+        appendJsonString(json, body + valueStart, valueStop - valueStart);
+        first = false;
+        pos = valueStop;
+    }
+
+    // score ping "name" lines
+    if (!first) json.push_back(',');
+    json.append("\"players\":[");
+    pos = infoLength + 1;
+    bool firstPlayer = true;
+    while (pos < length) {
+        size_t rowLength = lineLength(body + pos, length - pos);
+        const char* row = body + pos;
+        const char* space1 = static_cast<const char*>(std::memchr(row, ' ', rowLength));
+        const char* space2 = space1 ? static_cast<const char*>(std::memchr(space1 + 1, ' ', rowLength - (space1 + 1 - row))) : nullptr;
+        if (space2) {
+            const char* name = space2 + 1;
+            size_t nameLength = rowLength - static_cast<size_t>(name - row);
+            if (nameLength >= 2 && name[0] == '"' && name[nameLength - 1] == '"') {
+                ++name;
+                nameLength -= 2;
+            }
+            if (!firstPlayer) json.push_back(',');
+            json.append("{\"score\":");
+            appendJsonString(json, row, static_cast<size_t>(space1 - row));
+            json.append(",\"ping\":");
+            appendJsonString(json, space1 + 1, static_cast<size_t>(space2 - space1 - 1));
+            json.append(",\"name\":");
+            appendJsonString(json, name, nameLength);
+            json.push_back('}');
+            firstPlayer = false;
+        }
+        pos += rowLength + 1;
+    }
+    json.append("]}");
+}
+
+void StandInQuery::rconStatusToJson(const char* body, size_t length, int protocolId, std::string& json) {
+    json.assign("{\"players\":[");
+    bool firstPlayer = true;
+    struct Token {
+        size_t first;  // Offset within the row
+        size_t second; // Length
+    };
+    Token tokens[64];
+    size_t pos = 0;
+    while (pos < length) {
+        size_t rowLength = lineLength(body + pos, length - pos);
+        const char* row = body + pos;
+        pos += rowLength + 1;
+
+        size_t tokenCount = 0;
+        for (size_t i = 0; i < rowLength && tokenCount < 64;) {
+            while (i < rowLength && row[i] == ' ') ++i;
+            size_t start = i;
+            while (i < rowLength && row[i] != ' ') ++i;
+            if (i > start) tokens[tokenCount++] = { start, i - start };
+        }
+        // num score ping [guid] name... lastmsg address qport rate
+        size_t fixed = protocolId == 2 ? 9 : 8;
+        if (tokenCount < fixed || row[tokens[0].first] < '0' || row[tokens[0].first] > '9') {
+            continue; // Header, separator or map line
+        }
+        size_t nameToken = protocolId == 2 ? 4 : 3;
+        size_t nameStart = tokens[nameToken].first;
+        const Token& lastName = tokens[tokenCount - 5];
+        size_t nameEnd = lastName.first + lastName.second;
+        const Token& address = tokens[tokenCount - 3];
+
+        if (!firstPlayer) json.push_back(',');
+        json.append("{\"slot\":");
+        appendJsonString(json, row + tokens[0].first, tokens[0].second);
+        json.append(",\"name\":");
+        appendJsonString(json, row + nameStart, nameEnd - nameStart);
+        json.append(",\"address\":");
+        appendJsonString(json, row + address.first, address.second);
+        json.append(",\"score\":");
+        appendJsonString(json, row + tokens[1].first, tokens[1].second);
+        json.append(",\"ping\":");
+        appendJsonString(json, row + tokens[2].first, tokens[2].second);
+        if (protocolId == 2) {
+            json.append(",\"guid\":");
+            appendJsonString(json, row + tokens[3].first, tokens[3].second);
+        }
+        json.push_back('}');
+        firstPlayer = false;
+    }
+    json.append("]}");
+}
@@ -0,0 +1,23 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+// Stand-in for GameServerQuery on platforms without the DLL.
+// Converts raw out-of-band replies from GameServerSim into the JSON shape the DLL returns,
+// so StatusParser sees the same input in benchmarks as in the application.
+class StandInQuery {
+public:
+    enum class ReplyKind {
+        Unknown,
+        Status, // statusResponse
+        Print   // rcon print
+    };
+
+    // Identifies a raw reply and returns the offset of its body (after the kind line).
+    static ReplyKind classify(const char* data, size_t length, size_t& bodyOffset);
+    // Builds {"sv_hostname":...,"players":[{"score":..,"ping":..,"name":..}]} from a statusResponse body.
+    static void statusToJson(const char* body, size_t length, std::string& json);
+    // Builds {"players":[{"slot":..,"name":..,"address":..,"score":..,"ping":..}]} from an rcon status table.
+    // protocolId 2 tables carry a guid column before the name, passed on as "guid".
+    static void rconStatusToJson(const char* body, size_t length, int protocolId, std::string& json);
+};
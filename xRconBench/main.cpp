@@ -0,0 +1,70 @@
+// --- xRconBench\main.cpp ---
+// Entry point for the xRcon benchmark suite.
+// Parses options, runs every case and prints a table or JSON lines for regression tracking.
+
+#include "Bench.h"
+#include "UdpSocket.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+// Prints command-line usage.
+static void printUsage() {
+    std::printf(
+        "Usage: xRconBench [options]\n"
+        "  --filter TEXT       Only run cases whose name/param contains TEXT\n"
+        "  --min-time MS       Measuring time per case (default 500)\n"
+        "  --warmup MS         Warm-up time per case (default 50)\n"
+        "  --json              Print JSON lines instead of a table\n"
+        "  --out PATH          Also append JSON lines to PATH\n"
+        "  --label TEXT        Release or build label stored in every JSON line\n"
+        "  --base-port P       First UDP port for the simulated fleet (default 47000)\n");
+}
+
+int main(int argc, char** argv) {
+    BenchOptions options;
+    unsigned long basePort = 47000;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            printUsage();
+            return 0;
+        }
+        if (arg == "--json") {
+            options.json = true;
+            continue;
+        }
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (!value) {
+            std::fprintf(stderr, "Missing value for %s\n", arg.c_str());
+            return 1;
+        }
+        ++i;
+        if (arg == "--filter") options.filter = value;
+        else if (arg == "--min-time") options.minTimeMs = std::atof(value);
+        else if (arg == "--warmup") options.warmupMs = std::atof(value);
+        else if (arg == "--out") options.outPath = value;
+        else if (arg == "--label") options.label = value;
+        else if (arg == "--base-port") basePort = std::strtoul(value, nullptr, 10);
+        else {
+            std::fprintf(stderr, "Unknown option %s\n", arg.c_str());
+            printUsage();
+            return 1;
+        }
+    }
+    if (basePort == 0 || basePort > 65000) {
+        std::fprintf(stderr, "Invalid --base-port\n");
+        return 1;
+    }
+
+    if (!UdpSocket::startup()) {
+        std::fprintf(stderr, "Socket startup failed\n");
+        return 1;
+    }
+    BenchRunner runner(options);
+    runAllBenchmarks(runner, static_cast<uint16_t>(basePort));
+    UdpSocket::cleanup();
+    return 0;
+}